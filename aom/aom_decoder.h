@@ -350,7 +350,8 @@ aom_codec_err_t aom_codec_register_put_slice_cb(aom_codec_ctx_t *ctx,
  * \note
  * When decoding AV1, the application may be required to pass in at least
  * #AOM_MAXIMUM_WORK_BUFFERS external frame
- * buffers.
+ * buffers, plus one for each frame parallel decoding thread beyond the
+ * first.
  */
 aom_codec_err_t aom_codec_set_frame_buffer_functions(
     aom_codec_ctx_t *ctx, aom_get_frame_buffer_cb_fn_t cb_get,
@@ -23,9 +23,8 @@ extern "C" {
 #include "./aom_integer.h"
 
 /*!\brief The maximum number of work buffers used by libaom.
- *  Support maximum 4 threads to decode video in parallel.
- *  Each thread will use one work buffer.
- * TODO(hkuang): Add support to set number of worker threads dynamically.
+ *  Frame parallel decoding uses one more work buffer for each thread beyond
+ *  the first.
  */
 #define AOM_MAXIMUM_WORK_BUFFERS 8
 
@@ -571,6 +571,21 @@ enum aome_enc_control_id {
    * Supported in codecs: AV1
    */
   AV1E_SET_RENDER_SIZE,
+
+  /*!\brief Codec control function to enable row based multi-threading.
+   *
+   * When enabled, the superblock rows of each tile are encoded in parallel,
+   * with every row staying behind the row above it. This allows the encoder
+   * to use more threads than there are tile columns. The output does not
+   * depend on the number of threads. Tile rows are not independent, so this
+   * is also the only way the tile rows of a tile column run in parallel.
+   *
+   * By default, the value is set as 0, which means row based multi-threading
+   * is disabled.
+   *
+   * Supported in codecs: AV1
+   */
+  AV1E_SET_ROW_MT,
 };
 
 /*!\brief aom 1-D scaling mode
@@ -835,6 +850,9 @@ AOM_CTRL_USE_TYPE(AV1E_SET_SVC_REF_FRAME_CONFIG, aom_svc_ref_frame_config_t *)
 AOM_CTRL_USE_TYPE(AV1E_SET_RENDER_SIZE, int *)
 #define AOM_CTRL_AV1E_SET_RENDER_SIZE
 
+AOM_CTRL_USE_TYPE(AV1E_SET_ROW_MT, unsigned int)
+#define AOM_CTRL_AV1E_SET_ROW_MT
+
 /*!\endcond */
 /*! @} - end defgroup aom_encoder */
 #ifdef __cplusplus
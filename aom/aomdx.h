@@ -103,6 +103,18 @@ enum aom_dec_control_id {
    */
   AV1_SET_SKIP_LOOP_FILTER,
 
+  /** control function to let the decoder read compressed data directly from
+   * the buffers passed to aom_codec_decode(). Takes an aom_input_buffer_init,
+   * which contains a release callback and an opaque context pointer. Once it
+   * is set, the caller must keep each buffer unchanged until the release
+   * callback has been called for it. In frame parallel mode this avoids
+   * copying every frame into the worker's own buffer. The callback is called
+   * once per aom_codec_decode() call, including failed ones, and at the
+   * latest when the decoder is destroyed. May only be set before the first
+   * frame is decoded.
+   */
+  AV1D_SET_INPUT_BUFFER_RELEASE,
+
   AOM_DECODER_CTRL_ID_MAX
 };
 
@@ -124,6 +136,26 @@ typedef struct aom_decrypt_init {
   void *decrypt_state;
 } aom_decrypt_init;
 
+/** Tell the application that the decoder no longer reads the buffer at data,
+ *  which was passed to aom_codec_decode() with the given user_priv.
+ */
+typedef void (*aom_release_input_buffer_cb)(void *release_state,
+                                            const uint8_t *data,
+                                            void *user_priv);
+
+/*!\brief Structure to hold the input buffer release callback
+ *
+ * Defines a structure to hold the callback and state used by
+ * AV1D_SET_INPUT_BUFFER_RELEASE.
+ */
+typedef struct aom_input_buffer_init {
+  /*! Release callback. */
+  aom_release_input_buffer_cb release_cb;
+
+  /*! Release state. */
+  void *release_state;
+} aom_input_buffer_init;
+
 /*!\brief A deprecated alias for aom_decrypt_init.
  */
 typedef aom_decrypt_init aom_decrypt_init;
@@ -154,6 +186,8 @@ AOM_CTRL_USE_TYPE(AV1D_GET_FRAME_SIZE, int *)
 #define AOM_CTRL_AV1D_GET_FRAME_SIZE
 AOM_CTRL_USE_TYPE(AV1_INVERT_TILE_DECODE_ORDER, int)
 #define AOM_CTRL_AV1_INVERT_TILE_DECODE_ORDER
+AOM_CTRL_USE_TYPE(AV1D_SET_INPUT_BUFFER_RELEASE, aom_input_buffer_init *)
+#define AOM_CTRL_AV1D_SET_INPUT_BUFFER_RELEASE
 
 /*!\endcond */
 /*! @} - end defgroup aom_decoder */
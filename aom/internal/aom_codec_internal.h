@@ -242,7 +242,8 @@ typedef aom_image_t *(*aom_codec_get_frame_fn_t)(aom_codec_alg_priv_t *ctx,
  * \note
  * When decoding AV1, the application may be required to pass in at least
  * #AOM_MAXIMUM_WORK_BUFFERS external frame
- * buffers.
+ * buffers, plus one for each frame parallel decoding thread beyond the
+ * first.
  */
 typedef aom_codec_err_t (*aom_codec_set_fb_fn_t)(
     aom_codec_alg_priv_t *ctx, aom_get_frame_buffer_cb_fn_t cb_get,
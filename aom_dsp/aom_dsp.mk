@@ -80,6 +80,7 @@ DSP_SRCS-$(HAVE_SSSE3) += x86/aom_subpixel_8t_intrin_ssse3.c
 ifeq ($(CONFIG_AOM_HIGHBITDEPTH),yes)
 DSP_SRCS-$(HAVE_SSE2)  += x86/aom_high_subpixel_8t_sse2.asm
 DSP_SRCS-$(HAVE_SSE2)  += x86/aom_high_subpixel_bilinear_sse2.asm
+DSP_SRCS-$(HAVE_AVX2)  += x86/highbd_convolve_avx2.c
 endif
 ifeq ($(CONFIG_USE_X86INC),yes)
 DSP_SRCS-$(HAVE_SSE2)  += x86/aom_convolve_copy_sse2.asm
@@ -248,6 +249,12 @@ DSP_SRCS-$(HAVE_SSE2)   += x86/quantize_sse2.c
 ifeq ($(CONFIG_AOM_HIGHBITDEPTH),yes)
 DSP_SRCS-$(HAVE_SSE2)   += x86/highbd_quantize_intrin_sse2.c
 endif
+ifeq ($(CONFIG_AOM_QM),yes)
+DSP_SRCS-$(HAVE_SSE4_1) += x86/quantize_qm_sse4.h
+DSP_SRCS-$(HAVE_SSE4_1) += x86/quantize_qm_sse4.c
+DSP_SRCS-$(HAVE_AVX2)   += x86/quantize_qm_avx2.h
+DSP_SRCS-$(HAVE_AVX2)   += x86/quantize_qm_avx2.c
+endif
 ifeq ($(ARCH_X86_64),yes)
 ifeq ($(CONFIG_USE_X86INC),yes)
 DSP_SRCS-$(HAVE_SSSE3)  += x86/quantize_ssse3_x86_64.asm
@@ -0,0 +1,575 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "./aom_dsp_rtcd.h"
+#include "aom_dsp/aom_filter.h"
+#include "aom_dsp/x86/convolve.h"
+#include "aom_ports/mem.h"
+
+// Pixels of up to 12 bits fit in a signed 16-bit lane, so each pair of taps
+// is applied with a single _mm256_madd_epi16() and the sums are exact in 32
+// bits, as in the C code.
+
+static INLINE void prepare_filter(const int16_t *filter, __m256i *f) {
+  const __m128i f128 = _mm_loadu_si128((const __m128i *)filter);
+  const __m256i f256 =
+      _mm256_inserti128_si256(_mm256_castsi128_si256(f128), f128, 1);
+  f[0] = _mm256_shuffle_epi32(f256, 0x00);  // taps 0 and 1
+  f[1] = _mm256_shuffle_epi32(f256, 0x55);  // taps 2 and 3
+  f[2] = _mm256_shuffle_epi32(f256, 0xaa);  // taps 4 and 5
+  f[3] = _mm256_shuffle_epi32(f256, 0xff);  // taps 6 and 7
+}
+
+static INLINE __m256i round_shift(__m256i sum) {
+  const __m256i rounding = _mm256_set1_epi32(1 << (FILTER_BITS - 1));
+  return _mm256_srai_epi32(_mm256_add_epi32(sum, rounding), FILTER_BITS);
+}
+
+static INLINE __m256i load_rows(const uint16_t *src, ptrdiff_t pitch) {
+  const __m128i r0 = _mm_loadu_si128((const __m128i *)src);
+  const __m128i r1 = _mm_loadu_si128((const __m128i *)(src + pitch));
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(r0), r1, 1);
+}
+
+static INLINE void store_rows(uint16_t *dst, ptrdiff_t pitch, __m256i v,
+                              int width, int avg) {
+  __m128i r0 = _mm256_castsi256_si128(v);
+  __m128i r1 = _mm256_extracti128_si256(v, 1);
+  if (width == 8) {
+    if (avg) {
+      r0 = _mm_avg_epu16(r0, _mm_loadu_si128((const __m128i *)dst));
+      r1 = _mm_avg_epu16(r1, _mm_loadu_si128((const __m128i *)(dst + pitch)));
+    }
+    _mm_storeu_si128((__m128i *)dst, r0);
+    _mm_storeu_si128((__m128i *)(dst + pitch), r1);
+  } else {
+    if (avg) {
+      r0 = _mm_avg_epu16(r0, _mm_loadl_epi64((const __m128i *)dst));
+      r1 = _mm_avg_epu16(r1, _mm_loadl_epi64((const __m128i *)(dst + pitch)));
+    }
+    _mm_storel_epi64((__m128i *)dst, r0);
+    _mm_storel_epi64((__m128i *)(dst + pitch), r1);
+  }
+}
+
+// Filters the 8 pixels of each 128-bit lane, where lo holds pixels 0 to 7
+// of the window and hi pixels 8 to 15. Even outputs take their taps from the
+// even offsets into the window and odd outputs from the odd ones.
+static INLINE __m256i filter_h8(__m256i lo, __m256i hi, const __m256i *f,
+                                __m256i max) {
+  __m256i even = _mm256_madd_epi16(lo, f[0]);
+  __m256i odd = _mm256_madd_epi16(_mm256_alignr_epi8(hi, lo, 2), f[0]);
+  even = _mm256_add_epi32(
+      even, _mm256_madd_epi16(_mm256_alignr_epi8(hi, lo, 4), f[1]));
+  odd = _mm256_add_epi32(
+      odd, _mm256_madd_epi16(_mm256_alignr_epi8(hi, lo, 6), f[1]));
+  even = _mm256_add_epi32(
+      even, _mm256_madd_epi16(_mm256_alignr_epi8(hi, lo, 8), f[2]));
+  odd = _mm256_add_epi32(
+      odd, _mm256_madd_epi16(_mm256_alignr_epi8(hi, lo, 10), f[2]));
+  even = _mm256_add_epi32(
+      even, _mm256_madd_epi16(_mm256_alignr_epi8(hi, lo, 12), f[3]));
+  odd = _mm256_add_epi32(
+      odd, _mm256_madd_epi16(_mm256_alignr_epi8(hi, lo, 14), f[3]));
+  even = round_shift(even);
+  odd = round_shift(odd);
+  even = _mm256_packus_epi32(even, even);
+  odd = _mm256_packus_epi32(odd, odd);
+  return _mm256_min_epu16(_mm256_unpacklo_epi16(even, odd), max);
+}
+
+static INLINE void highbd_filter_h8_16(const uint16_t *src, ptrdiff_t src_pitch,
+                                       uint16_t *dst, ptrdiff_t dst_pitch,
+                                       unsigned int height,
+                                       const int16_t *filter, int bd, int avg) {
+  const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+  __m256i f[4];
+  unsigned int i;
+
+  prepare_filter(filter, f);
+  src -= SUBPEL_TAPS / 2 - 1;
+  for (i = 0; i < height; ++i) {
+    const __m256i lo = _mm256_loadu_si256((const __m256i *)src);
+    const __m256i hi = _mm256_loadu_si256((const __m256i *)(src + 8));
+    __m256i res = filter_h8(lo, hi, f, max);
+    if (avg)
+      res = _mm256_avg_epu16(res, _mm256_loadu_si256((const __m256i *)dst));
+    _mm256_storeu_si256((__m256i *)dst, res);
+    src += src_pitch;
+    dst += dst_pitch;
+  }
+}
+
+// Filters 8 or 4 pixels of two rows at a time, one row in each 128-bit lane.
+static INLINE void highbd_filter_h8_8(const uint16_t *src, ptrdiff_t src_pitch,
+                                      uint16_t *dst, ptrdiff_t dst_pitch,
+                                      unsigned int height,
+                                      const int16_t *filter, int bd, int width,
+                                      int avg) {
+  const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+  __m256i f[4];
+  unsigned int i;
+
+  prepare_filter(filter, f);
+  src -= SUBPEL_TAPS / 2 - 1;
+  for (i = 0; i < height; i += 2) {
+    // Repeat the last row when the height is odd.
+    const ptrdiff_t pitch = i + 1 < height ? src_pitch : 0;
+    const __m256i lo = load_rows(src, pitch);
+    __m256i hi;
+    if (width == 8) {
+      hi = load_rows(src + 8, pitch);
+    } else {
+      const __m128i r0 = _mm_loadl_epi64((const __m128i *)(src + 8));
+      const __m128i r1 = _mm_loadl_epi64((const __m128i *)(src + 8 + pitch));
+      hi = _mm256_inserti128_si256(_mm256_castsi128_si256(r0), r1, 1);
+    }
+    if (pitch) {
+      store_rows(dst, dst_pitch, filter_h8(lo, hi, f, max), width, avg);
+    } else {
+      __m128i r = _mm256_castsi256_si128(filter_h8(lo, hi, f, max));
+      if (width == 8) {
+        if (avg) r = _mm_avg_epu16(r, _mm_loadu_si128((const __m128i *)dst));
+        _mm_storeu_si128((__m128i *)dst, r);
+      } else {
+        if (avg) r = _mm_avg_epu16(r, _mm_loadl_epi64((const __m128i *)dst));
+        _mm_storel_epi64((__m128i *)dst, r);
+      }
+    }
+    src += 2 * src_pitch;
+    dst += 2 * dst_pitch;
+  }
+}
+
+// The rows are interleaved in pairs so that each _mm256_madd_epi16() applies
+// two taps to the same column.
+static INLINE __m256i filter_v8(const __m256i *s, const __m256i *f,
+                                __m256i max) {
+  __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(s[0], s[1]), f[0]);
+  __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(s[0], s[1]), f[0]);
+  lo = _mm256_add_epi32(
+      lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(s[2], s[3]), f[1]));
+  hi = _mm256_add_epi32(
+      hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(s[2], s[3]), f[1]));
+  lo = _mm256_add_epi32(
+      lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(s[4], s[5]), f[2]));
+  hi = _mm256_add_epi32(
+      hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(s[4], s[5]), f[2]));
+  lo = _mm256_add_epi32(
+      lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(s[6], s[7]), f[3]));
+  hi = _mm256_add_epi32(
+      hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(s[6], s[7]), f[3]));
+  return _mm256_min_epu16(
+      _mm256_packus_epi32(round_shift(lo), round_shift(hi)), max);
+}
+
+static INLINE void highbd_filter_v8_16(const uint16_t *src, ptrdiff_t src_pitch,
+                                       uint16_t *dst, ptrdiff_t dst_pitch,
+                                       unsigned int height,
+                                       const int16_t *filter, int bd, int avg) {
+  const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+  __m256i f[4], s[8];
+  unsigned int i;
+  int k;
+
+  prepare_filter(filter, f);
+  for (k = 0; k < 7; ++k)
+    s[k] = _mm256_loadu_si256((const __m256i *)(src + k * src_pitch));
+  src += 7 * src_pitch;
+  for (i = 0; i < height; ++i) {
+    __m256i res;
+    s[7] = _mm256_loadu_si256((const __m256i *)src);
+    res = filter_v8(s, f, max);
+    if (avg)
+      res = _mm256_avg_epu16(res, _mm256_loadu_si256((const __m256i *)dst));
+    _mm256_storeu_si256((__m256i *)dst, res);
+    for (k = 0; k < 7; ++k) s[k] = s[k + 1];
+    src += src_pitch;
+    dst += dst_pitch;
+  }
+}
+
+// Filters 8 or 4 pixels of two rows at a time. The low lane of s[k] holds
+// source row k and the high lane row k + 1.
+static INLINE void highbd_filter_v8_8(const uint16_t *src, ptrdiff_t src_pitch,
+                                      uint16_t *dst, ptrdiff_t dst_pitch,
+                                      unsigned int height,
+                                      const int16_t *filter, int bd, int width,
+                                      int avg) {
+  const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+  __m128i r[9];
+  __m256i f[4], s[8];
+  unsigned int i;
+  int k;
+
+  prepare_filter(filter, f);
+  for (k = 0; k < 7; ++k) {
+    r[k] = width == 8
+               ? _mm_loadu_si128((const __m128i *)(src + k * src_pitch))
+               : _mm_loadl_epi64((const __m128i *)(src + k * src_pitch));
+  }
+  src += 7 * src_pitch;
+  for (i = 0; i < height; i += 2) {
+    // Repeat the last row when the height is odd.
+    const ptrdiff_t pitch = i + 1 < height ? src_pitch : 0;
+    __m256i res;
+    if (width == 8) {
+      r[7] = _mm_loadu_si128((const __m128i *)src);
+      r[8] = _mm_loadu_si128((const __m128i *)(src + pitch));
+    } else {
+      r[7] = _mm_loadl_epi64((const __m128i *)src);
+      r[8] = _mm_loadl_epi64((const __m128i *)(src + pitch));
+    }
+    for (k = 0; k < 8; ++k)
+      s[k] = _mm256_inserti128_si256(_mm256_castsi128_si256(r[k]), r[k + 1],
+                                     1);
+    res = filter_v8(s, f, max);
+    if (pitch) {
+      store_rows(dst, dst_pitch, res, width, avg);
+    } else {
+      __m128i d = _mm256_castsi256_si128(res);
+      if (width == 8) {
+        if (avg) d = _mm_avg_epu16(d, _mm_loadu_si128((const __m128i *)dst));
+        _mm_storeu_si128((__m128i *)dst, d);
+      } else {
+        if (avg) d = _mm_avg_epu16(d, _mm_loadl_epi64((const __m128i *)dst));
+        _mm_storel_epi64((__m128i *)dst, d);
+      }
+    }
+    for (k = 0; k < 7; ++k) r[k] = r[k + 2];
+    src += 2 * src_pitch;
+    dst += 2 * dst_pitch;
+  }
+}
+
+#define HIGHBD_FILTER_H8(w, avg_name, avg)                                   \
+  static void aom_highbd_filter_block1d##w##_h8_##avg_name##avx2(            \
+      const uint16_t *src, const ptrdiff_t src_pitch, uint16_t *dst,         \
+      ptrdiff_t dst_pitch, unsigned int height, const int16_t *filter,       \
+      int bd) {                                                              \
+    if (w == 16)                                                             \
+      highbd_filter_h8_16(src, src_pitch, dst, dst_pitch, height, filter,    \
+                          bd, avg);                                          \
+    else                                                                     \
+      highbd_filter_h8_8(src, src_pitch, dst, dst_pitch, height, filter, bd, \
+                         w, avg);                                            \
+  }
+
+#define HIGHBD_FILTER_V8(w, avg_name, avg)                                   \
+  static void aom_highbd_filter_block1d##w##_v8_##avg_name##avx2(            \
+      const uint16_t *src, const ptrdiff_t src_pitch, uint16_t *dst,         \
+      ptrdiff_t dst_pitch, unsigned int height, const int16_t *filter,       \
+      int bd) {                                                              \
+    if (w == 16)                                                             \
+      highbd_filter_v8_16(src, src_pitch, dst, dst_pitch, height, filter,    \
+                          bd, avg);                                          \
+    else                                                                     \
+      highbd_filter_v8_8(src, src_pitch, dst, dst_pitch, height, filter, bd, \
+                         w, avg);                                            \
+  }
+
+HIGHBD_FILTER_H8(16, , 0)
+HIGHBD_FILTER_H8(8, , 0)
+HIGHBD_FILTER_H8(4, , 0)
+HIGHBD_FILTER_H8(16, avg_, 1)
+HIGHBD_FILTER_H8(8, avg_, 1)
+HIGHBD_FILTER_H8(4, avg_, 1)
+HIGHBD_FILTER_V8(16, , 0)
+HIGHBD_FILTER_V8(8, , 0)
+HIGHBD_FILTER_V8(4, , 0)
+HIGHBD_FILTER_V8(16, avg_, 1)
+HIGHBD_FILTER_V8(8, avg_, 1)
+HIGHBD_FILTER_V8(4, avg_, 1)
+
+// The bilinear filters only use taps 3 and 4.
+static INLINE __m256i prepare_filter2(const int16_t *filter) {
+  return _mm256_set1_epi32((uint16_t)filter[3] |
+                           ((uint32_t)(uint16_t)filter[4] << 16));
+}
+
+static INLINE __m256i filter_h2(__m256i even, __m256i odd, __m256i f,
+                                __m256i max) {
+  even = round_shift(_mm256_madd_epi16(even, f));
+  odd = round_shift(_mm256_madd_epi16(odd, f));
+  even = _mm256_packus_epi32(even, even);
+  odd = _mm256_packus_epi32(odd, odd);
+  return _mm256_min_epu16(_mm256_unpacklo_epi16(even, odd), max);
+}
+
+// Even outputs are filtered from the pixel pairs starting at src and odd
+// outputs from the pairs starting at src + 1.
+static INLINE void highbd_filter_h2(const uint16_t *src, ptrdiff_t src_pitch,
+                                    uint16_t *dst, ptrdiff_t dst_pitch,
+                                    unsigned int height, const int16_t *filter,
+                                    int bd, int width, int avg) {
+  const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+  const __m256i f = prepare_filter2(filter);
+  unsigned int i;
+
+  if (width == 16) {
+    for (i = 0; i < height; ++i) {
+      const __m256i even = _mm256_loadu_si256((const __m256i *)src);
+      const __m256i odd = _mm256_loadu_si256((const __m256i *)(src + 1));
+      __m256i res = filter_h2(even, odd, f, max);
+      if (avg)
+        res = _mm256_avg_epu16(res, _mm256_loadu_si256((const __m256i *)dst));
+      _mm256_storeu_si256((__m256i *)dst, res);
+      src += src_pitch;
+      dst += dst_pitch;
+    }
+    return;
+  }
+
+  for (i = 0; i < height; i += 2) {
+    // Repeat the last row when the height is odd.
+    const ptrdiff_t pitch = i + 1 < height ? src_pitch : 0;
+    __m256i even, odd, res;
+    if (width == 8) {
+      even = load_rows(src, pitch);
+      odd = load_rows(src + 1, pitch);
+    } else {
+      even = _mm256_inserti128_si256(
+          _mm256_castsi128_si256(_mm_loadl_epi64((const __m128i *)src)),
+          _mm_loadl_epi64((const __m128i *)(src + pitch)), 1);
+      odd = _mm256_inserti128_si256(
+          _mm256_castsi128_si256(_mm_loadl_epi64((const __m128i *)(src + 1))),
+          _mm_loadl_epi64((const __m128i *)(src + 1 + pitch)), 1);
+    }
+    res = filter_h2(even, odd, f, max);
+    if (pitch) {
+      store_rows(dst, dst_pitch, res, width, avg);
+    } else {
+      __m128i d = _mm256_castsi256_si128(res);
+      if (width == 8) {
+        if (avg) d = _mm_avg_epu16(d, _mm_loadu_si128((const __m128i *)dst));
+        _mm_storeu_si128((__m128i *)dst, d);
+      } else {
+        if (avg) d = _mm_avg_epu16(d, _mm_loadl_epi64((const __m128i *)dst));
+        _mm_storel_epi64((__m128i *)dst, d);
+      }
+    }
+    src += 2 * src_pitch;
+    dst += 2 * dst_pitch;
+  }
+}
+
+static INLINE __m128i filter_v2_128(__m128i s0, __m128i s1, __m128i f,
+                                    __m128i max) {
+  const __m128i rounding = _mm_set1_epi32(1 << (FILTER_BITS - 1));
+  __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(s0, s1), f);
+  __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(s0, s1), f);
+  lo = _mm_srai_epi32(_mm_add_epi32(lo, rounding), FILTER_BITS);
+  hi = _mm_srai_epi32(_mm_add_epi32(hi, rounding), FILTER_BITS);
+  return _mm_min_epu16(_mm_packus_epi32(lo, hi), max);
+}
+
+static INLINE void highbd_filter_v2(const uint16_t *src, ptrdiff_t src_pitch,
+                                    uint16_t *dst, ptrdiff_t dst_pitch,
+                                    unsigned int height, const int16_t *filter,
+                                    int bd, int width, int avg) {
+  const __m256i f = prepare_filter2(filter);
+  unsigned int i;
+
+  if (width == 16) {
+    const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+    __m256i s0 = _mm256_loadu_si256((const __m256i *)src);
+    for (i = 0; i < height; ++i) {
+      const __m256i s1 =
+          _mm256_loadu_si256((const __m256i *)(src + src_pitch));
+      __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(s0, s1), f);
+      __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(s0, s1), f);
+      __m256i res = _mm256_min_epu16(
+          _mm256_packus_epi32(round_shift(lo), round_shift(hi)), max);
+      if (avg)
+        res = _mm256_avg_epu16(res, _mm256_loadu_si256((const __m256i *)dst));
+      _mm256_storeu_si256((__m256i *)dst, res);
+      s0 = s1;
+      src += src_pitch;
+      dst += dst_pitch;
+    }
+  } else {
+    const __m128i f128 = _mm256_castsi256_si128(f);
+    const __m128i max = _mm_set1_epi16((1 << bd) - 1);
+    __m128i s0 = width == 8 ? _mm_loadu_si128((const __m128i *)src)
+                            : _mm_loadl_epi64((const __m128i *)src);
+    for (i = 0; i < height; ++i) {
+      const __m128i s1 =
+          width == 8 ? _mm_loadu_si128((const __m128i *)(src + src_pitch))
+                     : _mm_loadl_epi64((const __m128i *)(src + src_pitch));
+      __m128i res = filter_v2_128(s0, s1, f128, max);
+      if (width == 8) {
+        if (avg)
+          res = _mm_avg_epu16(res, _mm_loadu_si128((const __m128i *)dst));
+        _mm_storeu_si128((__m128i *)dst, res);
+      } else {
+        if (avg)
+          res = _mm_avg_epu16(res, _mm_loadl_epi64((const __m128i *)dst));
+        _mm_storel_epi64((__m128i *)dst, res);
+      }
+      s0 = s1;
+      src += src_pitch;
+      dst += dst_pitch;
+    }
+  }
+}
+
+#define HIGHBD_FILTER_2(w, avg_name, avg)                                   \
+  static void aom_highbd_filter_block1d##w##_h2_##avg_name##avx2(           \
+      const uint16_t *src, const ptrdiff_t src_pitch, uint16_t *dst,        \
+      ptrdiff_t dst_pitch, unsigned int height, const int16_t *filter,      \
+      int bd) {                                                             \
+    highbd_filter_h2(src, src_pitch, dst, dst_pitch, height, filter, bd, w, \
+                     avg);                                                  \
+  }                                                                         \
+  static void aom_highbd_filter_block1d##w##_v2_##avg_name##avx2(           \
+      const uint16_t *src, const ptrdiff_t src_pitch, uint16_t *dst,        \
+      ptrdiff_t dst_pitch, unsigned int height, const int16_t *filter,      \
+      int bd) {                                                             \
+    highbd_filter_v2(src, src_pitch, dst, dst_pitch, height, filter, bd, w, \
+                     avg);                                                  \
+  }
+
+HIGHBD_FILTER_2(16, , 0)
+HIGHBD_FILTER_2(8, , 0)
+HIGHBD_FILTER_2(4, , 0)
+HIGHBD_FILTER_2(16, avg_, 1)
+HIGHBD_FILTER_2(8, avg_, 1)
+HIGHBD_FILTER_2(4, avg_, 1)
+
+// void aom_highbd_convolve8_horiz_avx2(const uint8_t *src,
+//                                      ptrdiff_t src_stride,
+//                                      uint8_t *dst,
+//                                      ptrdiff_t dst_stride,
+//                                      const int16_t *filter_x,
+//                                      int x_step_q4,
+//                                      const int16_t *filter_y,
+//                                      int y_step_q4,
+//                                      int w, int h, int bd);
+// void aom_highbd_convolve8_vert_avx2(const uint8_t *src,
+//                                     ptrdiff_t src_stride,
+//                                     uint8_t *dst,
+//                                     ptrdiff_t dst_stride,
+//                                     const int16_t *filter_x,
+//                                     int x_step_q4,
+//                                     const int16_t *filter_y,
+//                                     int y_step_q4,
+//                                     int w, int h, int bd);
+// void aom_highbd_convolve8_avg_horiz_avx2(const uint8_t *src,
+//                                          ptrdiff_t src_stride,
+//                                          uint8_t *dst,
+//                                          ptrdiff_t dst_stride,
+//                                          const int16_t *filter_x,
+//                                          int x_step_q4,
+//                                          const int16_t *filter_y,
+//                                          int y_step_q4,
+//                                          int w, int h, int bd);
+// void aom_highbd_convolve8_avg_vert_avx2(const uint8_t *src,
+//                                         ptrdiff_t src_stride,
+//                                         uint8_t *dst,
+//                                         ptrdiff_t dst_stride,
+//                                         const int16_t *filter_x,
+//                                         int x_step_q4,
+//                                         const int16_t *filter_y,
+//                                         int y_step_q4,
+//                                         int w, int h, int bd);
+HIGH_FUN_CONV_1D(horiz, x_step_q4, filter_x, h, src, , avx2);
+HIGH_FUN_CONV_1D(vert, y_step_q4, filter_y, v, src - src_stride * 3, , avx2);
+HIGH_FUN_CONV_1D(avg_horiz, x_step_q4, filter_x, h, src, avg_, avx2);
+HIGH_FUN_CONV_1D(avg_vert, y_step_q4, filter_y, v, src - src_stride * 3, avg_,
+                 avx2);
+
+// void aom_highbd_convolve8_avx2(const uint8_t *src, ptrdiff_t src_stride,
+//                                uint8_t *dst, ptrdiff_t dst_stride,
+//                                const int16_t *filter_x, int x_step_q4,
+//                                const int16_t *filter_y, int y_step_q4,
+//                                int w, int h, int bd);
+// void aom_highbd_convolve8_avg_avx2(const uint8_t *src, ptrdiff_t src_stride,
+//                                    uint8_t *dst, ptrdiff_t dst_stride,
+//                                    const int16_t *filter_x, int x_step_q4,
+//                                    const int16_t *filter_y, int y_step_q4,
+//                                    int w, int h, int bd);
+HIGH_FUN_CONV_2D(, avx2);
+HIGH_FUN_CONV_2D(avg_, avx2);
+
+void aom_highbd_convolve_copy_avx2(const uint8_t *src8, ptrdiff_t src_stride,
+                                   uint8_t *dst8, ptrdiff_t dst_stride,
+                                   const int16_t *filter_x, int filter_x_stride,
+                                   const int16_t *filter_y, int filter_y_stride,
+                                   int w, int h, int bd) {
+  const uint16_t *src = CONVERT_TO_SHORTPTR(src8);
+  uint16_t *dst = CONVERT_TO_SHORTPTR(dst8);
+  int x, y;
+  (void)filter_x;
+  (void)filter_y;
+  (void)filter_x_stride;
+  (void)filter_y_stride;
+  (void)bd;
+
+  for (y = 0; y < h; ++y) {
+    for (x = 0; x + 16 <= w; x += 16) {
+      _mm256_storeu_si256((__m256i *)(dst + x),
+                          _mm256_loadu_si256((const __m256i *)(src + x)));
+    }
+    if (x + 8 <= w) {
+      _mm_storeu_si128((__m128i *)(dst + x),
+                       _mm_loadu_si128((const __m128i *)(src + x)));
+      x += 8;
+    }
+    if (x + 4 <= w) {
+      _mm_storel_epi64((__m128i *)(dst + x),
+                       _mm_loadl_epi64((const __m128i *)(src + x)));
+      x += 4;
+    }
+    for (; x < w; ++x) dst[x] = src[x];
+    src += src_stride;
+    dst += dst_stride;
+  }
+}
+
+void aom_highbd_convolve_avg_avx2(const uint8_t *src8, ptrdiff_t src_stride,
+                                  uint8_t *dst8, ptrdiff_t dst_stride,
+                                  const int16_t *filter_x, int filter_x_stride,
+                                  const int16_t *filter_y, int filter_y_stride,
+                                  int w, int h, int bd) {
+  const uint16_t *src = CONVERT_TO_SHORTPTR(src8);
+  uint16_t *dst = CONVERT_TO_SHORTPTR(dst8);
+  int x, y;
+  (void)filter_x;
+  (void)filter_y;
+  (void)filter_x_stride;
+  (void)filter_y_stride;
+  (void)bd;
+
+  for (y = 0; y < h; ++y) {
+    for (x = 0; x + 16 <= w; x += 16) {
+      const __m256i s = _mm256_loadu_si256((const __m256i *)(src + x));
+      const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + x));
+      _mm256_storeu_si256((__m256i *)(dst + x), _mm256_avg_epu16(s, d));
+    }
+    if (x + 8 <= w) {
+      const __m128i s = _mm_loadu_si128((const __m128i *)(src + x));
+      const __m128i d = _mm_loadu_si128((const __m128i *)(dst + x));
+      _mm_storeu_si128((__m128i *)(dst + x), _mm_avg_epu16(s, d));
+      x += 8;
+    }
+    if (x + 4 <= w) {
+      const __m128i s = _mm_loadl_epi64((const __m128i *)(src + x));
+      const __m128i d = _mm_loadl_epi64((const __m128i *)(dst + x));
+      _mm_storel_epi64((__m128i *)(dst + x), _mm_avg_epu16(s, d));
+      x += 4;
+    }
+    for (; x < w; ++x) dst[x] = ROUND_POWER_OF_TWO(dst[x] + src[x], 1);
+    src += src_stride;
+    dst += dst_stride;
+  }
+}
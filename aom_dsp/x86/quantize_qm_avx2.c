@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+
+#include "./aom_dsp_rtcd.h"
+#include "aom_dsp/x86/quantize_qm_avx2.h"
+
+// See quantize_qm_sse4.c.
+static INLINE void quantize_b_qm_avx2(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block,
+    const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *iscan_ptr, const qm_val_t *qm_ptr, const qm_val_t *iqm_ptr,
+    int log_scale, int clamp16) {
+  const int rounding = (1 << log_scale) >> 1;
+  const int shift_bits = 16 + AOM_QM_BITS - log_scale;
+  __m256i zbin, round, quant, shift, dequant;
+  __m256i eob = _mm256_setzero_si256();
+  intptr_t i;
+
+  if (skip_block) {
+    memset(qcoeff_ptr, 0, n_coeffs * sizeof(*qcoeff_ptr));
+    memset(dqcoeff_ptr, 0, n_coeffs * sizeof(*dqcoeff_ptr));
+    *eob_ptr = 0;
+    return;
+  }
+
+  zbin = qm_dc_ac_avx2(
+      (((zbin_ptr[0] + rounding) >> log_scale) << AOM_QM_BITS) - 1,
+      (((zbin_ptr[1] + rounding) >> log_scale) << AOM_QM_BITS) - 1);
+  round = qm_dc_ac_avx2((round_ptr[0] + rounding) >> log_scale,
+                        (round_ptr[1] + rounding) >> log_scale);
+  quant = qm_dc_ac_avx2(quant_ptr[0], quant_ptr[1]);
+  shift = qm_dc_ac_avx2(quant_shift_ptr[0], quant_shift_ptr[1]);
+  dequant = qm_dc_ac_avx2(dequant_ptr[0], dequant_ptr[1]);
+
+  for (i = 0; i < n_coeffs; i += 8) {
+    const __m256i coeff = qm_load_coeff_avx2(coeff_ptr + i);
+    const __m256i wt = qm_load_weight_avx2(qm_ptr + i);
+    const __m256i iwt = qm_load_weight_avx2(iqm_ptr + i);
+    const __m256i sign = _mm256_srai_epi32(coeff, 31);
+    const __m256i abs_coeff =
+        _mm256_sub_epi32(_mm256_xor_si256(coeff, sign), sign);
+    const __m256i nonzero =
+        _mm256_cmpgt_epi32(_mm256_mullo_epi32(abs_coeff, wt), zbin);
+    __m256i tmp, qcoeff, dqcoeff;
+
+    tmp = _mm256_add_epi32(abs_coeff, round);
+    if (clamp16) tmp = qm_clamp16_avx2(tmp);
+    tmp = _mm256_mullo_epi32(tmp, wt);
+    tmp = _mm256_add_epi32(qm_mul_shift_avx2(tmp, quant, 16), tmp);
+    tmp = qm_mul_shift_avx2(tmp, shift, shift_bits);
+    tmp = _mm256_and_si256(tmp, nonzero);
+
+    qcoeff = qm_narrow_coeff_avx2(
+        _mm256_sub_epi32(_mm256_xor_si256(tmp, sign), sign));
+    dqcoeff = _mm256_mullo_epi32(qcoeff, qm_dequant_avx2(dequant, iwt));
+    if (log_scale) dqcoeff = qm_half_avx2(dqcoeff);
+    qm_store_coeff_avx2(qcoeff, qcoeff_ptr + i);
+    qm_store_coeff_avx2(dqcoeff, dqcoeff_ptr + i);
+    eob = qm_update_eob_avx2(eob, tmp, iscan_ptr + i);
+
+    if (i == 0) {
+      zbin = qm_ac_avx2(zbin);
+      round = qm_ac_avx2(round);
+      quant = qm_ac_avx2(quant);
+      shift = qm_ac_avx2(shift);
+      dequant = qm_ac_avx2(dequant);
+    }
+  }
+  *eob_ptr = qm_eob_avx2(eob);
+}
+
+void aom_quantize_b_avx2(const tran_low_t *coeff_ptr, intptr_t n_coeffs,
+                         int skip_block, const int16_t *zbin_ptr,
+                         const int16_t *round_ptr, const int16_t *quant_ptr,
+                         const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+                         tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr,
+                         uint16_t *eob_ptr, const int16_t *scan_ptr,
+                         const int16_t *iscan_ptr, const qm_val_t *qm_ptr,
+                         const qm_val_t *iqm_ptr) {
+  (void)scan_ptr;
+  quantize_b_qm_avx2(coeff_ptr, n_coeffs, skip_block, zbin_ptr, round_ptr,
+                     quant_ptr, quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr,
+                     dequant_ptr, eob_ptr, iscan_ptr, qm_ptr, iqm_ptr, 0, 1);
+}
+
+void aom_quantize_b_32x32_avx2(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block,
+    const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan_ptr, const int16_t *iscan_ptr, const qm_val_t *qm_ptr,
+    const qm_val_t *iqm_ptr) {
+  (void)scan_ptr;
+  quantize_b_qm_avx2(coeff_ptr, n_coeffs, skip_block, zbin_ptr, round_ptr,
+                     quant_ptr, quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr,
+                     dequant_ptr, eob_ptr, iscan_ptr, qm_ptr, iqm_ptr, 1, 1);
+}
+
+#if CONFIG_AOM_HIGHBITDEPTH
+void aom_highbd_quantize_b_avx2(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block,
+    const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan_ptr, const int16_t *iscan_ptr, const qm_val_t *qm_ptr,
+    const qm_val_t *iqm_ptr) {
+  (void)scan_ptr;
+  quantize_b_qm_avx2(coeff_ptr, n_coeffs, skip_block, zbin_ptr, round_ptr,
+                     quant_ptr, quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr,
+                     dequant_ptr, eob_ptr, iscan_ptr, qm_ptr, iqm_ptr, 0, 0);
+}
+
+void aom_highbd_quantize_b_32x32_avx2(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block,
+    const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan_ptr, const int16_t *iscan_ptr, const qm_val_t *qm_ptr,
+    const qm_val_t *iqm_ptr) {
+  (void)scan_ptr;
+  quantize_b_qm_avx2(coeff_ptr, n_coeffs, skip_block, zbin_ptr, round_ptr,
+                     quant_ptr, quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr,
+                     dequant_ptr, eob_ptr, iscan_ptr, qm_ptr, iqm_ptr, 1, 0);
+}
+#endif  // CONFIG_AOM_HIGHBITDEPTH
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_DSP_X86_QUANTIZE_QM_AVX2_H_
+#define AOM_DSP_X86_QUANTIZE_QM_AVX2_H_
+
+#include <immintrin.h>
+
+#include "./aom_config.h"
+#include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
+
+// Eight lane versions of the helpers in quantize_qm_sse4.h.
+
+static INLINE __m256i qm_load_coeff_avx2(const tran_low_t *coeff_ptr) {
+#if CONFIG_AOM_HIGHBITDEPTH
+  return _mm256_loadu_si256((const __m256i *)coeff_ptr);
+#else
+  return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)coeff_ptr));
+#endif
+}
+
+static INLINE void qm_store_coeff_avx2(__m256i x, tran_low_t *coeff_ptr) {
+#if CONFIG_AOM_HIGHBITDEPTH
+  _mm256_storeu_si256((__m256i *)coeff_ptr, x);
+#else
+  // Keep the low 16 bits, as the C code does when it stores an int.
+  x = _mm256_srai_epi32(_mm256_slli_epi32(x, 16), 16);
+  _mm_storeu_si128((__m128i *)coeff_ptr,
+                   _mm_packs_epi32(_mm256_castsi256_si128(x),
+                                   _mm256_extracti128_si256(x, 1)));
+#endif
+}
+
+// The C code dequantizes the quantized value read back from tran_low_t.
+static INLINE __m256i qm_narrow_coeff_avx2(__m256i x) {
+#if CONFIG_AOM_HIGHBITDEPTH
+  return x;
+#else
+  return _mm256_srai_epi32(_mm256_slli_epi32(x, 16), 16);
+#endif
+}
+
+static INLINE __m256i qm_load_weight_avx2(const qm_val_t *qm_ptr) {
+  return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)qm_ptr));
+}
+
+// Lane 0 holds the DC value, the remaining lanes the AC value.
+static INLINE __m256i qm_dc_ac_avx2(int dc, int ac) {
+  return _mm256_setr_epi32(dc, ac, ac, ac, ac, ac, ac, ac);
+}
+
+static INLINE __m256i qm_ac_avx2(__m256i x) {
+  return _mm256_shuffle_epi32(x, 0x55);
+}
+
+// Low 32 bits of ((int64_t)a * b) >> shift.
+static INLINE __m256i qm_mul_shift_avx2(__m256i a, __m256i b, int shift) {
+  const __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(a, b), shift);
+  const __m256i odd = _mm256_slli_epi64(
+      _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)),
+      32 - shift);
+  return _mm256_blend_epi32(even, odd, 0xaa);
+}
+
+// (dequant * iwt + (1 << (AOM_QM_BITS - 1))) >> AOM_QM_BITS
+static INLINE __m256i qm_dequant_avx2(__m256i dequant, __m256i iwt) {
+  const __m256i round = _mm256_set1_epi32(1 << (AOM_QM_BITS - 1));
+  return _mm256_srai_epi32(
+      _mm256_add_epi32(_mm256_mullo_epi32(dequant, iwt), round), AOM_QM_BITS);
+}
+
+// Divides by two, rounding towards zero.
+static INLINE __m256i qm_half_avx2(__m256i x) {
+  return _mm256_srai_epi32(_mm256_add_epi32(x, _mm256_srli_epi32(x, 31)), 1);
+}
+
+static INLINE __m256i qm_clamp16_avx2(__m256i x) {
+  return _mm256_max_epi32(_mm256_min_epi32(x, _mm256_set1_epi32(INT16_MAX)),
+                          _mm256_set1_epi32(INT16_MIN));
+}
+
+// Keeps the largest iscan + 1 of the lanes with a non-zero quantized value.
+static INLINE __m256i qm_update_eob_avx2(__m256i eob, __m256i abs_qcoeff,
+                                         const int16_t *iscan_ptr) {
+  const __m256i zero =
+      _mm256_cmpeq_epi32(abs_qcoeff, _mm256_setzero_si256());
+  __m256i iscan =
+      _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)iscan_ptr));
+  iscan = _mm256_add_epi32(iscan, _mm256_set1_epi32(1));
+  return _mm256_max_epi32(eob, _mm256_andnot_si256(zero, iscan));
+}
+
+static INLINE uint16_t qm_eob_avx2(__m256i eob) {
+  __m128i x = _mm_max_epi32(_mm256_castsi256_si128(eob),
+                            _mm256_extracti128_si256(eob, 1));
+  x = _mm_max_epi32(x, _mm_srli_si128(x, 8));
+  x = _mm_max_epi32(x, _mm_srli_si128(x, 4));
+  return (uint16_t)_mm_cvtsi128_si32(x);
+}
+
+#endif  // AOM_DSP_X86_QUANTIZE_QM_AVX2_H_
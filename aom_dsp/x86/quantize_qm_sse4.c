@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+
+#include "./aom_dsp_rtcd.h"
+#include "aom_dsp/x86/quantize_qm_sse4.h"
+
+// The C code skips coefficients that fall inside the weighted zero bin and
+// stops at the last one that does not; both amount to masking the lanes
+// with abs_coeff * wt < zbin << AOM_QM_BITS, so the coefficients are
+// processed in raster order and the end of block comes from iscan.
+static INLINE void quantize_b_qm_sse4_1(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block,
+    const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *iscan_ptr, const qm_val_t *qm_ptr, const qm_val_t *iqm_ptr,
+    int log_scale, int clamp16) {
+  const int rounding = (1 << log_scale) >> 1;
+  const int shift_bits = 16 + AOM_QM_BITS - log_scale;
+  __m128i zbin, round, quant, shift, dequant;
+  __m128i eob = _mm_setzero_si128();
+  intptr_t i;
+
+  if (skip_block) {
+    memset(qcoeff_ptr, 0, n_coeffs * sizeof(*qcoeff_ptr));
+    memset(dqcoeff_ptr, 0, n_coeffs * sizeof(*dqcoeff_ptr));
+    *eob_ptr = 0;
+    return;
+  }
+
+  zbin = qm_dc_ac_sse4_1(
+      (((zbin_ptr[0] + rounding) >> log_scale) << AOM_QM_BITS) - 1,
+      (((zbin_ptr[1] + rounding) >> log_scale) << AOM_QM_BITS) - 1);
+  round = qm_dc_ac_sse4_1((round_ptr[0] + rounding) >> log_scale,
+                          (round_ptr[1] + rounding) >> log_scale);
+  quant = qm_dc_ac_sse4_1(quant_ptr[0], quant_ptr[1]);
+  shift = qm_dc_ac_sse4_1(quant_shift_ptr[0], quant_shift_ptr[1]);
+  dequant = qm_dc_ac_sse4_1(dequant_ptr[0], dequant_ptr[1]);
+
+  for (i = 0; i < n_coeffs; i += 4) {
+    const __m128i coeff = qm_load_coeff_sse4_1(coeff_ptr + i);
+    const __m128i wt = qm_load_weight_sse4_1(qm_ptr + i);
+    const __m128i iwt = qm_load_weight_sse4_1(iqm_ptr + i);
+    const __m128i sign = _mm_srai_epi32(coeff, 31);
+    const __m128i abs_coeff = _mm_sub_epi32(_mm_xor_si128(coeff, sign), sign);
+    const __m128i nonzero =
+        _mm_cmpgt_epi32(_mm_mullo_epi32(abs_coeff, wt), zbin);
+    __m128i tmp, qcoeff, dqcoeff;
+
+    tmp = _mm_add_epi32(abs_coeff, round);
+    if (clamp16) tmp = qm_clamp16_sse4_1(tmp);
+    tmp = _mm_mullo_epi32(tmp, wt);
+    tmp = _mm_add_epi32(qm_mul_shift_sse4_1(tmp, quant, 16), tmp);
+    tmp = qm_mul_shift_sse4_1(tmp, shift, shift_bits);
+    tmp = _mm_and_si128(tmp, nonzero);
+
+    qcoeff = qm_narrow_coeff_sse4_1(
+        _mm_sub_epi32(_mm_xor_si128(tmp, sign), sign));
+    dqcoeff = _mm_mullo_epi32(qcoeff, qm_dequant_sse4_1(dequant, iwt));
+    if (log_scale) dqcoeff = qm_half_sse4_1(dqcoeff);
+    qm_store_coeff_sse4_1(qcoeff, qcoeff_ptr + i);
+    qm_store_coeff_sse4_1(dqcoeff, dqcoeff_ptr + i);
+    eob = qm_update_eob_sse4_1(eob, tmp, iscan_ptr + i);
+
+    if (i == 0) {
+      zbin = qm_ac_sse4_1(zbin);
+      round = qm_ac_sse4_1(round);
+      quant = qm_ac_sse4_1(quant);
+      shift = qm_ac_sse4_1(shift);
+      dequant = qm_ac_sse4_1(dequant);
+    }
+  }
+  *eob_ptr = qm_eob_sse4_1(eob);
+}
+
+void aom_quantize_b_sse4_1(const tran_low_t *coeff_ptr, intptr_t n_coeffs,
+                           int skip_block, const int16_t *zbin_ptr,
+                           const int16_t *round_ptr, const int16_t *quant_ptr,
+                           const int16_t *quant_shift_ptr,
+                           tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr,
+                           const int16_t *dequant_ptr, uint16_t *eob_ptr,
+                           const int16_t *scan_ptr, const int16_t *iscan_ptr,
+                           const qm_val_t *qm_ptr, const qm_val_t *iqm_ptr) {
+  (void)scan_ptr;
+  quantize_b_qm_sse4_1(coeff_ptr, n_coeffs, skip_block, zbin_ptr, round_ptr,
+                       quant_ptr, quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr,
+                       dequant_ptr, eob_ptr, iscan_ptr, qm_ptr, iqm_ptr, 0, 1);
+}
+
+void aom_quantize_b_32x32_sse4_1(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block,
+    const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan_ptr, const int16_t *iscan_ptr, const qm_val_t *qm_ptr,
+    const qm_val_t *iqm_ptr) {
+  (void)scan_ptr;
+  quantize_b_qm_sse4_1(coeff_ptr, n_coeffs, skip_block, zbin_ptr, round_ptr,
+                       quant_ptr, quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr,
+                       dequant_ptr, eob_ptr, iscan_ptr, qm_ptr, iqm_ptr, 1, 1);
+}
+
+#if CONFIG_AOM_HIGHBITDEPTH
+void aom_highbd_quantize_b_sse4_1(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block,
+    const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan_ptr, const int16_t *iscan_ptr, const qm_val_t *qm_ptr,
+    const qm_val_t *iqm_ptr) {
+  (void)scan_ptr;
+  quantize_b_qm_sse4_1(coeff_ptr, n_coeffs, skip_block, zbin_ptr, round_ptr,
+                       quant_ptr, quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr,
+                       dequant_ptr, eob_ptr, iscan_ptr, qm_ptr, iqm_ptr, 0, 0);
+}
+
+void aom_highbd_quantize_b_32x32_sse4_1(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block,
+    const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan_ptr, const int16_t *iscan_ptr, const qm_val_t *qm_ptr,
+    const qm_val_t *iqm_ptr) {
+  (void)scan_ptr;
+  quantize_b_qm_sse4_1(coeff_ptr, n_coeffs, skip_block, zbin_ptr, round_ptr,
+                       quant_ptr, quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr,
+                       dequant_ptr, eob_ptr, iscan_ptr, qm_ptr, iqm_ptr, 1, 0);
+}
+#endif  // CONFIG_AOM_HIGHBITDEPTH
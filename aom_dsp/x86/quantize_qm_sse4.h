@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_DSP_X86_QUANTIZE_QM_SSE4_H_
+#define AOM_DSP_X86_QUANTIZE_QM_SSE4_H_
+
+#include <smmintrin.h>
+
+#include "./aom_config.h"
+#include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
+
+// Helpers for the quantization matrix quantizers. Each coefficient is
+// widened to a 32-bit lane so that the weighted products, which the C code
+// forms in 64 bits, can be computed exactly.
+
+static INLINE __m128i qm_load_coeff_sse4_1(const tran_low_t *coeff_ptr) {
+#if CONFIG_AOM_HIGHBITDEPTH
+  return _mm_load_si128((const __m128i *)coeff_ptr);
+#else
+  return _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)coeff_ptr));
+#endif
+}
+
+static INLINE void qm_store_coeff_sse4_1(__m128i x, tran_low_t *coeff_ptr) {
+#if CONFIG_AOM_HIGHBITDEPTH
+  _mm_store_si128((__m128i *)coeff_ptr, x);
+#else
+  // Keep the low 16 bits, as the C code does when it stores an int.
+  x = _mm_srai_epi32(_mm_slli_epi32(x, 16), 16);
+  _mm_storel_epi64((__m128i *)coeff_ptr, _mm_packs_epi32(x, x));
+#endif
+}
+
+// The C code dequantizes the quantized value read back from tran_low_t.
+static INLINE __m128i qm_narrow_coeff_sse4_1(__m128i x) {
+#if CONFIG_AOM_HIGHBITDEPTH
+  return x;
+#else
+  return _mm_srai_epi32(_mm_slli_epi32(x, 16), 16);
+#endif
+}
+
+static INLINE __m128i qm_load_weight_sse4_1(const qm_val_t *qm_ptr) {
+  return _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)qm_ptr));
+}
+
+// Lane 0 holds the DC value, the remaining lanes the AC value.
+static INLINE __m128i qm_dc_ac_sse4_1(int dc, int ac) {
+  return _mm_setr_epi32(dc, ac, ac, ac);
+}
+
+static INLINE __m128i qm_ac_sse4_1(__m128i x) {
+  return _mm_shuffle_epi32(x, 0x55);
+}
+
+// Low 32 bits of ((int64_t)a * b) >> shift.
+static INLINE __m128i qm_mul_shift_sse4_1(__m128i a, __m128i b, int shift) {
+  const __m128i even = _mm_srli_epi64(_mm_mul_epi32(a, b), shift);
+  const __m128i odd = _mm_slli_epi64(
+      _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)), 32 - shift);
+  return _mm_blend_epi16(even, odd, 0xcc);
+}
+
+// (dequant * iwt + (1 << (AOM_QM_BITS - 1))) >> AOM_QM_BITS
+static INLINE __m128i qm_dequant_sse4_1(__m128i dequant, __m128i iwt) {
+  const __m128i round = _mm_set1_epi32(1 << (AOM_QM_BITS - 1));
+  return _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(dequant, iwt), round),
+                        AOM_QM_BITS);
+}
+
+// Divides by two, rounding towards zero.
+static INLINE __m128i qm_half_sse4_1(__m128i x) {
+  return _mm_srai_epi32(_mm_add_epi32(x, _mm_srli_epi32(x, 31)), 1);
+}
+
+static INLINE __m128i qm_clamp16_sse4_1(__m128i x) {
+  return _mm_max_epi32(_mm_min_epi32(x, _mm_set1_epi32(INT16_MAX)),
+                       _mm_set1_epi32(INT16_MIN));
+}
+
+// Keeps the largest iscan + 1 of the lanes with a non-zero quantized value.
+static INLINE __m128i qm_update_eob_sse4_1(__m128i eob, __m128i abs_qcoeff,
+                                           const int16_t *iscan_ptr) {
+  const __m128i zero = _mm_cmpeq_epi32(abs_qcoeff, _mm_setzero_si128());
+  __m128i iscan =
+      _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)iscan_ptr));
+  iscan = _mm_add_epi32(iscan, _mm_set1_epi32(1));
+  return _mm_max_epi32(eob, _mm_andnot_si128(zero, iscan));
+}
+
+static INLINE uint16_t qm_eob_sse4_1(__m128i eob) {
+  eob = _mm_max_epi32(eob, _mm_srli_si128(eob, 8));
+  eob = _mm_max_epi32(eob, _mm_srli_si128(eob, 4));
+  return (uint16_t)_mm_cvtsi128_si32(eob);
+}
+
+#endif  // AOM_DSP_X86_QUANTIZE_QM_SSE4_H_
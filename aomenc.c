@@ -364,6 +364,9 @@ static const arg_def_t tile_cols =
     ARG_DEF(NULL, "tile-columns", 1, "Number of tile columns to use, log2");
 static const arg_def_t tile_rows =
     ARG_DEF(NULL, "tile-rows", 1, "Number of tile rows to use, log2");
+static const arg_def_t row_mt =
+    ARG_DEF(NULL, "row-mt", 1,
+            "Enable row based multi-threading (0: off (default), 1: on)");
 static const arg_def_t lossless =
     ARG_DEF(NULL, "lossless", 1, "Lossless mode (0: false (default), 1: true)");
 #if CONFIG_AOM_QM
@@ -447,7 +450,8 @@ static const arg_def_t *av1_args[] = {
 #endif
   &frame_parallel_decoding, &aq_mode,          &frame_periodic_boost,
   &noise_sens,              &tune_content,     &input_color_space,
-  &min_gf_interval,         &max_gf_interval,  NULL
+  &min_gf_interval,         &max_gf_interval,  &row_mt,
+  NULL
 };
 static const int av1_arg_ctrl_map[] = {
   AOME_SET_CPUUSED,                 AOME_SET_ENABLEAUTOALTREF,
@@ -466,6 +470,7 @@ static const int av1_arg_ctrl_map[] = {
   AV1E_SET_FRAME_PERIODIC_BOOST,    AV1E_SET_NOISE_SENSITIVITY,
   AV1E_SET_TUNE_CONTENT,            AV1E_SET_COLOR_SPACE,
   AV1E_SET_MIN_GF_INTERVAL,         AV1E_SET_MAX_GF_INTERVAL,
+  AV1E_SET_ROW_MT,
   0
 };
 /* clang-format on */
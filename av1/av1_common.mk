@@ -64,11 +64,18 @@ AV1_COMMON_SRCS-yes += common/av1_fwd_txfm.h
 AV1_COMMON_SRCS-yes += common/av1_fwd_txfm.c
 AV1_COMMON_SRCS-yes += common/clpf.c
 AV1_COMMON_SRCS-yes += common/clpf.h
+AV1_COMMON_SRCS-$(HAVE_SSE2) += common/x86/clpf_sse2.c
+AV1_COMMON_SRCS-$(HAVE_AVX2) += common/x86/clpf_avx2.c
 ifeq ($(CONFIG_DERING),yes)
 AV1_COMMON_SRCS-yes += common/od_dering.c
 AV1_COMMON_SRCS-yes += common/od_dering.h
 AV1_COMMON_SRCS-yes += common/dering.c
 AV1_COMMON_SRCS-yes += common/dering.h
+AV1_COMMON_SRCS-$(HAVE_SSE2) += common/x86/od_dering_sse2.c
+AV1_COMMON_SRCS-$(HAVE_SSE2) += common/x86/od_dering_impl_sse2.h
+AV1_COMMON_SRCS-$(HAVE_SSSE3) += common/x86/od_dering_ssse3.c
+AV1_COMMON_SRCS-$(HAVE_SSE4_1) += common/x86/od_dering_sse4.c
+AV1_COMMON_SRCS-$(HAVE_AVX2) += common/x86/od_dering_avx2.c
 endif
 AV1_COMMON_SRCS-yes += common/odintrin.c
 AV1_COMMON_SRCS-yes += common/odintrin.h
@@ -88,6 +95,9 @@ AV1_COMMON_SRCS-$(HAVE_SSE2) += common/x86/idct_intrin_sse2.c
 AV1_COMMON_SRCS-$(HAVE_SSE2) += common/x86/av1_fwd_txfm_sse2.c
 AV1_COMMON_SRCS-$(HAVE_SSE2) += common/x86/av1_fwd_dct32x32_impl_sse2.h
 AV1_COMMON_SRCS-$(HAVE_SSE2) += common/x86/av1_fwd_txfm_impl_sse2.h
+ifeq ($(CONFIG_AOM_HIGHBITDEPTH),yes)
+AV1_COMMON_SRCS-$(HAVE_SSE4_1) += common/x86/highbd_inv_txfm_sse4.c
+endif
 
 ifneq ($(CONFIG_AOM_HIGHBITDEPTH),yes)
 AV1_COMMON_SRCS-$(HAVE_NEON) += common/arm/neon/iht4x4_add_neon.c
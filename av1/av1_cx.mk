@@ -81,12 +81,19 @@ AV1_CX_SRCS-yes += encoder/temporal_filter.c
 AV1_CX_SRCS-yes += encoder/temporal_filter.h
 AV1_CX_SRCS-yes += encoder/mbgraph.c
 AV1_CX_SRCS-yes += encoder/mbgraph.h
+ifeq ($(CONFIG_DERING),yes)
 AV1_CX_SRCS-yes += encoder/pickdering.c
+AV1_CX_SRCS-yes += encoder/pickdering.h
+endif
 
 AV1_CX_SRCS-$(HAVE_SSE2) += encoder/x86/temporal_filter_apply_sse2.asm
 AV1_CX_SRCS-$(HAVE_SSE2) += encoder/x86/quantize_sse2.c
+ifeq ($(CONFIG_DERING),yes)
+AV1_CX_SRCS-$(HAVE_SSE2) += encoder/x86/pickdering_sse2.c
+endif
 ifeq ($(CONFIG_AOM_HIGHBITDEPTH),yes)
 AV1_CX_SRCS-$(HAVE_SSE2) += encoder/x86/highbd_block_error_intrin_sse2.c
+AV1_CX_SRCS-$(HAVE_SSE4_1) += encoder/x86/highbd_temporal_filter_sse4.c
 endif
 
 ifeq ($(CONFIG_USE_X86INC),yes)
@@ -102,8 +109,17 @@ endif
 
 AV1_CX_SRCS-$(HAVE_SSE2) += encoder/x86/dct_sse2.c
 AV1_CX_SRCS-$(HAVE_SSSE3) += encoder/x86/dct_ssse3.c
+AV1_CX_SRCS-$(HAVE_SSE2) += encoder/x86/resize_sse2.c
+AV1_CX_SRCS-$(HAVE_SSSE3) += encoder/x86/resize_ssse3.c
 
 AV1_CX_SRCS-$(HAVE_AVX2) += encoder/x86/error_intrin_avx2.c
+AV1_CX_SRCS-$(HAVE_AVX2) += encoder/x86/temporal_filter_avx2.c
+AV1_CX_SRCS-$(HAVE_AVX2) += encoder/x86/resize_avx2.c
+
+ifeq ($(CONFIG_AOM_QM),yes)
+AV1_CX_SRCS-$(HAVE_SSE4_1) += encoder/x86/quantize_qm_sse4.c
+AV1_CX_SRCS-$(HAVE_AVX2) += encoder/x86/quantize_qm_avx2.c
+endif
 
 ifneq ($(CONFIG_AOM_HIGHBITDEPTH),yes)
 AV1_CX_SRCS-$(HAVE_NEON) += encoder/arm/neon/dct_neon.c
@@ -54,6 +54,7 @@ struct av1_extracfg {
   int color_range;
   int render_width;
   int render_height;
+  unsigned int row_mt;
 };
 
 static struct av1_extracfg default_extra_cfg = {
@@ -88,6 +89,7 @@ static struct av1_extracfg default_extra_cfg = {
   0,                    // color range
   0,                    // render width
   0,                    // render height
+  0,                    // row_mt
 };
 
 struct aom_codec_alg_priv {
@@ -221,6 +223,7 @@ static aom_codec_err_t validate_config(aom_codec_alg_priv_t *ctx,
   RANGE_CHECK_HI(extra_cfg, noise_sensitivity, 6);
   RANGE_CHECK(extra_cfg, tile_columns, 0, 6);
   RANGE_CHECK(extra_cfg, tile_rows, 0, 2);
+  RANGE_CHECK_BOOL(extra_cfg, row_mt);
   RANGE_CHECK_HI(extra_cfg, sharpness, 7);
   RANGE_CHECK(extra_cfg, arnr_max_frames, 0, 15);
   RANGE_CHECK_HI(extra_cfg, arnr_strength, 6);
@@ -429,6 +432,7 @@ static aom_codec_err_t set_encoder_config(
 
   oxcf->tile_columns = extra_cfg->tile_columns;
   oxcf->tile_rows = extra_cfg->tile_rows;
+  oxcf->row_mt = extra_cfg->row_mt;
 
   oxcf->error_resilient_mode = cfg->g_error_resilient;
   oxcf->frame_parallel_decoding_mode = extra_cfg->frame_parallel_decoding_mode;
@@ -722,6 +726,8 @@ static aom_codec_err_t encoder_init(aom_codec_ctx_t *ctx,
     ctx->priv->enc.total_encoders = 1;
     priv->buffer_pool = (BufferPool *)aom_calloc(1, sizeof(BufferPool));
     if (priv->buffer_pool == NULL) return AOM_CODEC_MEM_ERROR;
+    if (av1_alloc_buffer_pool(priv->buffer_pool, FRAME_BUFFERS))
+      return AOM_CODEC_MEM_ERROR;
 
 #if CONFIG_MULTITHREAD
     if (pthread_mutex_init(&priv->buffer_pool->pool_mutex, NULL)) {
@@ -763,6 +769,7 @@ static aom_codec_err_t encoder_destroy(aom_codec_alg_priv_t *ctx) {
 #if CONFIG_MULTITHREAD
   pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
 #endif
+  av1_free_buffer_pool(ctx->buffer_pool);
   aom_free(ctx->buffer_pool);
   aom_free(ctx);
   return AOM_CODEC_OK;
@@ -1244,6 +1251,13 @@ static aom_codec_err_t ctrl_set_render_size(aom_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static aom_codec_err_t ctrl_set_row_mt(aom_codec_alg_priv_t *ctx,
+                                      va_list args) {
+  struct av1_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.row_mt = CAST(AV1E_SET_ROW_MT, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
 static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AOM_COPY_REFERENCE, ctrl_copy_reference },
 
@@ -1284,6 +1298,7 @@ static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1E_SET_MIN_GF_INTERVAL, ctrl_set_min_gf_interval },
   { AV1E_SET_MAX_GF_INTERVAL, ctrl_set_max_gf_interval },
   { AV1E_SET_RENDER_SIZE, ctrl_set_render_size },
+  { AV1E_SET_ROW_MT, ctrl_set_row_mt },
 
   // Getters
   { AOME_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -49,6 +49,8 @@ struct aom_codec_alg_priv {
   aom_postproc_cfg_t postproc_cfg;
   aom_decrypt_cb decrypt_cb;
   void *decrypt_state;
+  aom_release_input_buffer_cb release_input_cb;
+  void *release_input_state;
   aom_image_t img;
   int img_avail;
   int flushed;
@@ -70,6 +72,8 @@ struct aom_codec_alg_priv {
   int frame_cache_read;
   int num_cache_frames;
   int need_resync;  // wait for key/intra-only frame
+  // Worker that received the last frame of the current input buffer.
+  FrameWorkerData *last_input_worker_data;
   // BufferPool that holds all reference frames. Shared by all the FrameWorkers.
   BufferPool *buffer_pool;
 
@@ -110,6 +114,18 @@ static aom_codec_err_t decoder_init(aom_codec_ctx_t *ctx,
   return AOM_CODEC_OK;
 }
 
+// Hand the input buffer back to the application once the worker that decodes
+// its last frame has finished.
+static void release_input_buffer(aom_codec_alg_priv_t *ctx,
+                                 FrameWorkerData *const frame_worker_data) {
+  if (frame_worker_data->input_buffer != NULL) {
+    ctx->release_input_cb(ctx->release_input_state,
+                          frame_worker_data->input_buffer,
+                          frame_worker_data->input_user_priv);
+    frame_worker_data->input_buffer = NULL;
+  }
+}
+
 static aom_codec_err_t decoder_destroy(aom_codec_alg_priv_t *ctx) {
   if (ctx->frame_workers != NULL) {
     int i;
@@ -118,6 +134,7 @@ static aom_codec_err_t decoder_destroy(aom_codec_alg_priv_t *ctx) {
       FrameWorkerData *const frame_worker_data =
           (FrameWorkerData *)worker->data1;
       aom_get_worker_interface()->end(worker);
+      release_input_buffer(ctx, frame_worker_data);
       av1_remove_common(&frame_worker_data->pbi->common);
       av1_decoder_remove(frame_worker_data->pbi);
       aom_free(frame_worker_data->scratch_buffer);
@@ -135,6 +152,7 @@ static aom_codec_err_t decoder_destroy(aom_codec_alg_priv_t *ctx) {
   if (ctx->buffer_pool) {
     av1_free_ref_frame_buffers(ctx->buffer_pool);
     av1_free_internal_frame_buffers(&ctx->buffer_pool->int_frame_buffers);
+    av1_free_buffer_pool(ctx->buffer_pool);
   }
 
   aom_free(ctx->frame_workers);
@@ -284,7 +302,8 @@ static void init_buffer_callbacks(aom_codec_alg_priv_t *ctx) {
       pool->get_fb_cb = av1_get_frame_buffer;
       pool->release_fb_cb = av1_release_frame_buffer;
 
-      if (av1_alloc_internal_frame_buffers(&pool->int_frame_buffers))
+      if (av1_alloc_internal_frame_buffers(&pool->int_frame_buffers,
+                                           pool->num_frame_bufs))
         aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
                            "Failed to initialize internal frame buffers");
 
@@ -348,14 +367,23 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
   ctx->need_resync = 1;
   ctx->num_frame_workers =
       (ctx->frame_parallel_decode == 1) ? ctx->cfg.threads : 1;
-  if (ctx->num_frame_workers > MAX_DECODE_THREADS)
-    ctx->num_frame_workers = MAX_DECODE_THREADS;
   ctx->available_threads = ctx->num_frame_workers;
   ctx->flushed = 0;
 
   ctx->buffer_pool = (BufferPool *)aom_calloc(1, sizeof(BufferPool));
   if (ctx->buffer_pool == NULL) return AOM_CODEC_MEM_ERROR;
 
+  // Every frame worker may hold the frame it is decoding on top of the
+  // reference frames, and the frame cache and the last output frame hold one
+  // each.
+  if (av1_alloc_buffer_pool(
+          ctx->buffer_pool,
+          AOMMAX(FRAME_BUFFERS, REF_FRAMES + ctx->num_frame_workers +
+                                    FRAME_CACHE_SIZE + 1))) {
+    set_error_detail(ctx, "Failed to allocate buffer pool");
+    return AOM_CODEC_MEM_ERROR;
+  }
+
 #if CONFIG_MULTITHREAD
   if (pthread_mutex_init(&ctx->buffer_pool->pool_mutex, NULL)) {
     set_error_detail(ctx, "Failed to allocate buffer pool mutex");
@@ -389,6 +417,7 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
     frame_worker_data->worker_id = i;
     frame_worker_data->scratch_buffer = NULL;
     frame_worker_data->scratch_buffer_size = 0;
+    frame_worker_data->input_buffer = NULL;
     frame_worker_data->frame_context_ready = 0;
     frame_worker_data->received_frame = 0;
 #if CONFIG_MULTITHREAD
@@ -487,27 +516,34 @@ static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
           &ctx->frame_workers[ctx->last_submit_worker_id]);
 
     frame_worker_data->pbi->ready_for_new_data = 0;
-    // Copy the compressed data into worker's internal buffer.
-    // TODO(hkuang): Will all the workers allocate the same size
-    // as the size of the first intra frame be better? This will
-    // avoid too many deallocate and allocate.
-    if (frame_worker_data->scratch_buffer_size < data_sz) {
-      frame_worker_data->scratch_buffer =
-          (uint8_t *)aom_realloc(frame_worker_data->scratch_buffer, data_sz);
-      if (frame_worker_data->scratch_buffer == NULL) {
-        set_error_detail(ctx, "Failed to reallocate scratch buffer");
-        return AOM_CODEC_MEM_ERROR;
+    if (ctx->release_input_cb != NULL) {
+      // The application keeps the buffer until it is released, so the worker
+      // can read it in place.
+      frame_worker_data->data = *data;
+    } else {
+      // Copy the compressed data into worker's internal buffer.
+      // TODO(hkuang): Will all the workers allocate the same size
+      // as the size of the first intra frame be better? This will
+      // avoid too many deallocate and allocate.
+      if (frame_worker_data->scratch_buffer_size < data_sz) {
+        frame_worker_data->scratch_buffer =
+            (uint8_t *)aom_realloc(frame_worker_data->scratch_buffer, data_sz);
+        if (frame_worker_data->scratch_buffer == NULL) {
+          set_error_detail(ctx, "Failed to reallocate scratch buffer");
+          return AOM_CODEC_MEM_ERROR;
+        }
+        frame_worker_data->scratch_buffer_size = data_sz;
       }
-      frame_worker_data->scratch_buffer_size = data_sz;
+      memcpy(frame_worker_data->scratch_buffer, *data, data_sz);
+      frame_worker_data->data = frame_worker_data->scratch_buffer;
     }
     frame_worker_data->data_size = data_sz;
-    memcpy(frame_worker_data->scratch_buffer, *data, data_sz);
 
     frame_worker_data->frame_decoded = 0;
     frame_worker_data->frame_context_ready = 0;
     frame_worker_data->received_frame = 1;
-    frame_worker_data->data = frame_worker_data->scratch_buffer;
     frame_worker_data->user_priv = user_priv;
+    ctx->last_input_worker_data = frame_worker_data;
 
     if (ctx->next_submit_worker_id != ctx->last_submit_worker_id)
       ctx->last_submit_worker_id =
@@ -532,6 +568,7 @@ static void wait_worker_and_cache_frame(aom_codec_alg_priv_t *ctx) {
       (ctx->next_output_worker_id + 1) % ctx->num_frame_workers;
   // TODO(hkuang): Add worker error handling here.
   winterface->sync(worker);
+  release_input_buffer(ctx, frame_worker_data);
   frame_worker_data->received_frame = 0;
   ++ctx->available_threads;
 
@@ -550,9 +587,9 @@ static void wait_worker_and_cache_frame(aom_codec_alg_priv_t *ctx) {
   }
 }
 
-static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
-                                      const uint8_t *data, unsigned int data_sz,
-                                      void *user_priv, long deadline) {
+static aom_codec_err_t decode_buffer(aom_codec_alg_priv_t *ctx,
+                                     const uint8_t *data, unsigned int data_sz,
+                                     void *user_priv, long deadline) {
   const uint8_t *data_start = data;
   const uint8_t *const data_end = data + data_sz;
   aom_codec_err_t res;
@@ -669,6 +706,29 @@ static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
   return res;
 }
 
+static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
+                                      const uint8_t *data, unsigned int data_sz,
+                                      void *user_priv, long deadline) {
+  aom_codec_err_t res;
+
+  ctx->last_input_worker_data = NULL;
+  res = decode_buffer(ctx, data, data_sz, user_priv, deadline);
+
+  if (ctx->release_input_cb != NULL && data != NULL) {
+    // Frame workers finish in submission order, so the buffer is free once
+    // the worker that received its last frame is synced. Buffers decoded in
+    // serial mode are done with already.
+    if (ctx->last_input_worker_data != NULL) {
+      ctx->last_input_worker_data->input_buffer = data;
+      ctx->last_input_worker_data->input_user_priv = user_priv;
+    } else {
+      ctx->release_input_cb(ctx->release_input_state, data, user_priv);
+    }
+  }
+
+  return res;
+}
+
 static void release_last_output_frame(aom_codec_alg_priv_t *ctx) {
   RefCntBuffer *const frame_bufs = ctx->buffer_pool->frame_bufs;
   // Decrease reference count of last output frame in frame parallel mode.
@@ -711,10 +771,13 @@ static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
       AVxWorker *const worker = &ctx->frame_workers[ctx->next_output_worker_id];
       FrameWorkerData *const frame_worker_data =
           (FrameWorkerData *)worker->data1;
+      int ok;
       ctx->next_output_worker_id =
           (ctx->next_output_worker_id + 1) % ctx->num_frame_workers;
       // Wait for the frame from worker thread.
-      if (winterface->sync(worker)) {
+      ok = winterface->sync(worker);
+      release_input_buffer(ctx, frame_worker_data);
+      if (ok) {
         // Check if worker has received any frames.
         if (frame_worker_data->received_frame == 1) {
           ++ctx->available_threads;
@@ -981,6 +1044,17 @@ static aom_codec_err_t ctrl_set_decryptor(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_set_input_buffer_release(
+    aom_codec_alg_priv_t *ctx, va_list args) {
+  aom_input_buffer_init *init = va_arg(args, aom_input_buffer_init *);
+  // If the decoder has already been initialized, do not accept changes to the
+  // release function.
+  if (ctx->frame_workers != NULL) return AOM_CODEC_ERROR;
+  ctx->release_input_cb = init ? init->release_cb : NULL;
+  ctx->release_input_state = init ? init->release_state : NULL;
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t ctrl_set_byte_alignment(aom_codec_alg_priv_t *ctx,
                                                va_list args) {
   const int legacy_byte_alignment = 0;
@@ -1030,6 +1104,7 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AOMD_SET_DECRYPTOR, ctrl_set_decryptor },
   { AV1_SET_BYTE_ALIGNMENT, ctrl_set_byte_alignment },
   { AV1_SET_SKIP_LOOP_FILTER, ctrl_set_skip_loop_filter },
+  { AV1D_SET_INPUT_BUFFER_RELEASE, ctrl_set_input_buffer_release },
 
   // Getters
   { AOMD_GET_LAST_REF_UPDATES, ctrl_get_last_ref_updates },
@@ -66,10 +66,24 @@ static void free_seg_map(AV1_COMMON *cm) {
   }
 }
 
+int av1_alloc_buffer_pool(BufferPool *pool, int num_frame_bufs) {
+  pool->frame_bufs =
+      (RefCntBuffer *)aom_calloc(num_frame_bufs, sizeof(*pool->frame_bufs));
+  if (!pool->frame_bufs) return 1;
+  pool->num_frame_bufs = num_frame_bufs;
+  return 0;
+}
+
+void av1_free_buffer_pool(BufferPool *pool) {
+  aom_free(pool->frame_bufs);
+  pool->frame_bufs = NULL;
+  pool->num_frame_bufs = 0;
+}
+
 void av1_free_ref_frame_buffers(BufferPool *pool) {
   int i;
 
-  for (i = 0; i < FRAME_BUFFERS; ++i) {
+  for (i = 0; i < pool->num_frame_bufs; ++i) {
     if (pool->frame_bufs[i].ref_count > 0 &&
         pool->frame_bufs[i].raw_frame_buffer.data != NULL) {
       pool->release_fb_cb(pool->cb_priv, &pool->frame_bufs[i].raw_frame_buffer);
@@ -88,6 +102,14 @@ void av1_free_context_buffers(AV1_COMMON *cm) {
   cm->above_context = NULL;
   aom_free(cm->above_seg_context);
   cm->above_seg_context = NULL;
+#if CONFIG_DERING
+  aom_free(cm->dering_linebuf);
+  cm->dering_linebuf = NULL;
+  cm->dering_linebuf_size = 0;
+  aom_free(cm->dering_window);
+  cm->dering_window = NULL;
+  cm->dering_window_size = 0;
+#endif
 }
 
 int av1_alloc_context_buffers(AV1_COMMON *cm, int width, int height) {
@@ -27,6 +27,8 @@ int av1_alloc_context_buffers(struct AV1Common *cm, int width, int height);
 void av1_init_context_buffers(struct AV1Common *cm);
 void av1_free_context_buffers(struct AV1Common *cm);
 
+int av1_alloc_buffer_pool(struct BufferPool *pool, int num_frame_bufs);
+void av1_free_buffer_pool(struct BufferPool *pool);
 void av1_free_ref_frame_buffers(struct BufferPool *pool);
 
 int av1_alloc_state_buffers(struct AV1Common *cm, int width, int height);
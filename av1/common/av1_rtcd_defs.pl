@@ -128,7 +128,7 @@ if (aom_config("CONFIG_AOM_HIGHBITDEPTH") eq "yes") {
     specialize qw/av1_iht8x8_64_add sse2/;
 
     add_proto qw/void av1_iht16x16_256_add/, "const tran_low_t *input, uint8_t *output, int pitch, int tx_type";
-    specialize qw/av1_iht16x16_256_add/;
+    specialize qw/av1_iht16x16_256_add sse2/;
 
     add_proto qw/void av1_fdct4x4/, "const int16_t *input, tran_low_t *output, int stride";
     specialize qw/av1_fdct4x4 sse2/;
@@ -293,13 +293,48 @@ if (aom_config("CONFIG_AOM_HIGHBITDEPTH") eq "yes") {
   # Note as optimized versions of these functions are added we need to add a check to ensure
   # that when CONFIG_EMULATE_HARDWARE is on, it defaults to the C versions only.
   add_proto qw/void av1_highbd_iht4x4_16_add/, "const tran_low_t *input, uint8_t *dest, int dest_stride, int tx_type, int bd";
-  specialize qw/av1_highbd_iht4x4_16_add/;
-
   add_proto qw/void av1_highbd_iht8x8_64_add/, "const tran_low_t *input, uint8_t *dest, int dest_stride, int tx_type, int bd";
-  specialize qw/av1_highbd_iht8x8_64_add/;
-
   add_proto qw/void av1_highbd_iht16x16_256_add/, "const tran_low_t *input, uint8_t *output, int pitch, int tx_type, int bd";
-  specialize qw/av1_highbd_iht16x16_256_add/;
+  if (aom_config("CONFIG_EMULATE_HARDWARE") eq "yes") {
+    specialize qw/av1_highbd_iht4x4_16_add/;
+    specialize qw/av1_highbd_iht8x8_64_add/;
+    specialize qw/av1_highbd_iht16x16_256_add/;
+  } else {
+    specialize qw/av1_highbd_iht4x4_16_add sse4_1/;
+    specialize qw/av1_highbd_iht8x8_64_add sse4_1/;
+    specialize qw/av1_highbd_iht16x16_256_add sse4_1/;
+  }
+}
+
+#
+# Constrained low-pass filter
+#
+add_proto qw/void aom_clpf_block/, "const uint8_t *src, uint8_t *dst, int sstride, int dstride, int has_top, int has_left, int has_bottom, int has_right, int width, int height";
+specialize qw/aom_clpf_block sse2 avx2/;
+
+if (aom_config("CONFIG_AOM_HIGHBITDEPTH") eq "yes") {
+  add_proto qw/void aom_clpf_block_hbd/, "const uint16_t *src, uint16_t *dst, int sstride, int dstride, int has_top, int has_left, int has_bottom, int has_right, int width, int height";
+  specialize qw/aom_clpf_block_hbd sse2 avx2/;
+}
+
+#
+# Deringing
+#
+if (aom_config("CONFIG_DERING") eq "yes") {
+  add_proto qw/int od_dir_find8/, "const int16_t *img, int stride, int32_t *var, int coeff_shift";
+  specialize qw/od_dir_find8 sse2 sse4_1/;
+
+  add_proto qw/void od_filter_dering_direction_4x4/, "int16_t *y, int ystride, const int16_t *in, int threshold, int dir";
+  specialize qw/od_filter_dering_direction_4x4 sse2 ssse3/;
+
+  add_proto qw/void od_filter_dering_direction_8x8/, "int16_t *y, int ystride, const int16_t *in, int threshold, int dir";
+  specialize qw/od_filter_dering_direction_8x8 sse2 ssse3 avx2/;
+
+  add_proto qw/void od_filter_dering_orthogonal_4x4/, "int16_t *y, int ystride, const int16_t *in, const int16_t *x, int xstride, int threshold, int dir";
+  specialize qw/od_filter_dering_orthogonal_4x4 sse2 ssse3/;
+
+  add_proto qw/void od_filter_dering_orthogonal_8x8/, "int16_t *y, int ystride, const int16_t *in, const int16_t *x, int xstride, int threshold, int dir";
+  specialize qw/od_filter_dering_orthogonal_8x8 sse2 ssse3 avx2/;
 }
 
 #
@@ -309,6 +344,11 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
 
 # ENCODEMB INVOKE
 
+if (aom_config("CONFIG_DERING") eq "yes") {
+  add_proto qw/int64_t av1_dering_sse/, "const int16_t *a, int astride, const int16_t *b, int bstride, int w, int h";
+  specialize qw/av1_dering_sse sse2/;
+}
+
 if (aom_config("CONFIG_AOM_QM") eq "yes") {
   if (aom_config("CONFIG_AOM_HIGHBITDEPTH") eq "yes") {
     # the transform coefficients are held in 32-bit
@@ -317,8 +357,10 @@ if (aom_config("CONFIG_AOM_QM") eq "yes") {
     specialize qw/av1_block_error/;
 
     add_proto qw/void av1_quantize_fp/, "const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block, const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr, const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr, const int16_t *scan, const int16_t *iscan, const qm_val_t * qm_ptr, const qm_val_t *iqm_ptr";
+    specialize qw/av1_quantize_fp sse4_1 avx2/;
 
     add_proto qw/void av1_quantize_fp_32x32/, "const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block, const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr, const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr, const int16_t *scan, const int16_t *iscan, const qm_val_t * qm_ptr, const qm_val_t *iqm_ptr";
+    specialize qw/av1_quantize_fp_32x32 sse4_1 avx2/;
 
     add_proto qw/void av1_fdct8x8_quant/, "const int16_t *input, int stride, tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block, const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr, const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr, const int16_t *scan, const int16_t *iscan, const qm_val_t * qm_ptr, const qm_val_t *iqm_ptr";
     specialize qw/av1_fdct8x8_quant/;
@@ -330,8 +372,10 @@ if (aom_config("CONFIG_AOM_QM") eq "yes") {
     specialize qw/av1_block_error_fp neon/, "$sse2_x86inc";
 
     add_proto qw/void av1_quantize_fp/, "const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block, const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr, const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr, const int16_t *scan, const int16_t *iscan, const qm_val_t * qm_ptr, const qm_val_t *iqm_ptr";
+    specialize qw/av1_quantize_fp sse4_1 avx2/;
 
     add_proto qw/void av1_quantize_fp_32x32/, "const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block, const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr, const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr, const int16_t *scan, const int16_t *iscan, const qm_val_t * qm_ptr, const qm_val_t *iqm_ptr";
+    specialize qw/av1_quantize_fp_32x32 sse4_1 avx2/;
 
     add_proto qw/void av1_fdct8x8_quant/, "const int16_t *input, int stride, tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block, const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr, const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr, const int16_t *scan, const int16_t *iscan, const qm_val_t * qm_ptr, const qm_val_t *iqm_ptr";
   }
@@ -595,7 +639,17 @@ add_proto qw/int av1_full_range_search/, "const struct macroblock *x, const stru
 specialize qw/av1_full_range_search/;
 
 add_proto qw/void av1_temporal_filter_apply/, "uint8_t *frame1, unsigned int stride, uint8_t *frame2, unsigned int block_width, unsigned int block_height, int strength, int filter_weight, unsigned int *accumulator, uint16_t *count";
-specialize qw/av1_temporal_filter_apply sse2 msa/;
+specialize qw/av1_temporal_filter_apply sse2 avx2 msa/;
+
+# Spatial resampler
+add_proto qw/void av1_resize_horz/, "const uint8_t *input, uint8_t *output, int outlength, int64_t y, int64_t delta, const int16_t *filters";
+specialize qw/av1_resize_horz ssse3/;
+
+add_proto qw/void av1_resize_down2_horz/, "const uint8_t *input, uint8_t *output, int outlength, const int16_t *filter";
+specialize qw/av1_resize_down2_horz sse2 avx2/;
+
+add_proto qw/void av1_resize_vert/, "const uint8_t *const *rows, const int16_t *filter, uint8_t *output, int width";
+specialize qw/av1_resize_vert sse2 avx2/;
 
 if (aom_config("CONFIG_AOM_HIGHBITDEPTH") eq "yes") {
 
@@ -606,8 +660,10 @@ if (aom_config("CONFIG_AOM_HIGHBITDEPTH") eq "yes") {
 
   if (aom_config("CONFIG_AOM_QM") eq "yes") {
     add_proto qw/void av1_highbd_quantize_fp/, "const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block, const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr, const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr, const int16_t *scan, const int16_t *iscan, const qm_val_t * qm_ptr, const qm_val_t * iqm_ptr";
+    specialize qw/av1_highbd_quantize_fp sse4_1 avx2/;
 
     add_proto qw/void av1_highbd_quantize_fp_32x32/, "const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block, const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr, const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr, const int16_t *scan, const int16_t *iscan, const qm_val_t * qm_ptr, const qm_val_t * iqm_ptr";
+    specialize qw/av1_highbd_quantize_fp_32x32 sse4_1 avx2/;
   } else {
     add_proto qw/void av1_highbd_quantize_fp/, "const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block, const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr, const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr, const int16_t *scan, const int16_t *iscan";
     specialize qw/av1_highbd_quantize_fp/;
@@ -631,7 +687,16 @@ if (aom_config("CONFIG_AOM_HIGHBITDEPTH") eq "yes") {
   specialize qw/av1_highbd_fwht4x4/;
 
   add_proto qw/void av1_highbd_temporal_filter_apply/, "uint8_t *frame1, unsigned int stride, uint8_t *frame2, unsigned int block_width, unsigned int block_height, int strength, int filter_weight, unsigned int *accumulator, uint16_t *count";
-  specialize qw/av1_highbd_temporal_filter_apply/;
+  specialize qw/av1_highbd_temporal_filter_apply sse4_1 avx2/;
+
+  add_proto qw/void av1_highbd_resize_horz/, "const uint16_t *input, uint16_t *output, int outlength, int64_t y, int64_t delta, const int16_t *filters, int bd";
+  specialize qw/av1_highbd_resize_horz ssse3/;
+
+  add_proto qw/void av1_highbd_resize_down2_horz/, "const uint16_t *input, uint16_t *output, int outlength, const int16_t *filter, int bd";
+  specialize qw/av1_highbd_resize_down2_horz sse2 avx2/;
+
+  add_proto qw/void av1_highbd_resize_vert/, "const uint16_t *const *rows, const int16_t *filter, uint16_t *output, int width, int bd";
+  specialize qw/av1_highbd_resize_vert sse2 avx2/;
 
 }
 # End av1_high encoder functions
@@ -10,10 +10,35 @@
  */
 #include "av1/common/clpf.h"
 
-// Apply the filter on a single block
-static void clpf_block(const uint8_t *src, uint8_t *dst, int sstride,
-                       int dstride, int has_top, int has_left, int has_bottom,
-                       int has_right, int width, int height) {
+#include "./av1_rtcd.h"
+#include "aom_ports/mem.h"
+
+// Apply the filter on a single block. The SIMD versions filter several pixels
+// at once, so they need dst not to overlap src (CLPF_ALLOW_PIXEL_PARALLELISM).
+void aom_clpf_block_c(const uint8_t *src, uint8_t *dst, int sstride,
+                      int dstride, int has_top, int has_left, int has_bottom,
+                      int has_right, int width, int height) {
+  int x, y;
+
+  for (y = 0; y < height; y++) {
+    for (x = 0; x < width; x++) {
+      int X = src[(y + 0) * sstride + x + 0];
+      int A = has_top ? src[(y - 1) * sstride + x + 0] : X;
+      int B = has_left ? src[(y + 0) * sstride + x - 1] : X;
+      int C = has_right ? src[(y + 0) * sstride + x + 1] : X;
+      int D = has_bottom ? src[(y + 1) * sstride + x + 0] : X;
+      int delta = ((A > X) + (B > X) + (C > X) + (D > X) > 2) -
+                  ((A < X) + (B < X) + (C < X) + (D < X) > 2);
+      dst[y * dstride + x] = X + delta;
+    }
+  }
+}
+
+#if CONFIG_AOM_HIGHBITDEPTH
+void aom_clpf_block_hbd_c(const uint16_t *src, uint16_t *dst, int sstride,
+                          int dstride, int has_top, int has_left,
+                          int has_bottom, int has_right, int width,
+                          int height) {
   int x, y;
 
   for (y = 0; y < height; y++) {
@@ -29,19 +54,27 @@ static void clpf_block(const uint8_t *src, uint8_t *dst, int sstride,
     }
   }
 }
+#endif
 
 #define BS MI_SIZE *MI_BLOCK_SIZE
 
 // Iterate over blocks within a superblock
-static void av1_clpf_sb(const YV12_BUFFER_CONFIG *frame_buffer,
-                         const AV1_COMMON *cm, MACROBLOCKD *xd,
-                         MODE_INFO *const *mi_8x8, int xpos, int ypos) {
-  // Temporary buffer (to allow SIMD parallelism)
-  uint8_t buf_unaligned[BS * BS + 15];
-  uint8_t *buf = (uint8_t *)(((intptr_t)buf_unaligned + 15) & ~15);
+void av1_clpf_sb(const YV12_BUFFER_CONFIG *frame_buffer, const AV1_COMMON *cm,
+                 struct macroblockd_plane planes[MAX_MB_PLANE], int ypos,
+                 int xpos) {
+  // Temporary buffer (to allow SIMD parallelism), two bytes per pixel for
+  // high bitdepth frames
+  DECLARE_ALIGNED(16, uint8_t, buf[BS * BS * (1 + CONFIG_AOM_HIGHBITDEPTH)]);
+  MODE_INFO *const *mi_8x8 = cm->mi_grid_visible;
   int x, y, p;
 
+  av1_setup_dst_planes(planes, frame_buffer, ypos, xpos);
+
   for (p = 0; p < (CLPF_FILTER_ALL_PLANES ? MAX_MB_PLANE : 1); p++) {
+    const struct buf_2d *const dst = &planes[p].dst;
+    const int bw = MI_SIZE >> planes[p].subsampling_x;
+    const int bh = MI_SIZE >> planes[p].subsampling_y;
+
     for (y = 0; y < MI_BLOCK_SIZE && ypos + y < cm->mi_rows; y++) {
       for (x = 0; x < MI_BLOCK_SIZE && xpos + x < cm->mi_cols; x++) {
         const MB_MODE_INFO *mbmi =
@@ -61,16 +94,28 @@ static void av1_clpf_sb(const YV12_BUFFER_CONFIG *frame_buffer,
           has_bottom &= y != MI_BLOCK_SIZE - 1;
           has_right &= x != MI_BLOCK_SIZE - 1;
 #endif
-          av1_setup_dst_planes(xd->plane, frame_buffer, ypos + y, xpos + x);
-          clpf_block(
-              xd->plane[p].dst.buf, CLPF_ALLOW_PIXEL_PARALLELISM
-                                        ? buf + y * MI_SIZE * BS + x * MI_SIZE
-                                        : xd->plane[p].dst.buf,
-              xd->plane[p].dst.stride,
-              CLPF_ALLOW_PIXEL_PARALLELISM ? BS : xd->plane[p].dst.stride,
-              has_top, has_left, has_bottom, has_right,
-              MI_SIZE >> xd->plane[p].subsampling_x,
-              MI_SIZE >> xd->plane[p].subsampling_y);
+#if CONFIG_AOM_HIGHBITDEPTH
+          if (cm->use_highbitdepth) {
+            uint16_t *const src = CONVERT_TO_SHORTPTR(dst->buf) +
+                                  y * bh * dst->stride + x * bw;
+            aom_clpf_block_hbd(
+                src, CLPF_ALLOW_PIXEL_PARALLELISM
+                         ? (uint16_t *)buf + y * MI_SIZE * BS + x * MI_SIZE
+                         : src,
+                dst->stride, CLPF_ALLOW_PIXEL_PARALLELISM ? BS : dst->stride,
+                has_top, has_left, has_bottom, has_right, bw, bh);
+            continue;
+          }
+#endif
+          {
+            uint8_t *const src = dst->buf + y * bh * dst->stride + x * bw;
+            aom_clpf_block(src, CLPF_ALLOW_PIXEL_PARALLELISM
+                                    ? buf + y * MI_SIZE * BS + x * MI_SIZE
+                                    : src,
+                           dst->stride,
+                           CLPF_ALLOW_PIXEL_PARALLELISM ? BS : dst->stride,
+                           has_top, has_left, has_bottom, has_right, bw, bh);
+          }
         }
       }
     }
@@ -79,13 +124,25 @@ static void av1_clpf_sb(const YV12_BUFFER_CONFIG *frame_buffer,
       for (x = 0; x < MI_BLOCK_SIZE && xpos + x < cm->mi_cols; x++) {
         const MB_MODE_INFO *mbmi =
             &mi_8x8[(ypos + y) * cm->mi_stride + xpos + x]->mbmi;
-        av1_setup_dst_planes(xd->plane, frame_buffer, ypos + y, xpos + x);
         if (!mbmi->skip) {
-          int i = 0;
-          for (i = 0; i<MI_SIZE>> xd->plane[p].subsampling_y; i++)
-            memcpy(xd->plane[p].dst.buf + i * xd->plane[p].dst.stride,
-                   buf + (y * MI_SIZE + i) * BS + x * MI_SIZE,
-                   MI_SIZE >> xd->plane[p].subsampling_x);
+          int i;
+#if CONFIG_AOM_HIGHBITDEPTH
+          if (cm->use_highbitdepth) {
+            uint16_t *const dst_buf = CONVERT_TO_SHORTPTR(dst->buf) +
+                                      y * bh * dst->stride + x * bw;
+            for (i = 0; i < bh; i++)
+              memcpy(dst_buf + i * dst->stride,
+                     (uint16_t *)buf + (y * MI_SIZE + i) * BS + x * MI_SIZE,
+                     bw * sizeof(*dst_buf));
+            continue;
+          }
+#endif
+          {
+            uint8_t *const dst_buf = dst->buf + y * bh * dst->stride + x * bw;
+            for (i = 0; i < bh; i++)
+              memcpy(dst_buf + i * dst->stride,
+                     buf + (y * MI_SIZE + i) * BS + x * MI_SIZE, bw);
+          }
         }
       }
     }
@@ -100,5 +157,5 @@ void av1_clpf_frame(const YV12_BUFFER_CONFIG *frame, const AV1_COMMON *cm,
 
   for (y = 0; y < cm->mi_rows; y += MI_BLOCK_SIZE)
     for (x = 0; x < cm->mi_cols; x += MI_BLOCK_SIZE)
-      av1_clpf_sb(frame, cm, xd, cm->mi_grid_visible, x, y);
+      av1_clpf_sb(frame, cm, xd->plane, y, x);
 }
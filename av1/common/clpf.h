@@ -21,6 +21,13 @@
 #define CLPF_FILTER_ALL_PLANES \
   0  // 1 = filter both luma and chroma, 0 = filter only luma
 
+// Filter the superblock at (mi_row, mi_col). The superblocks above and to
+// the left must already have been filtered, the ones below and to the right
+// must not.
+void av1_clpf_sb(const YV12_BUFFER_CONFIG *frame_buffer, const AV1_COMMON *cm,
+                 struct macroblockd_plane planes[MAX_MB_PLANE], int mi_row,
+                 int mi_col);
+
 void av1_clpf_frame(const YV12_BUFFER_CONFIG *frame, const AV1_COMMON *cm,
                      MACROBLOCKD *xd);
 
@@ -14,6 +14,7 @@
 
 #include "./aom_scale_rtcd.h"
 #include "aom/aom_integer.h"
+#include "aom_mem/aom_mem.h"
 #include "av1/common/dering.h"
 #include "av1/common/onyxc_int.h"
 #include "av1/common/reconinter.h"
@@ -46,109 +47,197 @@ int sb_all_skip(const AV1_COMMON *const cm, int mi_row, int mi_col) {
   return skip;
 }
 
-void av1_dering_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
-                       MACROBLOCKD *xd, int global_level) {
+/* Number of lines of a superblock row window: the superblock row itself and
+   the filter border above and below it. */
+#define DERING_WINDOW_ROWS (MI_BLOCK_SIZE*8 + 2*OD_FILT_BORDER)
+
+static INLINE int dering_stride(const AV1_COMMON *cm) {
+  return MI_SIZE*cm->mi_cols;
+}
+
+static INLINE int dering_sb_rows(const AV1_COMMON *cm) {
+  return (cm->mi_rows + MI_BLOCK_SIZE - 1)/MI_BLOCK_SIZE;
+}
+
+/* Copy 'rows' lines of 'width' pixels starting at line 'y' of a plane into
+   'dst'. */
+static void copy_plane_lines(od_dering_in *dst, int dstride,
+                             const struct macroblockd_plane *pd, int y,
+                             int rows, int width, const AV1_COMMON *cm) {
+  int r, c;
+  for (r = 0; r < rows; ++r) {
+#if CONFIG_AOM_HIGHBITDEPTH
+    if (cm->use_highbitdepth) {
+      const uint16_t *src =
+          CONVERT_TO_SHORTPTR(pd->dst.buf) + (y + r)*pd->dst.stride;
+      memcpy(&dst[r*dstride], src, width*sizeof(*dst));
+      continue;
+    }
+#else
+    (void)cm;
+#endif
+    {
+      const uint8_t *src = pd->dst.buf + (y + r)*pd->dst.stride;
+      for (c = 0; c < width; ++c) dst[r*dstride + c] = src[c];
+    }
+  }
+}
+
+void av1_dering_alloc(AV1_COMMON *cm, int num_windows) {
+  const int stride = dering_stride(cm);
+  const int linebuf_size =
+      MAX_MB_PLANE*dering_sb_rows(cm)*2*OD_FILT_BORDER*stride;
+  const int window_size = num_windows*MAX_MB_PLANE*DERING_WINDOW_ROWS*stride;
+  if (linebuf_size > cm->dering_linebuf_size) {
+    aom_free(cm->dering_linebuf);
+    cm->dering_linebuf_size = 0;
+    CHECK_MEM_ERROR(cm, cm->dering_linebuf,
+                    aom_malloc(linebuf_size*sizeof(*cm->dering_linebuf)));
+    cm->dering_linebuf_size = linebuf_size;
+  }
+  if (window_size > cm->dering_window_size) {
+    aom_free(cm->dering_window);
+    cm->dering_window_size = 0;
+    CHECK_MEM_ERROR(cm, cm->dering_window,
+                    aom_malloc(window_size*sizeof(*cm->dering_window)));
+    cm->dering_window_size = window_size;
+  }
+}
+
+void av1_dering_save_boundary(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                              struct macroblockd_plane planes[MAX_MB_PLANE],
+                              int sbr) {
+  const int stride = dering_stride(cm);
+  const int nvsb = dering_sb_rows(cm);
+  int pli;
+  av1_setup_dst_planes(planes, frame, 0, 0);
+  for (pli = 0; pli < MAX_MB_PLANE; pli++) {
+    const int dec = planes[pli].subsampling_x;
+    const int sb_height = (MI_BLOCK_SIZE*MI_SIZE) >> dec;
+    const int width = (MI_SIZE >> dec)*cm->mi_cols;
+    copy_plane_lines(
+        &cm->dering_linebuf[(pli*nvsb + sbr)*2*OD_FILT_BORDER*stride],
+        stride, &planes[pli], sbr*sb_height - OD_FILT_BORDER,
+        2*OD_FILT_BORDER, width, cm);
+  }
+}
+
+void av1_dering_init_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                           struct macroblockd_plane planes[MAX_MB_PLANE],
+                           int num_windows) {
+  const int nvsb = dering_sb_rows(cm);
+  int sbr;
+  av1_dering_alloc(cm, num_windows);
+  /* Save the pixels on both sides of every superblock row boundary, as the
+     rows next to it may be filtered before they are read. */
+  for (sbr = 1; sbr < nvsb; sbr++)
+    av1_dering_save_boundary(frame, cm, planes, sbr);
+}
+
+void av1_dering_sb_row(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                       struct macroblockd_plane planes[MAX_MB_PLANE],
+                       int global_level, int sbr, int window) {
   int r, c;
-  int sbr, sbc;
-  int nhsb, nvsb;
+  int sbc;
+  const int nvsb = dering_sb_rows(cm);
+  const int nhsb = (cm->mi_cols + MI_BLOCK_SIZE - 1)/MI_BLOCK_SIZE;
+  const int nvb = AOMMIN(MI_BLOCK_SIZE, cm->mi_rows - MI_BLOCK_SIZE*sbr);
+  const int stride = dering_stride(cm);
+  const int coeff_shift = AOMMAX(cm->bit_depth - 8, 0);
   od_dering_in *src[3];
-  unsigned char *bskip;
-  int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS] = {{0}};
-  int stride;
   int bsize[3];
   int dec[3];
   int pli;
-  int coeff_shift = AOMMAX(cm->bit_depth - 8, 0);
-  nvsb = (cm->mi_rows + MI_BLOCK_SIZE - 1)/MI_BLOCK_SIZE;
-  nhsb = (cm->mi_cols + MI_BLOCK_SIZE - 1)/MI_BLOCK_SIZE;
-  bskip = aom_malloc(sizeof(*bskip)*cm->mi_rows*cm->mi_cols);
-  av1_setup_dst_planes(xd->plane, frame, 0, 0);
+  int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS] = {{0}};
+  av1_setup_dst_planes(planes, frame, 0, 0);
+  /* Fill the window: the saved lines above the row, the row itself and the
+     saved lines below it. */
   for (pli = 0; pli < 3; pli++) {
-    dec[pli] = xd->plane[pli].subsampling_x;
+    const int width = (MI_SIZE >> planes[pli].subsampling_x)*cm->mi_cols;
+    od_dering_in *const win = &cm->dering_window[
+        (window*MAX_MB_PLANE + pli)*DERING_WINDOW_ROWS*stride];
+    dec[pli] = planes[pli].subsampling_x;
     bsize[pli] = 8 >> dec[pli];
-  }
-  stride = bsize[0]*cm->mi_cols;
-  for (pli = 0; pli < 3; pli++) {
-    src[pli] = aom_malloc(sizeof(*src)*cm->mi_rows*cm->mi_cols*64);
-    for (r = 0; r < bsize[pli]*cm->mi_rows; ++r) {
-      for (c = 0; c < bsize[pli]*cm->mi_cols; ++c) {
-#if CONFIG_AOM_HIGHBITDEPTH
-        if (cm->use_highbitdepth) {
-          src[pli][r * stride + c] =
-              CONVERT_TO_SHORTPTR(xd->plane[pli].dst.buf)
-              [r * xd->plane[pli].dst.stride + c];
-        } else {
-#endif
-          src[pli][r * stride + c] =
-              xd->plane[pli].dst.buf[r * xd->plane[pli].dst.stride + c];
-#if CONFIG_AOM_HIGHBITDEPTH
-        }
-#endif
-      }
+    src[pli] = win + OD_FILT_BORDER*stride;
+    if (sbr > 0) {
+      memcpy(win,
+          &cm->dering_linebuf[(pli*nvsb + sbr)*2*OD_FILT_BORDER*stride],
+          OD_FILT_BORDER*stride*sizeof(*win));
     }
-  }
-  for (r = 0; r < cm->mi_rows; ++r) {
-    for (c = 0; c < cm->mi_cols; ++c) {
-      const MB_MODE_INFO *mbmi =
-          &cm->mi_grid_visible[r * cm->mi_stride + c]->mbmi;
-      bskip[r * cm->mi_cols + c] = mbmi->skip;
+    copy_plane_lines(src[pli], stride, &planes[pli],
+                     sbr*bsize[pli]*MI_BLOCK_SIZE, bsize[pli]*nvb, width, cm);
+    if (sbr < nvsb - 1) {
+      memcpy(src[pli] + bsize[pli]*MI_BLOCK_SIZE*stride,
+          &cm->dering_linebuf[((pli*nvsb + sbr + 1)*2 + 1)*OD_FILT_BORDER*
+          stride], OD_FILT_BORDER*stride*sizeof(*win));
     }
   }
-  for (sbr = 0; sbr < nvsb; sbr++) {
-    for (sbc = 0; sbc < nhsb; sbc++) {
-      int level;
-      int nhb, nvb;
-      nhb = AOMMIN(MI_BLOCK_SIZE, cm->mi_cols - MI_BLOCK_SIZE*sbc);
-      nvb = AOMMIN(MI_BLOCK_SIZE, cm->mi_rows - MI_BLOCK_SIZE*sbr);
-      for (pli = 0; pli < 3; pli++) {
-        int16_t dst[MI_BLOCK_SIZE*MI_BLOCK_SIZE*8*8];
-        int threshold;
+  for (sbc = 0; sbc < nhsb; sbc++) {
+    int level;
+    int nhb;
+    int all_skip = 1;
+    unsigned char bskip[MI_BLOCK_SIZE*MI_BLOCK_SIZE];
+    nhb = AOMMIN(MI_BLOCK_SIZE, cm->mi_cols - MI_BLOCK_SIZE*sbc);
+    for (r = 0; r < nvb; ++r) {
+      for (c = 0; c < nhb; ++c) {
+        bskip[r*MI_BLOCK_SIZE + c] = cm->mi_grid_visible[
+            (MI_BLOCK_SIZE*sbr + r)*cm->mi_stride + MI_BLOCK_SIZE*sbc + c]->
+            mbmi.skip;
+        all_skip &= bskip[r*MI_BLOCK_SIZE + c];
+      }
+    }
+    for (pli = 0; pli < 3; pli++) {
+      int16_t dst[MI_BLOCK_SIZE*MI_BLOCK_SIZE*8*8];
+      int threshold;
 #if DERING_REFINEMENT
-        level = compute_level_from_index(
-            global_level,
-            cm->mi_grid_visible[MI_BLOCK_SIZE*sbr*cm->mi_stride +
-            MI_BLOCK_SIZE*sbc]->mbmi.dering_gain);
+      level = compute_level_from_index(
+          global_level,
+          cm->mi_grid_visible[MI_BLOCK_SIZE*sbr*cm->mi_stride +
+          MI_BLOCK_SIZE*sbc]->mbmi.dering_gain);
 #else
-        level = global_level;
+      level = global_level;
 #endif
-        /* FIXME: This is a temporary hack that uses more conservative
-           deringing for chroma. */
-        if (pli) level = (level*5 + 4) >> 3;
-        if (sb_all_skip(cm, sbr*MI_BLOCK_SIZE, sbc*MI_BLOCK_SIZE)) level = 0;
-        threshold = level << coeff_shift;
-        od_dering(
-            &OD_DERING_VTBL_C,
-            dst,
-            MI_BLOCK_SIZE*bsize[pli],
-            &src[pli][sbr*stride*bsize[pli]*MI_BLOCK_SIZE +
-            sbc*bsize[pli]*MI_BLOCK_SIZE],
-            stride, nhb, nvb, sbc, sbr, nhsb, nvsb, dec[pli], dir, pli,
-            &bskip[MI_BLOCK_SIZE*sbr*cm->mi_cols + MI_BLOCK_SIZE*sbc],
-            cm->mi_cols, threshold, OD_DERING_NO_CHECK_OVERLAP, coeff_shift);
-        for (r = 0; r < bsize[pli]*nvb; ++r) {
-          for (c = 0; c < bsize[pli]*nhb; ++c) {
+      /* FIXME: This is a temporary hack that uses more conservative
+         deringing for chroma. */
+      if (pli) level = (level*5 + 4) >> 3;
+      if (all_skip) level = 0;
+      threshold = level << coeff_shift;
+      od_dering(
+          dst,
+          MI_BLOCK_SIZE*bsize[pli],
+          &src[pli][sbc*bsize[pli]*MI_BLOCK_SIZE],
+          stride, nhb, nvb, sbc, sbr, nhsb, nvsb, dec[pli], dir, pli,
+          bskip, MI_BLOCK_SIZE, threshold, OD_DERING_NO_CHECK_OVERLAP,
+          coeff_shift);
+      for (r = 0; r < bsize[pli]*nvb; ++r) {
+        for (c = 0; c < bsize[pli]*nhb; ++c) {
 #if CONFIG_AOM_HIGHBITDEPTH
-            if (cm->use_highbitdepth) {
-              CONVERT_TO_SHORTPTR(xd->plane[pli].dst.buf)
-                  [xd->plane[pli].dst.stride*(bsize[pli]*MI_BLOCK_SIZE*sbr + r)
-                  + sbc*bsize[pli]*MI_BLOCK_SIZE + c] =
-                  dst[r * MI_BLOCK_SIZE * bsize[pli] + c];
-            } else {
+          if (cm->use_highbitdepth) {
+            CONVERT_TO_SHORTPTR(planes[pli].dst.buf)
+                [planes[pli].dst.stride*(bsize[pli]*MI_BLOCK_SIZE*sbr + r)
+                + sbc*bsize[pli]*MI_BLOCK_SIZE + c] =
+                dst[r * MI_BLOCK_SIZE * bsize[pli] + c];
+          } else {
 #endif
-              xd->plane[pli].dst.buf[xd->plane[pli].dst.stride*
-                  (bsize[pli]*MI_BLOCK_SIZE*sbr + r) +
-                  sbc*bsize[pli]*MI_BLOCK_SIZE + c] =
-                  dst[r * MI_BLOCK_SIZE * bsize[pli] + c];
+            planes[pli].dst.buf[planes[pli].dst.stride*
+                (bsize[pli]*MI_BLOCK_SIZE*sbr + r) +
+                sbc*bsize[pli]*MI_BLOCK_SIZE + c] =
+                dst[r * MI_BLOCK_SIZE * bsize[pli] + c];
 #if CONFIG_AOM_HIGHBITDEPTH
-            }
-#endif
           }
+#endif
         }
       }
     }
   }
-  for (pli = 0; pli < 3; pli++) {
-    aom_free(src[pli]);
+}
+
+void av1_dering_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                       MACROBLOCKD *xd, int global_level) {
+  int sbr;
+  const int nvsb = dering_sb_rows(cm);
+  av1_dering_init_frame(frame, cm, xd->plane, 1);
+  for (sbr = 0; sbr < nvsb; sbr++) {
+    av1_dering_sb_row(frame, cm, xd->plane, global_level, sbr, 0);
   }
-  aom_free(bskip);
 }
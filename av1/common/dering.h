@@ -33,9 +33,28 @@ int sb_all_skip(const AV1_COMMON *const cm, int mi_row, int mi_col);
 void av1_dering_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
                        MACROBLOCKD *xd, int global_level);
 
-int av1_dering_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
-                      AV1_COMMON *cm,
-                      MACROBLOCKD *xd);
+/* Allocate the deringing scratch buffers in cm for 'num_windows' superblock
+   rows filtered concurrently. */
+void av1_dering_alloc(AV1_COMMON *cm, int num_windows);
+/* Save the pixels on both sides of the boundary between superblock rows
+   'sbr' - 1 and 'sbr' of 'frame'. Both rows must be final except for
+   deringing, and neither may have been deringed yet. */
+void av1_dering_save_boundary(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                              struct macroblockd_plane planes[MAX_MB_PLANE],
+                              int sbr);
+/* Prepare the deringing scratch buffers in cm for 'num_windows' superblock
+   rows filtered concurrently, and save the superblock row boundaries of
+   'frame'. Must be called before any call to av1_dering_sb_row(), unless
+   av1_dering_alloc() and av1_dering_save_boundary() are used instead. */
+void av1_dering_init_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                           struct macroblockd_plane planes[MAX_MB_PLANE],
+                           int num_windows);
+/* Dering superblock row 'sbr' in place using scratch window 'window'. Rows
+   may be processed in any order and concurrently, each with its own window
+   and planes, once the boundaries above and below them have been saved. */
+void av1_dering_sb_row(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                       struct macroblockd_plane planes[MAX_MB_PLANE],
+                       int global_level, int sbr, int window);
 
 #ifdef __cplusplus
 }  // extern "C"
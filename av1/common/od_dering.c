@@ -14,13 +14,9 @@
 
 #include <stdlib.h>
 #include <math.h>
+#include "./av1_rtcd.h"
 #include "dering.h"
 
-const od_dering_opt_vtbl OD_DERING_VTBL_C = {
-  {od_filter_dering_direction_4x4_c, od_filter_dering_direction_8x8_c},
-  {od_filter_dering_orthogonal_4x4_c, od_filter_dering_orthogonal_8x8_c}
-};
-
 /* Generated from gen_filter_tables.c. */
 const int OD_DIRECTION_OFFSETS_TABLE[8][3] = {
   {-1*OD_FILT_BSTRIDE + 1, -2*OD_FILT_BSTRIDE + 2, -3*OD_FILT_BSTRIDE + 3  },
@@ -44,7 +40,7 @@ const double OD_DERING_GAIN_TABLE[OD_DERING_LEVELS] = {
    in a particular direction. Since each direction have the same sum(x^2) term,
    that term is never computed. See Section 2, step 2, of:
    http://jmvalin.ca/notes/intra_paint.pdf */
-static int od_dir_find8(const od_dering_in *img, int stride, int32_t *var,
+int od_dir_find8_c(const od_dering_in *img, int stride, int32_t *var,
     int coeff_shift) {
   int i;
   int32_t cost[8] = {0};
@@ -237,11 +233,24 @@ static void od_compute_thresh(int thresh[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS],
   }
 }
 
-void od_dering(const od_dering_opt_vtbl *vtbl, int16_t *y, int ystride,
+void od_dering_find_dirs(const od_dering_in *x, int xstride, int nhb, int nvb,
+ int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS],
+ int32_t var[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS], int coeff_shift) {
+  int bx;
+  int by;
+  for (by = 0; by < nvb; by++) {
+    for (bx = 0; bx < nhb; bx++) {
+      dir[by][bx] = od_dir_find8(&x[8*by*xstride + 8*bx], xstride,
+       &var[by][bx], coeff_shift);
+    }
+  }
+}
+
+void od_dering_with_dirs(int16_t *y, int ystride,
  const od_dering_in *x, int xstride, int nhb, int nvb, int sbx, int sby,
  int nhsb, int nvsb, int xdec, int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS],
- int pli, unsigned char *bskip, int skip_stride, int threshold, int overlap,
- int coeff_shift) {
+ int32_t var[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS], unsigned char *bskip,
+ int skip_stride, int threshold, int overlap) {
   int i;
   int j;
   int bx;
@@ -249,9 +258,18 @@ void od_dering(const od_dering_opt_vtbl *vtbl, int16_t *y, int ystride,
   int16_t inbuf[OD_DERING_INBUF_SIZE];
   int16_t *in;
   int bsize;
-  int32_t var[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS];
   int thresh[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS];
+  od_filter_dering_direction_func filter_dering_direction;
+  od_filter_dering_orthogonal_func filter_dering_orthogonal;
   bsize = 3 - xdec;
+  if (bsize == OD_LOG_BSIZE0) {
+    filter_dering_direction = od_filter_dering_direction_4x4;
+    filter_dering_orthogonal = od_filter_dering_orthogonal_4x4;
+  }
+  else {
+    filter_dering_direction = od_filter_dering_direction_8x8;
+    filter_dering_orthogonal = od_filter_dering_orthogonal_8x8;
+  }
   in = inbuf + OD_FILT_BORDER*OD_FILT_BSTRIDE + OD_FILT_BORDER;
   /* We avoid filtering the pixels for which some of the pixels to average
      are outside the frame. We could change the filter instead, but it would
@@ -264,13 +282,7 @@ void od_dering(const od_dering_opt_vtbl *vtbl, int16_t *y, int ystride,
       in[i*OD_FILT_BSTRIDE + j] = x[i*xstride + j];
     }
   }
-  if (pli == 0) {
-    for (by = 0; by < nvb; by++) {
-      for (bx = 0; bx < nhb; bx++) {
-        dir[by][bx] = od_dir_find8(&x[8*by*xstride + 8*bx], xstride,
-         &var[by][bx], coeff_shift);
-      }
-    }
+  if (var) {
     od_compute_thresh(thresh, threshold, var, nhb, nvb);
   }
   else {
@@ -315,7 +327,7 @@ void od_dering(const od_dering_opt_vtbl *vtbl, int16_t *y, int ystride,
   }
   for (by = 0; by < nvb; by++) {
     for (bx = 0; bx < nhb; bx++) {
-      (vtbl->filter_dering_direction[bsize - OD_LOG_BSIZE0])(
+      filter_dering_direction(
        &y[(by*ystride << bsize) + (bx << bsize)], ystride,
        &in[(by*OD_FILT_BSTRIDE << bsize) + (bx << bsize)],
        thresh[by][bx], dir[by][bx]);
@@ -328,7 +340,7 @@ void od_dering(const od_dering_opt_vtbl *vtbl, int16_t *y, int ystride,
   }
   for (by = 0; by < nvb; by++) {
     for (bx = 0; bx < nhb; bx++) {
-      (vtbl->filter_dering_orthogonal[bsize - OD_LOG_BSIZE0])(
+      filter_dering_orthogonal(
        &y[(by*ystride << bsize) + (bx << bsize)], ystride,
        &in[(by*OD_FILT_BSTRIDE << bsize) + (bx << bsize)],
        &x[(by*xstride << bsize) + (bx << bsize)], xstride,
@@ -336,3 +348,16 @@ void od_dering(const od_dering_opt_vtbl *vtbl, int16_t *y, int ystride,
     }
   }
 }
+
+void od_dering(int16_t *y, int ystride,
+ const od_dering_in *x, int xstride, int nhb, int nvb, int sbx, int sby,
+ int nhsb, int nvsb, int xdec, int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS],
+ int pli, unsigned char *bskip, int skip_stride, int threshold, int overlap,
+ int coeff_shift) {
+  int32_t var[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS];
+  if (pli == 0) {
+    od_dering_find_dirs(x, xstride, nhb, nvb, dir, var, coeff_shift);
+  }
+  od_dering_with_dirs(y, ystride, x, xstride, nhb, nvb, sbx, sby, nhsb, nvsb,
+   xdec, dir, pli == 0 ? var : NULL, bskip, skip_stride, threshold, overlap);
+}
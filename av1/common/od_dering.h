@@ -40,34 +40,30 @@ typedef void (*od_filter_dering_orthogonal_func)(int16_t *y, int ystride,
  const int16_t *in, const od_dering_in *x, int xstride, int threshold,
  int dir);
 
-struct od_dering_opt_vtbl {
-  od_filter_dering_direction_func filter_dering_direction[OD_DERINGSIZES];
-  od_filter_dering_orthogonal_func filter_dering_orthogonal[OD_DERINGSIZES];
-};
-typedef struct od_dering_opt_vtbl od_dering_opt_vtbl;
-
-
-void od_dering(const od_dering_opt_vtbl *vtbl, int16_t *y, int ystride,
+void od_dering(int16_t *y, int ystride,
  const od_dering_in *x, int xstride, int nvb, int nhb, int sbx, int sby,
  int nhsb, int nvsb, int xdec, int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS],
  int pli, unsigned char *bskip, int skip_stride, int threshold, int overlap,
  int coeff_shift);
+/* Find the direction and the directional variance of every 8x8 block of a
+   superblock of the luma plane. */
+void od_dering_find_dirs(const od_dering_in *x, int xstride, int nhb, int nvb,
+ int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS],
+ int32_t var[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS], int coeff_shift);
+/* Same as od_dering(), with the directions and variances found by
+   od_dering_find_dirs() so that they can be reused for several thresholds.
+   'var' is NULL for the chroma planes. */
+void od_dering_with_dirs(int16_t *y, int ystride,
+ const od_dering_in *x, int xstride, int nhb, int nvb, int sbx, int sby,
+ int nhsb, int nvsb, int xdec, int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS],
+ int32_t var[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS], unsigned char *bskip,
+ int skip_stride, int threshold, int overlap);
 void od_filter_dering_direction_c(int16_t *y, int ystride, const int16_t *in,
  int ln, int threshold, int dir);
 void od_filter_dering_orthogonal_c(int16_t *y, int ystride, const int16_t *in,
  const od_dering_in *x, int xstride, int ln, int threshold, int dir);
 
-extern const od_dering_opt_vtbl OD_DERING_VTBL_C;
-
-void od_filter_dering_direction_4x4_c(int16_t *y, int ystride,
- const int16_t *in, int threshold, int dir);
-void od_filter_dering_direction_8x8_c(int16_t *y, int ystride,
- const int16_t *in, int threshold, int dir);
-void od_filter_dering_orthogonal_4x4_c(int16_t *y, int ystride,
- const int16_t *in, const od_dering_in *x, int xstride, int threshold,
- int dir);
-void od_filter_dering_orthogonal_8x8_c(int16_t *y, int ystride,
- const int16_t *in, const od_dering_in *x, int xstride, int threshold,
- int dir);
+/* The 4x4 and 8x8 filters and the direction search are declared in
+   av1_rtcd.h. */
 
 #endif
@@ -33,10 +33,9 @@ extern "C" {
 #define REF_FRAMES_LOG2 3
 #define REF_FRAMES (1 << REF_FRAMES_LOG2)
 
-// 4 scratch frames for the new frames to support a maximum of 4 cores decoding
-// in parallel, 3 for scaled references on the encoder.
-// TODO(hkuang): Add ondemand frame buffers instead of hardcoding the number
-// of framebuffers.
+// Default size of the BufferPool: 4 scratch frames for the new frames and 3
+// for scaled references on the encoder. The frame parallel decoder sizes its
+// pool from the number of frame workers instead.
 // TODO(jkoleszar): These 3 extra references could probably come from the
 // normal reference pool.
 #define FRAME_BUFFERS (REF_FRAMES + 7)
@@ -116,7 +115,10 @@ typedef struct BufferPool {
   aom_get_frame_buffer_cb_fn_t get_fb_cb;
   aom_release_frame_buffer_cb_fn_t release_fb_cb;
 
-  RefCntBuffer frame_bufs[FRAME_BUFFERS];
+  // The frame buffers' pixel data is only allocated once a frame is coded into
+  // them, so the memory in use grows on demand up to num_frame_bufs frames.
+  RefCntBuffer *frame_bufs;
+  int num_frame_bufs;
 
   // Frame buffers allocated internally by the codec.
   InternalFrameBufferList int_frame_buffers;
@@ -315,6 +317,12 @@ typedef struct AV1Common {
   aom_prob kf_y_prob[INTRA_MODES][INTRA_MODES][INTRA_MODES - 1];
 #if CONFIG_DERING
   int dering_level;
+  // Deringing scratch memory: the pixels around each superblock row boundary
+  // and one superblock row window per deringing thread.
+  int16_t *dering_linebuf;
+  int16_t *dering_window;
+  int dering_linebuf_size;
+  int dering_window_size;
 #endif
 } AV1_COMMON;
 
@@ -339,7 +347,7 @@ static void unlock_buffer_pool(BufferPool *const pool) {
 static INLINE YV12_BUFFER_CONFIG *get_ref_frame(AV1_COMMON *cm, int index) {
   if (index < 0 || index >= REF_FRAMES) return NULL;
   if (cm->ref_frame_map[index] < 0) return NULL;
-  assert(cm->ref_frame_map[index] < FRAME_BUFFERS);
+  assert(cm->ref_frame_map[index] < cm->buffer_pool->num_frame_bufs);
   return &cm->buffer_pool->frame_bufs[cm->ref_frame_map[index]].buf;
 }
 
@@ -352,10 +360,10 @@ static INLINE int get_free_fb(AV1_COMMON *cm) {
   int i;
 
   lock_buffer_pool(cm->buffer_pool);
-  for (i = 0; i < FRAME_BUFFERS; ++i)
+  for (i = 0; i < cm->buffer_pool->num_frame_bufs; ++i)
     if (frame_bufs[i].ref_count == 0) break;
 
-  if (i != FRAME_BUFFERS) {
+  if (i != cm->buffer_pool->num_frame_bufs) {
     frame_bufs[i].ref_count = 1;
   } else {
     // Reset i to be INVALID_IDX to indicate no free buffer found.
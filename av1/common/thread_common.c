@@ -16,6 +16,12 @@
 #include "av1/common/thread_common.h"
 #include "av1/common/reconinter.h"
 #include "av1/common/loopfilter.h"
+#if CONFIG_CLPF
+#include "av1/common/clpf.h"
+#endif
+#if CONFIG_DERING
+#include "av1/common/dering.h"
+#endif
 
 #if CONFIG_MULTITHREAD
 static INLINE void mutex_lock(pthread_mutex_t *const mutex) {
@@ -34,16 +40,21 @@ static INLINE void mutex_lock(pthread_mutex_t *const mutex) {
 }
 #endif  // CONFIG_MULTITHREAD
 
-static INLINE void sync_read(AV1LfSync *const lf_sync, int r, int c) {
+// 'clpf' selects the progress of CLPF instead of the one of the loopfilter.
+static INLINE void sync_read(AV1LfSync *const lf_sync, int r, int c,
+                             int clpf) {
 #if CONFIG_MULTITHREAD
   const int nsync = lf_sync->sync_range;
+  const int *const cur_sb_col =
+      clpf ? lf_sync->clpf_sb_col : lf_sync->cur_sb_col;
+  pthread_cond_t *const cond = clpf ? lf_sync->clpf_cond_ : lf_sync->cond_;
 
   if (r && !(c & (nsync - 1))) {
     pthread_mutex_t *const mutex = &lf_sync->mutex_[r - 1];
     mutex_lock(mutex);
 
-    while (c > lf_sync->cur_sb_col[r - 1] - nsync) {
-      pthread_cond_wait(&lf_sync->cond_[r - 1], mutex);
+    while (c > cur_sb_col[r - 1] - nsync) {
+      pthread_cond_wait(&cond[r - 1], mutex);
     }
     pthread_mutex_unlock(mutex);
   }
@@ -51,13 +62,16 @@ static INLINE void sync_read(AV1LfSync *const lf_sync, int r, int c) {
   (void)lf_sync;
   (void)r;
   (void)c;
+  (void)clpf;
 #endif  // CONFIG_MULTITHREAD
 }
 
 static INLINE void sync_write(AV1LfSync *const lf_sync, int r, int c,
-                              const int sb_cols) {
+                              const int sb_cols, int clpf) {
 #if CONFIG_MULTITHREAD
   const int nsync = lf_sync->sync_range;
+  int *const cur_sb_col = clpf ? lf_sync->clpf_sb_col : lf_sync->cur_sb_col;
+  pthread_cond_t *const cond = clpf ? lf_sync->clpf_cond_ : lf_sync->cond_;
   int cur;
   // Only signal when there are enough filtered SB for next row to run.
   int sig = 1;
@@ -72,9 +86,9 @@ static INLINE void sync_write(AV1LfSync *const lf_sync, int r, int c,
   if (sig) {
     mutex_lock(&lf_sync->mutex_[r]);
 
-    lf_sync->cur_sb_col[r] = cur;
+    cur_sb_col[r] = cur;
 
-    pthread_cond_signal(&lf_sync->cond_[r]);
+    pthread_cond_signal(&cond[r]);
     pthread_mutex_unlock(&lf_sync->mutex_[r]);
   }
 #else
@@ -82,9 +96,30 @@ static INLINE void sync_write(AV1LfSync *const lf_sync, int r, int c,
   (void)r;
   (void)c;
   (void)sb_cols;
+  (void)clpf;
 #endif  // CONFIG_MULTITHREAD
 }
 
+#if CONFIG_CLPF
+// CLPF of one superblock row. Each superblock reads the filtered pixels of
+// the superblocks above and to the left, so the row follows the one above it.
+static void thread_clpf_row(const YV12_BUFFER_CONFIG *const frame_buffer,
+                            AV1_COMMON *const cm,
+                            struct macroblockd_plane planes[MAX_MB_PLANE],
+                            int mi_row, AV1LfSync *const lf_sync) {
+  const int sb_cols = mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
+  const int r = mi_row >> MI_BLOCK_SIZE_LOG2;
+  int mi_col;
+
+  for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
+    const int c = mi_col >> MI_BLOCK_SIZE_LOG2;
+    sync_read(lf_sync, r, c, 1);
+    av1_clpf_sb(frame_buffer, cm, planes, mi_row, mi_col);
+    sync_write(lf_sync, r, c, sb_cols, 1);
+  }
+}
+#endif  // CONFIG_CLPF
+
 // Implement row loopfiltering for each thread.
 static INLINE void thread_loop_filter_rows(
     const YV12_BUFFER_CONFIG *const frame_buffer, AV1_COMMON *const cm,
@@ -104,16 +139,17 @@ static INLINE void thread_loop_filter_rows(
     path = LF_PATH_SLOW;
 
   for (mi_row = start; mi_row < stop;
-       mi_row += lf_sync->num_workers * MI_BLOCK_SIZE) {
+       mi_row += lf_sync->active_workers * MI_BLOCK_SIZE) {
     MODE_INFO **const mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
 
-    for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
+    for (mi_col = 0; lf_sync->loop_filter && mi_col < cm->mi_cols;
+         mi_col += MI_BLOCK_SIZE) {
       const int r = mi_row >> MI_BLOCK_SIZE_LOG2;
       const int c = mi_col >> MI_BLOCK_SIZE_LOG2;
       LOOP_FILTER_MASK lfm;
       int plane;
 
-      sync_read(lf_sync, r, c);
+      sync_read(lf_sync, r, c, 0);
 
       av1_setup_dst_planes(planes, frame_buffer, mi_row, mi_col);
 
@@ -136,8 +172,21 @@ static INLINE void thread_loop_filter_rows(
         }
       }
 
-      sync_write(lf_sync, r, c, sb_cols);
+      sync_write(lf_sync, r, c, sb_cols, 0);
     }
+
+#if CONFIG_CLPF
+    // The loopfilter of this row changes the bottom pixels of the row above,
+    // and CLPF reads the top pixels of the row below, so CLPF runs one row
+    // behind the loopfilter.
+    if (lf_sync->clpf) {
+      if (mi_row > 0)
+        thread_clpf_row(frame_buffer, cm, planes, mi_row - MI_BLOCK_SIZE,
+                        lf_sync);
+      if (mi_row + MI_BLOCK_SIZE >= stop)
+        thread_clpf_row(frame_buffer, cm, planes, mi_row, lf_sync);
+    }
+#endif  // CONFIG_CLPF
   }
 }
 
@@ -153,15 +202,12 @@ static int loop_filter_row_worker(AV1LfSync *const lf_sync,
 static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
                                 struct macroblockd_plane planes[MAX_MB_PLANE],
                                 int start, int stop, int y_only,
-                                AVxWorker *workers, int nworkers,
-                                AV1LfSync *lf_sync) {
+                                int loop_filter, int clpf, AVxWorker *workers,
+                                int nworkers, AV1LfSync *lf_sync) {
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
   // Number of superblock rows and cols
   const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
-  // Decoder may allocate more threads than number of tiles based on user's
-  // input.
-  const int tile_cols = 1 << cm->log2_tile_cols;
-  const int num_workers = AOMMIN(nworkers, tile_cols);
+  const int num_workers = nworkers;
   int i;
 
   if (!lf_sync->sync_range || sb_rows != lf_sync->rows ||
@@ -172,15 +218,12 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
 
   // Initialize cur_sb_col to -1 for all SB rows.
   memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  memset(lf_sync->clpf_sb_col, -1, sizeof(*lf_sync->clpf_sb_col) * sb_rows);
+  lf_sync->loop_filter = loop_filter;
+  lf_sync->clpf = clpf;
+  lf_sync->active_workers = num_workers;
 
   // Set up loopfilter thread data.
-  // The decoder is capping num_workers because it has been observed that using
-  // more threads on the loopfilter than there are cores will hurt performance
-  // on Android. This is because the system will only schedule the tile decode
-  // workers on cores equal to the number of tile columns. Then if the decoder
-  // tries to use more threads for the loopfilter, it will hurt performance
-  // because of contention. If the multithreading code changes in the future
-  // then the number of workers used by the loopfilter should be revisited.
   for (i = 0; i < num_workers; ++i) {
     AVxWorker *const worker = &workers[i];
     LFWorkerData *const lf_data = &lf_sync->lfdata[i];
@@ -228,12 +271,82 @@ void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
   end_mi_row = start_mi_row + mi_rows_to_filter;
   av1_loop_filter_frame_init(cm, frame_filter_level);
 
-  loop_filter_rows_mt(frame, cm, planes, start_mi_row, end_mi_row, y_only,
-                      workers, num_workers, lf_sync);
+  loop_filter_rows_mt(frame, cm, planes, start_mi_row, end_mi_row, y_only, 1,
+                      0, workers, num_workers, lf_sync);
+}
+
+#if CONFIG_CLPF
+void av1_loop_filter_clpf_frame_mt(
+    YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+    struct macroblockd_plane planes[MAX_MB_PLANE], int frame_filter_level,
+    AVxWorker *workers, int num_workers, AV1LfSync *lf_sync) {
+  if (frame_filter_level) av1_loop_filter_frame_init(cm, frame_filter_level);
+
+  loop_filter_rows_mt(frame, cm, planes, 0, cm->mi_rows, 0,
+                      frame_filter_level != 0, 1, workers, num_workers,
+                      lf_sync);
+}
+#endif  // CONFIG_CLPF
+
+#if CONFIG_DERING
+// Deringing hook. The superblock rows are interleaved between the workers and
+// each worker uses the scratch window matching its first row.
+static int dering_row_worker(AV1LfSync *const lf_sync,
+                             LFWorkerData *const lf_data) {
+  int sbr;
+  for (sbr = lf_data->start; sbr < lf_data->stop;
+       sbr += lf_sync->active_workers) {
+    av1_dering_sb_row(lf_data->frame_buffer, lf_data->cm, lf_data->planes,
+                      lf_sync->dering_level, sbr, lf_data->start);
+  }
+  return 1;
+}
+
+void av1_dering_frame_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                         struct macroblockd_plane planes[MAX_MB_PLANE],
+                         int global_level, AVxWorker *workers,
+                         int num_workers, AV1LfSync *lf_sync) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  int i;
+
+  num_workers = AOMMIN(num_workers, sb_rows);
+  if (!lf_sync->sync_range || sb_rows != lf_sync->rows ||
+      num_workers > lf_sync->num_workers) {
+    av1_loop_filter_dealloc(lf_sync);
+    av1_loop_filter_alloc(lf_sync, cm, sb_rows, cm->width, num_workers);
+  }
+  av1_dering_init_frame(frame, cm, planes, num_workers);
+  lf_sync->dering_level = global_level;
+  lf_sync->active_workers = num_workers;
+
+  for (i = 0; i < num_workers; ++i) {
+    AVxWorker *const worker = &workers[i];
+    LFWorkerData *const lf_data = &lf_sync->lfdata[i];
+
+    worker->hook = (AVxWorkerHook)dering_row_worker;
+    worker->data1 = lf_sync;
+    worker->data2 = lf_data;
+
+    av1_loop_filter_data_reset(lf_data, frame, cm, planes);
+    lf_data->start = i;
+    lf_data->stop = sb_rows;
+
+    if (i == num_workers - 1) {
+      winterface->execute(worker);
+    } else {
+      winterface->launch(worker);
+    }
+  }
+
+  for (i = 0; i < num_workers; ++i) {
+    winterface->sync(&workers[i]);
+  }
 }
+#endif  // CONFIG_DERING
 
 // Set up nsync by width.
-static INLINE int get_sync_range(int width) {
+int av1_get_sync_range(int width) {
   // nsync numbers are picked by testing. For example, for 4k
   // video, using 4 gives best performance.
   if (width < 640)
@@ -269,6 +382,14 @@ void av1_loop_filter_alloc(AV1LfSync *lf_sync, AV1_COMMON *cm, int rows,
         pthread_cond_init(&lf_sync->cond_[i], NULL);
       }
     }
+
+    CHECK_MEM_ERROR(cm, lf_sync->clpf_cond_,
+                    aom_malloc(sizeof(*lf_sync->clpf_cond_) * rows));
+    if (lf_sync->clpf_cond_) {
+      for (i = 0; i < rows; ++i) {
+        pthread_cond_init(&lf_sync->clpf_cond_[i], NULL);
+      }
+    }
   }
 #endif  // CONFIG_MULTITHREAD
 
@@ -278,9 +399,11 @@ void av1_loop_filter_alloc(AV1LfSync *lf_sync, AV1_COMMON *cm, int rows,
 
   CHECK_MEM_ERROR(cm, lf_sync->cur_sb_col,
                   aom_malloc(sizeof(*lf_sync->cur_sb_col) * rows));
+  CHECK_MEM_ERROR(cm, lf_sync->clpf_sb_col,
+                  aom_malloc(sizeof(*lf_sync->clpf_sb_col) * rows));
 
   // Set up nsync.
-  lf_sync->sync_range = get_sync_range(width);
+  lf_sync->sync_range = av1_get_sync_range(width);
 }
 
 // Deallocate lf synchronization related mutex and data
@@ -301,9 +424,16 @@ void av1_loop_filter_dealloc(AV1LfSync *lf_sync) {
       }
       aom_free(lf_sync->cond_);
     }
+    if (lf_sync->clpf_cond_ != NULL) {
+      for (i = 0; i < lf_sync->rows; ++i) {
+        pthread_cond_destroy(&lf_sync->clpf_cond_[i]);
+      }
+      aom_free(lf_sync->clpf_cond_);
+    }
 #endif  // CONFIG_MULTITHREAD
     aom_free(lf_sync->lfdata);
     aom_free(lf_sync->cur_sb_col);
+    aom_free(lf_sync->clpf_sb_col);
     // clear the structure as the source of this call may be a resize in which
     // case this call will be followed by an _alloc() which may fail.
     av1_zero(*lf_sync);
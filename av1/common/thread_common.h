@@ -27,9 +27,12 @@ typedef struct AV1LfSyncData {
 #if CONFIG_MULTITHREAD
   pthread_mutex_t *mutex_;
   pthread_cond_t *cond_;
+  pthread_cond_t *clpf_cond_;
 #endif
   // Allocate memory to store the loop-filtered superblock index in each row.
   int *cur_sb_col;
+  // Index of the last CLPF-filtered superblock in each row.
+  int *clpf_sb_col;
   // The optimal sync_range for different resolution and platform should be
   // determined by testing. Currently, it is chosen to be a power-of-2 number.
   int sync_range;
@@ -38,8 +41,24 @@ typedef struct AV1LfSyncData {
   // Row-based parallel loopfilter data
   LFWorkerData *lfdata;
   int num_workers;
+  // Number of workers sharing the rows of the current frame. This may be less
+  // than num_workers, the number of allocated lfdata.
+  int active_workers;
+
+  // Filters applied by the row workers.
+  int loop_filter;
+  int clpf;
+
+#if CONFIG_DERING
+  // Deringing level of the frame.
+  int dering_level;
+#endif
 } AV1LfSync;
 
+// Returns the number of superblock columns a row must stay ahead of the row
+// below it, picked for the given frame width.
+int av1_get_sync_range(int width);
+
 // Allocate memory for loopfilter row synchronization.
 void av1_loop_filter_alloc(AV1LfSync *lf_sync, struct AV1Common *cm,
                             int rows, int width, int num_workers);
@@ -47,13 +66,35 @@ void av1_loop_filter_alloc(AV1LfSync *lf_sync, struct AV1Common *cm,
 // Deallocate loopfilter synchronization related mutex and data.
 void av1_loop_filter_dealloc(AV1LfSync *lf_sync);
 
-// Multi-threaded loopfilter that uses the tile threads.
+// Multi-threaded loopfilter that uses the tile threads. All num_workers
+// workers filter rows; the caller picks their number. The decoder caps it to
+// the tile columns when it decodes tile columns in parallel, while the encoder
+// uses its whole worker pool.
 void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
                                struct macroblockd_plane planes[MAX_MB_PLANE],
                                int frame_filter_level, int y_only,
                                int partial_frame, AVxWorker *workers,
                                int num_workers, AV1LfSync *lf_sync);
 
+#if CONFIG_CLPF
+// Multi-threaded loopfilter followed by CLPF on the whole frame, using the
+// tile threads. The CLPF of a superblock row runs one row behind its
+// loopfilter. The loopfilter is skipped if frame_filter_level is 0.
+void av1_loop_filter_clpf_frame_mt(
+    YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
+    struct macroblockd_plane planes[MAX_MB_PLANE], int frame_filter_level,
+    AVxWorker *workers, int num_workers, AV1LfSync *lf_sync);
+#endif  // CONFIG_CLPF
+
+#if CONFIG_DERING
+// Multi-threaded deringing of the whole frame using the tile threads. Each
+// worker filters every num_workers-th superblock row.
+void av1_dering_frame_mt(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
+                         struct macroblockd_plane planes[MAX_MB_PLANE],
+                         int global_level, AVxWorker *workers,
+                         int num_workers, AV1LfSync *lf_sync);
+#endif  // CONFIG_DERING
+
 void av1_accumulate_frame_counts(struct AV1Common *cm,
                                   struct FRAME_COUNTS *counts, int is_dec);
 
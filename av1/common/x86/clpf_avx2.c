@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+
+// Load 8 pixels from each of the rows p to p + 3 * stride.
+static INLINE __m256i load_4rows(const uint8_t *p, int stride) {
+  const __m128i lo =
+      _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)p),
+                         _mm_loadl_epi64((const __m128i *)(p + stride)));
+  const __m128i hi =
+      _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)(p + 2 * stride)),
+                         _mm_loadl_epi64((const __m128i *)(p + 3 * stride)));
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+// Return x + 1 where more than two of a, b, c, d are above x, x - 1 where
+// more than two are below x, and x otherwise. The inputs are offset by 128 so
+// that signed comparisons can be used.
+static INLINE __m256i clpf_filter(__m256i x, __m256i a, __m256i b, __m256i c,
+                                  __m256i d) {
+  const __m256i minus2 = _mm256_set1_epi8(-2);
+  // The compare masks are -1 where true, so the sums are minus the counts.
+  const __m256i gt = _mm256_add_epi8(
+      _mm256_add_epi8(_mm256_cmpgt_epi8(a, x), _mm256_cmpgt_epi8(b, x)),
+      _mm256_add_epi8(_mm256_cmpgt_epi8(c, x), _mm256_cmpgt_epi8(d, x)));
+  const __m256i lt = _mm256_add_epi8(
+      _mm256_add_epi8(_mm256_cmpgt_epi8(x, a), _mm256_cmpgt_epi8(x, b)),
+      _mm256_add_epi8(_mm256_cmpgt_epi8(x, c), _mm256_cmpgt_epi8(x, d)));
+  return _mm256_add_epi8(_mm256_sub_epi8(x, _mm256_cmpgt_epi8(minus2, gt)),
+                         _mm256_cmpgt_epi8(minus2, lt));
+}
+
+void aom_clpf_block_avx2(const uint8_t *src, uint8_t *dst, int sstride,
+                         int dstride, int has_top, int has_left,
+                         int has_bottom, int has_right, int width,
+                         int height) {
+  const __m256i offset = _mm256_set1_epi8(-128);
+  int y;
+
+  if (width != 8 || (height & 3)) {
+    aom_clpf_block_c(src, dst, sstride, dstride, has_top, has_left,
+                     has_bottom, has_right, width, height);
+    return;
+  }
+
+  for (y = 0; y < height; y += 4) {
+    const uint8_t *const s = src + y * sstride;
+    const __m256i x = _mm256_xor_si256(load_4rows(s, sstride), offset);
+    const __m256i a =
+        has_top ? _mm256_xor_si256(load_4rows(s - sstride, sstride), offset)
+                : x;
+    const __m256i b =
+        has_left ? _mm256_xor_si256(load_4rows(s - 1, sstride), offset) : x;
+    const __m256i c =
+        has_right ? _mm256_xor_si256(load_4rows(s + 1, sstride), offset) : x;
+    const __m256i d =
+        has_bottom
+            ? _mm256_xor_si256(load_4rows(s + sstride, sstride), offset)
+            : x;
+    const __m256i r = _mm256_xor_si256(clpf_filter(x, a, b, c, d), offset);
+    const __m128i lo = _mm256_castsi256_si128(r);
+    const __m128i hi = _mm256_extracti128_si256(r, 1);
+    _mm_storel_epi64((__m128i *)(dst + y * dstride), lo);
+    _mm_storel_epi64((__m128i *)(dst + (y + 1) * dstride),
+                     _mm_srli_si128(lo, 8));
+    _mm_storel_epi64((__m128i *)(dst + (y + 2) * dstride), hi);
+    _mm_storel_epi64((__m128i *)(dst + (y + 3) * dstride),
+                     _mm_srli_si128(hi, 8));
+  }
+}
+
+#if CONFIG_AOM_HIGHBITDEPTH
+// Load 8 pixels from each of the rows p and p + stride.
+static INLINE __m256i load_2rows_hbd(const uint16_t *p, int stride) {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)p)),
+      _mm_loadu_si128((const __m128i *)(p + stride)), 1);
+}
+
+// 16-bit version of clpf_filter(). Pixels of up to 15 bits can be compared as
+// signed values directly.
+static INLINE __m256i clpf_filter_hbd(__m256i x, __m256i a, __m256i b,
+                                      __m256i c, __m256i d) {
+  const __m256i minus2 = _mm256_set1_epi16(-2);
+  const __m256i gt = _mm256_add_epi16(
+      _mm256_add_epi16(_mm256_cmpgt_epi16(a, x), _mm256_cmpgt_epi16(b, x)),
+      _mm256_add_epi16(_mm256_cmpgt_epi16(c, x), _mm256_cmpgt_epi16(d, x)));
+  const __m256i lt = _mm256_add_epi16(
+      _mm256_add_epi16(_mm256_cmpgt_epi16(x, a), _mm256_cmpgt_epi16(x, b)),
+      _mm256_add_epi16(_mm256_cmpgt_epi16(x, c), _mm256_cmpgt_epi16(x, d)));
+  return _mm256_add_epi16(_mm256_sub_epi16(x, _mm256_cmpgt_epi16(minus2, gt)),
+                          _mm256_cmpgt_epi16(minus2, lt));
+}
+
+void aom_clpf_block_hbd_avx2(const uint16_t *src, uint16_t *dst, int sstride,
+                             int dstride, int has_top, int has_left,
+                             int has_bottom, int has_right, int width,
+                             int height) {
+  int y;
+
+  if (width != 8 || (height & 1)) {
+    aom_clpf_block_hbd_c(src, dst, sstride, dstride, has_top, has_left,
+                         has_bottom, has_right, width, height);
+    return;
+  }
+
+  for (y = 0; y < height; y += 2) {
+    const uint16_t *const s = src + y * sstride;
+    const __m256i x = load_2rows_hbd(s, sstride);
+    const __m256i a = has_top ? load_2rows_hbd(s - sstride, sstride) : x;
+    const __m256i b = has_left ? load_2rows_hbd(s - 1, sstride) : x;
+    const __m256i c = has_right ? load_2rows_hbd(s + 1, sstride) : x;
+    const __m256i d = has_bottom ? load_2rows_hbd(s + sstride, sstride) : x;
+    const __m256i r = clpf_filter_hbd(x, a, b, c, d);
+    _mm_storeu_si128((__m128i *)(dst + y * dstride),
+                     _mm256_castsi256_si128(r));
+    _mm_storeu_si128((__m128i *)(dst + (y + 1) * dstride),
+                     _mm256_extracti128_si256(r, 1));
+  }
+}
+#endif  // CONFIG_AOM_HIGHBITDEPTH
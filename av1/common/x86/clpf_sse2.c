@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <emmintrin.h>  // SSE2
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+
+// Load 8 pixels from each of the rows p and p + stride.
+static INLINE __m128i load_2rows(const uint8_t *p, int stride) {
+  return _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)p),
+                            _mm_loadl_epi64((const __m128i *)(p + stride)));
+}
+
+// Return x + 1 where more than two of a, b, c, d are above x, x - 1 where
+// more than two are below x, and x otherwise. The inputs are offset by 128 so
+// that signed comparisons can be used.
+static INLINE __m128i clpf_filter(__m128i x, __m128i a, __m128i b, __m128i c,
+                                  __m128i d) {
+  const __m128i minus2 = _mm_set1_epi8(-2);
+  // The compare masks are -1 where true, so the sums are minus the counts.
+  const __m128i gt = _mm_add_epi8(
+      _mm_add_epi8(_mm_cmpgt_epi8(a, x), _mm_cmpgt_epi8(b, x)),
+      _mm_add_epi8(_mm_cmpgt_epi8(c, x), _mm_cmpgt_epi8(d, x)));
+  const __m128i lt = _mm_add_epi8(
+      _mm_add_epi8(_mm_cmplt_epi8(a, x), _mm_cmplt_epi8(b, x)),
+      _mm_add_epi8(_mm_cmplt_epi8(c, x), _mm_cmplt_epi8(d, x)));
+  return _mm_add_epi8(_mm_sub_epi8(x, _mm_cmplt_epi8(gt, minus2)),
+                      _mm_cmplt_epi8(lt, minus2));
+}
+
+void aom_clpf_block_sse2(const uint8_t *src, uint8_t *dst, int sstride,
+                         int dstride, int has_top, int has_left,
+                         int has_bottom, int has_right, int width,
+                         int height) {
+  const __m128i offset = _mm_set1_epi8(-128);
+  int y;
+
+  if (width != 8 || (height & 1)) {
+    aom_clpf_block_c(src, dst, sstride, dstride, has_top, has_left,
+                     has_bottom, has_right, width, height);
+    return;
+  }
+
+  for (y = 0; y < height; y += 2) {
+    const uint8_t *const s = src + y * sstride;
+    const __m128i x = _mm_xor_si128(load_2rows(s, sstride), offset);
+    const __m128i a =
+        has_top ? _mm_xor_si128(load_2rows(s - sstride, sstride), offset) : x;
+    const __m128i b =
+        has_left ? _mm_xor_si128(load_2rows(s - 1, sstride), offset) : x;
+    const __m128i c =
+        has_right ? _mm_xor_si128(load_2rows(s + 1, sstride), offset) : x;
+    const __m128i d =
+        has_bottom ? _mm_xor_si128(load_2rows(s + sstride, sstride), offset)
+                   : x;
+    const __m128i r = _mm_xor_si128(clpf_filter(x, a, b, c, d), offset);
+    _mm_storel_epi64((__m128i *)(dst + y * dstride), r);
+    _mm_storel_epi64((__m128i *)(dst + (y + 1) * dstride),
+                     _mm_srli_si128(r, 8));
+  }
+}
+
+#if CONFIG_AOM_HIGHBITDEPTH
+// 16-bit version of clpf_filter(). Pixels of up to 15 bits can be compared as
+// signed values directly.
+static INLINE __m128i clpf_filter_hbd(__m128i x, __m128i a, __m128i b,
+                                      __m128i c, __m128i d) {
+  const __m128i minus2 = _mm_set1_epi16(-2);
+  const __m128i gt = _mm_add_epi16(
+      _mm_add_epi16(_mm_cmpgt_epi16(a, x), _mm_cmpgt_epi16(b, x)),
+      _mm_add_epi16(_mm_cmpgt_epi16(c, x), _mm_cmpgt_epi16(d, x)));
+  const __m128i lt = _mm_add_epi16(
+      _mm_add_epi16(_mm_cmplt_epi16(a, x), _mm_cmplt_epi16(b, x)),
+      _mm_add_epi16(_mm_cmplt_epi16(c, x), _mm_cmplt_epi16(d, x)));
+  return _mm_add_epi16(_mm_sub_epi16(x, _mm_cmplt_epi16(gt, minus2)),
+                       _mm_cmplt_epi16(lt, minus2));
+}
+
+void aom_clpf_block_hbd_sse2(const uint16_t *src, uint16_t *dst, int sstride,
+                             int dstride, int has_top, int has_left,
+                             int has_bottom, int has_right, int width,
+                             int height) {
+  int y;
+
+  if (width != 8) {
+    aom_clpf_block_hbd_c(src, dst, sstride, dstride, has_top, has_left,
+                         has_bottom, has_right, width, height);
+    return;
+  }
+
+  for (y = 0; y < height; y++) {
+    const uint16_t *const s = src + y * sstride;
+    const __m128i x = _mm_loadu_si128((const __m128i *)s);
+    const __m128i a =
+        has_top ? _mm_loadu_si128((const __m128i *)(s - sstride)) : x;
+    const __m128i b = has_left ? _mm_loadu_si128((const __m128i *)(s - 1)) : x;
+    const __m128i c = has_right ? _mm_loadu_si128((const __m128i *)(s + 1)) : x;
+    const __m128i d =
+        has_bottom ? _mm_loadu_si128((const __m128i *)(s + sstride)) : x;
+    _mm_storeu_si128((__m128i *)(dst + y * dstride),
+                     clpf_filter_hbd(x, a, b, c, d));
+  }
+}
+#endif  // CONFIG_AOM_HIGHBITDEPTH
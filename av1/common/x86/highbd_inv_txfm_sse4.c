@@ -0,0 +1,555 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <smmintrin.h>  // SSE4.1
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+#include "aom_dsp/txfm_common.h"
+#include "aom_ports/mem.h"
+
+// The transforms work on 4 independent vectors at a time, one in each 32-bit
+// lane. The C code forms the products and their sums in 64 bits, which the
+// intermediate values of 10 and 12-bit video need, so the even and odd lanes
+// are multiplied separately with _mm_mul_epi32().
+typedef void (*highbd_transform_1d_sse4_1)(__m128i *in);
+
+typedef struct {
+  highbd_transform_1d_sse4_1 cols, rows;  // vertical and horizontal
+} highbd_transform_2d_sse4_1;
+
+// The 64-bit products of the even lanes of a and c in r[0], and of the odd
+// lanes in r[1].
+static INLINE void mul_epi64(__m128i a, tran_high_t c, __m128i *r) {
+  const __m128i k = _mm_set1_epi32((int)c);
+  r[0] = _mm_mul_epi32(a, k);
+  r[1] = _mm_mul_epi32(_mm_srli_epi64(a, 32), k);
+}
+
+// a * ca + b * cb in 64 bits.
+static INLINE void madd_epi64(__m128i a, tran_high_t ca, __m128i b,
+                              tran_high_t cb, __m128i *r) {
+  __m128i t[2];
+  mul_epi64(a, ca, r);
+  mul_epi64(b, cb, t);
+  r[0] = _mm_add_epi64(r[0], t[0]);
+  r[1] = _mm_add_epi64(r[1], t[1]);
+}
+
+static INLINE void add_epi64(const __m128i *a, const __m128i *b, __m128i *r) {
+  r[0] = _mm_add_epi64(a[0], b[0]);
+  r[1] = _mm_add_epi64(a[1], b[1]);
+}
+
+static INLINE void sub_epi64(const __m128i *a, const __m128i *b, __m128i *r) {
+  r[0] = _mm_sub_epi64(a[0], b[0]);
+  r[1] = _mm_sub_epi64(a[1], b[1]);
+}
+
+// highbd_dct_const_round_shift() of the 64-bit values, truncated to 32 bits.
+// Only bits 14 to 45 of the sums are kept, so a logical shift gives the same
+// result as the arithmetic shift of the C code.
+static INLINE __m128i round_shift_epi64(const __m128i *r) {
+  const __m128i rounding = _mm_set1_epi64x(DCT_CONST_ROUNDING);
+  const __m128i even =
+      _mm_srli_epi64(_mm_add_epi64(r[0], rounding), DCT_CONST_BITS);
+  const __m128i odd =
+      _mm_srli_epi64(_mm_add_epi64(r[1], rounding), DCT_CONST_BITS);
+  return _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0xcc);
+}
+
+static INLINE __m128i mul_round_shift(__m128i a, tran_high_t c) {
+  __m128i r[2];
+  mul_epi64(a, c, r);
+  return round_shift_epi64(r);
+}
+
+static INLINE __m128i madd_round_shift(__m128i a, tran_high_t ca, __m128i b,
+                                       tran_high_t cb) {
+  __m128i r[2];
+  madd_epi64(a, ca, b, cb, r);
+  return round_shift_epi64(r);
+}
+
+static void idct4_sse4_1(__m128i *in) {
+  __m128i step[4];
+
+  // stage 1
+  step[0] = mul_round_shift(_mm_add_epi32(in[0], in[2]), cospi_16_64);
+  step[1] = mul_round_shift(_mm_sub_epi32(in[0], in[2]), cospi_16_64);
+  step[2] = madd_round_shift(in[1], cospi_24_64, in[3], -cospi_8_64);
+  step[3] = madd_round_shift(in[1], cospi_8_64, in[3], cospi_24_64);
+
+  // stage 2
+  in[0] = _mm_add_epi32(step[0], step[3]);
+  in[1] = _mm_add_epi32(step[1], step[2]);
+  in[2] = _mm_sub_epi32(step[1], step[2]);
+  in[3] = _mm_sub_epi32(step[0], step[3]);
+}
+
+static void iadst4_sse4_1(__m128i *in) {
+  const __m128i x7 = _mm_add_epi32(_mm_sub_epi32(in[0], in[2]), in[3]);
+  __m128i s0[2], s1[2], s2[2], s3[2], t[2];
+
+  madd_epi64(in[0], sinpi_1_9, in[2], sinpi_4_9, s0);
+  mul_epi64(in[3], sinpi_2_9, t);
+  add_epi64(s0, t, s0);
+  madd_epi64(in[0], sinpi_2_9, in[2], -sinpi_1_9, s1);
+  mul_epi64(in[3], -sinpi_4_9, t);
+  add_epi64(s1, t, s1);
+  mul_epi64(in[1], sinpi_3_9, s3);
+  mul_epi64(x7, sinpi_3_9, s2);
+
+  add_epi64(s0, s3, t);
+  in[0] = round_shift_epi64(t);
+  add_epi64(s1, s3, t);
+  in[1] = round_shift_epi64(t);
+  in[2] = round_shift_epi64(s2);
+  add_epi64(s0, s1, t);
+  sub_epi64(t, s3, t);
+  in[3] = round_shift_epi64(t);
+}
+
+static void idct8_sse4_1(__m128i *in) {
+  __m128i step1[8], step2[8];
+
+  // stage 1
+  step1[0] = in[0];
+  step1[2] = in[4];
+  step1[1] = in[2];
+  step1[3] = in[6];
+  step1[4] = madd_round_shift(in[1], cospi_28_64, in[7], -cospi_4_64);
+  step1[7] = madd_round_shift(in[1], cospi_4_64, in[7], cospi_28_64);
+  step1[5] = madd_round_shift(in[5], cospi_12_64, in[3], -cospi_20_64);
+  step1[6] = madd_round_shift(in[5], cospi_20_64, in[3], cospi_12_64);
+
+  // stage 2 & stage 3 - even half
+  idct4_sse4_1(step1);
+
+  // stage 2 - odd half
+  step2[4] = _mm_add_epi32(step1[4], step1[5]);
+  step2[5] = _mm_sub_epi32(step1[4], step1[5]);
+  step2[6] = _mm_sub_epi32(step1[7], step1[6]);
+  step2[7] = _mm_add_epi32(step1[6], step1[7]);
+
+  // stage 3 - odd half
+  step1[4] = step2[4];
+  step1[5] = mul_round_shift(_mm_sub_epi32(step2[6], step2[5]), cospi_16_64);
+  step1[6] = mul_round_shift(_mm_add_epi32(step2[5], step2[6]), cospi_16_64);
+  step1[7] = step2[7];
+
+  // stage 4
+  in[0] = _mm_add_epi32(step1[0], step1[7]);
+  in[1] = _mm_add_epi32(step1[1], step1[6]);
+  in[2] = _mm_add_epi32(step1[2], step1[5]);
+  in[3] = _mm_add_epi32(step1[3], step1[4]);
+  in[4] = _mm_sub_epi32(step1[3], step1[4]);
+  in[5] = _mm_sub_epi32(step1[2], step1[5]);
+  in[6] = _mm_sub_epi32(step1[1], step1[6]);
+  in[7] = _mm_sub_epi32(step1[0], step1[7]);
+}
+
+static void iadst8_sse4_1(__m128i *in) {
+  const __m128i x0 = in[7];
+  const __m128i x1 = in[0];
+  const __m128i x2 = in[5];
+  const __m128i x3 = in[2];
+  const __m128i x4 = in[3];
+  const __m128i x5 = in[4];
+  const __m128i x6 = in[1];
+  const __m128i x7 = in[6];
+  __m128i s[8][2], t[2], x[8];
+
+  // stage 1
+  madd_epi64(x0, cospi_2_64, x1, cospi_30_64, s[0]);
+  madd_epi64(x0, cospi_30_64, x1, -cospi_2_64, s[1]);
+  madd_epi64(x2, cospi_10_64, x3, cospi_22_64, s[2]);
+  madd_epi64(x2, cospi_22_64, x3, -cospi_10_64, s[3]);
+  madd_epi64(x4, cospi_18_64, x5, cospi_14_64, s[4]);
+  madd_epi64(x4, cospi_14_64, x5, -cospi_18_64, s[5]);
+  madd_epi64(x6, cospi_26_64, x7, cospi_6_64, s[6]);
+  madd_epi64(x6, cospi_6_64, x7, -cospi_26_64, s[7]);
+
+  add_epi64(s[0], s[4], t);
+  x[0] = round_shift_epi64(t);
+  add_epi64(s[1], s[5], t);
+  x[1] = round_shift_epi64(t);
+  add_epi64(s[2], s[6], t);
+  x[2] = round_shift_epi64(t);
+  add_epi64(s[3], s[7], t);
+  x[3] = round_shift_epi64(t);
+  sub_epi64(s[0], s[4], t);
+  x[4] = round_shift_epi64(t);
+  sub_epi64(s[1], s[5], t);
+  x[5] = round_shift_epi64(t);
+  sub_epi64(s[2], s[6], t);
+  x[6] = round_shift_epi64(t);
+  sub_epi64(s[3], s[7], t);
+  x[7] = round_shift_epi64(t);
+
+  // stage 2
+  madd_epi64(x[4], cospi_8_64, x[5], cospi_24_64, s[4]);
+  madd_epi64(x[4], cospi_24_64, x[5], -cospi_8_64, s[5]);
+  madd_epi64(x[6], -cospi_24_64, x[7], cospi_8_64, s[6]);
+  madd_epi64(x[6], cospi_8_64, x[7], cospi_24_64, s[7]);
+
+  in[0] = _mm_add_epi32(x[0], x[2]);
+  in[7] = _mm_sub_epi32(_mm_setzero_si128(), _mm_add_epi32(x[1], x[3]));
+  x[2] = _mm_sub_epi32(x[0], x[2]);
+  x[3] = _mm_sub_epi32(x[1], x[3]);
+  add_epi64(s[4], s[6], t);
+  x[4] = round_shift_epi64(t);
+  add_epi64(s[5], s[7], t);
+  in[6] = round_shift_epi64(t);
+  sub_epi64(s[4], s[6], t);
+  x[6] = round_shift_epi64(t);
+  sub_epi64(s[5], s[7], t);
+  x[7] = round_shift_epi64(t);
+
+  // stage 3
+  in[3] = _mm_sub_epi32(
+      _mm_setzero_si128(),
+      mul_round_shift(_mm_add_epi32(x[2], x[3]), cospi_16_64));
+  in[4] = mul_round_shift(_mm_sub_epi32(x[2], x[3]), cospi_16_64);
+  in[2] = mul_round_shift(_mm_add_epi32(x[6], x[7]), cospi_16_64);
+  in[5] = _mm_sub_epi32(
+      _mm_setzero_si128(),
+      mul_round_shift(_mm_sub_epi32(x[6], x[7]), cospi_16_64));
+  in[1] = _mm_sub_epi32(_mm_setzero_si128(), x[4]);
+}
+
+static void idct16_sse4_1(__m128i *in) {
+  __m128i step1[16], step2[16];
+
+  // stage 1
+  step1[0] = in[0];
+  step1[1] = in[8];
+  step1[2] = in[4];
+  step1[3] = in[12];
+  step1[4] = in[2];
+  step1[5] = in[10];
+  step1[6] = in[6];
+  step1[7] = in[14];
+  step1[8] = in[1];
+  step1[9] = in[9];
+  step1[10] = in[5];
+  step1[11] = in[13];
+  step1[12] = in[3];
+  step1[13] = in[11];
+  step1[14] = in[7];
+  step1[15] = in[15];
+
+  // stage 2
+  step2[0] = step1[0];
+  step2[1] = step1[1];
+  step2[2] = step1[2];
+  step2[3] = step1[3];
+  step2[4] = step1[4];
+  step2[5] = step1[5];
+  step2[6] = step1[6];
+  step2[7] = step1[7];
+  step2[8] = madd_round_shift(step1[8], cospi_30_64, step1[15], -cospi_2_64);
+  step2[15] = madd_round_shift(step1[8], cospi_2_64, step1[15], cospi_30_64);
+  step2[9] = madd_round_shift(step1[9], cospi_14_64, step1[14], -cospi_18_64);
+  step2[14] = madd_round_shift(step1[9], cospi_18_64, step1[14], cospi_14_64);
+  step2[10] =
+      madd_round_shift(step1[10], cospi_22_64, step1[13], -cospi_10_64);
+  step2[13] = madd_round_shift(step1[10], cospi_10_64, step1[13], cospi_22_64);
+  step2[11] = madd_round_shift(step1[11], cospi_6_64, step1[12], -cospi_26_64);
+  step2[12] = madd_round_shift(step1[11], cospi_26_64, step1[12], cospi_6_64);
+
+  // stage 3
+  step1[0] = step2[0];
+  step1[1] = step2[1];
+  step1[2] = step2[2];
+  step1[3] = step2[3];
+  step1[4] = madd_round_shift(step2[4], cospi_28_64, step2[7], -cospi_4_64);
+  step1[7] = madd_round_shift(step2[4], cospi_4_64, step2[7], cospi_28_64);
+  step1[5] = madd_round_shift(step2[5], cospi_12_64, step2[6], -cospi_20_64);
+  step1[6] = madd_round_shift(step2[5], cospi_20_64, step2[6], cospi_12_64);
+  step1[8] = _mm_add_epi32(step2[8], step2[9]);
+  step1[9] = _mm_sub_epi32(step2[8], step2[9]);
+  step1[10] = _mm_sub_epi32(step2[11], step2[10]);
+  step1[11] = _mm_add_epi32(step2[10], step2[11]);
+  step1[12] = _mm_add_epi32(step2[12], step2[13]);
+  step1[13] = _mm_sub_epi32(step2[12], step2[13]);
+  step1[14] = _mm_sub_epi32(step2[15], step2[14]);
+  step1[15] = _mm_add_epi32(step2[14], step2[15]);
+
+  // stage 4
+  step2[0] = mul_round_shift(_mm_add_epi32(step1[0], step1[1]), cospi_16_64);
+  step2[1] = mul_round_shift(_mm_sub_epi32(step1[0], step1[1]), cospi_16_64);
+  step2[2] = madd_round_shift(step1[2], cospi_24_64, step1[3], -cospi_8_64);
+  step2[3] = madd_round_shift(step1[2], cospi_8_64, step1[3], cospi_24_64);
+  step2[4] = _mm_add_epi32(step1[4], step1[5]);
+  step2[5] = _mm_sub_epi32(step1[4], step1[5]);
+  step2[6] = _mm_sub_epi32(step1[7], step1[6]);
+  step2[7] = _mm_add_epi32(step1[6], step1[7]);
+  step2[8] = step1[8];
+  step2[15] = step1[15];
+  step2[9] = madd_round_shift(step1[9], -cospi_8_64, step1[14], cospi_24_64);
+  step2[14] = madd_round_shift(step1[9], cospi_24_64, step1[14], cospi_8_64);
+  step2[10] =
+      madd_round_shift(step1[10], -cospi_24_64, step1[13], -cospi_8_64);
+  step2[13] = madd_round_shift(step1[10], -cospi_8_64, step1[13], cospi_24_64);
+  step2[11] = step1[11];
+  step2[12] = step1[12];
+
+  // stage 5
+  step1[0] = _mm_add_epi32(step2[0], step2[3]);
+  step1[1] = _mm_add_epi32(step2[1], step2[2]);
+  step1[2] = _mm_sub_epi32(step2[1], step2[2]);
+  step1[3] = _mm_sub_epi32(step2[0], step2[3]);
+  step1[4] = step2[4];
+  step1[5] = mul_round_shift(_mm_sub_epi32(step2[6], step2[5]), cospi_16_64);
+  step1[6] = mul_round_shift(_mm_add_epi32(step2[5], step2[6]), cospi_16_64);
+  step1[7] = step2[7];
+  step1[8] = _mm_add_epi32(step2[8], step2[11]);
+  step1[9] = _mm_add_epi32(step2[9], step2[10]);
+  step1[10] = _mm_sub_epi32(step2[9], step2[10]);
+  step1[11] = _mm_sub_epi32(step2[8], step2[11]);
+  step1[12] = _mm_sub_epi32(step2[15], step2[12]);
+  step1[13] = _mm_sub_epi32(step2[14], step2[13]);
+  step1[14] = _mm_add_epi32(step2[13], step2[14]);
+  step1[15] = _mm_add_epi32(step2[12], step2[15]);
+
+  // stage 6
+  step2[0] = _mm_add_epi32(step1[0], step1[7]);
+  step2[1] = _mm_add_epi32(step1[1], step1[6]);
+  step2[2] = _mm_add_epi32(step1[2], step1[5]);
+  step2[3] = _mm_add_epi32(step1[3], step1[4]);
+  step2[4] = _mm_sub_epi32(step1[3], step1[4]);
+  step2[5] = _mm_sub_epi32(step1[2], step1[5]);
+  step2[6] = _mm_sub_epi32(step1[1], step1[6]);
+  step2[7] = _mm_sub_epi32(step1[0], step1[7]);
+  step2[8] = step1[8];
+  step2[9] = step1[9];
+  step2[10] =
+      mul_round_shift(_mm_sub_epi32(step1[13], step1[10]), cospi_16_64);
+  step2[13] =
+      mul_round_shift(_mm_add_epi32(step1[10], step1[13]), cospi_16_64);
+  step2[11] =
+      mul_round_shift(_mm_sub_epi32(step1[12], step1[11]), cospi_16_64);
+  step2[12] =
+      mul_round_shift(_mm_add_epi32(step1[11], step1[12]), cospi_16_64);
+  step2[14] = step1[14];
+  step2[15] = step1[15];
+
+  // stage 7
+  in[0] = _mm_add_epi32(step2[0], step2[15]);
+  in[1] = _mm_add_epi32(step2[1], step2[14]);
+  in[2] = _mm_add_epi32(step2[2], step2[13]);
+  in[3] = _mm_add_epi32(step2[3], step2[12]);
+  in[4] = _mm_add_epi32(step2[4], step2[11]);
+  in[5] = _mm_add_epi32(step2[5], step2[10]);
+  in[6] = _mm_add_epi32(step2[6], step2[9]);
+  in[7] = _mm_add_epi32(step2[7], step2[8]);
+  in[8] = _mm_sub_epi32(step2[7], step2[8]);
+  in[9] = _mm_sub_epi32(step2[6], step2[9]);
+  in[10] = _mm_sub_epi32(step2[5], step2[10]);
+  in[11] = _mm_sub_epi32(step2[4], step2[11]);
+  in[12] = _mm_sub_epi32(step2[3], step2[12]);
+  in[13] = _mm_sub_epi32(step2[2], step2[13]);
+  in[14] = _mm_sub_epi32(step2[1], step2[14]);
+  in[15] = _mm_sub_epi32(step2[0], step2[15]);
+}
+
+static void iadst16_sse4_1(__m128i *in) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i s[16][2], t[2], x[16];
+  int i;
+
+  // stage 1
+  madd_epi64(in[15], cospi_1_64, in[0], cospi_31_64, s[0]);
+  madd_epi64(in[15], cospi_31_64, in[0], -cospi_1_64, s[1]);
+  madd_epi64(in[13], cospi_5_64, in[2], cospi_27_64, s[2]);
+  madd_epi64(in[13], cospi_27_64, in[2], -cospi_5_64, s[3]);
+  madd_epi64(in[11], cospi_9_64, in[4], cospi_23_64, s[4]);
+  madd_epi64(in[11], cospi_23_64, in[4], -cospi_9_64, s[5]);
+  madd_epi64(in[9], cospi_13_64, in[6], cospi_19_64, s[6]);
+  madd_epi64(in[9], cospi_19_64, in[6], -cospi_13_64, s[7]);
+  madd_epi64(in[7], cospi_17_64, in[8], cospi_15_64, s[8]);
+  madd_epi64(in[7], cospi_15_64, in[8], -cospi_17_64, s[9]);
+  madd_epi64(in[5], cospi_21_64, in[10], cospi_11_64, s[10]);
+  madd_epi64(in[5], cospi_11_64, in[10], -cospi_21_64, s[11]);
+  madd_epi64(in[3], cospi_25_64, in[12], cospi_7_64, s[12]);
+  madd_epi64(in[3], cospi_7_64, in[12], -cospi_25_64, s[13]);
+  madd_epi64(in[1], cospi_29_64, in[14], cospi_3_64, s[14]);
+  madd_epi64(in[1], cospi_3_64, in[14], -cospi_29_64, s[15]);
+
+  for (i = 0; i < 8; ++i) {
+    add_epi64(s[i], s[i + 8], t);
+    x[i] = round_shift_epi64(t);
+    sub_epi64(s[i], s[i + 8], t);
+    x[i + 8] = round_shift_epi64(t);
+  }
+
+  // stage 2
+  madd_epi64(x[8], cospi_4_64, x[9], cospi_28_64, s[8]);
+  madd_epi64(x[8], cospi_28_64, x[9], -cospi_4_64, s[9]);
+  madd_epi64(x[10], cospi_20_64, x[11], cospi_12_64, s[10]);
+  madd_epi64(x[10], cospi_12_64, x[11], -cospi_20_64, s[11]);
+  madd_epi64(x[12], -cospi_28_64, x[13], cospi_4_64, s[12]);
+  madd_epi64(x[12], cospi_4_64, x[13], cospi_28_64, s[13]);
+  madd_epi64(x[14], -cospi_12_64, x[15], cospi_20_64, s[14]);
+  madd_epi64(x[14], cospi_20_64, x[15], cospi_12_64, s[15]);
+
+  for (i = 0; i < 4; ++i) {
+    const __m128i a = x[i];
+    x[i] = _mm_add_epi32(a, x[i + 4]);
+    x[i + 4] = _mm_sub_epi32(a, x[i + 4]);
+    add_epi64(s[i + 8], s[i + 12], t);
+    x[i + 8] = round_shift_epi64(t);
+    sub_epi64(s[i + 8], s[i + 12], t);
+    x[i + 12] = round_shift_epi64(t);
+  }
+
+  // stage 3
+  madd_epi64(x[4], cospi_8_64, x[5], cospi_24_64, s[4]);
+  madd_epi64(x[4], cospi_24_64, x[5], -cospi_8_64, s[5]);
+  madd_epi64(x[6], -cospi_24_64, x[7], cospi_8_64, s[6]);
+  madd_epi64(x[6], cospi_8_64, x[7], cospi_24_64, s[7]);
+  madd_epi64(x[12], cospi_8_64, x[13], cospi_24_64, s[12]);
+  madd_epi64(x[12], cospi_24_64, x[13], -cospi_8_64, s[13]);
+  madd_epi64(x[14], -cospi_24_64, x[15], cospi_8_64, s[14]);
+  madd_epi64(x[14], cospi_8_64, x[15], cospi_24_64, s[15]);
+
+  for (i = 0; i < 16; i += 8) {
+    const __m128i a0 = x[i];
+    const __m128i a1 = x[i + 1];
+    x[i] = _mm_add_epi32(a0, x[i + 2]);
+    x[i + 1] = _mm_add_epi32(a1, x[i + 3]);
+    x[i + 2] = _mm_sub_epi32(a0, x[i + 2]);
+    x[i + 3] = _mm_sub_epi32(a1, x[i + 3]);
+    add_epi64(s[i + 4], s[i + 6], t);
+    x[i + 4] = round_shift_epi64(t);
+    add_epi64(s[i + 5], s[i + 7], t);
+    x[i + 5] = round_shift_epi64(t);
+    sub_epi64(s[i + 4], s[i + 6], t);
+    x[i + 6] = round_shift_epi64(t);
+    sub_epi64(s[i + 5], s[i + 7], t);
+    x[i + 7] = round_shift_epi64(t);
+  }
+
+  // stage 4
+  in[7] = mul_round_shift(_mm_add_epi32(x[2], x[3]), -cospi_16_64);
+  in[8] = mul_round_shift(_mm_sub_epi32(x[2], x[3]), cospi_16_64);
+  in[4] = mul_round_shift(_mm_add_epi32(x[6], x[7]), cospi_16_64);
+  in[11] = mul_round_shift(_mm_sub_epi32(x[7], x[6]), cospi_16_64);
+  in[6] = mul_round_shift(_mm_add_epi32(x[10], x[11]), cospi_16_64);
+  in[9] = mul_round_shift(_mm_sub_epi32(x[11], x[10]), cospi_16_64);
+  in[5] = mul_round_shift(_mm_add_epi32(x[14], x[15]), -cospi_16_64);
+  in[10] = mul_round_shift(_mm_sub_epi32(x[14], x[15]), cospi_16_64);
+
+  in[0] = x[0];
+  in[1] = _mm_sub_epi32(zero, x[8]);
+  in[2] = x[12];
+  in[3] = _mm_sub_epi32(zero, x[4]);
+  in[12] = x[5];
+  in[13] = _mm_sub_epi32(zero, x[13]);
+  in[14] = x[9];
+  in[15] = _mm_sub_epi32(zero, x[1]);
+}
+
+static INLINE void transpose_4x4(const __m128i *in, __m128i *out) {
+  const __m128i t0 = _mm_unpacklo_epi32(in[0], in[1]);
+  const __m128i t1 = _mm_unpackhi_epi32(in[0], in[1]);
+  const __m128i t2 = _mm_unpacklo_epi32(in[2], in[3]);
+  const __m128i t3 = _mm_unpackhi_epi32(in[2], in[3]);
+  out[0] = _mm_unpacklo_epi64(t0, t2);
+  out[1] = _mm_unpackhi_epi64(t0, t2);
+  out[2] = _mm_unpacklo_epi64(t1, t3);
+  out[3] = _mm_unpackhi_epi64(t1, t3);
+}
+
+// Inverse transform the n x n block of coefficients and add the residual,
+// rounded by 'shift' bits, to dest.
+static void highbd_iht_add_sse4_1(const tran_low_t *input, uint16_t *dest,
+                                  int stride, int n,
+                                  const highbd_transform_2d_sse4_1 *ht,
+                                  int shift, int bd) {
+  DECLARE_ALIGNED(16, tran_low_t, out[16 * 16]);
+  const __m128i rounding = _mm_set1_epi32(1 << (shift - 1));
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i max =
+      _mm_set1_epi32(bd == 10 ? 1023 : (bd == 12 ? 4095 : 255));
+  __m128i buf[16], t[4];
+  int i, j, k;
+
+  // Rows, 4 at a time with the coefficients of each row in one lane.
+  for (i = 0; i < n; i += 4) {
+    for (k = 0; k < n; k += 4) {
+      for (j = 0; j < 4; ++j)
+        t[j] = _mm_loadu_si128((const __m128i *)(input + (i + j) * n + k));
+      transpose_4x4(t, &buf[k]);
+    }
+    ht->rows(buf);
+    for (k = 0; k < n; k += 4) {
+      transpose_4x4(&buf[k], t);
+      for (j = 0; j < 4; ++j)
+        _mm_store_si128((__m128i *)(out + (i + j) * n + k), t[j]);
+    }
+  }
+
+  // Columns, 4 at a time with each column in one lane.
+  for (i = 0; i < n; i += 4) {
+    for (j = 0; j < n; ++j)
+      buf[j] = _mm_load_si128((const __m128i *)(out + j * n + i));
+    ht->cols(buf);
+    for (j = 0; j < n; ++j) {
+      uint16_t *const d = dest + j * stride + i;
+      const __m128i p = _mm_cvtepu16_epi32(_mm_loadl_epi64((__m128i *)d));
+      __m128i v = _mm_srai_epi32(_mm_add_epi32(buf[j], rounding), shift);
+      v = _mm_min_epi32(_mm_max_epi32(_mm_add_epi32(v, p), zero), max);
+      _mm_storel_epi64((__m128i *)d, _mm_packus_epi32(v, v));
+    }
+  }
+}
+
+static const highbd_transform_2d_sse4_1 HIGH_IHT_4[] = {
+  { idct4_sse4_1, idct4_sse4_1 },   // DCT_DCT  = 0
+  { iadst4_sse4_1, idct4_sse4_1 },  // ADST_DCT = 1
+  { idct4_sse4_1, iadst4_sse4_1 },  // DCT_ADST = 2
+  { iadst4_sse4_1, iadst4_sse4_1 }  // ADST_ADST = 3
+};
+
+static const highbd_transform_2d_sse4_1 HIGH_IHT_8[] = {
+  { idct8_sse4_1, idct8_sse4_1 },   // DCT_DCT  = 0
+  { iadst8_sse4_1, idct8_sse4_1 },  // ADST_DCT = 1
+  { idct8_sse4_1, iadst8_sse4_1 },  // DCT_ADST = 2
+  { iadst8_sse4_1, iadst8_sse4_1 }  // ADST_ADST = 3
+};
+
+static const highbd_transform_2d_sse4_1 HIGH_IHT_16[] = {
+  { idct16_sse4_1, idct16_sse4_1 },   // DCT_DCT  = 0
+  { iadst16_sse4_1, idct16_sse4_1 },  // ADST_DCT = 1
+  { idct16_sse4_1, iadst16_sse4_1 },  // DCT_ADST = 2
+  { iadst16_sse4_1, iadst16_sse4_1 }  // ADST_ADST = 3
+};
+
+void av1_highbd_iht4x4_16_add_sse4_1(const tran_low_t *input, uint8_t *dest8,
+                                     int stride, int tx_type, int bd) {
+  highbd_iht_add_sse4_1(input, CONVERT_TO_SHORTPTR(dest8), stride, 4,
+                        &HIGH_IHT_4[tx_type], 4, bd);
+}
+
+void av1_highbd_iht8x8_64_add_sse4_1(const tran_low_t *input, uint8_t *dest8,
+                                     int stride, int tx_type, int bd) {
+  highbd_iht_add_sse4_1(input, CONVERT_TO_SHORTPTR(dest8), stride, 8,
+                        &HIGH_IHT_8[tx_type], 5, bd);
+}
+
+void av1_highbd_iht16x16_256_add_sse4_1(const tran_low_t *input,
+                                        uint8_t *dest8, int stride,
+                                        int tx_type, int bd) {
+  highbd_iht_add_sse4_1(input, CONVERT_TO_SHORTPTR(dest8), stride, 16,
+                        &HIGH_IHT_16[tx_type], 6, bd);
+}
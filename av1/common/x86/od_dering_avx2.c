@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+#include "av1/common/od_dering.h"
+
+// The 8x8 filters process two rows per register.
+
+// Load 8 pixels from each of the rows p and p + stride.
+static INLINE __m256i load_2rows(const int16_t *p, int stride) {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)p)),
+      _mm_loadu_si128((const __m128i *)(p + stride)), 1);
+}
+
+static INLINE void store_2rows(int16_t *p, int stride, __m256i v) {
+  _mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(v));
+  _mm_storeu_si128((__m128i *)(p + stride), _mm256_extracti128_si256(v, 1));
+}
+
+// Return the difference between the pixels at p and xx where it is below thr
+// and 0 elsewhere.
+static INLINE __m256i constrain(const int16_t *p, __m256i xx, __m256i thr) {
+  const __m256i d = _mm256_sub_epi16(load_2rows(p, OD_FILT_BSTRIDE), xx);
+  return _mm256_and_si256(d, _mm256_cmpgt_epi16(thr, _mm256_abs_epi16(d)));
+}
+
+void od_filter_dering_direction_8x8_avx2(int16_t *y, int ystride,
+                                         const int16_t *in, int threshold,
+                                         int dir) {
+  const int o1 = OD_DIRECTION_OFFSETS_TABLE[dir][0];
+  const int o2 = OD_DIRECTION_OFFSETS_TABLE[dir][1];
+  const int o3 = OD_DIRECTION_OFFSETS_TABLE[dir][2];
+  const __m256i thr = _mm256_set1_epi16(threshold);
+  const __m256i four = _mm256_set1_epi16(4);
+  int i;
+  for (i = 0; i < 8; i += 2) {
+    const int16_t *const p = in + i * OD_FILT_BSTRIDE;
+    const __m256i xx = load_2rows(p, OD_FILT_BSTRIDE);
+    __m256i sum;
+    __m256i t;
+    // Tap 3
+    t = _mm256_add_epi16(constrain(p + o1, xx, thr),
+                         constrain(p - o1, xx, thr));
+    sum = _mm256_add_epi16(t, _mm256_add_epi16(t, t));
+    // Taps 2
+    t = _mm256_add_epi16(constrain(p + o2, xx, thr),
+                         constrain(p - o2, xx, thr));
+    t = _mm256_add_epi16(t, constrain(p + o3, xx, thr));
+    t = _mm256_add_epi16(t, constrain(p - o3, xx, thr));
+    sum = _mm256_add_epi16(sum, _mm256_add_epi16(t, t));
+    // (sum + 8) >> 4 == ((sum >> 1) + 4) >> 3, which cannot overflow.
+    sum = _mm256_srai_epi16(
+        _mm256_add_epi16(_mm256_srai_epi16(sum, 1), four), 3);
+    store_2rows(y + i * ystride, ystride, _mm256_add_epi16(xx, sum));
+  }
+}
+
+void od_filter_dering_orthogonal_8x8_avx2(int16_t *y, int ystride,
+                                          const int16_t *in, const int16_t *x,
+                                          int xstride, int threshold,
+                                          int dir) {
+  const int offset = dir > 0 && dir < 4 ? OD_FILT_BSTRIDE : 1;
+  const __m256i thr = _mm256_set1_epi16(threshold);
+  const __m256i thr3 = _mm256_set1_epi16(threshold / 3);
+  const __m256i one = _mm256_set1_epi16(1);
+  const __m256i four = _mm256_set1_epi16(4);
+  int i;
+  for (i = 0; i < 8; i += 2) {
+    const int16_t *const p = in + i * OD_FILT_BSTRIDE;
+    const __m256i yy = load_2rows(p, OD_FILT_BSTRIDE);
+    const __m256i athresh = _mm256_min_epi16(
+        thr, _mm256_adds_epi16(
+                 thr3, _mm256_abs_epi16(_mm256_subs_epi16(
+                           yy, load_2rows(x + i * xstride, xstride)))));
+    __m256i sum;
+    __m256i half;
+    sum = _mm256_add_epi16(constrain(p + offset, yy, athresh),
+                           constrain(p - offset, yy, athresh));
+    sum = _mm256_add_epi16(sum, constrain(p + 2 * offset, yy, athresh));
+    sum = _mm256_add_epi16(sum, constrain(p - 2 * offset, yy, athresh));
+    // (3 * sum + 8) >> 4 == (3 * (sum >> 1) + (sum & 1) + 4) >> 3, which
+    // cannot overflow.
+    half = _mm256_srai_epi16(sum, 1);
+    sum = _mm256_add_epi16(
+        _mm256_add_epi16(half, _mm256_add_epi16(half, half)),
+        _mm256_add_epi16(_mm256_and_si256(sum, one), four));
+    sum = _mm256_srai_epi16(sum, 3);
+    store_2rows(y + i * ystride, ystride, _mm256_add_epi16(yy, sum));
+  }
+}
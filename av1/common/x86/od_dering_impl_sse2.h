@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+// Deringing filters shared by the SSE2 and SSSE3 versions. The including file
+// defines the function names and ABS_EPI16(), which returns the absolute value
+// of each signed 16-bit lane.
+
+#include <emmintrin.h>  // SSE2
+
+#include "./av1_rtcd.h"
+#include "av1/common/od_dering.h"
+
+// Load n (4 or 8) pixels.
+static INLINE __m128i od_dering_load(const int16_t *p, int n) {
+  return n == 4 ? _mm_loadl_epi64((const __m128i *)p)
+                : _mm_loadu_si128((const __m128i *)p);
+}
+
+static INLINE void od_dering_store(int16_t *p, __m128i v, int n) {
+  if (n == 4)
+    _mm_storel_epi64((__m128i *)p, v);
+  else
+    _mm_storeu_si128((__m128i *)p, v);
+}
+
+// Return the difference between the pixels at p and xx where it is below thr
+// and 0 elsewhere.
+static INLINE __m128i od_dering_constrain(const int16_t *p, __m128i xx,
+                                          __m128i thr, int n) {
+  const __m128i d = _mm_sub_epi16(od_dering_load(p, n), xx);
+  return _mm_and_si128(d, _mm_cmplt_epi16(ABS_EPI16(d), thr));
+}
+
+// Smooth an n x n block in the direction dir. Matches
+// od_filter_dering_direction_c(), including its 16-bit wrap-around.
+static INLINE void od_filter_dering_direction_sse2_impl(int16_t *y,
+                                                        int ystride,
+                                                        const int16_t *in,
+                                                        int threshold,
+                                                        int dir, int n) {
+  const int o1 = OD_DIRECTION_OFFSETS_TABLE[dir][0];
+  const int o2 = OD_DIRECTION_OFFSETS_TABLE[dir][1];
+  const int o3 = OD_DIRECTION_OFFSETS_TABLE[dir][2];
+  const __m128i thr = _mm_set1_epi16(threshold);
+  const __m128i four = _mm_set1_epi16(4);
+  int i;
+  for (i = 0; i < n; i++) {
+    const int16_t *const p = in + i * OD_FILT_BSTRIDE;
+    const __m128i xx = od_dering_load(p, n);
+    __m128i sum;
+    __m128i t;
+    // Tap 3
+    t = _mm_add_epi16(od_dering_constrain(p + o1, xx, thr, n),
+                      od_dering_constrain(p - o1, xx, thr, n));
+    sum = _mm_add_epi16(t, _mm_add_epi16(t, t));
+    // Taps 2
+    t = _mm_add_epi16(od_dering_constrain(p + o2, xx, thr, n),
+                      od_dering_constrain(p - o2, xx, thr, n));
+    t = _mm_add_epi16(t, od_dering_constrain(p + o3, xx, thr, n));
+    t = _mm_add_epi16(t, od_dering_constrain(p - o3, xx, thr, n));
+    sum = _mm_add_epi16(sum, _mm_add_epi16(t, t));
+    // (sum + 8) >> 4 == ((sum >> 1) + 4) >> 3, which cannot overflow.
+    sum = _mm_srai_epi16(_mm_add_epi16(_mm_srai_epi16(sum, 1), four), 3);
+    od_dering_store(y + i * ystride, _mm_add_epi16(xx, sum), n);
+  }
+}
+
+// Smooth an n x n block in the direction orthogonal to dir. Matches
+// od_filter_dering_orthogonal_c().
+static INLINE void od_filter_dering_orthogonal_sse2_impl(
+    int16_t *y, int ystride, const int16_t *in, const int16_t *x, int xstride,
+    int threshold, int dir, int n) {
+  const int offset = dir > 0 && dir < 4 ? OD_FILT_BSTRIDE : 1;
+  const __m128i thr = _mm_set1_epi16(threshold);
+  const __m128i thr3 = _mm_set1_epi16(threshold / 3);
+  const __m128i one = _mm_set1_epi16(1);
+  const __m128i four = _mm_set1_epi16(4);
+  int i;
+  for (i = 0; i < n; i++) {
+    const int16_t *const p = in + i * OD_FILT_BSTRIDE;
+    const __m128i yy = od_dering_load(p, n);
+    const __m128i athresh = _mm_min_epi16(
+        thr, _mm_adds_epi16(thr3, ABS_EPI16(_mm_subs_epi16(
+                                      yy, od_dering_load(x + i * xstride, n)))));
+    __m128i sum;
+    __m128i half;
+    sum = _mm_add_epi16(od_dering_constrain(p + offset, yy, athresh, n),
+                        od_dering_constrain(p - offset, yy, athresh, n));
+    sum = _mm_add_epi16(sum,
+                        od_dering_constrain(p + 2 * offset, yy, athresh, n));
+    sum = _mm_add_epi16(sum,
+                        od_dering_constrain(p - 2 * offset, yy, athresh, n));
+    // (3 * sum + 8) >> 4 == (3 * (sum >> 1) + (sum & 1) + 4) >> 3, which
+    // cannot overflow.
+    half = _mm_srai_epi16(sum, 1);
+    sum = _mm_add_epi16(_mm_add_epi16(half, _mm_add_epi16(half, half)),
+                        _mm_add_epi16(_mm_and_si128(sum, one), four));
+    sum = _mm_srai_epi16(sum, 3);
+    od_dering_store(y + i * ystride, _mm_add_epi16(yy, sum), n);
+  }
+}
+
+void OD_FILTER_DERING_DIRECTION_4X4(int16_t *y, int ystride, const int16_t *in,
+                                    int threshold, int dir) {
+  od_filter_dering_direction_sse2_impl(y, ystride, in, threshold, dir, 4);
+}
+
+void OD_FILTER_DERING_DIRECTION_8X8(int16_t *y, int ystride, const int16_t *in,
+                                    int threshold, int dir) {
+  od_filter_dering_direction_sse2_impl(y, ystride, in, threshold, dir, 8);
+}
+
+void OD_FILTER_DERING_ORTHOGONAL_4X4(int16_t *y, int ystride,
+                                     const int16_t *in, const int16_t *x,
+                                     int xstride, int threshold, int dir) {
+  od_filter_dering_orthogonal_sse2_impl(y, ystride, in, x, xstride, threshold,
+                                        dir, 4);
+}
+
+void OD_FILTER_DERING_ORTHOGONAL_8X8(int16_t *y, int ystride,
+                                     const int16_t *in, const int16_t *x,
+                                     int xstride, int threshold, int dir) {
+  od_filter_dering_orthogonal_sse2_impl(y, ystride, in, x, xstride, threshold,
+                                        dir, 8);
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <emmintrin.h>  // SSE2
+
+#include "./aom_config.h"
+#include "aom_ports/mem.h"
+
+// SSE2 has no 16-bit absolute value. The negation saturates so that the result
+// is never negative.
+#define ABS_EPI16(x) \
+  _mm_max_epi16((x), _mm_subs_epi16(_mm_setzero_si128(), (x)))
+#define OD_FILTER_DERING_DIRECTION_4X4 od_filter_dering_direction_4x4_sse2
+#define OD_FILTER_DERING_DIRECTION_8X8 od_filter_dering_direction_8x8_sse2
+#define OD_FILTER_DERING_ORTHOGONAL_4X4 od_filter_dering_orthogonal_4x4_sse2
+#define OD_FILTER_DERING_ORTHOGONAL_8X8 od_filter_dering_orthogonal_8x8_sse2
+#include "av1/common/x86/od_dering_impl_sse2.h"
+#undef OD_FILTER_DERING_DIRECTION_4X4
+#undef OD_FILTER_DERING_DIRECTION_8X8
+#undef OD_FILTER_DERING_ORTHOGONAL_4X4
+#undef OD_FILTER_DERING_ORTHOGONAL_8X8
+#undef ABS_EPI16
+
+// Each weight of the squared partial sums of od_dir_find8_c() is split into
+// two factors, so that _mm_madd_epi16() applies it without 32-bit multiplies.
+// A partial sum times either factor still fits in 16 bits. The diagonal
+// directions have 15 partial sums, the other oblique directions 11.
+DECLARE_ALIGNED(16, static const int16_t, kDiagWeightsA[16]) = {
+  28, 20, 14, 14, 12, 10, 10, 7, 10, 10, 12, 14, 14, 20, 28, 0
+};
+DECLARE_ALIGNED(16, static const int16_t, kDiagWeightsB[16]) = {
+  30, 21, 20, 15, 14, 14, 12, 15, 12, 14, 14, 15, 20, 21, 30, 0
+};
+DECLARE_ALIGNED(16, static const int16_t, kObliqueWeightsA[16]) = {
+  20, 14, 10, 7, 7, 7, 7, 7, 10, 14, 20, 0, 0, 0, 0, 0
+};
+DECLARE_ALIGNED(16, static const int16_t, kObliqueWeightsB[16]) = {
+  21, 15, 14, 15, 15, 15, 15, 15, 14, 15, 21, 0, 0, 0, 0, 0
+};
+
+// Shift the 8 partial sums in v up by n lanes into the 16 lanes lo:hi.
+#define ACCUMULATE_SHIFTED(lo, hi, v, n)                        \
+  do {                                                          \
+    lo = _mm_add_epi16(lo, _mm_slli_si128(v, 2 * (n)));         \
+    hi = _mm_add_epi16(hi, _mm_srli_si128(v, 16 - 2 * (n)));    \
+  } while (0)
+
+// Return the sum of the 4 32-bit lanes of v.
+static INLINE int32_t hsum_epi32(__m128i v) {
+  v = _mm_add_epi32(v, _mm_srli_si128(v, 8));
+  v = _mm_add_epi32(v, _mm_srli_si128(v, 4));
+  return _mm_cvtsi128_si32(v);
+}
+
+// Return the sums of the 4 32-bit lanes of each of a, b, c and d.
+static INLINE __m128i hsum4_epi32(__m128i a, __m128i b, __m128i c,
+                                  __m128i d) {
+  const __m128i ab = _mm_add_epi32(_mm_unpacklo_epi32(a, b),
+                                   _mm_unpackhi_epi32(a, b));
+  const __m128i cd = _mm_add_epi32(_mm_unpacklo_epi32(c, d),
+                                   _mm_unpackhi_epi32(c, d));
+  return _mm_add_epi32(_mm_unpacklo_epi64(ab, cd),
+                       _mm_unpackhi_epi64(ab, cd));
+}
+
+// Return the weighted sum of squares of the 16 partial sums lo:hi.
+static INLINE int32_t partial_cost(__m128i lo, __m128i hi, const int16_t *wa,
+                                   const int16_t *wb) {
+  const __m128i sum_lo =
+      _mm_madd_epi16(_mm_mullo_epi16(lo, _mm_load_si128((const __m128i *)wa)),
+                     _mm_mullo_epi16(lo, _mm_load_si128((const __m128i *)wb)));
+  const __m128i sum_hi = _mm_madd_epi16(
+      _mm_mullo_epi16(hi, _mm_load_si128((const __m128i *)(wa + 8))),
+      _mm_mullo_epi16(hi, _mm_load_si128((const __m128i *)(wb + 8))));
+  return hsum_epi32(_mm_add_epi32(sum_lo, sum_hi));
+}
+
+int od_dir_find8_sse2(const int16_t *img, int stride, int32_t *var,
+                      int coeff_shift) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ones = _mm_set1_epi16(1);
+  const __m128i bias = _mm_set1_epi16(128);
+  // Partial sums of the directions, see od_dir_find8_c(). The 4th and 5th
+  // directions are accumulated in reverse order, which leaves their cost
+  // unchanged as the weights are symmetric.
+  __m128i p0_lo = zero, p0_hi = zero;
+  __m128i p1_lo = zero, p1_hi = zero;
+  __m128i p3_lo = zero, p3_hi = zero;
+  __m128i p4_lo = zero, p4_hi = zero;
+  __m128i p5_lo = zero, p5_hi = zero;
+  __m128i p7_lo = zero, p7_hi = zero;
+  __m128i p6 = zero;
+  __m128i p2;
+  __m128i rows[8];
+  int32_t cost[8];
+  int32_t best_cost = 0;
+  int best_dir = 0;
+  int i;
+
+  for (i = 0; i < 8; i++) {
+    rows[i] = _mm_sub_epi16(
+        _mm_sra_epi16(_mm_loadu_si128((const __m128i *)(img + i * stride)),
+                      _mm_cvtsi32_si128(coeff_shift)),
+        bias);
+    p6 = _mm_add_epi16(p6, rows[i]);
+  }
+
+#define ACCUMULATE_ROW(i)                                                  \
+  do {                                                                     \
+    const __m128i pairs =                                                  \
+        _mm_packs_epi32(_mm_madd_epi16(rows[i], ones), zero);              \
+    ACCUMULATE_SHIFTED(p0_lo, p0_hi, rows[i], i);                          \
+    ACCUMULATE_SHIFTED(p4_lo, p4_hi, rows[i], 7 - (i));                    \
+    ACCUMULATE_SHIFTED(p5_lo, p5_hi, rows[i], 3 - (i) / 2);                \
+    ACCUMULATE_SHIFTED(p7_lo, p7_hi, rows[i], (i) / 2);                    \
+    ACCUMULATE_SHIFTED(p1_lo, p1_hi, pairs, i);                            \
+    ACCUMULATE_SHIFTED(p3_lo, p3_hi, pairs, 7 - (i));                      \
+  } while (0)
+  ACCUMULATE_ROW(0);
+  ACCUMULATE_ROW(1);
+  ACCUMULATE_ROW(2);
+  ACCUMULATE_ROW(3);
+  ACCUMULATE_ROW(4);
+  ACCUMULATE_ROW(5);
+  ACCUMULATE_ROW(6);
+  ACCUMULATE_ROW(7);
+#undef ACCUMULATE_ROW
+
+  // Horizontal direction: the sum of each row.
+  p2 = _mm_packs_epi32(
+      hsum4_epi32(_mm_madd_epi16(rows[0], ones), _mm_madd_epi16(rows[1], ones),
+                  _mm_madd_epi16(rows[2], ones),
+                  _mm_madd_epi16(rows[3], ones)),
+      hsum4_epi32(_mm_madd_epi16(rows[4], ones), _mm_madd_epi16(rows[5], ones),
+                  _mm_madd_epi16(rows[6], ones),
+                  _mm_madd_epi16(rows[7], ones)));
+  cost[2] = hsum_epi32(_mm_madd_epi16(p2, p2)) * 105;
+  cost[6] = hsum_epi32(_mm_madd_epi16(p6, p6)) * 105;
+
+  cost[0] = partial_cost(p0_lo, p0_hi, kDiagWeightsA, kDiagWeightsB);
+  cost[4] = partial_cost(p4_lo, p4_hi, kDiagWeightsA, kDiagWeightsB);
+  cost[1] = partial_cost(p1_lo, p1_hi, kObliqueWeightsA, kObliqueWeightsB);
+  cost[3] = partial_cost(p3_lo, p3_hi, kObliqueWeightsA, kObliqueWeightsB);
+  cost[5] = partial_cost(p5_lo, p5_hi, kObliqueWeightsA, kObliqueWeightsB);
+  cost[7] = partial_cost(p7_lo, p7_hi, kObliqueWeightsA, kObliqueWeightsB);
+
+  for (i = 0; i < 8; i++) {
+    if (cost[i] > best_cost) {
+      best_cost = cost[i];
+      best_dir = i;
+    }
+  }
+  *var = (best_cost - cost[(best_dir + 4) & 7]) >> 10;
+  return best_dir;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <smmintrin.h>  // SSE4.1
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+#include "aom_ports/mem.h"
+
+// Weights of the squared partial sums of each direction, i.e. the
+// div_table[] factors of od_dir_find8_c(). The diagonal directions have 15
+// partial sums, the other oblique directions 11.
+DECLARE_ALIGNED(16, static const int32_t, kDiagWeights[16]) = {
+  840, 420, 280, 210, 168, 140, 120, 105, 120, 140, 168, 210, 280, 420, 840, 0
+};
+DECLARE_ALIGNED(16, static const int32_t, kObliqueWeights[16]) = {
+  420, 210, 140, 105, 105, 105, 105, 105, 140, 210, 420, 0, 0, 0, 0, 0
+};
+
+// Shift the 8 partial sums in v up by n lanes into the 16 lanes lo:hi.
+#define ACCUMULATE_SHIFTED(lo, hi, v, n)                        \
+  do {                                                          \
+    lo = _mm_add_epi16(lo, _mm_slli_si128(v, 2 * (n)));         \
+    hi = _mm_add_epi16(hi, _mm_srli_si128(v, 16 - 2 * (n)));    \
+  } while (0)
+
+// Return the weighted sum of squares of 4 partial sums.
+static INLINE __m128i weighted_sq(__m128i v, const int32_t *w) {
+  const __m128i v32 = _mm_cvtepi16_epi32(v);
+  return _mm_mullo_epi32(_mm_mullo_epi32(v32, v32),
+                         _mm_load_si128((const __m128i *)w));
+}
+
+// Return the weighted sum of squares of the 16 partial sums lo:hi.
+static INLINE int32_t partial_cost(__m128i lo, __m128i hi, const int32_t *w) {
+  __m128i sum = _mm_add_epi32(weighted_sq(lo, w),
+                              weighted_sq(_mm_srli_si128(lo, 8), w + 4));
+  sum = _mm_add_epi32(sum, weighted_sq(hi, w + 8));
+  sum = _mm_add_epi32(sum, weighted_sq(_mm_srli_si128(hi, 8), w + 12));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+  return _mm_cvtsi128_si32(sum);
+}
+
+// Return the sum of squares of the 8 partial sums in v.
+static INLINE __m128i sq_sum(__m128i v) { return _mm_madd_epi16(v, v); }
+
+int od_dir_find8_sse4_1(const int16_t *img, int stride, int32_t *var,
+                        int coeff_shift) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ones = _mm_set1_epi16(1);
+  const __m128i bias = _mm_set1_epi16(128);
+  // Partial sums of the directions, see od_dir_find8_c(). The 4th and 5th
+  // directions are accumulated in reverse order, which leaves their cost
+  // unchanged as the weights are symmetric.
+  __m128i p0_lo = zero, p0_hi = zero;
+  __m128i p1_lo = zero, p1_hi = zero;
+  __m128i p3_lo = zero, p3_hi = zero;
+  __m128i p4_lo = zero, p4_hi = zero;
+  __m128i p5_lo = zero, p5_hi = zero;
+  __m128i p7_lo = zero, p7_hi = zero;
+  __m128i p6 = zero;
+  __m128i rows[8];
+  __m128i c2;
+  int32_t cost[8];
+  int32_t best_cost = 0;
+  int best_dir = 0;
+  int i;
+
+  for (i = 0; i < 8; i++) {
+    rows[i] = _mm_sub_epi16(
+        _mm_sra_epi16(_mm_loadu_si128((const __m128i *)(img + i * stride)),
+                      _mm_cvtsi32_si128(coeff_shift)),
+        bias);
+    p6 = _mm_add_epi16(p6, rows[i]);
+  }
+
+#define ACCUMULATE_ROW(i)                                                  \
+  do {                                                                     \
+    const __m128i pairs = _mm_hadd_epi16(rows[i], zero);                   \
+    ACCUMULATE_SHIFTED(p0_lo, p0_hi, rows[i], i);                          \
+    ACCUMULATE_SHIFTED(p4_lo, p4_hi, rows[i], 7 - (i));                    \
+    ACCUMULATE_SHIFTED(p5_lo, p5_hi, rows[i], 3 - (i) / 2);                \
+    ACCUMULATE_SHIFTED(p7_lo, p7_hi, rows[i], (i) / 2);                    \
+    ACCUMULATE_SHIFTED(p1_lo, p1_hi, pairs, i);                            \
+    ACCUMULATE_SHIFTED(p3_lo, p3_hi, pairs, 7 - (i));                      \
+  } while (0)
+  ACCUMULATE_ROW(0);
+  ACCUMULATE_ROW(1);
+  ACCUMULATE_ROW(2);
+  ACCUMULATE_ROW(3);
+  ACCUMULATE_ROW(4);
+  ACCUMULATE_ROW(5);
+  ACCUMULATE_ROW(6);
+  ACCUMULATE_ROW(7);
+#undef ACCUMULATE_ROW
+
+  // Horizontal direction: the sum of each row.
+  c2 = _mm_hadd_epi32(
+      _mm_hadd_epi32(_mm_madd_epi16(rows[0], ones),
+                     _mm_madd_epi16(rows[1], ones)),
+      _mm_hadd_epi32(_mm_madd_epi16(rows[2], ones),
+                     _mm_madd_epi16(rows[3], ones)));
+  c2 = _mm_mullo_epi32(c2, c2);
+  {
+    __m128i c2b = _mm_hadd_epi32(
+        _mm_hadd_epi32(_mm_madd_epi16(rows[4], ones),
+                       _mm_madd_epi16(rows[5], ones)),
+        _mm_hadd_epi32(_mm_madd_epi16(rows[6], ones),
+                       _mm_madd_epi16(rows[7], ones)));
+    c2 = _mm_add_epi32(c2, _mm_mullo_epi32(c2b, c2b));
+  }
+  c2 = _mm_hadd_epi32(c2, sq_sum(p6));
+  c2 = _mm_hadd_epi32(c2, c2);
+  cost[2] = _mm_cvtsi128_si32(c2) * 105;
+  cost[6] = _mm_extract_epi32(c2, 1) * 105;
+
+  cost[0] = partial_cost(p0_lo, p0_hi, kDiagWeights);
+  cost[4] = partial_cost(p4_lo, p4_hi, kDiagWeights);
+  cost[1] = partial_cost(p1_lo, p1_hi, kObliqueWeights);
+  cost[3] = partial_cost(p3_lo, p3_hi, kObliqueWeights);
+  cost[5] = partial_cost(p5_lo, p5_hi, kObliqueWeights);
+  cost[7] = partial_cost(p7_lo, p7_hi, kObliqueWeights);
+
+  for (i = 0; i < 8; i++) {
+    if (cost[i] > best_cost) {
+      best_cost = cost[i];
+      best_dir = i;
+    }
+  }
+  *var = (best_cost - cost[(best_dir + 4) & 7]) >> 10;
+  return best_dir;
+}
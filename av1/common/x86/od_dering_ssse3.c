@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <tmmintrin.h>  // SSSE3
+
+#include "./aom_config.h"
+
+#define ABS_EPI16(x) _mm_abs_epi16(x)
+#define OD_FILTER_DERING_DIRECTION_4X4 od_filter_dering_direction_4x4_ssse3
+#define OD_FILTER_DERING_DIRECTION_8X8 od_filter_dering_direction_8x8_ssse3
+#define OD_FILTER_DERING_ORTHOGONAL_4X4 od_filter_dering_orthogonal_4x4_ssse3
+#define OD_FILTER_DERING_ORTHOGONAL_8X8 od_filter_dering_orthogonal_8x8_ssse3
+#include "av1/common/x86/od_dering_impl_sse2.h"
+#undef OD_FILTER_DERING_DIRECTION_4X4
+#undef OD_FILTER_DERING_DIRECTION_8X8
+#undef OD_FILTER_DERING_ORTHOGONAL_4X4
+#undef OD_FILTER_DERING_ORTHOGONAL_8X8
+#undef ABS_EPI16
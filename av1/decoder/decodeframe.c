@@ -788,9 +788,64 @@ static MB_MODE_INFO *set_offsets(AV1_COMMON *const cm, MACROBLOCKD *const xd,
   return &xd->mi[0]->mbmi;
 }
 
+// Read position in the row-based multi-threaded decoding coefficient buffers
+// of one superblock. The parsing pass appends the end-of-block position of
+// every coded transform block and its coefficients up to it in scan order,
+// and the reconstruction pass consumes them in the same order. Only the
+// coded coefficients are stored, so the buffers stay small and the dense
+// transform blocks never leave the cache of the thread using them.
+typedef struct SbCoeffCursor {
+  tran_low_t *dqcoeff[MAX_MB_PLANE];
+  uint16_t *eob[MAX_MB_PLANE];
+} SbCoeffCursor;
+
+#if CONFIG_MULTITHREAD
+static void init_sb_coeff_cursor(AV1Decoder *const pbi,
+                                 const MACROBLOCKD *const xd, int sb_idx,
+                                 SbCoeffCursor *const cursor) {
+  int plane;
+  for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+    const struct macroblockd_plane *const pd = &xd->plane[plane];
+    const int ss = pd->subsampling_x + pd->subsampling_y;
+    cursor->dqcoeff[plane] =
+        pbi->row_mt_dqcoeff[plane] + sb_idx * ((64 * 64) >> ss);
+    cursor->eob[plane] = pbi->row_mt_eob[plane] + sb_idx * ((16 * 16) >> ss);
+  }
+}
+#endif  // CONFIG_MULTITHREAD
+
+static int parse_block_tokens(MACROBLOCKD *const xd, aom_reader *r,
+                              MB_MODE_INFO *const mbmi, int plane, int row,
+                              int col, TX_SIZE tx_size,
+                              SbCoeffCursor *const cursor) {
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  PLANE_TYPE plane_type = (plane == 0) ? PLANE_TYPE_Y : PLANE_TYPE_UV;
+  int block_idx = (row << 1) + col;
+  TX_TYPE tx_type = get_tx_type(plane_type, xd, block_idx);
+  const scan_order *sc = get_scan(tx_size, tx_type);
+  const int eob = av1_decode_block_tokens(xd, plane, sc, col, row, tx_size, r,
+                                           mbmi->segment_id);
+  tran_low_t *const dqcoeff = pd->dqcoeff;
+  tran_low_t *const out = cursor->dqcoeff[plane];
+  int i;
+
+  // Leave the transform block cleared for the next one.
+  for (i = 0; i < eob; ++i) {
+    out[i] = dqcoeff[sc->scan[i]];
+    dqcoeff[sc->scan[i]] = 0;
+  }
+  *cursor->eob[plane]++ = eob;
+  cursor->dqcoeff[plane] += eob;
+  return eob;
+}
+
+// When 'cursor' is not NULL, only the mode info and the coefficients of the
+// block are decoded, and the coefficients are stored for a later
+// reconstruct_block().
 static void decode_block(AV1Decoder *const pbi, MACROBLOCKD *const xd,
                          int mi_row, int mi_col, aom_reader *r,
-                         BLOCK_SIZE bsize, int bwl, int bhl) {
+                         BLOCK_SIZE bsize, int bwl, int bhl,
+                         SbCoeffCursor *const cursor) {
   AV1_COMMON *const cm = &pbi->common;
   const int less8x8 = bsize < BLOCK_8X8;
   const int bw = 1 << (bwl - 1);
@@ -836,18 +891,29 @@ static void decode_block(AV1Decoder *const pbi, MACROBLOCKD *const xd,
                            : xd->mb_to_bottom_edge >> (5 + pd->subsampling_y));
 
       for (row = 0; row < max_blocks_high; row += step)
-        for (col = 0; col < max_blocks_wide; col += step)
-          predict_and_reconstruct_intra_block(xd, r, mbmi, plane, row, col,
-                                              tx_size);
+        for (col = 0; col < max_blocks_wide; col += step) {
+          if (cursor) {
+            if (!mbmi->skip)
+              parse_block_tokens(xd, r, mbmi, plane, row, col, tx_size,
+                                 cursor);
+          } else {
+            predict_and_reconstruct_intra_block(xd, r, mbmi, plane, row, col,
+                                                tx_size);
+          }
+        }
     }
   } else {
     // Prediction
-    dec_build_inter_predictors_sb(pbi, xd, mi_row, mi_col);
+    if (!cursor) dec_build_inter_predictors_sb(pbi, xd, mi_row, mi_col);
 
     // Reconstruction
     if (!mbmi->skip) {
       int eobtotal = 0;
       int plane;
+#if !CONFIG_MISC_FIXES
+      SbCoeffCursor block_start;
+      if (cursor) block_start = *cursor;
+#endif
 
       for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
         const struct macroblockd_plane *const pd = &xd->plane[plane];
@@ -870,15 +936,22 @@ static void decode_block(AV1Decoder *const pbi, MACROBLOCKD *const xd,
         for (row = 0; row < max_blocks_high; row += step)
           for (col = 0; col < max_blocks_wide; col += step)
             eobtotal +=
-                reconstruct_inter_block(xd, r, mbmi, plane, row, col, tx_size);
+                cursor ? parse_block_tokens(xd, r, mbmi, plane, row, col,
+                                            tx_size, cursor)
+                       : reconstruct_inter_block(xd, r, mbmi, plane, row, col,
+                                                 tx_size);
       }
 
-      if (!less8x8 && eobtotal == 0)
+      if (!less8x8 && eobtotal == 0) {
 #if CONFIG_MISC_FIXES
         mbmi->has_no_coeffs = 1;  // skip loopfilter
 #else
         mbmi->skip = 1;  // skip loopfilter
+        // The reconstruction pass will skip this block, so drop its (all
+        // zero) coefficients from the superblock buffer.
+        if (cursor) *cursor = block_start;
 #endif
+      }
     }
   }
 
@@ -934,7 +1007,8 @@ static PARTITION_TYPE read_partition(AV1_COMMON *cm, MACROBLOCKD *xd,
 // TODO(slavarnway): eliminate bsize and subsize in future commits
 static void decode_partition(AV1Decoder *const pbi, MACROBLOCKD *const xd,
                              int mi_row, int mi_col, aom_reader *r,
-                             BLOCK_SIZE bsize, int n4x4_l2) {
+                             BLOCK_SIZE bsize, int n4x4_l2,
+                             SbCoeffCursor *const cursor) {
   AV1_COMMON *const cm = &pbi->common;
   const int n8x8_l2 = n4x4_l2 - 1;
   const int num_8x8_wh = 1 << n8x8_l2;
@@ -953,30 +1027,36 @@ static void decode_partition(AV1Decoder *const pbi, MACROBLOCKD *const xd,
     // calculate bmode block dimensions (log 2)
     xd->bmode_blocks_wl = 1 >> !!(partition & PARTITION_VERT);
     xd->bmode_blocks_hl = 1 >> !!(partition & PARTITION_HORZ);
-    decode_block(pbi, xd, mi_row, mi_col, r, subsize, 1, 1);
+    decode_block(pbi, xd, mi_row, mi_col, r, subsize, 1, 1, cursor);
   } else {
     switch (partition) {
       case PARTITION_NONE:
-        decode_block(pbi, xd, mi_row, mi_col, r, subsize, n4x4_l2, n4x4_l2);
+        decode_block(pbi, xd, mi_row, mi_col, r, subsize, n4x4_l2, n4x4_l2,
+                     cursor);
         break;
       case PARTITION_HORZ:
-        decode_block(pbi, xd, mi_row, mi_col, r, subsize, n4x4_l2, n8x8_l2);
+        decode_block(pbi, xd, mi_row, mi_col, r, subsize, n4x4_l2, n8x8_l2,
+                     cursor);
         if (has_rows)
           decode_block(pbi, xd, mi_row + hbs, mi_col, r, subsize, n4x4_l2,
-                       n8x8_l2);
+                       n8x8_l2, cursor);
         break;
       case PARTITION_VERT:
-        decode_block(pbi, xd, mi_row, mi_col, r, subsize, n8x8_l2, n4x4_l2);
+        decode_block(pbi, xd, mi_row, mi_col, r, subsize, n8x8_l2, n4x4_l2,
+                     cursor);
         if (has_cols)
           decode_block(pbi, xd, mi_row, mi_col + hbs, r, subsize, n8x8_l2,
-                       n4x4_l2);
+                       n4x4_l2, cursor);
         break;
       case PARTITION_SPLIT:
-        decode_partition(pbi, xd, mi_row, mi_col, r, subsize, n8x8_l2);
-        decode_partition(pbi, xd, mi_row, mi_col + hbs, r, subsize, n8x8_l2);
-        decode_partition(pbi, xd, mi_row + hbs, mi_col, r, subsize, n8x8_l2);
+        decode_partition(pbi, xd, mi_row, mi_col, r, subsize, n8x8_l2,
+                         cursor);
+        decode_partition(pbi, xd, mi_row, mi_col + hbs, r, subsize, n8x8_l2,
+                         cursor);
+        decode_partition(pbi, xd, mi_row + hbs, mi_col, r, subsize, n8x8_l2,
+                         cursor);
         decode_partition(pbi, xd, mi_row + hbs, mi_col + hbs, r, subsize,
-                         n8x8_l2);
+                         n8x8_l2, cursor);
         break;
       default: assert(0 && "Invalid partition type");
     }
@@ -999,6 +1079,141 @@ static void decode_partition(AV1Decoder *const pbi, MACROBLOCKD *const xd,
 #endif
 }
 
+#if CONFIG_MULTITHREAD
+// Reconstruct a block from the mode info and the coefficients stored by the
+// parsing pass of row-based multi-threaded decoding.
+static void reconstruct_block(AV1Decoder *const pbi, MACROBLOCKD *const xd,
+                              int mi_row, int mi_col, int bwl, int bhl,
+                              SbCoeffCursor *const cursor) {
+  AV1_COMMON *const cm = &pbi->common;
+  const int bw = 1 << (bwl - 1);
+  const int bh = 1 << (bhl - 1);
+  MB_MODE_INFO *mbmi;
+  int plane;
+
+  xd->mi = cm->mi_grid_visible + mi_row * cm->mi_stride + mi_col;
+  mbmi = &xd->mi[0]->mbmi;
+  set_plane_n4(xd, bw, bh, bwl, bhl);
+  set_mi_row_col(xd, &xd->tile, mi_row, bh, mi_col, bw, cm->mi_rows,
+                 cm->mi_cols);
+  av1_setup_dst_planes(xd->plane, get_frame_new_buffer(cm), mi_row, mi_col);
+
+  if (is_inter_block(mbmi)) {
+    int ref;
+    for (ref = 0; ref < 1 + has_second_ref(mbmi); ++ref) {
+      RefBuffer *ref_buf = &cm->frame_refs[mbmi->ref_frame[ref] - LAST_FRAME];
+      xd->block_refs[ref] = ref_buf;
+      av1_setup_pre_planes(xd, ref, ref_buf->buf, mi_row, mi_col,
+                           &ref_buf->sf);
+    }
+    dec_build_inter_predictors_sb(pbi, xd, mi_row, mi_col);
+    if (mbmi->skip) return;
+  }
+
+  for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+    struct macroblockd_plane *const pd = &xd->plane[plane];
+    const PLANE_TYPE plane_type = (plane == 0) ? PLANE_TYPE_Y : PLANE_TYPE_UV;
+    const TX_SIZE tx_size =
+        plane ? dec_get_uv_tx_size(mbmi, pd->n4_wl, pd->n4_hl) : mbmi->tx_size;
+    const int step = (1 << tx_size);
+    int row, col;
+    const int max_blocks_wide =
+        pd->n4_w + (xd->mb_to_right_edge >= 0
+                        ? 0
+                        : xd->mb_to_right_edge >> (5 + pd->subsampling_x));
+    const int max_blocks_high =
+        pd->n4_h + (xd->mb_to_bottom_edge >= 0
+                        ? 0
+                        : xd->mb_to_bottom_edge >> (5 + pd->subsampling_y));
+
+    for (row = 0; row < max_blocks_high; row += step) {
+      for (col = 0; col < max_blocks_wide; col += step) {
+        uint8_t *const dst =
+            &pd->dst.buf[4 * row * pd->dst.stride + 4 * col];
+        const int block_idx = (row << 1) + col;
+        int eob;
+
+        if (!is_inter_block(mbmi)) {
+          PREDICTION_MODE mode = (plane == 0) ? mbmi->mode : mbmi->uv_mode;
+          if (mbmi->sb_type < BLOCK_8X8 && plane == 0)
+            mode = xd->mi[0]->bmi[block_idx].as_mode;
+          av1_predict_intra_block(xd, pd->n4_wl, pd->n4_hl, tx_size, mode,
+                                  dst, pd->dst.stride, dst, pd->dst.stride,
+                                  col, row, plane);
+          if (mbmi->skip) continue;
+        }
+
+        eob = *cursor->eob[plane]++;
+        if (eob > 0) {
+          const TX_TYPE tx_type = get_tx_type(plane_type, xd, block_idx);
+          const int16_t *const scan = get_scan(tx_size, tx_type)->scan;
+          int i;
+          for (i = 0; i < eob; ++i)
+            pd->dqcoeff[scan[i]] = cursor->dqcoeff[plane][i];
+          cursor->dqcoeff[plane] += eob;
+          if (is_inter_block(mbmi))
+            inverse_transform_block_inter(xd, plane, tx_size, dst,
+                                          pd->dst.stride, eob, block_idx);
+          else
+            inverse_transform_block_intra(xd, plane, tx_type, tx_size, dst,
+                                          pd->dst.stride, eob);
+        }
+      }
+    }
+  }
+}
+
+static void reconstruct_partition(AV1Decoder *const pbi,
+                                  MACROBLOCKD *const xd, int mi_row,
+                                  int mi_col, BLOCK_SIZE bsize, int n4x4_l2,
+                                  SbCoeffCursor *const cursor) {
+  AV1_COMMON *const cm = &pbi->common;
+  const int n8x8_l2 = n4x4_l2 - 1;
+  const int hbs = (1 << n8x8_l2) >> 1;
+  const int bsl = b_width_log2_lookup[bsize];
+  PARTITION_TYPE partition;
+
+  if (mi_row >= cm->mi_rows || mi_col >= cm->mi_cols) return;
+
+  partition = partition_lookup[bsl][cm->mi_grid_visible[mi_row * cm->mi_stride +
+                                                        mi_col]->mbmi.sb_type];
+  if (!hbs) {
+    reconstruct_block(pbi, xd, mi_row, mi_col, 1, 1, cursor);
+  } else {
+    const BLOCK_SIZE subsize = subsize_lookup[partition][bsize];
+    switch (partition) {
+      case PARTITION_NONE:
+        reconstruct_block(pbi, xd, mi_row, mi_col, n4x4_l2, n4x4_l2, cursor);
+        break;
+      case PARTITION_HORZ:
+        reconstruct_block(pbi, xd, mi_row, mi_col, n4x4_l2, n8x8_l2, cursor);
+        if (mi_row + hbs < cm->mi_rows)
+          reconstruct_block(pbi, xd, mi_row + hbs, mi_col, n4x4_l2, n8x8_l2,
+                            cursor);
+        break;
+      case PARTITION_VERT:
+        reconstruct_block(pbi, xd, mi_row, mi_col, n8x8_l2, n4x4_l2, cursor);
+        if (mi_col + hbs < cm->mi_cols)
+          reconstruct_block(pbi, xd, mi_row, mi_col + hbs, n8x8_l2, n4x4_l2,
+                            cursor);
+        break;
+      case PARTITION_SPLIT:
+        reconstruct_partition(pbi, xd, mi_row, mi_col, subsize, n8x8_l2,
+                              cursor);
+        reconstruct_partition(pbi, xd, mi_row, mi_col + hbs, subsize, n8x8_l2,
+                              cursor);
+        reconstruct_partition(pbi, xd, mi_row + hbs, mi_col, subsize, n8x8_l2,
+                              cursor);
+        reconstruct_partition(pbi, xd, mi_row + hbs, mi_col + hbs, subsize,
+                              n8x8_l2, cursor);
+        break;
+      default: assert(0 && "Invalid partition type");
+    }
+  }
+}
+
+#endif  // CONFIG_MULTITHREAD
+
 static void setup_token_decoder(const uint8_t *data, const uint8_t *data_end,
                                 size_t read_size,
                                 struct aom_internal_error_info *error_info,
@@ -1502,6 +1717,76 @@ static void get_tile_buffers(AV1Decoder *pbi, const uint8_t *data,
   }
 }
 
+// The single-threaded decoder runs the in-loop filters one superblock row at
+// a time, as soon as the pixels they read are final, so that each row is
+// still in the cache when it is filtered. The loop filter of a row changes
+// the last lines of the row above it, so once it has reached mi row
+// 'lf_stop' all the rows but the last one it filtered are final. Return the
+// number of superblock rows that are final 'delay' rows later in the
+// pipeline.
+static int post_filter_rows_ready(const AV1_COMMON *cm, int lf_stop,
+                                  int delay) {
+  if (lf_stop >= cm->mi_rows)
+    return mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  return AOMMAX(0, (lf_stop >> MI_BLOCK_SIZE_LOG2) - delay);
+}
+
+// Return the number of pixel rows that are completely filtered once the loop
+// filter has reached mi row 'lf_stop'.
+static int post_filter_progress(const AV1_COMMON *cm, int lf_stop) {
+  int delay = 0;
+#if CONFIG_CLPF
+  if (cm->clpf) delay = 1;
+#endif
+#if CONFIG_DERING
+  if (cm->dering_level) delay = 2;
+#endif
+  return post_filter_rows_ready(cm, lf_stop, delay)
+         << (MI_BLOCK_SIZE_LOG2 + MI_SIZE_LOG2);
+}
+
+// Loop filter the mi rows described by 'lf_data', then run CLPF and
+// deringing on the superblock rows that this has made final.
+static int post_filter_worker(LFWorkerData *const lf_data, void *unused) {
+  AV1_COMMON *const cm = lf_data->cm;
+  (void)unused;
+
+  if (cm->lf.filter_level)
+    av1_loop_filter_rows(lf_data->frame_buffer, cm, lf_data->planes,
+                         lf_data->start, lf_data->stop, lf_data->y_only);
+#if CONFIG_CLPF
+  // CLPF reads the first line of the row below, which the loop filter of
+  // the row after it leaves unchanged.
+  if (cm->clpf) {
+    int sbr;
+    for (sbr = post_filter_rows_ready(cm, lf_data->start, 1);
+         sbr < post_filter_rows_ready(cm, lf_data->stop, 1); ++sbr) {
+      int mi_col;
+      for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE)
+        av1_clpf_sb(lf_data->frame_buffer, cm, lf_data->planes,
+                    sbr * MI_BLOCK_SIZE, mi_col);
+    }
+  }
+#endif
+#if CONFIG_DERING
+  // A row boundary is saved once the rows on both sides are final but for
+  // deringing. A row is deringed once the boundary below it is saved, which
+  // is also after CLPF of the row below has read its last line.
+  if (cm->dering_level) {
+    int sbr;
+    for (sbr = AOMMAX(1, post_filter_rows_ready(cm, lf_data->start, 1));
+         sbr < post_filter_rows_ready(cm, lf_data->stop, 1); ++sbr)
+      av1_dering_save_boundary(lf_data->frame_buffer, cm, lf_data->planes,
+                               sbr);
+    for (sbr = post_filter_rows_ready(cm, lf_data->start, 2);
+         sbr < post_filter_rows_ready(cm, lf_data->stop, 2); ++sbr)
+      av1_dering_sb_row(lf_data->frame_buffer, cm, lf_data->planes,
+                        cm->dering_level, sbr, 0);
+  }
+#endif  // CONFIG_DERING
+  return 1;
+}
+
 static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
                                    const uint8_t *data_end) {
   AV1_COMMON *const cm = &pbi->common;
@@ -1513,24 +1798,35 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
   int tile_row, tile_col;
   int mi_row, mi_col;
   TileData *tile_data = NULL;
+  int post_filter = cm->lf.filter_level != 0;
+
+#if CONFIG_CLPF
+  post_filter |= cm->clpf;
+#endif
+#if CONFIG_DERING
+  post_filter |= cm->dering_level != 0;
+#endif
+  post_filter &= !cm->skip_loop_filter;
 
-  if (cm->lf.filter_level && !cm->skip_loop_filter &&
-      pbi->lf_worker.data1 == NULL) {
+  if (post_filter && pbi->lf_worker.data1 == NULL) {
     CHECK_MEM_ERROR(cm, pbi->lf_worker.data1,
                     aom_memalign(32, sizeof(LFWorkerData)));
-    pbi->lf_worker.hook = (AVxWorkerHook)av1_loop_filter_worker;
+    pbi->lf_worker.hook = (AVxWorkerHook)post_filter_worker;
     if (pbi->max_threads > 1 && !winterface->reset(&pbi->lf_worker)) {
       aom_internal_error(&cm->error, AOM_CODEC_ERROR,
                          "Loop filter thread creation failed");
     }
   }
 
-  if (cm->lf.filter_level && !cm->skip_loop_filter) {
+  if (post_filter) {
     LFWorkerData *const lf_data = (LFWorkerData *)pbi->lf_worker.data1;
     // Be sure to sync as we might be resuming after a failed frame decode.
     winterface->sync(&pbi->lf_worker);
     av1_loop_filter_data_reset(lf_data, get_frame_new_buffer(cm), cm,
                                 pbi->mb.plane);
+#if CONFIG_DERING
+    if (cm->dering_level) av1_dering_alloc(cm, 1);
+#endif
   }
 
   assert(tile_rows <= 4);
@@ -1592,15 +1888,15 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
         for (mi_col = tile.mi_col_start; mi_col < tile.mi_col_end;
              mi_col += MI_BLOCK_SIZE) {
           decode_partition(pbi, &tile_data->xd, mi_row, mi_col,
-                           &tile_data->bit_reader, BLOCK_64X64, 4);
+                           &tile_data->bit_reader, BLOCK_64X64, 4, NULL);
         }
         pbi->mb.corrupted |= tile_data->xd.corrupted;
         if (pbi->mb.corrupted)
           aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
                              "Failed to decode tile data");
       }
-      // Loopfilter one row.
-      if (cm->lf.filter_level && !cm->skip_loop_filter) {
+      // Filter one row.
+      if (post_filter) {
         const int lf_start = mi_row - MI_BLOCK_SIZE;
         LFWorkerData *const lf_data = (LFWorkerData *)pbi->lf_worker.data1;
 
@@ -1621,29 +1917,21 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
       }
       // After loopfiltering, the last 7 row pixels in each superblock row may
       // still be changed by the longest loopfilter of the next superblock
-      // row.
+      // row. CLPF and deringing lag further behind.
       if (cm->frame_parallel_decode)
-        av1_frameworker_broadcast(pbi->cur_buf, mi_row << MI_BLOCK_SIZE_LOG2);
+        av1_frameworker_broadcast(pbi->cur_buf,
+                                  post_filter_progress(cm, mi_row));
     }
   }
 
-  // Loopfilter remaining rows in the frame.
-  if (cm->lf.filter_level && !cm->skip_loop_filter) {
+  // Filter remaining rows in the frame.
+  if (post_filter) {
     LFWorkerData *const lf_data = (LFWorkerData *)pbi->lf_worker.data1;
     winterface->sync(&pbi->lf_worker);
     lf_data->start = lf_data->stop;
     lf_data->stop = cm->mi_rows;
     winterface->execute(&pbi->lf_worker);
   }
-#if CONFIG_CLPF
-  if (cm->clpf && !cm->skip_loop_filter)
-    av1_clpf_frame(&pbi->cur_buf->buf, cm, &pbi->mb);
-#endif
-#if CONFIG_DERING
-  if (cm->dering_level && !cm->skip_loop_filter) {
-    av1_dering_frame(&pbi->cur_buf->buf, cm, &pbi->mb, cm->dering_level);
-  }
-#endif  // CONFIG_DERING
 
   // Get last tile data.
   tile_data = pbi->tile_data + tile_cols * tile_rows - 1;
@@ -1653,9 +1941,22 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
   return aom_reader_find_end(&tile_data->bit_reader);
 }
 
+// A tile column handed to a tile worker.
+typedef struct TileColumnJob {
+  TileBuffer (*tile_buffers)[1 << 6];
+  const uint8_t *data_end;
+  int tile_col;
+} TileColumnJob;
+
+// Decodes the tiles of a tile column from the top tile row down. A tile only
+// depends on the tile above it, through the above context of its column, so
+// the worker never waits on another one.
 static int tile_worker_hook(TileWorkerData *const tile_data,
-                            const TileInfo *const tile) {
-  int mi_row, mi_col;
+                            const TileColumnJob *const job) {
+  AV1Decoder *const pbi = tile_data->pbi;
+  AV1_COMMON *const cm = &pbi->common;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  int tile_row, mi_row, mi_col;
 
   if (setjmp(tile_data->error_info.jmp)) {
     tile_data->error_info.setjmp = 0;
@@ -1666,14 +1967,26 @@ static int tile_worker_hook(TileWorkerData *const tile_data,
   tile_data->error_info.setjmp = 1;
   tile_data->xd.error_info = &tile_data->error_info;
 
-  for (mi_row = tile->mi_row_start; mi_row < tile->mi_row_end;
-       mi_row += MI_BLOCK_SIZE) {
-    av1_zero(tile_data->xd.left_context);
-    av1_zero(tile_data->xd.left_seg_context);
-    for (mi_col = tile->mi_col_start; mi_col < tile->mi_col_end;
-         mi_col += MI_BLOCK_SIZE) {
-      decode_partition(tile_data->pbi, &tile_data->xd, mi_row, mi_col,
-                       &tile_data->bit_reader, BLOCK_64X64, 4);
+  for (tile_row = 0; tile_row < tile_rows && !tile_data->xd.corrupted;
+       ++tile_row) {
+    const TileBuffer *const buf = &job->tile_buffers[tile_row][job->tile_col];
+    TileInfo tile;
+
+    av1_tile_init(&tile, cm, tile_row, job->tile_col);
+    av1_tile_init(&tile_data->xd.tile, cm, tile_row, job->tile_col);
+    setup_token_decoder(buf->data, job->data_end, buf->size,
+                        &tile_data->error_info, &tile_data->bit_reader,
+                        pbi->decrypt_cb, pbi->decrypt_state);
+
+    for (mi_row = tile.mi_row_start; mi_row < tile.mi_row_end;
+         mi_row += MI_BLOCK_SIZE) {
+      av1_zero(tile_data->xd.left_context);
+      av1_zero(tile_data->xd.left_seg_context);
+      for (mi_col = tile.mi_col_start; mi_col < tile.mi_col_end;
+           mi_col += MI_BLOCK_SIZE) {
+        decode_partition(pbi, &tile_data->xd, mi_row, mi_col,
+                         &tile_data->bit_reader, BLOCK_64X64, 4, NULL);
+      }
     }
   }
   return !tile_data->xd.corrupted;
@@ -1686,22 +1999,11 @@ static int compare_tile_buffers(const void *a, const void *b) {
   return (int)(buf2->size - buf1->size);
 }
 
-static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
-                                      const uint8_t *data_end) {
+// Create the tile worker threads on first use. The last worker does not get
+// a thread of its own: its work is run on the calling thread.
+static void create_tile_workers(AV1Decoder *pbi) {
   AV1_COMMON *const cm = &pbi->common;
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
-  const uint8_t *bit_reader_end = NULL;
-  const int aligned_mi_cols = mi_cols_aligned_to_sb(cm->mi_cols);
-  const int tile_cols = 1 << cm->log2_tile_cols;
-  const int tile_rows = 1 << cm->log2_tile_rows;
-  const int num_workers = AOMMIN(pbi->max_threads & ~1, tile_cols);
-  TileBuffer tile_buffers[1][1 << 6];
-  int n;
-  int final_worker = -1;
-
-  assert(tile_cols <= (1 << 6));
-  assert(tile_rows == 1);
-  (void)tile_rows;
 
   // TODO(jzern): See if we can remove the restriction of passing in max
   // threads to the decoder.
@@ -1716,8 +2018,6 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
     CHECK_MEM_ERROR(
         cm, pbi->tile_worker_data,
         aom_memalign(32, num_threads * sizeof(*pbi->tile_worker_data)));
-    CHECK_MEM_ERROR(cm, pbi->tile_worker_info,
-                    aom_malloc(num_threads * sizeof(*pbi->tile_worker_info)));
     for (i = 0; i < num_threads; ++i) {
       AVxWorker *const worker = &pbi->tile_workers[i];
       ++pbi->num_tile_workers;
@@ -1729,6 +2029,27 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
       }
     }
   }
+}
+
+static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
+                                      const uint8_t *data_end) {
+  AV1_COMMON *const cm = &pbi->common;
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  const uint8_t *bit_reader_end = NULL;
+  const int aligned_mi_cols = mi_cols_aligned_to_sb(cm->mi_cols);
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  const int num_workers = AOMMIN(pbi->max_threads & ~1, tile_cols);
+  TileBuffer tile_buffers[4][1 << 6];
+  TileBuffer col_buffers[1 << 6];
+  TileColumnJob jobs[1 << 6];
+  int n;
+  int final_worker = -1;
+
+  assert(tile_cols <= (1 << 6));
+  assert(tile_rows <= 4);
+
+  create_tile_workers(pbi);
 
   // Reset tile decoding hook
   for (n = 0; n < num_workers; ++n) {
@@ -1736,7 +2057,7 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
     winterface->sync(worker);
     worker->hook = (AVxWorkerHook)tile_worker_hook;
     worker->data1 = &pbi->tile_worker_data[n];
-    worker->data2 = &pbi->tile_worker_info[n];
+    worker->data2 = &jobs[n];
   }
 
   // Note: this memset assumes above_context[0], [1] and [2]
@@ -1749,22 +2070,35 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
   // Load tile data into tile_buffers
   get_tile_buffers(pbi, data, data_end, tile_cols, tile_rows, tile_buffers);
 
-  // Sort the buffers based on size in descending order.
-  qsort(tile_buffers[0], tile_cols, sizeof(tile_buffers[0][0]),
-        compare_tile_buffers);
-
-  // Rearrange the tile buffers such that per-tile group the largest, and
-  // presumably the most difficult, tile will be decoded in the main thread.
-  // This should help minimize the number of instances where the main thread is
-  // waiting for a worker to complete.
+  // Tiles in the same column share the above context, so each tile depends on
+  // the one above it, while the tile columns are independent of each other.
+  // Each worker decodes a whole tile column through all the tile rows, so the
+  // tile rows do not have to wait for each other. Size the columns by the
+  // total size of their tiles.
+  for (n = 0; n < tile_cols; ++n) {
+    int tile_row;
+    col_buffers[n].data = tile_buffers[0][n].data;
+    col_buffers[n].size = 0;
+    col_buffers[n].col = n;
+    for (tile_row = 0; tile_row < tile_rows; ++tile_row)
+      col_buffers[n].size += tile_buffers[tile_row][n].size;
+  }
+
+  // Sort the columns based on size in descending order.
+  qsort(col_buffers, tile_cols, sizeof(col_buffers[0]), compare_tile_buffers);
+
+  // Rearrange the columns such that per-tile group the largest, and
+  // presumably the most difficult, column will be decoded in the main thread.
+  // This should help minimize the number of instances where the main thread
+  // is waiting for a worker to complete.
   {
     int group_start = 0;
     while (group_start < tile_cols) {
-      const TileBuffer largest = tile_buffers[0][group_start];
+      const TileBuffer largest = col_buffers[group_start];
       const int group_end = AOMMIN(group_start + num_workers, tile_cols) - 1;
-      memmove(tile_buffers[0] + group_start, tile_buffers[0] + group_start + 1,
-              (group_end - group_start) * sizeof(tile_buffers[0][0]));
-      tile_buffers[0][group_end] = largest;
+      memmove(col_buffers + group_start, col_buffers + group_start + 1,
+              (group_end - group_start) * sizeof(col_buffers[0]));
+      col_buffers[group_end] = largest;
       group_start = group_end + 1;
     }
   }
@@ -1786,8 +2120,12 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
     for (i = 0; i < num_workers && n < tile_cols; ++i) {
       AVxWorker *const worker = &pbi->tile_workers[i];
       TileWorkerData *const tile_data = (TileWorkerData *)worker->data1;
-      TileInfo *const tile = (TileInfo *)worker->data2;
-      TileBuffer *const buf = &tile_buffers[0][n];
+      TileColumnJob *const job = (TileColumnJob *)worker->data2;
+      const int tile_col = col_buffers[n].col;
+
+      job->tile_buffers = tile_buffers;
+      job->data_end = data_end;
+      job->tile_col = tile_col;
 
       tile_data->pbi = pbi;
       tile_data->xd = pbi->mb;
@@ -1797,11 +2135,6 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
               ? &tile_data->counts
               : NULL;
       av1_zero(tile_data->dqcoeff);
-      av1_tile_init(tile, cm, 0, buf->col);
-      av1_tile_init(&tile_data->xd.tile, cm, 0, buf->col);
-      setup_token_decoder(buf->data, data_end, buf->size, &cm->error,
-                          &tile_data->bit_reader, pbi->decrypt_cb,
-                          pbi->decrypt_state);
       av1_init_macroblockd(cm, &tile_data->xd, tile_data->dqcoeff);
       tile_data->xd.plane[0].color_index_map = tile_data->color_index_map[0];
       tile_data->xd.plane[1].color_index_map = tile_data->color_index_map[1];
@@ -1813,7 +2146,7 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
         winterface->launch(worker);
       }
 
-      if (buf->col == tile_cols - 1) {
+      if (tile_col == tile_cols - 1) {
         final_worker = i;
       }
 
@@ -1823,9 +2156,9 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
     for (; i > 0; --i) {
       AVxWorker *const worker = &pbi->tile_workers[i - 1];
       // TODO(jzern): The tile may have specific error data associated with
-      // its aom_internal_error_info which could be propagated to the main info
-      // in cm. Additionally once the threads have been synced and an error is
-      // detected, there's no point in continuing to decode tiles.
+      // its aom_internal_error_info which could be propagated to the main
+      // info in cm. Additionally once the threads have been synced and an
+      // error is detected, there's no point in continuing to decode tiles.
       pbi->mb.corrupted |= !winterface->sync(worker);
     }
     if (final_worker > -1) {
@@ -1835,20 +2168,245 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
       final_worker = -1;
     }
 
-    // Accumulate thread frame counts.
-    if (n >= tile_cols &&
-        cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD) {
-      for (i = 0; i < num_workers; ++i) {
-        TileWorkerData *const tile_data =
-            (TileWorkerData *)pbi->tile_workers[i].data1;
-        av1_accumulate_frame_counts(cm, &tile_data->counts, 1);
-      }
+    if (pbi->mb.corrupted) break;
+  }
+
+  // Accumulate thread frame counts, unless some tiles were left undecoded.
+  if (!pbi->mb.corrupted &&
+      cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD) {
+    int i;
+    for (i = 0; i < num_workers; ++i) {
+      TileWorkerData *const tile_data =
+          (TileWorkerData *)pbi->tile_workers[i].data1;
+      av1_accumulate_frame_counts(cm, &tile_data->counts, 1);
     }
   }
 
   return bit_reader_end;
 }
 
+#if CONFIG_MULTITHREAD
+// Reconstructs superblock rows handed out by the row-based multi-threaded
+// decoder, following the parsing thread and the row above.
+static int row_mt_worker_hook(TileWorkerData *const tile_data, void *unused) {
+  AV1Decoder *const pbi = tile_data->pbi;
+  AV1_COMMON *const cm = &pbi->common;
+  AV1RowMTSync *const row_mt_sync = &pbi->row_mt_sync;
+  const int sb_cols = mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
+  int sb_row;
+  (void)unused;
+
+  if (setjmp(tile_data->error_info.jmp)) {
+    tile_data->error_info.setjmp = 0;
+    tile_data->xd.corrupted = 1;
+    av1_row_mt_sync_abort(row_mt_sync);
+    return 0;
+  }
+
+  tile_data->error_info.setjmp = 1;
+  tile_data->xd.error_info = &tile_data->error_info;
+
+  while ((sb_row = av1_row_mt_sync_next_row(row_mt_sync)) >= 0) {
+    const int mi_row = sb_row << MI_BLOCK_SIZE_LOG2;
+    int sb_col;
+    for (sb_col = 0; sb_col < sb_cols; ++sb_col) {
+      SbCoeffCursor cursor;
+      if (!av1_row_mt_sync_recon_read(row_mt_sync, sb_row, sb_col)) break;
+      init_sb_coeff_cursor(pbi, &tile_data->xd, sb_row * sb_cols + sb_col,
+                           &cursor);
+      reconstruct_partition(pbi, &tile_data->xd, mi_row,
+                            sb_col << MI_BLOCK_SIZE_LOG2, BLOCK_64X64, 4,
+                            &cursor);
+      av1_row_mt_sync_recon_write(row_mt_sync, sb_row, sb_col);
+    }
+  }
+
+  tile_data->error_info.setjmp = 0;
+  return !tile_data->xd.corrupted;
+}
+
+// Allocate the per-superblock coefficient buffers and the row
+// synchronization used by row-based multi-threaded decoding.
+static void row_mt_alloc(AV1Decoder *pbi, int sb_rows, int sb_cols) {
+  AV1_COMMON *const cm = &pbi->common;
+  AV1RowMTSync *const row_mt_sync = &pbi->row_mt_sync;
+  int plane;
+
+  for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+    const struct macroblockd_plane *const pd = &pbi->mb.plane[plane];
+    const int ss = pd->subsampling_x + pd->subsampling_y;
+    const int size = sb_rows * sb_cols * ((64 * 64) >> ss);
+    if (size > pbi->row_mt_dqcoeff_size[plane]) {
+      aom_free(pbi->row_mt_dqcoeff[plane]);
+      aom_free(pbi->row_mt_eob[plane]);
+      pbi->row_mt_dqcoeff_size[plane] = 0;
+      // Each superblock gets room for all of its coefficients, of which the
+      // parsing pass only writes the coded ones.
+      CHECK_MEM_ERROR(cm, pbi->row_mt_dqcoeff[plane],
+                      aom_malloc(size * sizeof(*pbi->row_mt_dqcoeff[plane])));
+      CHECK_MEM_ERROR(cm, pbi->row_mt_eob[plane],
+                      aom_malloc((size >> 4) * sizeof(*pbi->row_mt_eob[plane])));
+      pbi->row_mt_dqcoeff_size[plane] = size;
+    }
+  }
+
+  if (row_mt_sync->rows != sb_rows || row_mt_sync->sb_cols != sb_cols) {
+    av1_row_mt_sync_dealloc(row_mt_sync);
+    av1_row_mt_sync_alloc(row_mt_sync, cm, sb_rows, sb_cols);
+  }
+  av1_row_mt_sync_reset(row_mt_sync);
+}
+
+// Row-based multi-threaded decoding of frames with a single tile column.
+// Entropy decoding of a tile is inherently serial, so the calling thread
+// parses every superblock and stores its coefficients, while the tile
+// workers reconstruct superblock rows in a wavefront behind it.
+static const uint8_t *decode_tiles_row_mt(AV1Decoder *pbi, const uint8_t *data,
+                                          const uint8_t *data_end) {
+  AV1_COMMON *const cm = &pbi->common;
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  const int aligned_cols = mi_cols_aligned_to_sb(cm->mi_cols);
+  const int sb_cols = aligned_cols >> MI_BLOCK_SIZE_LOG2;
+  const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  TileBuffer tile_buffers[4][1 << 6];
+  TileData *tile_data = NULL;
+  int tile_row, mi_row, mi_col;
+  int num_workers;
+  int n;
+
+  assert(tile_rows <= 4);
+  assert(cm->log2_tile_cols == 0);
+
+  create_tile_workers(pbi);
+  num_workers = pbi->num_tile_workers;
+
+  // Be sure to sync as we might be resuming after a failed frame decode.
+  for (n = 0; n < num_workers; ++n) winterface->sync(&pbi->tile_workers[n]);
+
+  row_mt_alloc(pbi, sb_rows, sb_cols);
+
+  // Note: this memset assumes above_context[0], [1] and [2]
+  // are allocated as part of the same buffer.
+  memset(cm->above_context, 0,
+         sizeof(*cm->above_context) * MAX_MB_PLANE * 2 * aligned_cols);
+
+  memset(cm->above_seg_context, 0,
+         sizeof(*cm->above_seg_context) * aligned_cols);
+
+  get_tile_buffers(pbi, data, data_end, 1, tile_rows, tile_buffers);
+
+  if (pbi->tile_data == NULL || tile_rows != pbi->total_tiles) {
+    aom_free(pbi->tile_data);
+    CHECK_MEM_ERROR(cm, pbi->tile_data,
+                    aom_memalign(32, tile_rows * (sizeof(*pbi->tile_data))));
+    pbi->total_tiles = tile_rows;
+  }
+
+  for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
+    const TileBuffer *const buf = &tile_buffers[tile_row][0];
+    tile_data = pbi->tile_data + tile_row;
+    tile_data->cm = cm;
+    tile_data->xd = pbi->mb;
+    tile_data->xd.corrupted = 0;
+    tile_data->xd.counts =
+        cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD
+            ? &cm->counts
+            : NULL;
+    av1_zero(tile_data->dqcoeff);
+    av1_tile_init(&tile_data->xd.tile, tile_data->cm, tile_row, 0);
+    setup_token_decoder(buf->data, data_end, buf->size, &cm->error,
+                        &tile_data->bit_reader, pbi->decrypt_cb,
+                        pbi->decrypt_state);
+    av1_init_macroblockd(cm, &tile_data->xd, tile_data->dqcoeff);
+    tile_data->xd.plane[0].color_index_map = tile_data->color_index_map[0];
+    tile_data->xd.plane[1].color_index_map = tile_data->color_index_map[1];
+  }
+
+  // Start the reconstruction workers. The last one runs on this thread once
+  // parsing is done.
+  for (n = 0; n < num_workers; ++n) {
+    AVxWorker *const worker = &pbi->tile_workers[n];
+    TileWorkerData *const worker_data = &pbi->tile_worker_data[n];
+
+    worker->hook = (AVxWorkerHook)row_mt_worker_hook;
+    worker->data1 = worker_data;
+    worker->data2 = NULL;
+    worker->had_error = 0;
+
+    worker_data->pbi = pbi;
+    worker_data->xd = pbi->mb;
+    worker_data->xd.corrupted = 0;
+    worker_data->xd.counts = NULL;
+    av1_zero(worker_data->dqcoeff);
+    av1_tile_init(&worker_data->xd.tile, cm, 0, 0);
+    av1_init_macroblockd(cm, &worker_data->xd, worker_data->dqcoeff);
+
+    if (n < num_workers - 1) winterface->launch(worker);
+  }
+
+  for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
+    tile_data = pbi->tile_data + tile_row;
+    for (mi_row = tile_data->xd.tile.mi_row_start;
+         mi_row < tile_data->xd.tile.mi_row_end; mi_row += MI_BLOCK_SIZE) {
+      const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
+      av1_zero(tile_data->xd.left_context);
+      av1_zero(tile_data->xd.left_seg_context);
+      for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
+        const int sb_col = mi_col >> MI_BLOCK_SIZE_LOG2;
+        SbCoeffCursor cursor;
+        init_sb_coeff_cursor(pbi, &tile_data->xd, sb_row * sb_cols + sb_col,
+                             &cursor);
+        decode_partition(pbi, &tile_data->xd, mi_row, mi_col,
+                         &tile_data->bit_reader, BLOCK_64X64, 4, &cursor);
+        av1_row_mt_sync_parse_write(&pbi->row_mt_sync, sb_row, sb_col);
+      }
+      pbi->mb.corrupted |= tile_data->xd.corrupted;
+      if (pbi->mb.corrupted) {
+        av1_row_mt_sync_abort(&pbi->row_mt_sync);
+        for (n = 0; n < num_workers; ++n)
+          winterface->sync(&pbi->tile_workers[n]);
+        aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
+                           "Failed to decode tile data");
+      }
+    }
+  }
+
+  winterface->execute(&pbi->tile_workers[num_workers - 1]);
+  for (n = 0; n < num_workers; ++n)
+    pbi->mb.corrupted |= !winterface->sync(&pbi->tile_workers[n]);
+
+  // Get last tile data.
+  tile_data = pbi->tile_data + tile_rows - 1;
+  return aom_reader_find_end(&tile_data->bit_reader);
+}
+#endif  // CONFIG_MULTITHREAD
+
+// Apply the loop filter and the filters that follow it to a frame decoded by
+// one of the multi-threaded decoders, using 'num_workers' tile workers.
+static void filter_frame_mt(AV1Decoder *pbi, int num_workers) {
+  AV1_COMMON *const cm = &pbi->common;
+  YV12_BUFFER_CONFIG *const new_fb = get_frame_new_buffer(cm);
+#if CONFIG_CLPF
+  if (cm->clpf) {
+    av1_loop_filter_clpf_frame_mt(new_fb, cm, pbi->mb.plane,
+                                  cm->lf.filter_level, pbi->tile_workers,
+                                  num_workers, &pbi->lf_row_sync);
+  } else
+#endif  // CONFIG_CLPF
+  {
+    av1_loop_filter_frame_mt(new_fb, cm, pbi->mb.plane, cm->lf.filter_level,
+                              0, 0, pbi->tile_workers, num_workers,
+                              &pbi->lf_row_sync);
+  }
+#if CONFIG_DERING
+  if (cm->dering_level) {
+    av1_dering_frame_mt(new_fb, cm, pbi->mb.plane, cm->dering_level,
+                        pbi->tile_workers, num_workers, &pbi->lf_row_sync);
+  }
+#endif  // CONFIG_DERING
+}
+
 static void error_handler(void *data) {
   AV1_COMMON *const cm = (AV1_COMMON *)data;
   aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME, "Truncated packet");
@@ -2372,7 +2930,6 @@ void av1_decode_frame(AV1Decoder *pbi, const uint8_t *data,
   uint8_t clear_data[MAX_AV1_HEADER_SIZE];
   const size_t first_partition_size = read_uncompressed_header(
       pbi, init_read_bit_buffer(pbi, &rb, data, data_end, clear_data));
-  const int tile_rows = 1 << cm->log2_tile_rows;
   const int tile_cols = 1 << cm->log2_tile_cols;
   YV12_BUFFER_CONFIG *const new_fb = get_frame_new_buffer(cm);
   xd->cur_buf = new_fb;
@@ -2431,21 +2988,37 @@ void av1_decode_frame(AV1Decoder *pbi, const uint8_t *data,
     av1_frameworker_unlock_stats(worker);
   }
 
-  if (pbi->max_threads > 1 && tile_rows == 1 && tile_cols > 1) {
+  if (pbi->max_threads > 1 && tile_cols > 1) {
     // Multi-threaded tile decoder
     *p_data_end = decode_tiles_mt(pbi, data + first_partition_size, data_end);
     if (!xd->corrupted) {
       if (!cm->skip_loop_filter) {
         // If multiple threads are used to decode tiles, then we use those
-        // threads to do parallel loopfiltering.
-        av1_loop_filter_frame_mt(new_fb, cm, pbi->mb.plane,
-                                  cm->lf.filter_level, 0, 0, pbi->tile_workers,
-                                  pbi->num_tile_workers, &pbi->lf_row_sync);
+        // threads to do parallel loopfiltering. The number of workers is
+        // capped because it has been observed that using more threads on the
+        // loopfilter than there are cores will hurt performance on Android:
+        // the system will only schedule the tile decode workers on cores
+        // equal to the number of tile columns.
+        filter_frame_mt(pbi, AOMMIN(pbi->num_tile_workers, tile_cols));
+      }
+    } else {
+      aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
+                         "Decode failed. Frame data is corrupted.");
+    }
+#if CONFIG_MULTITHREAD
+  } else if (pbi->max_threads > 1 && tile_cols == 1) {
+    // Row-based multi-threaded decoder
+    *p_data_end =
+        decode_tiles_row_mt(pbi, data + first_partition_size, data_end);
+    if (!xd->corrupted) {
+      if (!cm->skip_loop_filter) {
+        filter_frame_mt(pbi, pbi->num_tile_workers);
       }
     } else {
       aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
                          "Decode failed. Frame data is corrupted.");
     }
+#endif  // CONFIG_MULTITHREAD
   } else {
     *p_data_end = decode_tiles(pbi, data + first_partition_size, data_end);
   }
@@ -134,13 +134,18 @@ void av1_decoder_remove(AV1Decoder *pbi) {
     aom_get_worker_interface()->end(worker);
   }
   aom_free(pbi->tile_worker_data);
-  aom_free(pbi->tile_worker_info);
   aom_free(pbi->tile_workers);
 
   if (pbi->num_tile_workers > 0) {
     av1_loop_filter_dealloc(&pbi->lf_row_sync);
   }
 
+  av1_row_mt_sync_dealloc(&pbi->row_mt_sync);
+  for (i = 0; i < MAX_MB_PLANE; ++i) {
+    aom_free(pbi->row_mt_dqcoeff[i]);
+    aom_free(pbi->row_mt_eob[i]);
+  }
+
   aom_free(pbi);
 }
 
@@ -326,7 +331,10 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     pbi->ready_for_new_data = 1;
 
     // Synchronize all threads immediately as a subsequent decode call may
-    // cause a resize invalidating some allocations.
+    // cause a resize invalidating some allocations. Row-based decoding
+    // workers may be waiting for superblocks that will never be parsed, so
+    // release them first.
+    if (pbi->row_mt_sync.rows > 0) av1_row_mt_sync_abort(&pbi->row_mt_sync);
     winterface->sync(&pbi->lf_worker);
     for (i = 0; i < pbi->num_tile_workers; ++i) {
       winterface->sync(&pbi->tile_workers[i]);
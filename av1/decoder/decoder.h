@@ -65,7 +65,6 @@ typedef struct AV1Decoder {
   AVxWorker lf_worker;
   AVxWorker *tile_workers;
   TileWorkerData *tile_worker_data;
-  TileInfo *tile_worker_info;
   int num_tile_workers;
 
   TileData *tile_data;
@@ -73,6 +72,14 @@ typedef struct AV1Decoder {
 
   AV1LfSync lf_row_sync;
 
+  // Row-based multi-threaded decoding of frames with a single tile column:
+  // the dequantized coefficients and end-of-block positions of every
+  // superblock, stored by the parsing thread in decoding order.
+  AV1RowMTSync row_mt_sync;
+  tran_low_t *row_mt_dqcoeff[MAX_MB_PLANE];
+  uint16_t *row_mt_eob[MAX_MB_PLANE];
+  int row_mt_dqcoeff_size[MAX_MB_PLANE];
+
   aom_decrypt_cb decrypt_cb;
   void *decrypt_state;
 
@@ -12,11 +12,186 @@
 #include "./aom_config.h"
 #include "aom_mem/aom_mem.h"
 #include "av1/common/reconinter.h"
+#include "av1/common/thread_common.h"
 #include "av1/decoder/dthread.h"
 #include "av1/decoder/decoder.h"
 
 // #define DEBUG_THREAD
 
+void av1_row_mt_sync_alloc(AV1RowMTSync *row_mt_sync, AV1_COMMON *cm,
+                           int rows, int sb_cols) {
+  row_mt_sync->rows = rows;
+  row_mt_sync->sb_cols = sb_cols;
+#if CONFIG_MULTITHREAD
+  {
+    int i;
+
+    CHECK_MEM_ERROR(cm, row_mt_sync->mutex_,
+                    aom_malloc(sizeof(*row_mt_sync->mutex_) * rows));
+    for (i = 0; i < rows; ++i) pthread_mutex_init(&row_mt_sync->mutex_[i], NULL);
+
+    CHECK_MEM_ERROR(cm, row_mt_sync->parse_cond_,
+                    aom_malloc(sizeof(*row_mt_sync->parse_cond_) * rows));
+    for (i = 0; i < rows; ++i)
+      pthread_cond_init(&row_mt_sync->parse_cond_[i], NULL);
+
+    CHECK_MEM_ERROR(cm, row_mt_sync->recon_cond_,
+                    aom_malloc(sizeof(*row_mt_sync->recon_cond_) * rows));
+    for (i = 0; i < rows; ++i)
+      pthread_cond_init(&row_mt_sync->recon_cond_[i], NULL);
+
+    pthread_mutex_init(&row_mt_sync->job_mutex_, NULL);
+  }
+#endif  // CONFIG_MULTITHREAD
+
+  CHECK_MEM_ERROR(cm, row_mt_sync->parsed_sb_col,
+                  aom_malloc(sizeof(*row_mt_sync->parsed_sb_col) * rows));
+  CHECK_MEM_ERROR(cm, row_mt_sync->recon_sb_col,
+                  aom_malloc(sizeof(*row_mt_sync->recon_sb_col) * rows));
+
+  row_mt_sync->sync_range = av1_get_sync_range(cm->width);
+}
+
+void av1_row_mt_sync_dealloc(AV1RowMTSync *row_mt_sync) {
+  if (row_mt_sync != NULL) {
+#if CONFIG_MULTITHREAD
+    int i;
+
+    if (row_mt_sync->mutex_ != NULL) {
+      for (i = 0; i < row_mt_sync->rows; ++i)
+        pthread_mutex_destroy(&row_mt_sync->mutex_[i]);
+      aom_free(row_mt_sync->mutex_);
+      pthread_mutex_destroy(&row_mt_sync->job_mutex_);
+    }
+    if (row_mt_sync->parse_cond_ != NULL) {
+      for (i = 0; i < row_mt_sync->rows; ++i)
+        pthread_cond_destroy(&row_mt_sync->parse_cond_[i]);
+      aom_free(row_mt_sync->parse_cond_);
+    }
+    if (row_mt_sync->recon_cond_ != NULL) {
+      for (i = 0; i < row_mt_sync->rows; ++i)
+        pthread_cond_destroy(&row_mt_sync->recon_cond_[i]);
+      aom_free(row_mt_sync->recon_cond_);
+    }
+#endif  // CONFIG_MULTITHREAD
+    aom_free(row_mt_sync->parsed_sb_col);
+    aom_free(row_mt_sync->recon_sb_col);
+    // clear the structure as the source of this call may be a resize in which
+    // case this call will be followed by an _alloc() which may fail.
+    av1_zero(*row_mt_sync);
+  }
+}
+
+void av1_row_mt_sync_reset(AV1RowMTSync *row_mt_sync) {
+  memset(row_mt_sync->parsed_sb_col, -1,
+         sizeof(*row_mt_sync->parsed_sb_col) * row_mt_sync->rows);
+  memset(row_mt_sync->recon_sb_col, -1,
+         sizeof(*row_mt_sync->recon_sb_col) * row_mt_sync->rows);
+  row_mt_sync->next_row = 0;
+  row_mt_sync->abort = 0;
+}
+
+void av1_row_mt_sync_parse_write(AV1RowMTSync *row_mt_sync, int r, int c) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&row_mt_sync->mutex_[r]);
+  row_mt_sync->parsed_sb_col[r] = c;
+  pthread_cond_signal(&row_mt_sync->parse_cond_[r]);
+  pthread_mutex_unlock(&row_mt_sync->mutex_[r]);
+#else
+  row_mt_sync->parsed_sb_col[r] = c;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void av1_row_mt_sync_recon_write(AV1RowMTSync *row_mt_sync, int r, int c) {
+#if CONFIG_MULTITHREAD
+  const int nsync = row_mt_sync->sync_range;
+  int cur;
+  // Only signal when there are enough reconstructed SBs for the next row to
+  // run.
+  int sig = 1;
+
+  if (c < row_mt_sync->sb_cols - 1) {
+    cur = c;
+    if (c % nsync) sig = 0;
+  } else {
+    cur = row_mt_sync->sb_cols + nsync;
+  }
+
+  if (sig) {
+    pthread_mutex_lock(&row_mt_sync->mutex_[r]);
+    row_mt_sync->recon_sb_col[r] = cur;
+    pthread_cond_signal(&row_mt_sync->recon_cond_[r]);
+    pthread_mutex_unlock(&row_mt_sync->mutex_[r]);
+  }
+#else
+  (void)row_mt_sync;
+  (void)r;
+  (void)c;
+#endif  // CONFIG_MULTITHREAD
+}
+
+int av1_row_mt_sync_recon_read(AV1RowMTSync *row_mt_sync, int r, int c) {
+#if CONFIG_MULTITHREAD
+  const int nsync = row_mt_sync->sync_range;
+  int ok;
+
+  // The superblock itself must have been parsed.
+  pthread_mutex_lock(&row_mt_sync->mutex_[r]);
+  while (c > row_mt_sync->parsed_sb_col[r] && !row_mt_sync->abort)
+    pthread_cond_wait(&row_mt_sync->parse_cond_[r], &row_mt_sync->mutex_[r]);
+  ok = !row_mt_sync->abort;
+  pthread_mutex_unlock(&row_mt_sync->mutex_[r]);
+
+  // The row above must be far enough ahead to provide the above and
+  // above-right pixels used by intra prediction.
+  if (ok && r && !(c & (nsync - 1))) {
+    pthread_mutex_t *const mutex = &row_mt_sync->mutex_[r - 1];
+    pthread_mutex_lock(mutex);
+    while (c > row_mt_sync->recon_sb_col[r - 1] - nsync &&
+           !row_mt_sync->abort)
+      pthread_cond_wait(&row_mt_sync->recon_cond_[r - 1], mutex);
+    ok = !row_mt_sync->abort;
+    pthread_mutex_unlock(mutex);
+  }
+  return ok;
+#else
+  return c <= row_mt_sync->parsed_sb_col[r] && !row_mt_sync->abort;
+#endif  // CONFIG_MULTITHREAD
+}
+
+int av1_row_mt_sync_next_row(AV1RowMTSync *row_mt_sync) {
+  int r = -1;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&row_mt_sync->job_mutex_);
+#endif
+  if (row_mt_sync->next_row < row_mt_sync->rows && !row_mt_sync->abort)
+    r = row_mt_sync->next_row++;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&row_mt_sync->job_mutex_);
+#endif
+  return r;
+}
+
+void av1_row_mt_sync_abort(AV1RowMTSync *row_mt_sync) {
+#if CONFIG_MULTITHREAD
+  int i;
+  pthread_mutex_lock(&row_mt_sync->job_mutex_);
+  row_mt_sync->abort = 1;
+  pthread_mutex_unlock(&row_mt_sync->job_mutex_);
+  // The waits read the flag under the row mutexes, so it is also set under
+  // each of them before waking the waiters up.
+  for (i = 0; i < row_mt_sync->rows; ++i) {
+    pthread_mutex_lock(&row_mt_sync->mutex_[i]);
+    row_mt_sync->abort = 1;
+    pthread_cond_broadcast(&row_mt_sync->parse_cond_[i]);
+    pthread_cond_broadcast(&row_mt_sync->recon_cond_[i]);
+    pthread_mutex_unlock(&row_mt_sync->mutex_[i]);
+  }
+#else
+  row_mt_sync->abort = 1;
+#endif  // CONFIG_MULTITHREAD
+}
+
 // TODO(hkuang): Clean up all the #ifdef in this file.
 void av1_frameworker_lock_stats(AVxWorker *const worker) {
 #if CONFIG_MULTITHREAD
@@ -40,6 +40,12 @@ typedef struct FrameWorkerData {
   uint8_t *scratch_buffer;
   size_t scratch_buffer_size;
 
+  // Input buffer to hand back to the application once this worker has
+  // finished, when the decoder reads the application's buffers directly.
+  // Only set on the worker that decodes the last frame of the buffer.
+  const uint8_t *input_buffer;
+  void *input_user_priv;
+
 #if CONFIG_MULTITHREAD
   pthread_mutex_t stats_mutex;
   pthread_cond_t stats_cond;
@@ -49,6 +55,58 @@ typedef struct FrameWorkerData {
   int frame_decoded;        // Finished decoding current frame.
 } FrameWorkerData;
 
+// Superblock row synchronization for row-based multi-threaded decoding. The
+// parsing thread publishes how far it has parsed each superblock row, and the
+// reconstruction workers publish how far they have reconstructed it, so that a
+// row is only reconstructed once it is parsed and the row above is far enough
+// ahead for intra prediction.
+typedef struct AV1RowMTSync {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *mutex_;
+  pthread_cond_t *parse_cond_;
+  pthread_cond_t *recon_cond_;
+  pthread_mutex_t job_mutex_;
+#endif
+  // Index of the last parsed and the last reconstructed superblock in each
+  // row.
+  int *parsed_sb_col;
+  int *recon_sb_col;
+  int sync_range;
+  int rows;
+  int sb_cols;
+  // Next superblock row to be handed out to a reconstruction worker.
+  int next_row;
+  // Set when decoding of the frame failed; all waits return immediately.
+  int abort;
+} AV1RowMTSync;
+
+// Allocate memory for row-based multi-threaded decoding synchronization.
+void av1_row_mt_sync_alloc(AV1RowMTSync *row_mt_sync, struct AV1Common *cm,
+                           int rows, int sb_cols);
+
+// Deallocate row-based multi-threaded decoding synchronization data.
+void av1_row_mt_sync_dealloc(AV1RowMTSync *row_mt_sync);
+
+// Reset the progress of all rows before decoding a new frame.
+void av1_row_mt_sync_reset(AV1RowMTSync *row_mt_sync);
+
+// Mark superblock 'c' of row 'r' as parsed.
+void av1_row_mt_sync_parse_write(AV1RowMTSync *row_mt_sync, int r, int c);
+
+// Mark superblock 'c' of row 'r' as reconstructed.
+void av1_row_mt_sync_recon_write(AV1RowMTSync *row_mt_sync, int r, int c);
+
+// Wait until superblock 'c' of row 'r' can be reconstructed. Returns 0 if the
+// frame decode was aborted while waiting.
+int av1_row_mt_sync_recon_read(AV1RowMTSync *row_mt_sync, int r, int c);
+
+// Return the next superblock row to be reconstructed, or -1 if all rows have
+// been handed out.
+int av1_row_mt_sync_next_row(AV1RowMTSync *row_mt_sync);
+
+// Abort the current frame, releasing all waiting workers.
+void av1_row_mt_sync_abort(AV1RowMTSync *row_mt_sync);
+
 void av1_frameworker_lock_stats(AVxWorker *const worker);
 void av1_frameworker_unlock_stats(AVxWorker *const worker);
 void av1_frameworker_signal_stats(AVxWorker *const worker);
@@ -42,6 +42,10 @@
 #include "av1/encoder/subexp.h"
 #include "av1/encoder/tokenize.h"
 
+// Space left for the uncompressed header when it is written after the rest
+// of the frame.
+#define MAX_UNCOMPRESSED_HEADER_SIZE 256
+
 static const struct av1_token intra_mode_encodings[INTRA_MODES] = {
   { 0, 1 },  { 6, 3 },   { 28, 5 },  { 30, 5 }, { 58, 6 },
   { 59, 6 }, { 126, 7 }, { 127, 7 }, { 62, 6 }, { 2, 2 }
@@ -400,14 +404,15 @@ static void write_ref_frames(const AV1_COMMON *cm, const MACROBLOCKD *xd,
   }
 }
 
-static void pack_inter_mode_mvs(AV1_COMP *cpi, const MODE_INFO *mi,
-                                aom_writer *w) {
+static void pack_inter_mode_mvs(
+    AV1_COMP *cpi, const MACROBLOCKD *const xd, const MODE_INFO *mi,
+    const MB_MODE_INFO_EXT *const mbmi_ext, aom_writer *w,
+    unsigned int *const max_mv_magnitude,
+    int interp_filter_selected[MAX_REF_FRAMES][SWITCHABLE]) {
   AV1_COMMON *const cm = &cpi->common;
 #if !CONFIG_REF_MV
   const nmv_context *nmvc = &cm->fc->nmvc;
 #endif
-  const MACROBLOCK *const x = &cpi->td.mb;
-  const MACROBLOCKD *const xd = &x->e_mbd;
   const struct segmentation *const seg = &cm->seg;
 #if CONFIG_MISC_FIXES
   const struct segmentation_probs *const segp = &cm->fc->seg;
@@ -415,7 +420,6 @@ static void pack_inter_mode_mvs(AV1_COMP *cpi, const MODE_INFO *mi,
   const struct segmentation_probs *const segp = &cm->segp;
 #endif
   const MB_MODE_INFO *const mbmi = &mi->mbmi;
-  const MB_MODE_INFO_EXT *const mbmi_ext = x->mbmi_ext;
   const PREDICTION_MODE mode = mbmi->mode;
   const int segment_id = mbmi->segment_id;
   const BLOCK_SIZE bsize = mbmi->sb_type;
@@ -485,7 +489,7 @@ static void pack_inter_mode_mvs(AV1_COMP *cpi, const MODE_INFO *mi,
       av1_write_token(w, av1_switchable_interp_tree,
                        cm->fc->switchable_interp_prob[ctx],
                        &switchable_interp_encodings[mbmi->interp_filter]);
-      ++cpi->interp_filter_selected[0][mbmi->interp_filter];
+      ++interp_filter_selected[0][mbmi->interp_filter];
     } else {
       assert(mbmi->interp_filter == cm->interp_filter);
     }
@@ -513,7 +517,7 @@ static void pack_inter_mode_mvs(AV1_COMP *cpi, const MODE_INFO *mi,
 #endif
               av1_encode_mv(cpi, w, &mi->bmi[j].as_mv[ref].as_mv,
                              &mbmi_ext->ref_mvs[mbmi->ref_frame[ref]][0].as_mv,
-                             nmvc, allow_hp);
+                             nmvc, allow_hp, max_mv_magnitude);
             }
           }
         }
@@ -529,7 +533,7 @@ static void pack_inter_mode_mvs(AV1_COMP *cpi, const MODE_INFO *mi,
 #endif
               av1_encode_mv(cpi, w, &mbmi->mv[ref].as_mv,
                          &mbmi_ext->ref_mvs[mbmi->ref_frame[ref]][0].as_mv,
-                         nmvc, allow_hp);
+                         nmvc, allow_hp, max_mv_magnitude);
         }
       }
     }
@@ -603,27 +607,29 @@ static void write_mb_modes_kf(const AV1_COMMON *cm, const MACROBLOCKD *xd,
   }
 }
 
-static void write_modes_b(AV1_COMP *cpi, const TileInfo *const tile,
-                          aom_writer *w, TOKENEXTRA **tok,
-                          const TOKENEXTRA *const tok_end, int mi_row,
-                          int mi_col) {
+static void write_modes_b(
+    AV1_COMP *cpi, MACROBLOCKD *const xd, const TileInfo *const tile,
+    aom_writer *w, TOKENEXTRA **tok, const TOKENEXTRA *const tok_end,
+    unsigned int *const max_mv_magnitude,
+    int interp_filter_selected[MAX_REF_FRAMES][SWITCHABLE], int mi_row,
+    int mi_col) {
   const AV1_COMMON *const cm = &cpi->common;
-  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+  const MB_MODE_INFO_EXT *const mbmi_ext =
+      cpi->mbmi_ext_base + (mi_row * cm->mi_cols + mi_col);
   MODE_INFO *m;
   int plane;
 
   xd->mi = cm->mi_grid_visible + (mi_row * cm->mi_stride + mi_col);
   m = xd->mi[0];
 
-  cpi->td.mb.mbmi_ext = cpi->mbmi_ext_base + (mi_row * cm->mi_cols + mi_col);
-
   set_mi_row_col(xd, tile, mi_row, num_8x8_blocks_high_lookup[m->mbmi.sb_type],
                  mi_col, num_8x8_blocks_wide_lookup[m->mbmi.sb_type],
                  cm->mi_rows, cm->mi_cols);
   if (frame_is_intra_only(cm)) {
     write_mb_modes_kf(cm, xd, xd->mi, w);
   } else {
-    pack_inter_mode_mvs(cpi, m, w);
+    pack_inter_mode_mvs(cpi, xd, m, mbmi_ext, w, max_mv_magnitude,
+                        interp_filter_selected);
   }
 
   if (!m->mbmi.skip) {
@@ -660,12 +666,13 @@ static void write_partition(const AV1_COMMON *const cm,
   }
 }
 
-static void write_modes_sb(AV1_COMP *cpi, const TileInfo *const tile,
-                           aom_writer *w, TOKENEXTRA **tok,
-                           const TOKENEXTRA *const tok_end, int mi_row,
-                           int mi_col, BLOCK_SIZE bsize) {
+static void write_modes_sb(
+    AV1_COMP *cpi, MACROBLOCKD *const xd, const TileInfo *const tile,
+    aom_writer *w, TOKENEXTRA **tok, const TOKENEXTRA *const tok_end,
+    unsigned int *const max_mv_magnitude,
+    int interp_filter_selected[MAX_REF_FRAMES][SWITCHABLE], int mi_row,
+    int mi_col, BLOCK_SIZE bsize) {
   const AV1_COMMON *const cm = &cpi->common;
-  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
 
   const int bsl = b_width_log2_lookup[bsize];
   const int bs = (1 << bsl) / 4;
@@ -681,29 +688,37 @@ static void write_modes_sb(AV1_COMP *cpi, const TileInfo *const tile,
   write_partition(cm, xd, bs, mi_row, mi_col, partition, bsize, w);
   subsize = get_subsize(bsize, partition);
   if (subsize < BLOCK_8X8) {
-    write_modes_b(cpi, tile, w, tok, tok_end, mi_row, mi_col);
+    write_modes_b(cpi, xd, tile, w, tok, tok_end, max_mv_magnitude,
+                  interp_filter_selected, mi_row, mi_col);
   } else {
     switch (partition) {
       case PARTITION_NONE:
-        write_modes_b(cpi, tile, w, tok, tok_end, mi_row, mi_col);
+        write_modes_b(cpi, xd, tile, w, tok, tok_end, max_mv_magnitude,
+                      interp_filter_selected, mi_row, mi_col);
         break;
       case PARTITION_HORZ:
-        write_modes_b(cpi, tile, w, tok, tok_end, mi_row, mi_col);
+        write_modes_b(cpi, xd, tile, w, tok, tok_end, max_mv_magnitude,
+                      interp_filter_selected, mi_row, mi_col);
         if (mi_row + bs < cm->mi_rows)
-          write_modes_b(cpi, tile, w, tok, tok_end, mi_row + bs, mi_col);
+          write_modes_b(cpi, xd, tile, w, tok, tok_end, max_mv_magnitude,
+                        interp_filter_selected, mi_row + bs, mi_col);
         break;
       case PARTITION_VERT:
-        write_modes_b(cpi, tile, w, tok, tok_end, mi_row, mi_col);
+        write_modes_b(cpi, xd, tile, w, tok, tok_end, max_mv_magnitude,
+                      interp_filter_selected, mi_row, mi_col);
         if (mi_col + bs < cm->mi_cols)
-          write_modes_b(cpi, tile, w, tok, tok_end, mi_row, mi_col + bs);
+          write_modes_b(cpi, xd, tile, w, tok, tok_end, max_mv_magnitude,
+                        interp_filter_selected, mi_row, mi_col + bs);
         break;
       case PARTITION_SPLIT:
-        write_modes_sb(cpi, tile, w, tok, tok_end, mi_row, mi_col, subsize);
-        write_modes_sb(cpi, tile, w, tok, tok_end, mi_row, mi_col + bs,
-                       subsize);
-        write_modes_sb(cpi, tile, w, tok, tok_end, mi_row + bs, mi_col,
-                       subsize);
-        write_modes_sb(cpi, tile, w, tok, tok_end, mi_row + bs, mi_col + bs,
+        write_modes_sb(cpi, xd, tile, w, tok, tok_end, max_mv_magnitude,
+                       interp_filter_selected, mi_row, mi_col, subsize);
+        write_modes_sb(cpi, xd, tile, w, tok, tok_end, max_mv_magnitude,
+                       interp_filter_selected, mi_row, mi_col + bs, subsize);
+        write_modes_sb(cpi, xd, tile, w, tok, tok_end, max_mv_magnitude,
+                       interp_filter_selected, mi_row + bs, mi_col, subsize);
+        write_modes_sb(cpi, xd, tile, w, tok, tok_end, max_mv_magnitude,
+                       interp_filter_selected, mi_row + bs, mi_col + bs,
                        subsize);
         break;
       default: assert(0);
@@ -725,10 +740,11 @@ static void write_modes_sb(AV1_COMP *cpi, const TileInfo *const tile,
 #endif
 }
 
-static void write_modes(AV1_COMP *cpi, const TileInfo *const tile,
-                        aom_writer *w, TOKENEXTRA **tok,
-                        const TOKENEXTRA *const tok_end) {
-  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+static void write_modes(
+    AV1_COMP *cpi, MACROBLOCKD *const xd, const TileInfo *const tile,
+    aom_writer *w, TOKENEXTRA **tok, const TOKENEXTRA *const tok_end,
+    unsigned int *const max_mv_magnitude,
+    int interp_filter_selected[MAX_REF_FRAMES][SWITCHABLE]) {
   int mi_row, mi_col;
 
   for (mi_row = tile->mi_row_start; mi_row < tile->mi_row_end;
@@ -736,7 +752,8 @@ static void write_modes(AV1_COMP *cpi, const TileInfo *const tile,
     av1_zero(xd->left_seg_context);
     for (mi_col = tile->mi_col_start; mi_col < tile->mi_col_end;
          mi_col += MI_BLOCK_SIZE)
-      write_modes_sb(cpi, tile, w, tok, tok_end, mi_row, mi_col, BLOCK_64X64);
+      write_modes_sb(cpi, xd, tile, w, tok, tok_end, max_mv_magnitude,
+                     interp_filter_selected, mi_row, mi_col, BLOCK_64X64);
   }
 }
 
@@ -999,7 +1016,7 @@ static void encode_quantization(const AV1_COMMON *const cm,
 #endif
 }
 
-static void encode_segmentation(AV1_COMMON *cm, MACROBLOCKD *xd,
+static void encode_segmentation(AV1_COMMON *cm,
                                 struct aom_write_bit_buffer *wb) {
   int i, j;
 
@@ -1018,8 +1035,6 @@ static void encode_segmentation(AV1_COMMON *cm, MACROBLOCKD *xd,
     assert(seg->update_map == 1);
   }
   if (seg->update_map) {
-    // Select the coding strategy (temporal or spatial)
-    av1_choose_segmap_coding_method(cm, xd);
 #if !CONFIG_MISC_FIXES
     // Write out probabilities used to decode unpredicted  macro-block segments
     for (i = 0; i < SEG_TREE_PROBS; i++) {
@@ -1207,49 +1222,195 @@ static int get_refresh_mask(AV1_COMP *cpi) {
   }
 }
 
-static size_t encode_tiles(AV1_COMP *cpi, uint8_t *data_ptr,
+// A tile packed by a worker thread, before it is copied to the bitstream.
+typedef struct {
+  uint8_t *data;
+  unsigned int size;
+} PackedTile;
+
+// The work of one worker in pack_tiles_mt(), kept in cpi->pack_tile_jobs.
+typedef struct PackTilesJob {
+  AV1_COMP *cpi;
+  MACROBLOCKD xd;
+  // The tile columns start, start + step, ... are packed by this job, each
+  // one into the scratch space starting at tiles[0][tile_col].data.
+  int start;
+  int step;
+  PackedTile (*tiles)[1 << 6];
+  unsigned int max_mv_magnitude;
+  int interp_filter_selected[MAX_REF_FRAMES][SWITCHABLE];
+} PackTilesJob;
+
+static unsigned int pack_tile(
+    AV1_COMP *cpi, MACROBLOCKD *const xd, int tile_row, int tile_col,
+    uint8_t *dst, unsigned int *const max_mv_magnitude,
+    int interp_filter_selected[MAX_REF_FRAMES][SWITCHABLE]) {
+  const int tile_cols = 1 << cpi->common.log2_tile_cols;
+  const TileInfo *const tile_info =
+      &cpi->tile_data[tile_row * tile_cols + tile_col].tile_info;
+  TOKENEXTRA *tok = cpi->tile_tok[tile_row][tile_col];
+  const TOKENEXTRA *const tok_end = tok + cpi->tok_count[tile_row][tile_col];
+  aom_writer residual_bc;
+
+  aom_start_encode(&residual_bc, dst);
+  write_modes(cpi, xd, tile_info, &residual_bc, &tok, tok_end,
+              max_mv_magnitude, interp_filter_selected);
+  assert(tok == tok_end);
+  aom_stop_encode(&residual_bc);
+
+  return residual_bc.pos;
+}
+
+static int pack_tiles_worker_hook(PackTilesJob *job, void *unused) {
+  AV1_COMP *const cpi = job->cpi;
+  const int tile_cols = 1 << cpi->common.log2_tile_cols;
+  const int tile_rows = 1 << cpi->common.log2_tile_rows;
+  int tile_row, tile_col;
+  (void)unused;
+
+  for (tile_col = job->start; tile_col < tile_cols; tile_col += job->step) {
+    // The tile rows depend on each other through the partition context, so
+    // a column is packed from top to bottom.
+    uint8_t *dst = job->tiles[0][tile_col].data;
+    for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
+      PackedTile *const tile = &job->tiles[tile_row][tile_col];
+      tile->data = dst;
+      tile->size =
+          pack_tile(cpi, &job->xd, tile_row, tile_col, dst,
+                    &job->max_mv_magnitude, job->interp_filter_selected);
+      dst += tile->size;
+    }
+  }
+
+  return 1;
+}
+
+// Pack the tile columns on the worker threads, each one into its own part of
+// cpi->tile_pack_buf.
+static void pack_tiles_mt(AV1_COMP *cpi, PackedTile tiles[4][1 << 6]) {
+  AV1_COMMON *const cm = &cpi->common;
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int num_workers = AOMMIN(cpi->num_workers, tile_cols);
+  const int height = cm->mi_rows * MI_SIZE;
+  PackTilesJob *jobs;
+  size_t offsets[1 << 6];
+  size_t buf_size = 0;
+  int i, j;
+
+  // Leave room for twice the size of the uncompressed tile column, the same
+  // margin the output buffer has for the whole frame.
+  for (i = 0; i < tile_cols; ++i) {
+    const TileInfo *const tile_info = &cpi->tile_data[i].tile_info;
+    const int width = (tile_info->mi_col_end - tile_info->mi_col_start) *
+                      MI_SIZE;
+    size_t col_size = (size_t)width * height +
+                      2 * (size_t)(width >> cm->subsampling_x) *
+                          (height >> cm->subsampling_y);
+#if CONFIG_AOM_HIGHBITDEPTH
+    if (cm->use_highbitdepth) col_size *= 2;
+#endif
+    offsets[i] = buf_size;
+    buf_size += 2 * col_size + 4096;
+  }
+
+  if (buf_size > cpi->tile_pack_buf_size) {
+    aom_free(cpi->tile_pack_buf);
+    cpi->tile_pack_buf_size = 0;
+    CHECK_MEM_ERROR(cm, cpi->tile_pack_buf, aom_malloc(buf_size));
+    cpi->tile_pack_buf_size = buf_size;
+  }
+  for (i = 0; i < tile_cols; ++i)
+    tiles[0][i].data = cpi->tile_pack_buf + offsets[i];
+
+  // Each job holds a MACROBLOCKD, too large for the stack, so there is one
+  // per worker allocated with the workers.
+  if (cpi->pack_tile_jobs == NULL) {
+    CHECK_MEM_ERROR(cm, cpi->pack_tile_jobs,
+                    aom_memalign(32, cpi->num_workers *
+                                         sizeof(*cpi->pack_tile_jobs)));
+  }
+  jobs = cpi->pack_tile_jobs;
+
+  for (i = 0; i < num_workers; ++i) {
+    PackTilesJob *const job = &jobs[i];
+    AVxWorker *const worker = &cpi->workers[i];
+
+    job->cpi = cpi;
+    job->xd = cpi->td.mb.e_mbd;
+    job->start = i;
+    job->step = num_workers;
+    job->tiles = tiles;
+    job->max_mv_magnitude = 0;
+    av1_zero(job->interp_filter_selected);
+
+    worker->hook = (AVxWorkerHook)pack_tiles_worker_hook;
+    worker->data1 = job;
+    worker->data2 = NULL;
+
+    // The last job runs on the main thread.
+    if (i == num_workers - 1)
+      winterface->execute(worker);
+    else
+      winterface->launch(worker);
+  }
+
+  for (i = 0; i < num_workers; ++i) {
+    const PackTilesJob *const job = &jobs[i];
+
+    winterface->sync(&cpi->workers[i]);
+    cpi->max_mv_magnitude =
+        AOMMAX(cpi->max_mv_magnitude, job->max_mv_magnitude);
+    for (j = 0; j < SWITCHABLE; ++j)
+      cpi->interp_filter_selected[0][j] += job->interp_filter_selected[0][j];
+  }
+}
+
+static size_t encode_tiles(AV1_COMP *cpi, MACROBLOCKD *const xd,
+                           int allow_workers, uint8_t *data_ptr,
                            unsigned int *max_tile_sz) {
   AV1_COMMON *const cm = &cpi->common;
-  aom_writer residual_bc;
   int tile_row, tile_col;
-  TOKENEXTRA *tok_end;
   size_t total_size = 0;
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int tile_rows = 1 << cm->log2_tile_rows;
+  const int use_workers =
+      allow_workers && cpi->num_workers > 1 && tile_cols > 1;
+  PackedTile tiles[4][1 << 6];
   unsigned int max_tile = 0;
 
   memset(cm->above_seg_context, 0,
          sizeof(*cm->above_seg_context) * mi_cols_aligned_to_sb(cm->mi_cols));
 
+  if (use_workers) pack_tiles_mt(cpi, tiles);
+
   for (tile_row = 0; tile_row < tile_rows; tile_row++) {
     for (tile_col = 0; tile_col < tile_cols; tile_col++) {
-      int tile_idx = tile_row * tile_cols + tile_col;
-      TOKENEXTRA *tok = cpi->tile_tok[tile_row][tile_col];
-
-      tok_end = cpi->tile_tok[tile_row][tile_col] +
-                cpi->tok_count[tile_row][tile_col];
-
-      if (tile_col < tile_cols - 1 || tile_row < tile_rows - 1)
-        aom_start_encode(&residual_bc, data_ptr + total_size + 4);
-      else
-        aom_start_encode(&residual_bc, data_ptr + total_size);
-
-      write_modes(cpi, &cpi->tile_data[tile_idx].tile_info, &residual_bc, &tok,
-                  tok_end);
-      assert(tok == tok_end);
-      aom_stop_encode(&residual_bc);
-      if (tile_col < tile_cols - 1 || tile_row < tile_rows - 1) {
+      const int is_last_tile =
+          tile_col == tile_cols - 1 && tile_row == tile_rows - 1;
+      uint8_t *const dst = data_ptr + total_size + (is_last_tile ? 0 : 4);
+      unsigned int size;
+
+      if (use_workers) {
+        size = tiles[tile_row][tile_col].size;
+        memcpy(dst, tiles[tile_row][tile_col].data, size);
+      } else {
+        size = pack_tile(cpi, xd, tile_row, tile_col, dst,
+                         &cpi->max_mv_magnitude, cpi->interp_filter_selected);
+      }
+
+      if (!is_last_tile) {
         unsigned int tile_sz;
 
         // size of this tile
-        assert(residual_bc.pos > 0);
-        tile_sz = residual_bc.pos - CONFIG_MISC_FIXES;
+        assert(size > 0);
+        tile_sz = size - CONFIG_MISC_FIXES;
         mem_put_le32(data_ptr + total_size, tile_sz);
         max_tile = max_tile > tile_sz ? max_tile : tile_sz;
         total_size += 4;
       }
 
-      total_size += residual_bc.pos;
+      total_size += size;
     }
   }
   *max_tile_sz = max_tile;
@@ -1357,7 +1518,9 @@ static void write_bitdepth_colorspace_sampling(
 static void write_uncompressed_header(AV1_COMP *cpi,
                                       struct aom_write_bit_buffer *wb) {
   AV1_COMMON *const cm = &cpi->common;
-  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+#if CONFIG_MISC_FIXES
+  const MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+#endif
 
   aom_wb_write_literal(wb, AOM_FRAME_MARKER, 2);
 
@@ -1423,7 +1586,6 @@ static void write_uncompressed_header(AV1_COMP *cpi,
 
       aom_wb_write_bit(wb, cm->allow_high_precision_mv);
 
-      fix_interp_filter(cm, cpi->td.counts);
       write_interp_filter(cm->interp_filter, wb);
     }
   }
@@ -1448,12 +1610,9 @@ static void write_uncompressed_header(AV1_COMP *cpi,
   encode_dering(cm->dering_level, wb);
 #endif  // CONFIG_DERING
   encode_quantization(cm, wb);
-  encode_segmentation(cm, xd, wb);
+  encode_segmentation(cm, wb);
 #if CONFIG_MISC_FIXES
-  if (!cm->seg.enabled && xd->lossless[0])
-    cm->tx_mode = TX_4X4;
-  else
-    write_txfm_mode(cm->tx_mode, wb);
+  if (cm->seg.enabled || !xd->lossless[0]) write_txfm_mode(cm->tx_mode, wb);
   if (cpi->allow_comp_inter_inter) {
     const int use_hybrid_pred = cm->reference_mode == REFERENCE_MODE_SELECT;
     const int use_compound_pred = cm->reference_mode != SINGLE_REFERENCE;
@@ -1479,9 +1638,7 @@ static size_t write_compressed_header(AV1_COMP *cpi, uint8_t *data) {
   aom_start_encode(&header_bc, data);
 
 #if !CONFIG_MISC_FIXES
-  if (cpi->td.mb.e_mbd.lossless[0]) {
-    cm->tx_mode = TX_4X4;
-  } else {
+  if (!cpi->td.mb.e_mbd.lossless[0]) {
     write_txfm_mode(cm->tx_mode, &header_bc);
     update_txfm_probs(cm, &header_bc, counts);
   }
@@ -1620,6 +1777,56 @@ static int remux_tiles(uint8_t *dest, const int sz, const int n_tiles,
 }
 #endif
 
+// Settle the frame level choices the uncompressed header makes on behalf of
+// the compressed header and the tile data, so that it can be written last.
+static void prepare_frame_header(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+
+  if (!frame_is_intra_only(cm)) fix_interp_filter(cm, cpi->td.counts);
+
+  // Select the coding strategy (temporal or spatial) of the segmentation map
+  if (cm->seg.enabled && cm->seg.update_map)
+    av1_choose_segmap_coding_method(cm, xd);
+
+#if CONFIG_MISC_FIXES
+  if (!cm->seg.enabled && xd->lossless[0]) cm->tx_mode = TX_4X4;
+#else
+  if (xd->lossless[0]) cm->tx_mode = TX_4X4;
+#endif
+}
+
+#if CONFIG_MISC_FIXES
+// Write the number of bytes of the tile sizes to 'wb' and shrink the tile
+// size fields of 'data' to it. Returns the new size of the tile data.
+static size_t write_tile_size_bytes(const AV1_COMMON *cm,
+                                    struct aom_write_bit_buffer *wb,
+                                    uint8_t *data, size_t data_sz,
+                                    unsigned int max_tile) {
+  const int n_log2_tiles = cm->log2_tile_rows + cm->log2_tile_cols;
+
+  if (max_tile > 0) {
+    int mag;
+    unsigned int mask;
+
+    // Choose the (tile size) magnitude
+    for (mag = 0, mask = 0xff; mag < 4; mag++) {
+      if (max_tile <= mask) break;
+      mask <<= 8;
+      mask |= 0xff;
+    }
+    assert(n_log2_tiles > 0);
+    aom_wb_write_literal(wb, mag, 2);
+    if (mag < 3)
+      data_sz = remux_tiles(data, (int)data_sz, 1 << n_log2_tiles, mag);
+  } else {
+    assert(n_log2_tiles == 0);
+  }
+
+  return data_sz;
+}
+#endif
+
 void av1_pack_bitstream(AV1_COMP *const cpi, uint8_t *dest, size_t *size) {
   uint8_t *data = dest;
   size_t first_part_size, uncompressed_hdr_size, data_sz;
@@ -1635,6 +1842,8 @@ void av1_pack_bitstream(AV1_COMP *const cpi, uint8_t *dest, size_t *size) {
                              // tile size marker in the header
 #endif
 
+  prepare_frame_header(cpi);
+
   write_uncompressed_header(cpi, &wb);
   saved_wb = wb;
   // don't know in advance first part. size
@@ -1648,25 +1857,9 @@ void av1_pack_bitstream(AV1_COMP *const cpi, uint8_t *dest, size_t *size) {
   first_part_size = write_compressed_header(cpi, data);
   data += first_part_size;
 
-  data_sz = encode_tiles(cpi, data, &max_tile);
+  data_sz = encode_tiles(cpi, &cpi->td.mb.e_mbd, 1, data, &max_tile);
 #if CONFIG_MISC_FIXES
-  if (max_tile > 0) {
-    int mag;
-    unsigned int mask;
-
-    // Choose the (tile size) magnitude
-    for (mag = 0, mask = 0xff; mag < 4; mag++) {
-      if (max_tile <= mask) break;
-      mask <<= 8;
-      mask |= 0xff;
-    }
-    assert(n_log2_tiles > 0);
-    aom_wb_write_literal(&saved_wb, mag, 2);
-    if (mag < 3)
-      data_sz = remux_tiles(data, (int)data_sz, 1 << n_log2_tiles, mag);
-  } else {
-    assert(n_log2_tiles == 0);
-  }
+  data_sz = write_tile_size_bytes(cm, &saved_wb, data, data_sz, max_tile);
 #endif
   data += data_sz;
 
@@ -1675,3 +1868,75 @@ void av1_pack_bitstream(AV1_COMP *const cpi, uint8_t *dest, size_t *size) {
 
   *size = data - dest;
 }
+
+static int pack_frame_worker_hook(AV1_COMP *cpi, void *unused) {
+  PackFrameData *const pd = &cpi->pack_data;
+  (void)unused;
+
+  aom_clear_system_state();
+
+  // This runs on one of the workers, which cannot hand out work to the
+  // others; there is a single tile column anyway.
+  pd->first_part_size = write_compressed_header(cpi, pd->data);
+  pd->data_sz = encode_tiles(cpi, &pd->xd, 0, pd->data + pd->first_part_size,
+                             &pd->max_tile);
+
+  return 1;
+}
+
+void av1_start_pack_bitstream(AV1_COMP *cpi, uint8_t *dest) {
+  AVxWorker *const worker = &cpi->workers[0];
+  PackFrameData *const pd = &cpi->pack_data;
+
+  assert(cpi->num_workers > 1);
+  prepare_frame_header(cpi);
+
+  pd->xd = cpi->td.mb.e_mbd;
+  pd->data = dest + MAX_UNCOMPRESSED_HEADER_SIZE;
+
+  worker->hook = (AVxWorkerHook)pack_frame_worker_hook;
+  worker->data1 = cpi;
+  worker->data2 = NULL;
+  aom_get_worker_interface()->launch(worker);
+}
+
+void av1_finish_pack_bitstream(AV1_COMP *cpi, uint8_t *dest, size_t *size) {
+  const PackFrameData *const pd = &cpi->pack_data;
+  struct aom_write_bit_buffer wb = { dest, 0 };
+  struct aom_write_bit_buffer saved_wb;
+  size_t uncompressed_hdr_size, data_sz;
+#if CONFIG_MISC_FIXES
+  AV1_COMMON *const cm = &cpi->common;
+  const int have_tiles = cm->log2_tile_rows + cm->log2_tile_cols > 0;
+#else
+  const int have_tiles = 0;
+#endif
+
+  if (!aom_get_worker_interface()->sync(&cpi->workers[0]))
+    aom_internal_error(&cpi->common.error, AOM_CODEC_ERROR,
+                       "Failed to pack the bitstream");
+
+  // The header is written straight into the space reserved for it, and a
+  // header that has run into the packed data is an error.
+  write_uncompressed_header(cpi, &wb);
+  saved_wb = wb;
+  aom_wb_write_literal(&wb, 0, 16 + have_tiles * 2);
+  uncompressed_hdr_size = aom_wb_bytes_written(&wb);
+  if (uncompressed_hdr_size > MAX_UNCOMPRESSED_HEADER_SIZE)
+    aom_internal_error(&cpi->common.error, AOM_CODEC_ERROR,
+                       "Uncompressed frame header too large");
+
+  data_sz = pd->data_sz;
+#if CONFIG_MISC_FIXES
+  data_sz = write_tile_size_bytes(cm, &saved_wb, pd->data + pd->first_part_size,
+                                  data_sz, pd->max_tile);
+#endif
+  aom_wb_write_literal(&saved_wb, (int)pd->first_part_size, 16);
+
+  // Close the gap between the header and the data packed after the space
+  // reserved for it.
+  memmove(dest + uncompressed_hdr_size, pd->data,
+          pd->first_part_size + data_sz);
+
+  *size = uncompressed_hdr_size + pd->first_part_size + data_sz;
+}
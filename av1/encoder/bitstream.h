@@ -21,6 +21,16 @@ extern "C" {
 void av1_encode_token_init();
 void av1_pack_bitstream(AV1_COMP *const cpi, uint8_t *dest, size_t *size);
 
+// Pack the compressed header and the tile data of the frame on
+// cpi->workers[0], while the caller applies the filters to the frame on the
+// other workers. Only the filter application is overlapped: the caller starts
+// packing once the loop filter level and deringing searches are done.
+// av1_finish_pack_bitstream() then writes the uncompressed header in front of
+// them. Only used with a single tile column: av1_pack_bitstream() packs
+// several tile columns in parallel on all the workers instead.
+void av1_start_pack_bitstream(AV1_COMP *cpi, uint8_t *dest);
+void av1_finish_pack_bitstream(AV1_COMP *cpi, uint8_t *dest, size_t *size);
+
 static INLINE int av1_preserve_existing_gf(AV1_COMP *cpi) {
   return !cpi->multi_arf_allowed && cpi->refresh_golden_frame &&
          cpi->rc.is_src_frame_alt_ref;
@@ -2393,14 +2393,15 @@ static void rd_pick_partition(AV1_COMP *cpi, ThreadData *td,
   }
 }
 
-static void encode_rd_sb_row(AV1_COMP *cpi, ThreadData *td,
-                             TileDataEnc *tile_data, int mi_row,
-                             TOKENEXTRA **tp) {
+void av1_encode_sb_row(AV1_COMP *cpi, ThreadData *td, TileDataEnc *tile_data,
+                       int mi_row, TOKENEXTRA **tp,
+                       AV1EncRowMTSync *row_mt_sync) {
   AV1_COMMON *const cm = &cpi->common;
   TileInfo *const tile_info = &tile_data->tile_info;
   MACROBLOCK *const x = &td->mb;
   MACROBLOCKD *const xd = &x->e_mbd;
   SPEED_FEATURES *const sf = &cpi->sf;
+  const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
   int mi_col;
 
   // Initialize the left context for the new SB row
@@ -2419,6 +2420,9 @@ static void encode_rd_sb_row(AV1_COMP *cpi, ThreadData *td,
 
     const int idx_str = cm->mi_stride * mi_row + mi_col;
     MODE_INFO **mi = cm->mi_grid_visible + idx_str;
+    const int sb_col = (mi_col - tile_info->mi_col_start) >> MI_BLOCK_SIZE_LOG2;
+
+    if (row_mt_sync) av1_enc_row_mt_sync_read(row_mt_sync, sb_row, sb_col);
 
     if (sf->adaptive_pred_interp_filter) {
       for (i = 0; i < 64; ++i) td->leaf_tree[i].pred_interp_filter = SWITCHABLE;
@@ -2471,6 +2475,8 @@ static void encode_rd_sb_row(AV1_COMP *cpi, ThreadData *td,
       rd_pick_partition(cpi, td, tile_data, tp, mi_row, mi_col, BLOCK_64X64,
                         &dummy_rdc, INT64_MAX, td->pc_root);
     }
+
+    if (row_mt_sync) av1_enc_row_mt_sync_write(row_mt_sync, sb_row, sb_col);
   }
 }
 
@@ -2587,16 +2593,24 @@ void av1_encode_tile(AV1_COMP *cpi, ThreadData *td, int tile_row,
   TileDataEnc *this_tile = &cpi->tile_data[tile_row * tile_cols + tile_col];
   const TileInfo *const tile_info = &this_tile->tile_info;
   TOKENEXTRA *tok = cpi->tile_tok[tile_row][tile_col];
+  int m_search_count = 0;
+  int ex_search_count = 0;
   int mi_row;
 
-  // Set up pointers to per thread motion search counters.
-  td->mb.m_search_count_ptr = &td->rd_counts.m_search_count;
-  td->mb.ex_search_count_ptr = &td->rd_counts.ex_search_count;
+  // Set up pointers to per tile motion search counters, so that the tile is
+  // encoded the same way whichever thread picks it up.
+  td->mb.m_search_count_ptr = &m_search_count;
+  td->mb.ex_search_count_ptr = &ex_search_count;
 
   for (mi_row = tile_info->mi_row_start; mi_row < tile_info->mi_row_end;
        mi_row += MI_BLOCK_SIZE) {
-    encode_rd_sb_row(cpi, td, this_tile, mi_row, &tok);
+    av1_encode_sb_row(cpi, td, this_tile, mi_row, &tok, NULL);
   }
+  td->rd_counts.m_search_count += m_search_count;
+  td->rd_counts.ex_search_count += ex_search_count;
+  // The tile's counters go out of scope here.
+  td->mb.m_search_count_ptr = NULL;
+  td->mb.ex_search_count_ptr = NULL;
   cpi->tok_count[tile_row][tile_col] =
       (unsigned int)(tok - cpi->tile_tok[tile_row][tile_col]);
   assert(tok - cpi->tile_tok[tile_row][tile_col] <=
@@ -2688,8 +2702,13 @@ static void encode_frame_internal(AV1_COMP *cpi) {
     }
 #endif
 
+    // Row based multi-threading splits each tile into superblock rows. The
+    // row path is also taken with a single thread so that the output does not
+    // depend on the number of threads.
+    if (cpi->oxcf.row_mt)
+      av1_encode_tiles_row_mt(cpi);
     // If allowed, encoding tiles in parallel with one thread handling one tile.
-    if (AOMMIN(cpi->oxcf.max_threads, 1 << cm->log2_tile_cols) > 1)
+    else if (AOMMIN(cpi->oxcf.max_threads, 1 << cm->log2_tile_cols) > 1)
       av1_encode_tiles_mt(cpi);
     else
       encode_tiles(cpi);
@@ -22,6 +22,9 @@ struct macroblock;
 struct yv12_buffer_config;
 struct AV1_COMP;
 struct ThreadData;
+struct TileDataEnc;
+struct TOKENEXTRA;
+struct AV1EncRowMTSync;
 
 // Constants used in SOURCE_VAR_BASED_PARTITION
 #define VAR_HIST_MAX_BG_VAR 1000
@@ -39,6 +42,12 @@ void av1_encode_frame(struct AV1_COMP *cpi);
 void av1_init_tile_data(struct AV1_COMP *cpi);
 void av1_encode_tile(struct AV1_COMP *cpi, struct ThreadData *td,
                       int tile_row, int tile_col);
+// Encode the superblock row starting at mi_row of a tile. When row_mt_sync is
+// not NULL each superblock waits for the row above to be far enough ahead.
+void av1_encode_sb_row(struct AV1_COMP *cpi, struct ThreadData *td,
+                       struct TileDataEnc *tile_data, int mi_row,
+                       struct TOKENEXTRA **tp,
+                       struct AV1EncRowMTSync *row_mt_sync);
 
 void av1_set_variance_partition_thresholds(struct AV1_COMP *cpi, int q);
 
@@ -246,7 +246,8 @@ void av1_write_nmv_probs(AV1_COMMON *cm, int usehp, aom_writer *w,
 
 
 void av1_encode_mv(AV1_COMP *cpi, aom_writer *w, const MV *mv, const MV *ref,
-                    const nmv_context *mvctx, int usehp) {
+                    const nmv_context *mvctx, int usehp,
+                    unsigned int *const max_mv_magnitude) {
   const MV diff = { mv->row - ref->row, mv->col - ref->col };
   const MV_JOINT_TYPE j = av1_get_mv_joint(&diff);
   usehp = usehp && av1_use_mv_hp(ref);
@@ -263,7 +264,7 @@ void av1_encode_mv(AV1_COMP *cpi, aom_writer *w, const MV *mv, const MV *ref,
   // motion vector component used.
   if (cpi->sf.mv.auto_mv_step_size) {
     unsigned int maxv = AOMMAX(abs(mv->row), abs(mv->col)) >> 3;
-    cpi->max_mv_magnitude = AOMMAX(maxv, cpi->max_mv_magnitude);
+    *max_mv_magnitude = AOMMAX(maxv, *max_mv_magnitude);
   }
 }
 
@@ -24,7 +24,8 @@ void av1_write_nmv_probs(AV1_COMMON *cm, int usehp, aom_writer *w,
                           nmv_context_counts *const counts);
 
 void av1_encode_mv(AV1_COMP *cpi, aom_writer *w, const MV *mv, const MV *ref,
-                    const nmv_context *mvctx, int usehp);
+                    const nmv_context *mvctx, int usehp,
+                    unsigned int *const max_mv_magnitude);
 
 void av1_build_nmv_cost_table(int *mvjoint, int *mvcost[2],
                                const nmv_context *mvctx, int usehp);
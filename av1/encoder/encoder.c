@@ -39,6 +39,9 @@
 #include "av1/encoder/ethread.h"
 #include "av1/encoder/firstpass.h"
 #include "av1/encoder/mbgraph.h"
+#if CONFIG_DERING
+#include "av1/encoder/pickdering.h"
+#endif
 #include "av1/encoder/picklpf.h"
 #include "av1/encoder/ratectrl.h"
 #include "av1/encoder/rd.h"
@@ -348,9 +351,7 @@ void av1_initialize_enc(void) {
 
 static void dealloc_compressor_data(AV1_COMP *cpi) {
   AV1_COMMON *const cm = &cpi->common;
-#if CONFIG_REF_MV
   int i;
-#endif
 
   aom_free(cpi->mbmi_ext_base);
   cpi->mbmi_ext_base = NULL;
@@ -358,6 +359,14 @@ static void dealloc_compressor_data(AV1_COMP *cpi) {
   aom_free(cpi->tile_data);
   cpi->tile_data = NULL;
 
+  aom_free(cpi->twopass.row_stats);
+  cpi->twopass.row_stats = NULL;
+  aom_free(cpi->twopass.mb_factors);
+  cpi->twopass.mb_factors = NULL;
+  cpi->twopass.fp_mb_rows = 0;
+  cpi->twopass.fp_mb_cols = 0;
+  av1_enc_row_mt_sync_dealloc(&cpi->twopass.row_mt_sync);
+
   // Delete sementation map
   aom_free(cpi->segmentation_map);
   cpi->segmentation_map = NULL;
@@ -407,6 +416,15 @@ static void dealloc_compressor_data(AV1_COMP *cpi) {
   av1_free_context_buffers(cm);
 
   aom_free_frame_buffer(&cpi->last_frame_uf);
+  for (i = 0; i < MAX_LPF_SEARCH_JOBS - 1; ++i)
+    aom_free_frame_buffer(&cpi->lpf_search_buf[i]);
+  aom_free(cpi->lpf_search_cm);
+  cpi->lpf_search_cm = NULL;
+#if CONFIG_DERING
+  aom_free(cpi->dering_mse);
+  cpi->dering_mse = NULL;
+  cpi->dering_search_sbs = 0;
+#endif
   aom_free_frame_buffer(&cpi->scaled_source);
   aom_free_frame_buffer(&cpi->scaled_last_source);
   aom_free_frame_buffer(&cpi->alt_ref_buffer);
@@ -415,6 +433,10 @@ static void dealloc_compressor_data(AV1_COMP *cpi) {
   aom_free(cpi->tile_tok[0][0]);
   cpi->tile_tok[0][0] = 0;
 
+  aom_free(cpi->tile_pack_buf);
+  cpi->tile_pack_buf = NULL;
+  cpi->tile_pack_buf_size = 0;
+
   av1_free_pc_tree(&cpi->td);
 
   if (cpi->source_diff_var != NULL) {
@@ -1829,10 +1851,21 @@ void av1_remove_compressor(AV1_COMP *cpi) {
     }
   }
   aom_free(cpi->tile_thr_data);
+  aom_free(cpi->pack_tile_jobs);
   aom_free(cpi->workers);
+#if CONFIG_MULTITHREAD
+  if (cpi->job_mutex_ != NULL) {
+    pthread_mutex_destroy(cpi->job_mutex_);
+    aom_free(cpi->job_mutex_);
+  }
+#endif
 
   if (cpi->num_workers > 1) av1_loop_filter_dealloc(&cpi->lf_row_sync);
 
+  for (t = 0; t < cpi->num_row_mt_sync; ++t)
+    av1_enc_row_mt_sync_dealloc(&cpi->row_mt_sync[t]);
+  aom_free(cpi->row_mt_sync);
+
   dealloc_compressor_data(cpi);
 
   for (i = 0; i < sizeof(cpi->mbgraph_stats) / sizeof(cpi->mbgraph_stats[0]);
@@ -2325,12 +2358,14 @@ static void scale_and_extend_frame_nonnormative(const YV12_BUFFER_CONFIG *src,
   aom_extend_frame_borders(dst);
 }
 
+// Scale the band of 16 luma rows starting at row 'y' of 'src', and the chroma
+// rows under it, into 'dst'.
 #if CONFIG_AOM_HIGHBITDEPTH
-static void scale_and_extend_frame(const YV12_BUFFER_CONFIG *src,
-                                   YV12_BUFFER_CONFIG *dst, int bd) {
+static void scale_frame_rows(const YV12_BUFFER_CONFIG *src,
+                             YV12_BUFFER_CONFIG *dst, int y, int bd) {
 #else
-static void scale_and_extend_frame(const YV12_BUFFER_CONFIG *src,
-                                   YV12_BUFFER_CONFIG *dst) {
+static void scale_frame_rows(const YV12_BUFFER_CONFIG *src,
+                             YV12_BUFFER_CONFIG *dst, int y) {
 #endif  // CONFIG_AOM_HIGHBITDEPTH
   const int src_w = src->y_crop_width;
   const int src_h = src->y_crop_height;
@@ -2342,44 +2377,66 @@ static void scale_and_extend_frame(const YV12_BUFFER_CONFIG *src,
   uint8_t *const dsts[3] = { dst->y_buffer, dst->u_buffer, dst->v_buffer };
   const int dst_strides[3] = { dst->y_stride, dst->uv_stride, dst->uv_stride };
   const InterpKernel *const kernel = av1_filter_kernels[EIGHTTAP];
-  int x, y, i;
-
-  for (y = 0; y < dst_h; y += 16) {
-    for (x = 0; x < dst_w; x += 16) {
-      for (i = 0; i < MAX_MB_PLANE; ++i) {
-        const int factor = (i == 0 || i == 3 ? 1 : 2);
-        const int x_q4 = x * (16 / factor) * src_w / dst_w;
-        const int y_q4 = y * (16 / factor) * src_h / dst_h;
-        const int src_stride = src_strides[i];
-        const int dst_stride = dst_strides[i];
-        const uint8_t *src_ptr = srcs[i] +
-                                 (y / factor) * src_h / dst_h * src_stride +
-                                 (x / factor) * src_w / dst_w;
-        uint8_t *dst_ptr = dsts[i] + (y / factor) * dst_stride + (x / factor);
+  int x, i;
+
+  for (x = 0; x < dst_w; x += 16) {
+    for (i = 0; i < MAX_MB_PLANE; ++i) {
+      const int factor = (i == 0 || i == 3 ? 1 : 2);
+      const int x_q4 = x * (16 / factor) * src_w / dst_w;
+      const int y_q4 = y * (16 / factor) * src_h / dst_h;
+      const int src_stride = src_strides[i];
+      const int dst_stride = dst_strides[i];
+      const uint8_t *src_ptr = srcs[i] +
+                               (y / factor) * src_h / dst_h * src_stride +
+                               (x / factor) * src_w / dst_w;
+      uint8_t *dst_ptr = dsts[i] + (y / factor) * dst_stride + (x / factor);
 
 #if CONFIG_AOM_HIGHBITDEPTH
-        if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
-          aom_highbd_convolve8(src_ptr, src_stride, dst_ptr, dst_stride,
-                               kernel[x_q4 & 0xf], 16 * src_w / dst_w,
-                               kernel[y_q4 & 0xf], 16 * src_h / dst_h,
-                               16 / factor, 16 / factor, bd);
-        } else {
-          aom_convolve8(src_ptr, src_stride, dst_ptr, dst_stride,
-                        kernel[x_q4 & 0xf], 16 * src_w / dst_w,
-                        kernel[y_q4 & 0xf], 16 * src_h / dst_h, 16 / factor,
-                        16 / factor);
-        }
-#else
-        aom_convolve8(src_ptr, src_stride, dst_ptr, dst_stride,
+      if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+        aom_highbd_convolve8(src_ptr, src_stride, dst_ptr, dst_stride,
+                             kernel[x_q4 & 0xf], 16 * src_w / dst_w,
+                             kernel[y_q4 & 0xf], 16 * src_h / dst_h,
+                             16 / factor, 16 / factor, bd);
+      } else {
+        aom_scaled_2d(src_ptr, src_stride, dst_ptr, dst_stride,
                       kernel[x_q4 & 0xf], 16 * src_w / dst_w,
                       kernel[y_q4 & 0xf], 16 * src_h / dst_h, 16 / factor,
                       16 / factor);
-#endif  // CONFIG_AOM_HIGHBITDEPTH
       }
+#else
+      aom_scaled_2d(src_ptr, src_stride, dst_ptr, dst_stride,
+                    kernel[x_q4 & 0xf], 16 * src_w / dst_w,
+                    kernel[y_q4 & 0xf], 16 * src_h / dst_h, 16 / factor,
+                    16 / factor);
+#endif  // CONFIG_AOM_HIGHBITDEPTH
     }
   }
+}
 
-  aom_extend_frame_borders(dst);
+void av1_scale_reference_rows(const ScaleRefsData *sr, int ref, int row) {
+#if CONFIG_AOM_HIGHBITDEPTH
+  scale_frame_rows(sr->src[ref], sr->dst[ref], row * 16, sr->bd);
+#else
+  scale_frame_rows(sr->src[ref], sr->dst[ref], row * 16);
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+}
+
+static void scale_and_extend_references(AV1_COMP *cpi, ScaleRefsData *sr) {
+  const AV1_COMMON *const cm = &cpi->common;
+  int ref, row;
+
+  sr->rows = (cm->height + 15) >> 4;
+  sr->bd = (int)cm->bit_depth;
+
+  if (cpi->oxcf.max_threads > 1 && sr->num_refs * sr->rows > 1) {
+    av1_scale_references_mt(cpi, sr);
+  } else {
+    for (ref = 0; ref < sr->num_refs; ++ref) {
+      for (row = 0; row < sr->rows; ++row)
+        av1_scale_reference_rows(sr, ref, row);
+      aom_extend_frame_borders(sr->dst[ref]);
+    }
+  }
 }
 
 static int scale_down(AV1_COMP *cpi, int q) {
@@ -2499,9 +2556,16 @@ void av1_update_reference_frames(AV1_COMP *cpi) {
   }
 }
 
-static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
+// When 'dest' is not NULL, the frame is packed into it on cpi->workers[0]
+// once the filter searches are done, and the filters are applied on the other
+// workers meanwhile. The searches themselves are not overlapped: the level
+// search uses all the workers, and the compressed header updates state that
+// it shares with them.
+static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm, uint8_t *dest) {
   MACROBLOCKD *xd = &cpi->td.mb.e_mbd;
   struct loopfilter *lf = &cm->lf;
+  AVxWorker *workers = cpi->workers;
+  int num_workers = cpi->num_workers;
   if (is_lossless_requested(&cpi->oxcf)) {
     lf->filter_level = 0;
   } else {
@@ -2517,11 +2581,19 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
     cpi->time_pick_lpf += aom_usec_timer_elapsed(&timer);
   }
 
+#if !CONFIG_DERING
+  if (dest != NULL) {
+    av1_start_pack_bitstream(cpi, dest);
+    ++workers;
+    --num_workers;
+  }
+#endif
+
   if (lf->filter_level > 0) {
-    if (cpi->num_workers > 1)
+    if (num_workers > 1)
       av1_loop_filter_frame_mt(cm->frame_to_show, cm, xd->plane,
-                                lf->filter_level, 0, 0, cpi->workers,
-                                cpi->num_workers, &cpi->lf_row_sync);
+                                lf->filter_level, 0, 0, workers, num_workers,
+                                &cpi->lf_row_sync);
     else
       av1_loop_filter_frame(cm->frame_to_show, cm, xd, lf->filter_level, 0, 0);
   }
@@ -2530,9 +2602,23 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
   if (is_lossless_requested(&cpi->oxcf)) {
     cm->dering_level = 0;
   } else {
-    cm->dering_level = av1_dering_search(cm->frame_to_show, cpi->Source, cm,
-                                          xd);
-    av1_dering_frame(cm->frame_to_show, cm, xd, cm->dering_level);
+    cm->dering_level =
+        av1_dering_search(cpi, cm->frame_to_show, cpi->Source);
+  }
+
+  // The tile data carries the deringing refinements picked above.
+  if (dest != NULL) {
+    av1_start_pack_bitstream(cpi, dest);
+    ++workers;
+    --num_workers;
+  }
+
+  if (!is_lossless_requested(&cpi->oxcf)) {
+    if (num_workers > 1)
+      av1_dering_frame_mt(cm->frame_to_show, cm, xd->plane, cm->dering_level,
+                          workers, num_workers, &cpi->lf_row_sync);
+    else
+      av1_dering_frame(cm->frame_to_show, cm, xd, cm->dering_level);
   }
 #endif  // CONFIG_DERING
 
@@ -2615,6 +2701,11 @@ void av1_scale_references(AV1_COMP *cpi) {
   MV_REFERENCE_FRAME ref_frame;
   const AOM_REFFRAME ref_mask[3] = { AOM_LAST_FLAG, AOM_GOLD_FLAG,
                                      AOM_ALT_FLAG };
+  ScaleRefsData sr;
+
+  // The references are scaled together once their buffers are set up, so the
+  // row bands of all of them can be spread over the worker threads.
+  sr.num_refs = 0;
 
   for (ref_frame = LAST_FRAME; ref_frame <= ALTREF_FRAME; ++ref_frame) {
     // Need to convert from AOM_REFFRAME to index into ref_mask (subtract 1).
@@ -2637,7 +2728,7 @@ void av1_scale_references(AV1_COMP *cpi) {
           new_fb = get_free_fb(cm);
           force_scaling = 1;
         }
-        if (new_fb == INVALID_IDX) return;
+        if (new_fb == INVALID_IDX) break;
         new_fb_ptr = &pool->frame_bufs[new_fb];
         if (force_scaling || new_fb_ptr->buf.y_crop_width != cm->width ||
             new_fb_ptr->buf.y_crop_height != cm->height) {
@@ -2645,7 +2736,9 @@ void av1_scale_references(AV1_COMP *cpi) {
               &new_fb_ptr->buf, cm->width, cm->height, cm->subsampling_x,
               cm->subsampling_y, cm->use_highbitdepth, AOM_ENC_BORDER_IN_PIXELS,
               cm->byte_alignment, NULL, NULL, NULL);
-          scale_and_extend_frame(ref, &new_fb_ptr->buf, (int)cm->bit_depth);
+          sr.src[sr.num_refs] = ref;
+          sr.dst[sr.num_refs] = &new_fb_ptr->buf;
+          ++sr.num_refs;
           cpi->scaled_ref_idx[ref_frame - 1] = new_fb;
           alloc_frame_mvs(cm, new_fb);
         }
@@ -2658,7 +2751,7 @@ void av1_scale_references(AV1_COMP *cpi) {
           new_fb = get_free_fb(cm);
           force_scaling = 1;
         }
-        if (new_fb == INVALID_IDX) return;
+        if (new_fb == INVALID_IDX) break;
         new_fb_ptr = &pool->frame_bufs[new_fb];
         if (force_scaling || new_fb_ptr->buf.y_crop_width != cm->width ||
             new_fb_ptr->buf.y_crop_height != cm->height) {
@@ -2666,7 +2759,9 @@ void av1_scale_references(AV1_COMP *cpi) {
                                    cm->subsampling_x, cm->subsampling_y,
                                    AOM_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
                                    NULL, NULL, NULL);
-          scale_and_extend_frame(ref, &new_fb_ptr->buf);
+          sr.src[sr.num_refs] = ref;
+          sr.dst[sr.num_refs] = &new_fb_ptr->buf;
+          ++sr.num_refs;
           cpi->scaled_ref_idx[ref_frame - 1] = new_fb;
           alloc_frame_mvs(cm, new_fb);
         }
@@ -2683,6 +2778,8 @@ void av1_scale_references(AV1_COMP *cpi) {
       if (cpi->oxcf.pass != 0) cpi->scaled_ref_idx[ref_frame - 1] = INVALID_IDX;
     }
   }
+
+  if (sr.num_refs > 0) scale_and_extend_references(cpi, &sr);
 }
 
 static void release_scaled_references(AV1_COMP *cpi) {
@@ -3397,6 +3494,7 @@ static void encode_frame_to_data_rate(AV1_COMP *cpi, size_t *size,
   const AV1EncoderConfig *const oxcf = &cpi->oxcf;
   struct segmentation *const seg = &cm->seg;
   TX_SIZE t;
+  int overlap_pack;
 
   set_ext_overrides(cpi);
   aom_clear_system_state();
@@ -3491,11 +3589,21 @@ static void encode_frame_to_data_rate(AV1_COMP *cpi, size_t *size,
   cm->frame_to_show->render_width = cm->render_width;
   cm->frame_to_show->render_height = cm->render_height;
 
-  // Pick the loop filter level for the frame.
-  loopfilter_frame(cpi, cm);
+  // Pick the loop filter level for the frame. With worker threads and a
+  // single tile column, the bitstream is packed while the filters are applied
+  // and only the uncompressed header, which carries the filter levels, is
+  // left for afterwards. Several tile columns are instead packed in parallel
+  // once the filtering is done. The pool is created here rather than relying
+  // on an earlier stage having done so.
+  if (cpi->oxcf.max_threads > 1) av1_create_enc_workers(cpi);
+  overlap_pack = cpi->num_workers > 1 && cm->log2_tile_cols == 0;
+  loopfilter_frame(cpi, cm, overlap_pack ? dest : NULL);
 
   // build the bitstream
-  av1_pack_bitstream(cpi, dest, size);
+  if (overlap_pack)
+    av1_finish_pack_bitstream(cpi, dest, size);
+  else
+    av1_pack_bitstream(cpi, dest, size);
 
   if (cm->seg.update_map) update_reference_segmentation_map(cpi);
 
@@ -18,6 +18,9 @@
 #include "aom/aomcx.h"
 
 #include "av1/common/alloccommon.h"
+#if CONFIG_DERING
+#include "av1/common/dering.h"
+#endif  // CONFIG_DERING
 #include "av1/common/entropymode.h"
 #include "av1/common/thread_common.h"
 #include "av1/common/onyxc_int.h"
@@ -46,6 +49,10 @@
 extern "C" {
 #endif
 
+// Maximum number of loop filter levels tried at the same time by the filter
+// level search.
+#define MAX_LPF_SEARCH_JOBS 4
+
 typedef struct {
   int nmvjointcost[MV_JOINTS];
   int nmvcosts[2][MV_VALS];
@@ -222,6 +229,8 @@ typedef struct AV1EncoderConfig {
   int tile_rows;
 
   int max_threads;
+  // Encode the superblock rows of each tile in parallel.
+  int row_mt;
 
   aom_fixed_buf_t two_pass_stats_in;
   struct aom_codec_pkt_list *output_pkt_list;
@@ -271,6 +280,8 @@ typedef struct ThreadData {
 } ThreadData;
 
 struct EncWorkerData;
+struct AV1EncRowMTSync;
+struct PackTilesJob;
 
 typedef struct ActiveMap {
   int enabled;
@@ -285,6 +296,16 @@ typedef struct IMAGE_STAT {
   double worst;
 } ImageStat;
 
+// The compressed header and the tile data of a frame, packed by
+// cpi->workers[0] at 'data' while the frame is being filtered.
+typedef struct PackFrameData {
+  MACROBLOCKD xd;
+  uint8_t *data;
+  size_t first_part_size;
+  size_t data_sz;
+  unsigned int max_tile;
+} PackFrameData;
+
 typedef struct AV1_COMP {
   QUANTS quants;
   ThreadData td;
@@ -327,9 +348,24 @@ typedef struct AV1_COMP {
   int ext_refresh_frame_context;
 
   YV12_BUFFER_CONFIG last_frame_uf;
+  // Scratch frames and common state of the loop filter level search jobs.
+  YV12_BUFFER_CONFIG lpf_search_buf[MAX_LPF_SEARCH_JOBS - 1];
+  AV1_COMMON *lpf_search_cm;
+#if CONFIG_DERING
+  // Squared error of every deringing level for each superblock, with room
+  // for dering_search_sbs superblocks.
+  int (*dering_mse)[MAX_DERING_LEVEL];
+  int dering_search_sbs;
+#endif
 
   TOKENEXTRA *tile_tok[4][1 << 6];
   unsigned int tok_count[4][1 << 6];
+  // Scratch space of tile_pack_buf_size bytes the tile columns are packed
+  // into by the worker threads.
+  uint8_t *tile_pack_buf;
+  size_t tile_pack_buf_size;
+  // One tile packing job per worker.
+  struct PackTilesJob *pack_tile_jobs;
 
   // Ambient reconstruction err target for force key frames
   int64_t ambient_err;
@@ -503,7 +539,17 @@ typedef struct AV1_COMP {
   int num_workers;
   AVxWorker *workers;
   struct EncWorkerData *tile_thr_data;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *job_mutex_;
+#endif
+  // Next job, a tile column or a row of blocks, to be handed out to a worker.
+  int next_job;
   AV1LfSync lf_row_sync;
+  // Superblock row synchronization of each tile column for row based
+  // encoding.
+  struct AV1EncRowMTSync *row_mt_sync;
+  int num_row_mt_sync;
+  PackFrameData pack_data;
 } AV1_COMP;
 
 void av1_initialize_enc(void);
@@ -610,6 +656,22 @@ void av1_alloc_compressor_data(AV1_COMP *cpi);
 
 void av1_scale_references(AV1_COMP *cpi);
 
+// The references rescaled to the frame size, shared by the threads scaling
+// their row bands.
+typedef struct ScaleRefsData {
+  const YV12_BUFFER_CONFIG *src[3];
+  YV12_BUFFER_CONFIG *dst[3];
+  int num_refs;
+  // Number of 16 pixel high row bands in each reference.
+  int rows;
+  int bd;
+} ScaleRefsData;
+
+// Scale row band 'row' of reference 'ref'. The bands are independent of each
+// other, the borders of a reference are extended once all of its bands are
+// scaled.
+void av1_scale_reference_rows(const ScaleRefsData *sr, int ref, int row);
+
 void av1_update_reference_frames(AV1_COMP *cpi);
 
 void av1_set_high_precision_mv(AV1_COMP *cpi, int allow_high_precision_mv);
@@ -9,10 +9,18 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <assert.h>
+
+#include "./aom_scale_rtcd.h"
 #include "av1/encoder/encodeframe.h"
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/ethread.h"
+#if CONFIG_DERING
+#include "av1/encoder/pickdering.h"
+#endif
+#include "av1/encoder/temporal_filter.h"
 #include "aom_dsp/aom_dsp_common.h"
+#include "aom_mem/aom_mem.h"
 
 static void accumulate_rd_opt(ThreadData *td, ThreadData *td_t) {
   int i, j, k, l, m, n;
@@ -37,38 +45,148 @@ static void accumulate_rd_opt(ThreadData *td, ThreadData *td_t) {
   td->rd_counts.ex_search_count += td_t->rd_counts.ex_search_count;
 }
 
+void av1_enc_row_mt_sync_alloc(AV1EncRowMTSync *row_mt_sync, AV1_COMMON *cm,
+                               int rows, int sb_cols) {
+  row_mt_sync->rows = rows;
+  row_mt_sync->sb_cols = sb_cols;
+#if CONFIG_MULTITHREAD
+  {
+    int i;
+
+    CHECK_MEM_ERROR(cm, row_mt_sync->mutex_,
+                    aom_malloc(sizeof(*row_mt_sync->mutex_) * rows));
+    for (i = 0; i < rows; ++i)
+      pthread_mutex_init(&row_mt_sync->mutex_[i], NULL);
+
+    CHECK_MEM_ERROR(cm, row_mt_sync->cond_,
+                    aom_malloc(sizeof(*row_mt_sync->cond_) * rows));
+    for (i = 0; i < rows; ++i) pthread_cond_init(&row_mt_sync->cond_[i], NULL);
+  }
+#endif  // CONFIG_MULTITHREAD
+
+  CHECK_MEM_ERROR(cm, row_mt_sync->cur_sb_col,
+                  aom_malloc(sizeof(*row_mt_sync->cur_sb_col) * rows));
+  CHECK_MEM_ERROR(cm, row_mt_sync->tok_count,
+                  aom_malloc(sizeof(*row_mt_sync->tok_count) * rows));
+
+  row_mt_sync->sync_range = av1_get_sync_range(cm->width);
+}
+
+void av1_enc_row_mt_sync_dealloc(AV1EncRowMTSync *row_mt_sync) {
+  if (row_mt_sync != NULL) {
+#if CONFIG_MULTITHREAD
+    int i;
+
+    if (row_mt_sync->mutex_ != NULL) {
+      for (i = 0; i < row_mt_sync->rows; ++i)
+        pthread_mutex_destroy(&row_mt_sync->mutex_[i]);
+      aom_free(row_mt_sync->mutex_);
+    }
+    if (row_mt_sync->cond_ != NULL) {
+      for (i = 0; i < row_mt_sync->rows; ++i)
+        pthread_cond_destroy(&row_mt_sync->cond_[i]);
+      aom_free(row_mt_sync->cond_);
+    }
+#endif  // CONFIG_MULTITHREAD
+    aom_free(row_mt_sync->cur_sb_col);
+    aom_free(row_mt_sync->tok_count);
+    // clear the structure as the source of this call may be a resize in which
+    // case this call will be followed by an _alloc() which may fail.
+    av1_zero(*row_mt_sync);
+  }
+}
+
+void av1_enc_row_mt_sync_read(AV1EncRowMTSync *row_mt_sync, int r, int c) {
+#if CONFIG_MULTITHREAD
+  const int nsync = row_mt_sync->sync_range;
+
+  if (r && !(c & (nsync - 1))) {
+    pthread_mutex_t *const mutex = &row_mt_sync->mutex_[r - 1];
+    pthread_mutex_lock(mutex);
+
+    while (c > row_mt_sync->cur_sb_col[r - 1] - nsync)
+      pthread_cond_wait(&row_mt_sync->cond_[r - 1], mutex);
+    pthread_mutex_unlock(mutex);
+  }
+#else
+  (void)row_mt_sync;
+  (void)r;
+  (void)c;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void av1_enc_row_mt_sync_write(AV1EncRowMTSync *row_mt_sync, int r, int c) {
+#if CONFIG_MULTITHREAD
+  const int nsync = row_mt_sync->sync_range;
+  int cur;
+  // Only signal when there are enough encoded SBs for the next row to run.
+  int sig = 1;
+
+  if (c < row_mt_sync->sb_cols - 1) {
+    cur = c;
+    if (c % nsync) sig = 0;
+  } else {
+    cur = row_mt_sync->sb_cols + nsync;
+  }
+
+  if (sig) {
+    pthread_mutex_lock(&row_mt_sync->mutex_[r]);
+    row_mt_sync->cur_sb_col[r] = cur;
+    pthread_cond_signal(&row_mt_sync->cond_[r]);
+    pthread_mutex_unlock(&row_mt_sync->mutex_[r]);
+  }
+#else
+  (void)row_mt_sync;
+  (void)r;
+  (void)c;
+#endif  // CONFIG_MULTITHREAD
+}
+
+// Hand out the next job, e.g. a tile column to be encoded. Every worker takes
+// a new job as soon as it is done with the last one, so jobs that take
+// different times keep all the workers busy.
+static int get_next_job(AV1_COMP *cpi) {
+  int t;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(cpi->job_mutex_);
+#endif
+  t = cpi->next_job++;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(cpi->job_mutex_);
+#endif
+  return t;
+}
+
 static int enc_worker_hook(EncWorkerData *const thread_data, void *unused) {
   AV1_COMP *const cpi = thread_data->cpi;
   const AV1_COMMON *const cm = &cpi->common;
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int tile_rows = 1 << cm->log2_tile_rows;
-  int t;
+  int tile_row, tile_col;
 
   (void)unused;
 
-  for (t = thread_data->start; t < tile_rows * tile_cols;
-       t += cpi->num_workers) {
-    int tile_row = t / tile_cols;
-    int tile_col = t % tile_cols;
-
-    av1_encode_tile(cpi, thread_data->td, tile_row, tile_col);
+  // Tile rows use the above context of the tile row above them, so the tiles
+  // of a column are encoded in order by one worker.
+  while ((tile_col = get_next_job(cpi)) < tile_cols) {
+    for (tile_row = 0; tile_row < tile_rows; ++tile_row)
+      av1_encode_tile(cpi, thread_data->td, tile_row, tile_col);
   }
 
   return 0;
 }
 
-void av1_encode_tiles_mt(AV1_COMP *cpi) {
+// Only run once to create threads and allocate thread data. The pool is
+// shared by all the multi-threaded stages of the encoder, any of which may be
+// the first to run, so it gets a worker for each thread. Each stage then uses
+// as many of the workers as it has work for.
+void av1_create_enc_workers(AV1_COMP *cpi) {
   AV1_COMMON *const cm = &cpi->common;
-  const int tile_cols = 1 << cm->log2_tile_cols;
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
-  const int num_workers = AOMMIN(cpi->oxcf.max_threads, tile_cols);
   int i;
 
-  av1_init_tile_data(cpi);
-
-  // Only run once to create threads and allocate thread data.
   if (cpi->num_workers == 0) {
-    int allocated_workers = num_workers;
+    const int allocated_workers = AOMMAX(cpi->oxcf.max_threads, 1);
 
     CHECK_MEM_ERROR(cm, cpi->workers,
                     aom_malloc(allocated_workers * sizeof(*cpi->workers)));
@@ -76,6 +194,12 @@ void av1_encode_tiles_mt(AV1_COMP *cpi) {
     CHECK_MEM_ERROR(cm, cpi->tile_thr_data,
                     aom_calloc(allocated_workers, sizeof(*cpi->tile_thr_data)));
 
+#if CONFIG_MULTITHREAD
+    CHECK_MEM_ERROR(cm, cpi->job_mutex_,
+                    aom_malloc(sizeof(*cpi->job_mutex_)));
+    pthread_mutex_init(cpi->job_mutex_, NULL);
+#endif
+
     for (i = 0; i < allocated_workers; i++) {
       AVxWorker *const worker = &cpi->workers[i];
       EncWorkerData *thread_data = &cpi->tile_thr_data[i];
@@ -113,12 +237,17 @@ void av1_encode_tiles_mt(AV1_COMP *cpi) {
       winterface->sync(worker);
     }
   }
+}
+
+static void prepare_enc_workers(AV1_COMP *cpi, AVxWorkerHook hook,
+                                int num_workers) {
+  int i;
 
   for (i = 0; i < num_workers; i++) {
     AVxWorker *const worker = &cpi->workers[i];
     EncWorkerData *thread_data;
 
-    worker->hook = (AVxWorkerHook)enc_worker_hook;
+    worker->hook = hook;
     worker->data1 = &cpi->tile_thr_data[i];
     worker->data2 = NULL;
     thread_data = (EncWorkerData *)worker->data1;
@@ -133,35 +262,432 @@ void av1_encode_tiles_mt(AV1_COMP *cpi) {
              sizeof(cpi->common.counts));
     }
   }
+}
+
+// Run the workers, with the last one on the main thread, and wait for all of
+// them to finish.
+static void launch_enc_workers(AV1_COMP *cpi, int num_workers) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  int i;
 
-  // Encode a frame
   for (i = 0; i < num_workers; i++) {
     AVxWorker *const worker = &cpi->workers[i];
-    EncWorkerData *const thread_data = (EncWorkerData *)worker->data1;
 
-    // Set the starting tile for each thread.
-    thread_data->start = i;
-
-    if (i == cpi->num_workers - 1)
+    if (i == num_workers - 1)
       winterface->execute(worker);
     else
       winterface->launch(worker);
   }
 
-  // Encoding ends.
   for (i = 0; i < num_workers; i++) {
     AVxWorker *const worker = &cpi->workers[i];
     winterface->sync(worker);
   }
+}
+
+// Encode a frame and accumulate the counters of the workers other than the
+// main thread.
+static void run_enc_workers(AV1_COMP *cpi, int num_workers) {
+  AV1_COMMON *const cm = &cpi->common;
+  int i;
+
+  launch_enc_workers(cpi, num_workers);
 
   for (i = 0; i < num_workers; i++) {
     AVxWorker *const worker = &cpi->workers[i];
     EncWorkerData *const thread_data = (EncWorkerData *)worker->data1;
 
     // Accumulate counters.
-    if (i < cpi->num_workers - 1) {
+    if (thread_data->td != &cpi->td) {
       av1_accumulate_frame_counts(cm, thread_data->td->counts, 0);
       accumulate_rd_opt(&cpi->td, thread_data->td);
     }
   }
 }
+
+void av1_encode_tiles_mt(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  int num_workers = AOMMIN(cpi->oxcf.max_threads, tile_cols);
+
+  av1_init_tile_data(cpi);
+
+  av1_create_enc_workers(cpi);
+  num_workers = AOMMIN(num_workers, cpi->num_workers);
+  prepare_enc_workers(cpi, (AVxWorkerHook)enc_worker_hook, num_workers);
+  cpi->next_job = 0;
+
+  run_enc_workers(cpi, num_workers);
+}
+
+static int get_tile_sb_cols(const TileInfo *tile_info) {
+  const int mi_cols = tile_info->mi_col_end - tile_info->mi_col_start;
+  return (mi_cols + MI_BLOCK_SIZE - 1) >> MI_BLOCK_SIZE_LOG2;
+}
+
+// Tokens available to each superblock row of a tile. The rows of a tile write
+// their tokens to separate parts of the tile's token buffer, and the last row
+// gets what is left.
+static int get_sb_row_token_alloc(const TileInfo *tile_info) {
+  const int tile_mb_cols =
+      (tile_info->mi_col_end - tile_info->mi_col_start + 1) >> 1;
+  return get_token_alloc(MI_BLOCK_SIZE >> 1, tile_mb_cols);
+}
+
+// Return the tile row of tile column 'tile_col' holding superblock row
+// 'sb_row' of the frame.
+static int get_sb_row_tile_row(const AV1_COMP *cpi, int tile_col, int sb_row) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  const int mi_row = sb_row << MI_BLOCK_SIZE_LOG2;
+  int tile_row = 0;
+
+  while (tile_row < tile_rows - 1 &&
+         mi_row >=
+             cpi->tile_data[tile_row * tile_cols + tile_col].tile_info.mi_row_end)
+    ++tile_row;
+  return tile_row;
+}
+
+static void encode_tile_sb_row(AV1_COMP *cpi, ThreadData *td, int tile_col,
+                               int sb_row) {
+  AV1_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_row = get_sb_row_tile_row(cpi, tile_col, sb_row);
+  TileDataEnc *const this_tile =
+      &cpi->tile_data[tile_row * tile_cols + tile_col];
+  AV1EncRowMTSync *const row_mt_sync = &cpi->row_mt_sync[tile_col];
+  const TileInfo *const tile_info = &this_tile->tile_info;
+  const int mi_row = sb_row << MI_BLOCK_SIZE_LOG2;
+  const int tile_sb_row =
+      (mi_row - tile_info->mi_row_start) >> MI_BLOCK_SIZE_LOG2;
+  TOKENEXTRA *const row_tok = cpi->tile_tok[tile_row][tile_col] +
+                              tile_sb_row * get_sb_row_token_alloc(tile_info);
+  TOKENEXTRA *tok = row_tok;
+  TileDataEnc row_tile = *this_tile;
+  int m_search_count = 0;
+  int ex_search_count = 0;
+
+  // Every row starts from the adaptive mode thresholds the tile had at the
+  // start of the frame and counts its own motion searches, so the result
+  // does not depend on which thread encodes the row.
+  td->mb.m_search_count_ptr = &m_search_count;
+  td->mb.ex_search_count_ptr = &ex_search_count;
+
+  av1_encode_sb_row(cpi, td, &row_tile, mi_row, &tok, row_mt_sync);
+
+  td->rd_counts.m_search_count += m_search_count;
+  td->rd_counts.ex_search_count += ex_search_count;
+  // The row's counters go out of scope here.
+  td->mb.m_search_count_ptr = NULL;
+  td->mb.ex_search_count_ptr = NULL;
+  row_mt_sync->tok_count[sb_row] = (unsigned int)(tok - row_tok);
+  assert(mi_row + MI_BLOCK_SIZE < tile_info->mi_row_end ||
+         tok - cpi->tile_tok[tile_row][tile_col] <=
+             allocated_tokens(*tile_info));
+  assert(mi_row + MI_BLOCK_SIZE >= tile_info->mi_row_end ||
+         tok - row_tok <= get_sb_row_token_alloc(tile_info));
+
+  // The rows above have all finished by the time the last row of the tile is
+  // done, so its thresholds are carried over to the next frame.
+  if (mi_row + MI_BLOCK_SIZE >= tile_info->mi_row_end) *this_tile = row_tile;
+}
+
+// The number of workers sharing the rows is passed in data2.
+static int enc_row_mt_worker_hook(EncWorkerData *const thread_data,
+                                  void *data2) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  const AV1_COMMON *const cm = &cpi->common;
+  const int num_workers = (int)(intptr_t)data2;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  int job = 0;
+  int sb_row, tile_col;
+
+  // The superblock rows are handed out in frame raster order. Tile rows
+  // depend on the tile row above, so a row only ever waits for the row above
+  // it in the same tile column. That row has a lower job index, so a thread
+  // can always make progress on the lowest unfinished row.
+  for (sb_row = 0; sb_row < cpi->row_mt_sync[0].rows; ++sb_row) {
+    for (tile_col = 0; tile_col < tile_cols; ++tile_col, ++job) {
+      if (job % num_workers == thread_data->start)
+        encode_tile_sb_row(cpi, thread_data->td, tile_col, sb_row);
+    }
+  }
+
+  return 0;
+}
+
+// Size the synchronization for 'rows' rows of 'sb_cols' blocks and mark all
+// the rows as not started.
+static void reset_row_mt_sync(AV1EncRowMTSync *row_mt_sync, AV1_COMMON *cm,
+                              int rows, int sb_cols) {
+  if (row_mt_sync->rows != rows || row_mt_sync->sb_cols != sb_cols ||
+      row_mt_sync->sync_range != av1_get_sync_range(cm->width)) {
+    av1_enc_row_mt_sync_dealloc(row_mt_sync);
+    av1_enc_row_mt_sync_alloc(row_mt_sync, cm, rows, sb_cols);
+  }
+  memset(row_mt_sync->cur_sb_col, -1, sizeof(*row_mt_sync->cur_sb_col) * rows);
+}
+
+static void init_row_mt_sync(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int rows = (cm->mi_rows + MI_BLOCK_SIZE - 1) >> MI_BLOCK_SIZE_LOG2;
+  int tile_col;
+
+  if (cpi->num_row_mt_sync < tile_cols) {
+    for (tile_col = 0; tile_col < cpi->num_row_mt_sync; ++tile_col)
+      av1_enc_row_mt_sync_dealloc(&cpi->row_mt_sync[tile_col]);
+    aom_free(cpi->row_mt_sync);
+    cpi->num_row_mt_sync = 0;
+    CHECK_MEM_ERROR(cm, cpi->row_mt_sync,
+                    aom_calloc(tile_cols, sizeof(*cpi->row_mt_sync)));
+    cpi->num_row_mt_sync = tile_cols;
+  }
+
+  // The superblock rows of a tile column are synchronized across tile rows.
+  for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
+    reset_row_mt_sync(&cpi->row_mt_sync[tile_col], cm, rows,
+                      get_tile_sb_cols(&cpi->tile_data[tile_col].tile_info));
+  }
+}
+
+void av1_encode_tiles_row_mt(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  int num_workers;
+  int i, t;
+
+  av1_init_tile_data(cpi);
+  init_row_mt_sync(cpi);
+
+#if CONFIG_MULTITHREAD
+  num_workers = AOMMIN(cpi->oxcf.max_threads,
+                       cpi->row_mt_sync[0].rows * tile_cols);
+  num_workers = AOMMAX(num_workers, 1);
+#else
+  // Without threads the workers run one after another and the rows could not
+  // wait for the rows above.
+  num_workers = 1;
+#endif  // CONFIG_MULTITHREAD
+
+  av1_create_enc_workers(cpi);
+  num_workers = AOMMIN(num_workers, cpi->num_workers);
+  prepare_enc_workers(cpi, (AVxWorkerHook)enc_row_mt_worker_hook, num_workers);
+
+  for (i = 0; i < num_workers; i++) {
+    AVxWorker *const worker = &cpi->workers[i];
+    EncWorkerData *const thread_data = (EncWorkerData *)worker->data1;
+
+    thread_data->start = i;
+    worker->data2 = (void *)(intptr_t)num_workers;
+  }
+  run_enc_workers(cpi, num_workers);
+
+  // Close the gaps between the tokens of the superblock rows of each tile.
+  for (t = 0; t < tile_rows * tile_cols; ++t) {
+    const int tile_row = t / tile_cols;
+    const int tile_col = t % tile_cols;
+    const TileInfo *const tile_info = &cpi->tile_data[t].tile_info;
+    const AV1EncRowMTSync *const row_mt_sync = &cpi->row_mt_sync[tile_col];
+    const int row_alloc = get_sb_row_token_alloc(tile_info);
+    TOKENEXTRA *const tile_tok = cpi->tile_tok[tile_row][tile_col];
+    TOKENEXTRA *tok = tile_tok;
+    int mi_row;
+
+    for (mi_row = tile_info->mi_row_start; mi_row < tile_info->mi_row_end;
+         mi_row += MI_BLOCK_SIZE) {
+      const int tile_sb_row =
+          (mi_row - tile_info->mi_row_start) >> MI_BLOCK_SIZE_LOG2;
+      const TOKENEXTRA *const row_tok = tile_tok + tile_sb_row * row_alloc;
+      const unsigned int count =
+          row_mt_sync->tok_count[mi_row >> MI_BLOCK_SIZE_LOG2];
+      if (tok != row_tok) memmove(tok, row_tok, count * sizeof(*tok));
+      tok += count;
+    }
+    cpi->tok_count[tile_row][tile_col] = (unsigned int)(tok - tile_tok);
+  }
+}
+
+// The number of workers sharing the rows is passed in data2.
+static int first_pass_worker_hook(EncWorkerData *const thread_data,
+                                  void *data2) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  const int num_workers = (int)(intptr_t)data2;
+  int mb_row;
+
+  // A row only waits for the row above it, which has been handed to a worker
+  // earlier, so a thread can always make progress.
+  for (mb_row = thread_data->start; mb_row < cpi->common.mb_rows;
+       mb_row += num_workers) {
+    av1_first_pass_row(cpi, thread_data->td, mb_row,
+                       &cpi->twopass.row_mt_sync);
+  }
+
+  return 0;
+}
+
+void av1_first_pass_row_mt(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  int num_workers;
+  int i;
+
+  reset_row_mt_sync(&cpi->twopass.row_mt_sync, cm, cm->mb_rows, cm->mb_cols);
+
+#if CONFIG_MULTITHREAD
+  num_workers = AOMMIN(cpi->oxcf.max_threads, cm->mb_rows);
+  num_workers = AOMMAX(num_workers, 1);
+#else
+  num_workers = 1;
+#endif  // CONFIG_MULTITHREAD
+
+  av1_create_enc_workers(cpi);
+  num_workers = AOMMIN(num_workers, cpi->num_workers);
+
+  // The rows only produce first pass statistics, so the frame counters of the
+  // workers are neither copied nor accumulated.
+  for (i = 0; i < num_workers; i++) {
+    AVxWorker *const worker = &cpi->workers[i];
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+
+    worker->hook = (AVxWorkerHook)first_pass_worker_hook;
+    worker->data1 = thread_data;
+    worker->data2 = (void *)(intptr_t)num_workers;
+    thread_data->start = i;
+    if (thread_data->td != &cpi->td) thread_data->td->mb = cpi->td.mb;
+  }
+  launch_enc_workers(cpi, num_workers);
+}
+
+// The parameters of the alt-ref frame are passed in data2.
+static int temporal_filter_worker_hook(EncWorkerData *const thread_data,
+                                       void *data2) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  const TemporalFilterData *const tf = (const TemporalFilterData *)data2;
+  const YV12_BUFFER_CONFIG *const f = tf->frames[tf->alt_ref_index];
+  const int mb_rows = (f->y_crop_height + 15) >> 4;
+  int mb_row;
+
+  // The rows take different times depending on the motion search, so they
+  // are handed out one at a time.
+  while ((mb_row = get_next_job(cpi)) < mb_rows)
+    av1_temporal_filter_iterate_row(cpi, thread_data->td, tf, mb_row);
+
+  return 0;
+}
+
+void av1_temporal_filter_row_mt(AV1_COMP *cpi, TemporalFilterData *tf) {
+  const YV12_BUFFER_CONFIG *const f = tf->frames[tf->alt_ref_index];
+  const int mb_rows = (f->y_crop_height + 15) >> 4;
+  int num_workers;
+  int i;
+
+#if CONFIG_MULTITHREAD
+  num_workers = AOMMIN(cpi->oxcf.max_threads, mb_rows);
+  num_workers = AOMMAX(num_workers, 1);
+#else
+  num_workers = 1;
+#endif  // CONFIG_MULTITHREAD
+
+  av1_create_enc_workers(cpi);
+  num_workers = AOMMIN(num_workers, cpi->num_workers);
+
+  // Only the motion search state of the thread data is used.
+  for (i = 0; i < num_workers; i++) {
+    AVxWorker *const worker = &cpi->workers[i];
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+
+    worker->hook = (AVxWorkerHook)temporal_filter_worker_hook;
+    worker->data1 = thread_data;
+    worker->data2 = tf;
+    if (thread_data->td != &cpi->td) thread_data->td->mb = cpi->td.mb;
+  }
+  cpi->next_job = 0;
+  launch_enc_workers(cpi, num_workers);
+}
+
+#if CONFIG_DERING
+// The search data is passed in data2.
+static int dering_search_worker_hook(EncWorkerData *const thread_data,
+                                     void *data2) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  const DeringSearchData *const ds = (const DeringSearchData *)data2;
+  int sbr;
+
+  while ((sbr = get_next_job(cpi)) < ds->nvsb)
+    av1_dering_search_row(&cpi->common, ds, sbr);
+
+  return 0;
+}
+
+void av1_dering_search_row_mt(AV1_COMP *cpi, DeringSearchData *ds) {
+  int num_workers;
+  int i;
+
+  av1_create_enc_workers(cpi);
+  num_workers = AOMMIN(cpi->num_workers, ds->nvsb);
+
+  for (i = 0; i < num_workers; i++) {
+    AVxWorker *const worker = &cpi->workers[i];
+
+    worker->hook = (AVxWorkerHook)dering_search_worker_hook;
+    worker->data1 = &cpi->tile_thr_data[i];
+    worker->data2 = ds;
+  }
+  cpi->next_job = 0;
+  launch_enc_workers(cpi, num_workers);
+}
+#endif  // CONFIG_DERING
+
+static int scale_refs_worker_hook(EncWorkerData *const thread_data,
+                                  void *data2) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  const ScaleRefsData *const sr = (const ScaleRefsData *)data2;
+  const int num_jobs = sr->num_refs * sr->rows;
+  int job;
+
+  while ((job = get_next_job(cpi)) < num_jobs)
+    av1_scale_reference_rows(sr, job / sr->rows, job % sr->rows);
+
+  return 0;
+}
+
+static int extend_refs_worker_hook(EncWorkerData *const thread_data,
+                                   void *data2) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  const ScaleRefsData *const sr = (const ScaleRefsData *)data2;
+  int ref;
+
+  while ((ref = get_next_job(cpi)) < sr->num_refs)
+    aom_extend_frame_borders(sr->dst[ref]);
+
+  return 0;
+}
+
+void av1_scale_references_mt(AV1_COMP *cpi, ScaleRefsData *sr) {
+  int num_workers = AOMMIN(cpi->oxcf.max_threads, sr->num_refs * sr->rows);
+  int i;
+
+  av1_create_enc_workers(cpi);
+  num_workers = AOMMIN(num_workers, cpi->num_workers);
+
+  for (i = 0; i < num_workers; i++) {
+    AVxWorker *const worker = &cpi->workers[i];
+
+    worker->hook = (AVxWorkerHook)scale_refs_worker_hook;
+    worker->data1 = &cpi->tile_thr_data[i];
+    worker->data2 = sr;
+  }
+  cpi->next_job = 0;
+  launch_enc_workers(cpi, num_workers);
+
+  // The borders are extended from the edge pixels of the scaled bands, so
+  // they wait for all of the bands of all references.
+  num_workers = AOMMIN(num_workers, sr->num_refs);
+  for (i = 0; i < num_workers; i++)
+    cpi->workers[i].hook = (AVxWorkerHook)extend_refs_worker_hook;
+  cpi->next_job = 0;
+  launch_enc_workers(cpi, num_workers);
+}
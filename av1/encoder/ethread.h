@@ -12,12 +12,19 @@
 #ifndef AV1_ENCODER_ETHREAD_H_
 #define AV1_ENCODER_ETHREAD_H_
 
+#include "./aom_config.h"
+#include "aom_util/aom_thread.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct AV1_COMP;
+struct AV1Common;
 struct ThreadData;
+struct TemporalFilterData;
+struct DeringSearchData;
+struct ScaleRefsData;
 
 typedef struct EncWorkerData {
   struct AV1_COMP *cpi;
@@ -25,8 +32,68 @@ typedef struct EncWorkerData {
   int start;
 } EncWorkerData;
 
+// Superblock row synchronization for row-based multi-threaded encoding of a
+// tile column. A superblock is only encoded once the row above is far enough
+// ahead to provide its above and above-right context, which crosses tile row
+// boundaries.
+typedef struct AV1EncRowMTSync {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *mutex_;
+  pthread_cond_t *cond_;
+#endif
+  // Index of the last encoded superblock in each row.
+  int *cur_sb_col;
+  // Number of tokens written by each row.
+  unsigned int *tok_count;
+  int sync_range;
+  int rows;
+  int sb_cols;
+} AV1EncRowMTSync;
+
+// Allocate memory for the synchronization of 'rows' superblock rows of
+// 'sb_cols' superblocks each.
+void av1_enc_row_mt_sync_alloc(AV1EncRowMTSync *row_mt_sync,
+                               struct AV1Common *cm, int rows, int sb_cols);
+
+// Deallocate row-based multi-threaded encoding synchronization data.
+void av1_enc_row_mt_sync_dealloc(AV1EncRowMTSync *row_mt_sync);
+
+// Wait until superblock 'c' of row 'r' can be encoded.
+void av1_enc_row_mt_sync_read(AV1EncRowMTSync *row_mt_sync, int r, int c);
+
+// Mark superblock 'c' of row 'r' as encoded.
+void av1_enc_row_mt_sync_write(AV1EncRowMTSync *row_mt_sync, int r, int c);
+
+// Create the worker pool shared by the multi-threaded stages, if it does not
+// exist yet. Stages that only use cpi->workers when there are several of
+// them call this first, so that they do not depend on an earlier stage
+// having created the pool.
+void av1_create_enc_workers(struct AV1_COMP *cpi);
+
 void av1_encode_tiles_mt(struct AV1_COMP *cpi);
 
+// Encode the tiles of a frame with the superblock rows of each tile spread
+// over the worker threads.
+void av1_encode_tiles_row_mt(struct AV1_COMP *cpi);
+
+// Run the first pass analysis of a frame with the macroblock rows spread over
+// the worker threads.
+void av1_first_pass_row_mt(struct AV1_COMP *cpi);
+
+// Build an alt-ref frame with its macroblock rows spread over the worker
+// threads.
+void av1_temporal_filter_row_mt(struct AV1_COMP *cpi,
+                                struct TemporalFilterData *tf);
+
+// Compute the errors of the deringing level search with the superblock rows
+// spread over the worker threads.
+void av1_dering_search_row_mt(struct AV1_COMP *cpi,
+                              struct DeringSearchData *ds);
+
+// Rescale the references and extend their borders with the row bands spread
+// over the worker threads.
+void av1_scale_references_mt(struct AV1_COMP *cpi, struct ScaleRefsData *sr);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
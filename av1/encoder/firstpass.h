@@ -12,6 +12,8 @@
 #ifndef AV1_ENCODER_FIRSTPASS_H_
 #define AV1_ENCODER_FIRSTPASS_H_
 
+#include "av1/common/mv.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/lookahead.h"
 #include "av1/encoder/ratectrl.h"
 
@@ -67,6 +69,40 @@ typedef struct {
   double count;
 } FIRSTPASS_STATS;
 
+// Sums of the first pass statistics of one macroblock row. The rows of a frame
+// can be analyzed in any order and are combined afterwards.
+typedef struct {
+  int64_t intra_error;
+  int64_t coded_error;
+  int64_t sr_coded_error;
+  int64_t sum_mvrs;
+  int64_t sum_mvcs;
+  int sum_mvr;
+  int sum_mvc;
+  int sum_mvr_abs;
+  int sum_mvc_abs;
+  int mvcount;
+  int intercount;
+  int second_ref_count;
+  int intra_skip_count;
+  int sum_in_vectors;
+  // Set if a block past the first column of the row has image data.
+  int image_data;
+  // Changes between consecutive non-zero motion vectors of the row. The first
+  // and last of those vectors are kept to count the changes across rows.
+  int new_mv_count;
+  MV first_mv;
+  MV last_mv;
+} FIRSTPASS_ROW_STATS;
+
+// Floating point contributions of one macroblock to the frame statistics.
+// These are summed in raster order, as the result depends on the order.
+typedef struct {
+  double intra_factor;
+  double brightness_factor;
+  double neutral_count;
+} FIRSTPASS_MB_FACTORS;
+
 typedef enum {
   KF_UPDATE = 0,
   LF_UPDATE = 1,
@@ -137,14 +173,29 @@ typedef struct {
   int extend_minq_fast;
 
   GF_GROUP gf_group;
+
+  // Statistics of the macroblock rows and macroblocks of the frame being
+  // analyzed in the first pass, allocated for fp_mb_rows x fp_mb_cols MBs.
+  FIRSTPASS_ROW_STATS *row_stats;
+  FIRSTPASS_MB_FACTORS *mb_factors;
+  int fp_mb_rows;
+  int fp_mb_cols;
+  // Macroblock row synchronization of the multi-threaded first pass.
+  AV1EncRowMTSync row_mt_sync;
 } TWO_PASS;
 
 struct AV1_COMP;
+struct ThreadData;
 
 void av1_init_first_pass(struct AV1_COMP *cpi);
 void av1_rc_get_first_pass_params(struct AV1_COMP *cpi);
 void av1_first_pass(struct AV1_COMP *cpi,
                      const struct lookahead_entry *source);
+// Analyze macroblock row 'mb_row' of the first pass frame with the thread
+// data 'td'. With 'row_mt_sync' set, every macroblock waits for the row above
+// to be far enough ahead, so that the rows can run on different threads.
+void av1_first_pass_row(struct AV1_COMP *cpi, struct ThreadData *td,
+                        int mb_row, AV1EncRowMTSync *row_mt_sync);
 void av1_end_first_pass(struct AV1_COMP *cpi);
 
 void av1_init_second_pass(struct AV1_COMP *cpi);
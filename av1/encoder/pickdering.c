@@ -12,120 +12,155 @@
 #include <string.h>
 
 #include "./aom_scale_rtcd.h"
+#include "./av1_rtcd.h"
 #include "av1/common/dering.h"
 #include "av1/common/onyxc_int.h"
 #include "av1/common/reconinter.h"
 #include "av1/encoder/encoder.h"
+#include "av1/encoder/ethread.h"
+#include "av1/encoder/pickdering.h"
 #include "aom/aom_integer.h"
+#include "aom_mem/aom_mem.h"
+#include "aom_ports/mem.h"
 
-static double compute_dist(int16_t *x, int xstride, int16_t *y, int ystride,
-    int nhb, int nvb, int coeff_shift) {
+/* Width of the copy of a superblock: the superblock and the filter border on
+   both sides of it. */
+#define DERING_SB_STRIDE (MI_BLOCK_SIZE*8 + 2*OD_FILT_BORDER)
+
+int64_t av1_dering_sse_c(const int16_t *a, int astride, const int16_t *b,
+    int bstride, int w, int h) {
   int i, j;
-  double sum;
-  sum = 0;
-  for (i = 0; i < nvb << 3; i++) {
-    for (j = 0; j < nhb << 3; j++) {
-      double tmp;
-      tmp = x[i*xstride + j] - y[i*ystride + j];
-      sum += tmp*tmp;
+  int64_t sse;
+  sse = 0;
+  for (i = 0; i < h; i++) {
+    for (j = 0; j < w; j++) {
+      const int d = a[i*astride + j] - b[i*bstride + j];
+      sse += d*d;
     }
   }
-  return sum/(double)(1 << 2*coeff_shift);
+  return sse;
 }
 
-int av1_dering_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
-                       AV1_COMMON *cm,
-                       MACROBLOCKD *xd) {
+/* Copy 'rows' lines of 'cols' pixels of the luma plane of 'frame', starting
+   at line 'y' and column 'x', into 'dst'. */
+static void copy_luma(int16_t *dst, int dstride,
+    const YV12_BUFFER_CONFIG *frame, int y, int x, int rows, int cols,
+    const AV1_COMMON *cm) {
   int r, c;
+#if CONFIG_AOM_HIGHBITDEPTH
+  if (cm->use_highbitdepth) {
+    const uint16_t *src =
+        CONVERT_TO_SHORTPTR(frame->y_buffer) + y*frame->y_stride + x;
+    for (r = 0; r < rows; ++r) {
+      memcpy(&dst[r*dstride], &src[r*frame->y_stride], cols*sizeof(*dst));
+    }
+    return;
+  }
+#else
+  (void)cm;
+#endif
+  {
+    const uint8_t *src = frame->y_buffer + y*frame->y_stride + x;
+    for (r = 0; r < rows; ++r) {
+      for (c = 0; c < cols; ++c) {
+        dst[r*dstride + c] = src[r*frame->y_stride + c];
+      }
+    }
+  }
+}
+
+void av1_dering_search_row(const AV1_COMMON *cm, const DeringSearchData *ds,
+                           int sbr) {
+  const int coeff_shift = AOMMAX(cm->bit_depth - 8, 0);
+  const int nvb = AOMMIN(MI_BLOCK_SIZE, cm->mi_rows - MI_BLOCK_SIZE*sbr);
+  const int top = OD_FILT_BORDER*(sbr != 0);
+  const int bottom = OD_FILT_BORDER*(sbr != ds->nvsb - 1);
+  int sbc;
+  for (sbc = 0; sbc < ds->nhsb; sbc++) {
+    DECLARE_ALIGNED(16, od_dering_in, src[DERING_SB_STRIDE*DERING_SB_STRIDE]);
+    DECLARE_ALIGNED(16, int16_t, ref_coeff[MI_BLOCK_SIZE*MI_BLOCK_SIZE*8*8]);
+    DECLARE_ALIGNED(16, int16_t, dst[MI_BLOCK_SIZE*MI_BLOCK_SIZE*8*8]);
+    int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS];
+    int32_t var[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS];
+    unsigned char bskip[MI_BLOCK_SIZE*MI_BLOCK_SIZE];
+    od_dering_in *const x = src + OD_FILT_BORDER*DERING_SB_STRIDE +
+        OD_FILT_BORDER;
+    int *const mse = ds->mse[ds->nhsb*sbr + sbc];
+    const int nhb = AOMMIN(MI_BLOCK_SIZE, cm->mi_cols - MI_BLOCK_SIZE*sbc);
+    const int left = OD_FILT_BORDER*(sbc != 0);
+    const int right = OD_FILT_BORDER*(sbc != ds->nhsb - 1);
+    int r, c;
+    int level;
+    /* Only the pixels the filter reads are copied: the superblock and the
+       border shared with the superblocks around it. */
+    copy_luma(x - top*DERING_SB_STRIDE - left, DERING_SB_STRIDE, ds->frame,
+              MI_BLOCK_SIZE*8*sbr - top, MI_BLOCK_SIZE*8*sbc - left,
+              8*nvb + top + bottom, 8*nhb + left + right, cm);
+    copy_luma(ref_coeff, MI_BLOCK_SIZE*8, ds->ref, MI_BLOCK_SIZE*8*sbr,
+              MI_BLOCK_SIZE*8*sbc, 8*nvb, 8*nhb, cm);
+    /* Level 0 leaves the superblock unchanged, and so does every level when
+       all its blocks are skipped. */
+    mse[0] = (int)(av1_dering_sse(x, DERING_SB_STRIDE, ref_coeff,
+                                  MI_BLOCK_SIZE*8, 8*nhb, 8*nvb) >>
+                   2*coeff_shift);
+    if (sb_all_skip(cm, MI_BLOCK_SIZE*sbr, MI_BLOCK_SIZE*sbc)) {
+      for (level = 1; level < MAX_DERING_LEVEL; level++) mse[level] = mse[0];
+      continue;
+    }
+    for (r = 0; r < nvb; ++r) {
+      for (c = 0; c < nhb; ++c) {
+        bskip[r*MI_BLOCK_SIZE + c] = cm->mi_grid_visible[
+            (MI_BLOCK_SIZE*sbr + r)*cm->mi_stride + MI_BLOCK_SIZE*sbc + c]->
+            mbmi.skip;
+      }
+    }
+    /* The directions do not depend on the level. */
+    od_dering_find_dirs(x, DERING_SB_STRIDE, nhb, nvb, dir, var, coeff_shift);
+    for (level = 1; level < MAX_DERING_LEVEL; level++) {
+      od_dering_with_dirs(dst, MI_BLOCK_SIZE*8, x, DERING_SB_STRIDE, nhb, nvb,
+                          sbc, sbr, ds->nhsb, ds->nvsb, 0, dir, var, bskip,
+                          MI_BLOCK_SIZE, level << coeff_shift,
+                          OD_DERING_NO_CHECK_OVERLAP);
+      mse[level] = (int)(av1_dering_sse(dst, MI_BLOCK_SIZE*8, ref_coeff,
+                                        MI_BLOCK_SIZE*8, 8*nhb, 8*nvb) >>
+                         2*coeff_shift);
+    }
+  }
+}
+
+int av1_dering_search(AV1_COMP *cpi, const YV12_BUFFER_CONFIG *frame,
+                      const YV12_BUFFER_CONFIG *ref) {
+  AV1_COMMON *const cm = &cpi->common;
+  DeringSearchData ds;
   int sbr, sbc;
   int nhsb, nvsb;
-  od_dering_in *src;
-  int16_t *ref_coeff;
-  unsigned char *bskip;
-  int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS] = {{0}};
-  int stride;
-  int bsize[3];
-  int dec[3];
-  int pli;
   int (*mse)[MAX_DERING_LEVEL];
-  int best_count[MAX_DERING_LEVEL] = {0};
-  double tot_mse[MAX_DERING_LEVEL] = {0};
   int level;
   int best_level;
+#if DERING_REFINEMENT
   int global_level;
   double best_tot_mse = 1e15;
-  int coeff_shift = AOMMAX(cm->bit_depth - 8, 0);
-  src = aom_malloc(sizeof(*src)*cm->mi_rows*cm->mi_cols*64);
-  ref_coeff = aom_malloc(sizeof(*ref_coeff)*cm->mi_rows*cm->mi_cols*64);
-  bskip = aom_malloc(sizeof(*bskip)*cm->mi_rows*cm->mi_cols);
-  av1_setup_dst_planes(xd->plane, frame, 0, 0);
-  for (pli = 0; pli < 3; pli++) {
-    dec[pli] = xd->plane[pli].subsampling_x;
-    bsize[pli] = 8 >> dec[pli];
-  }
-  stride = bsize[0]*cm->mi_cols;
-  for (r = 0; r < bsize[0]*cm->mi_rows; ++r) {
-    for (c = 0; c < bsize[0]*cm->mi_cols; ++c) {
-#if CONFIG_AOM_HIGHBITDEPTH
-      if (cm->use_highbitdepth) {
-        src[r * stride + c] =
-            CONVERT_TO_SHORTPTR(xd->plane[0].dst.buf)
-            [r*xd->plane[0].dst.stride + c];
-        ref_coeff[r * stride + c] =
-            CONVERT_TO_SHORTPTR(ref->y_buffer)[r * ref->y_stride + c];
-      } else {
 #endif
-        src[r * stride + c] =
-            xd->plane[0].dst.buf[r*xd->plane[0].dst.stride + c];
-        ref_coeff[r * stride + c] = ref->y_buffer[r * ref->y_stride + c];
-#if CONFIG_AOM_HIGHBITDEPTH
-      }
-#endif
-    }
-  }
-  for (r = 0; r < cm->mi_rows; ++r) {
-    for (c = 0; c < cm->mi_cols; ++c) {
-      const MB_MODE_INFO *mbmi =
-          &cm->mi_grid_visible[r * cm->mi_stride + c]->mbmi;
-      bskip[r * cm->mi_cols + c] = mbmi->skip;
-    }
-  }
   nvsb = (cm->mi_rows + MI_BLOCK_SIZE - 1)/MI_BLOCK_SIZE;
   nhsb = (cm->mi_cols + MI_BLOCK_SIZE - 1)/MI_BLOCK_SIZE;
-  mse = aom_malloc(nvsb*nhsb*sizeof(*mse));
-  for (sbr = 0; sbr < nvsb; sbr++) {
-    for (sbc = 0; sbc < nhsb; sbc++) {
-      int best_mse = 1000000000;
-      int nvb, nhb;
-      int16_t dst[MI_BLOCK_SIZE*MI_BLOCK_SIZE*8*8];
-      best_level = 0;
-      nhb = AOMMIN(MI_BLOCK_SIZE, cm->mi_cols - MI_BLOCK_SIZE*sbc);
-      nvb = AOMMIN(MI_BLOCK_SIZE, cm->mi_rows - MI_BLOCK_SIZE*sbr);
-      for (level = 0; level < 64; level++) {
-        int threshold;
-        threshold = level << coeff_shift;
-        od_dering(
-            &OD_DERING_VTBL_C,
-            dst,
-            MI_BLOCK_SIZE*bsize[0],
-            &src[sbr*stride*bsize[0]*MI_BLOCK_SIZE +
-            sbc*bsize[0]*MI_BLOCK_SIZE],
-            cm->mi_cols*bsize[0], nhb, nvb, sbc, sbr, nhsb, nvsb, 0, dir, 0,
-            &bskip[MI_BLOCK_SIZE*sbr*cm->mi_cols + MI_BLOCK_SIZE*sbc],
-            cm->mi_cols, threshold, OD_DERING_NO_CHECK_OVERLAP, coeff_shift);
-        mse[nhsb*sbr+sbc][level] = compute_dist(
-            dst, MI_BLOCK_SIZE*bsize[0],
-            &ref_coeff[sbr*stride*bsize[0]*MI_BLOCK_SIZE +
-            sbc*bsize[0]*MI_BLOCK_SIZE],
-            stride, nhb, nvb, coeff_shift);
-        tot_mse[level] += mse[nhsb*sbr+sbc][level];
-        if (mse[nhsb*sbr+sbc][level] < best_mse) {
-          best_mse = mse[nhsb*sbr+sbc][level];
-          best_level = level;
-        }
-      }
-      best_count[best_level]++;
-    }
+  /* The buffer of the squared errors is kept from frame to frame. */
+  if (nvsb*nhsb > cpi->dering_search_sbs) {
+    aom_free(cpi->dering_mse);
+    cpi->dering_search_sbs = 0;
+    CHECK_MEM_ERROR(cm, cpi->dering_mse,
+                    aom_malloc(nvsb*nhsb*sizeof(*cpi->dering_mse)));
+    cpi->dering_search_sbs = nvsb*nhsb;
+  }
+  mse = cpi->dering_mse;
+  ds.frame = frame;
+  ds.ref = ref;
+  ds.nhsb = nhsb;
+  ds.nvsb = nvsb;
+  ds.mse = mse;
+  if (cpi->oxcf.max_threads > 1 && nvsb > 1) {
+    av1_dering_search_row_mt(cpi, &ds);
+  } else {
+    for (sbr = 0; sbr < nvsb; sbr++) av1_dering_search_row(cm, &ds, sbr);
   }
 #if DERING_REFINEMENT
   best_level = 0;
@@ -168,14 +203,20 @@ int av1_dering_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
     }
   }
 #else
-  best_level = 0;
-  for (level = 0; level < MAX_DERING_LEVEL; level++) {
-    if (tot_mse[level] < tot_mse[best_level]) best_level = level;
+  {
+    double tot_mse[MAX_DERING_LEVEL] = {0};
+    for (sbr = 0; sbr < nvsb; sbr++) {
+      for (sbc = 0; sbc < nhsb; sbc++) {
+        for (level = 0; level < MAX_DERING_LEVEL; level++) {
+          tot_mse[level] += mse[nhsb*sbr+sbc][level];
+        }
+      }
+    }
+    best_level = 0;
+    for (level = 0; level < MAX_DERING_LEVEL; level++) {
+      if (tot_mse[level] < tot_mse[best_level]) best_level = level;
+    }
   }
 #endif
-  aom_free(src);
-  aom_free(ref_coeff);
-  aom_free(bskip);
-  aom_free(mse);
   return best_level;
 }
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AV1_ENCODER_PICKDERING_H_
+#define AV1_ENCODER_PICKDERING_H_
+
+#include "av1/common/dering.h"
+#include "av1/encoder/encoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct DeringSearchData {
+  const YV12_BUFFER_CONFIG *frame;
+  const YV12_BUFFER_CONFIG *ref;
+  int nhsb;
+  int nvsb;
+  // Squared error of every superblock at every deringing level.
+  int (*mse)[MAX_DERING_LEVEL];
+} DeringSearchData;
+
+// Compute the squared error of every deringing level for the superblocks of
+// superblock row 'sbr'.
+void av1_dering_search_row(const AV1_COMMON *cm, const DeringSearchData *ds,
+                           int sbr);
+
+// Pick the deringing level of 'frame' and the refinement of each superblock.
+int av1_dering_search(AV1_COMP *cpi, const YV12_BUFFER_CONFIG *frame,
+                      const YV12_BUFFER_CONFIG *ref);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AV1_ENCODER_PICKDERING_H_
@@ -23,6 +23,7 @@
 #include "av1/common/quant_common.h"
 
 #include "av1/encoder/encoder.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/picklpf.h"
 #include "av1/encoder/quantize.h"
 
@@ -65,15 +66,140 @@ static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
   return filt_err;
 }
 
+typedef struct {
+  AV1_COMP *cpi;
+  const YV12_BUFFER_CONFIG *sd;
+  // Frame filtered by the job, either cm->frame_to_show or a scratch frame.
+  YV12_BUFFER_CONFIG *frame;
+  // The loop filter takes the levels of the blocks from the table in
+  // AV1_COMMON, so every job has a copy of its own in cpi->lpf_search_cm.
+  AV1_COMMON *cm;
+  MACROBLOCKD xd;
+  int filt_level;
+  int partial_frame;
+  int64_t filt_err;
+} LpfSearchJob;
+
+static int lpf_search_worker_hook(LpfSearchJob *job, void *unused) {
+  AV1_COMP *const cpi = job->cpi;
+
+  (void)unused;
+
+  if (job->frame != cpi->common.frame_to_show)
+    aom_yv12_copy_y(&cpi->last_frame_uf, job->frame);
+
+  av1_loop_filter_frame(job->frame, job->cm, &job->xd, job->filt_level, 1,
+                        job->partial_frame);
+
+#if CONFIG_AOM_HIGHBITDEPTH
+  if (job->cm->use_highbitdepth) {
+    job->filt_err = av1_highbd_get_y_sse(job->sd, job->frame);
+  } else {
+    job->filt_err = av1_get_y_sse(job->sd, job->frame);
+  }
+#else
+  job->filt_err = av1_get_y_sse(job->sd, job->frame);
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+
+  if (job->frame == cpi->common.frame_to_show)
+    aom_yv12_copy_y(&cpi->last_frame_uf, job->frame);
+
+  return 1;
+}
+
+// Number of filter levels that are evaluated at the same time.
+static int get_lpf_search_jobs(const AV1_COMP *cpi) {
+  return cpi->num_workers > 1 ? AOMMIN(cpi->num_workers, MAX_LPF_SEARCH_JOBS)
+                              : 1;
+}
+
+// Add 'filt_level' to the levels to be evaluated, unless its error is known.
+static void add_search_level(int *levels, int *num_levels, int max_levels,
+                             const int64_t *ss_err, int filt_level) {
+  int i;
+
+  if (ss_err[filt_level] >= 0 || *num_levels >= max_levels) return;
+  for (i = 0; i < *num_levels; ++i)
+    if (levels[i] == filt_level) return;
+  levels[(*num_levels)++] = filt_level;
+}
+
+// Store the error of each of the filter levels in 'ss_err'. Several levels
+// are filtered at the same time on the worker threads, each one in its own
+// copy of the unfiltered frame.
+static void try_filter_levels(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
+                              const int *levels, int num_levels,
+                              int partial_frame, int64_t *ss_err) {
+  AV1_COMMON *const cm = &cpi->common;
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  LpfSearchJob jobs[MAX_LPF_SEARCH_JOBS];
+  int i;
+
+  if (num_levels == 1 || get_lpf_search_jobs(cpi) == 1) {
+    for (i = 0; i < num_levels; ++i)
+      ss_err[levels[i]] = try_filter_frame(sd, cpi, levels[i], partial_frame);
+    return;
+  }
+
+  assert(num_levels <= get_lpf_search_jobs(cpi));
+
+  for (i = 0; i < num_levels; ++i) {
+    LpfSearchJob *const job = &jobs[i];
+
+    job->cpi = cpi;
+    job->sd = sd;
+    job->cm = &cpi->lpf_search_cm[i];
+    job->xd = cpi->td.mb.e_mbd;
+    job->filt_level = levels[i];
+    job->partial_frame = partial_frame;
+    if (i == 0) {
+      job->frame = cm->frame_to_show;
+    } else {
+      job->frame = &cpi->lpf_search_buf[i - 1];
+      if (aom_realloc_frame_buffer(job->frame, cm->width, cm->height,
+                                   cm->subsampling_x, cm->subsampling_y,
+#if CONFIG_AOM_HIGHBITDEPTH
+                                   cm->use_highbitdepth,
+#endif
+                                   AOM_ENC_BORDER_IN_PIXELS,
+                                   cm->byte_alignment, NULL, NULL, NULL))
+        aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                           "Failed to allocate loop filter search buffer");
+    }
+  }
+
+  for (i = 0; i < num_levels; ++i) {
+    AVxWorker *const worker = &cpi->workers[i];
+
+    worker->hook = (AVxWorkerHook)lpf_search_worker_hook;
+    worker->data1 = &jobs[i];
+    worker->data2 = NULL;
+
+    // The last job runs on the main thread.
+    if (i == num_levels - 1)
+      winterface->execute(worker);
+    else
+      winterface->launch(worker);
+  }
+
+  for (i = 0; i < num_levels; ++i) {
+    winterface->sync(&cpi->workers[i]);
+    ss_err[levels[i]] = jobs[i].filt_err;
+  }
+}
+
 static int search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
                                int partial_frame) {
-  const AV1_COMMON *const cm = &cpi->common;
+  AV1_COMMON *const cm = &cpi->common;
   const struct loopfilter *const lf = &cm->lf;
   const int min_filter_level = 0;
   const int max_filter_level = get_max_filter_level(cpi);
+  const int max_jobs = get_lpf_search_jobs(cpi);
   int filt_direction = 0;
   int64_t best_err;
   int filt_best;
+  int levels[MAX_LPF_SEARCH_JOBS];
+  int num_levels = 0;
 
   // Start the search at the previous frame filter level unless it is now out of
   // range.
@@ -88,9 +214,29 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
   //  Make a copy of the unfiltered / processed recon buffer
   aom_yv12_copy_y(cm->frame_to_show, &cpi->last_frame_uf);
 
-  best_err = try_filter_frame(sd, cpi, filt_mid, partial_frame);
+  // The common state of the jobs only differs in the block levels, which every
+  // job sets up itself, so it is copied once for the whole search.
+  if (max_jobs > 1) {
+    int i;
+
+    if (!cpi->lpf_search_cm)
+      CHECK_MEM_ERROR(cm, cpi->lpf_search_cm,
+                      aom_malloc(MAX_LPF_SEARCH_JOBS *
+                                 sizeof(*cpi->lpf_search_cm)));
+    for (i = 0; i < max_jobs; ++i) cpi->lpf_search_cm[i] = *cm;
+  }
+
+  // With several jobs the levels of the first step are evaluated along with
+  // the middle one.
+  add_search_level(levels, &num_levels, max_jobs, ss_err, filt_mid);
+  add_search_level(levels, &num_levels, max_jobs, ss_err,
+                   AOMMAX(filt_mid - filter_step, min_filter_level));
+  add_search_level(levels, &num_levels, max_jobs, ss_err,
+                   AOMMIN(filt_mid + filter_step, max_filter_level));
+  try_filter_levels(sd, cpi, levels, num_levels, partial_frame, ss_err);
+
+  best_err = ss_err[filt_mid];
   filt_best = filt_mid;
-  ss_err[filt_mid] = best_err;
 
   while (filter_step > 0) {
     const int filt_high = AOMMIN(filt_mid + filter_step, max_filter_level);
@@ -105,11 +251,33 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
     // yx, bias less for large block size
     if (cm->tx_mode != ONLY_4X4) bias >>= 1;
 
+    // Get the error scores needed by this step. With several jobs, also start
+    // on the levels the next step may need: one step further out if one of
+    // these levels wins, or half a step around the middle otherwise. The
+    // picked level does not depend on the number of jobs.
+    num_levels = 0;
+    if (filt_direction <= 0)
+      add_search_level(levels, &num_levels, 2, ss_err, filt_low);
+    if (filt_direction >= 0)
+      add_search_level(levels, &num_levels, 2, ss_err, filt_high);
+    if (filt_direction <= 0) {
+      add_search_level(levels, &num_levels, max_jobs, ss_err,
+                       AOMMAX(filt_low - filter_step, min_filter_level));
+    }
+    if (filt_direction >= 0) {
+      add_search_level(levels, &num_levels, max_jobs, ss_err,
+                       AOMMIN(filt_high + filter_step, max_filter_level));
+    }
+    if (filter_step > 1) {
+      add_search_level(levels, &num_levels, max_jobs, ss_err,
+                       AOMMAX(filt_mid - filter_step / 2, min_filter_level));
+      add_search_level(levels, &num_levels, max_jobs, ss_err,
+                       AOMMIN(filt_mid + filter_step / 2, max_filter_level));
+    }
+    if (num_levels > 0)
+      try_filter_levels(sd, cpi, levels, num_levels, partial_frame, ss_err);
+
     if (filt_direction <= 0 && filt_low != filt_mid) {
-      // Get Low filter error score
-      if (ss_err[filt_low] < 0) {
-        ss_err[filt_low] = try_filter_frame(sd, cpi, filt_low, partial_frame);
-      }
       // If value is close to the best so far then bias towards a lower loop
       // filter value.
       if ((ss_err[filt_low] - bias) < best_err) {
@@ -122,9 +290,6 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
 
     // Now look at filt_high
     if (filt_direction >= 0 && filt_high != filt_mid) {
-      if (ss_err[filt_high] < 0) {
-        ss_err[filt_high] = try_filter_frame(sd, cpi, filt_high, partial_frame);
-      }
       // Was it better than the previous best?
       if (ss_err[filt_high] < (best_err - bias)) {
         best_err = ss_err[filt_high];
@@ -184,6 +349,9 @@ void av1_pick_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
     if (cm->frame_type == KEY_FRAME) filt_guess -= 4;
     lf->filter_level = clamp(filt_guess, min_filter_level, max_filter_level);
   } else {
+    // The levels are searched on the worker threads, whichever stages ran
+    // before.
+    if (cpi->oxcf.max_threads > 1) av1_create_enc_workers(cpi);
     lf->filter_level =
         search_filter_level(sd, cpi, method == LPF_PICK_FROM_SUBIMAGE);
   }
@@ -19,16 +19,17 @@
 #if CONFIG_AOM_HIGHBITDEPTH
 #include "aom_dsp/aom_dsp_common.h"
 #endif  // CONFIG_AOM_HIGHBITDEPTH
+#include "./av1_rtcd.h"
 #include "aom_ports/mem.h"
 #include "av1/common/common.h"
 #include "av1/encoder/resize.h"
 
 #define FILTER_BITS 7
 
-#define INTERP_TAPS 8
-#define SUBPEL_BITS 5
-#define SUBPEL_MASK ((1 << SUBPEL_BITS) - 1)
-#define INTERP_PRECISION_BITS 32
+#define INTERP_TAPS RS_INTERP_TAPS
+#define SUBPEL_BITS RS_SUBPEL_BITS
+#define SUBPEL_MASK RS_SUBPEL_MASK
+#define INTERP_PRECISION_BITS RS_INTERP_PRECISION_BITS
 
 typedef int16_t interp_kernel[INTERP_TAPS];
 
@@ -136,6 +137,15 @@ static const interp_kernel filteredinterp_filters1000[(1 << SUBPEL_BITS)] = {
 static const int16_t av1_down2_symeven_half_filter[] = { 56, 12, -3, -1 };
 static const int16_t av1_down2_symodd_half_filter[] = { 64, 35, 0, -3 };
 
+// The same filters with all INTERP_TAPS taps written out, starting
+// INTERP_TAPS / 2 - 1 pixels before the (even) centre pixel.
+static const int16_t av1_down2_symeven_filter[INTERP_TAPS] = {
+  -1, -3, 12, 56, 56, 12, -3, -1
+};
+static const int16_t av1_down2_symodd_filter[INTERP_TAPS] = {
+  -3, 0, 35, 64, 35, 0, -3, 0
+};
+
 static const interp_kernel *choose_interp_filter(int inlength, int outlength) {
   int outlength16 = outlength * 16;
   if (outlength16 >= inlength * 16)
@@ -150,16 +160,104 @@ static const interp_kernel *choose_interp_filter(int inlength, int outlength) {
     return filteredinterp_filters500;
 }
 
+static int64_t get_interp_delta(int inlength, int outlength) {
+  return (((uint64_t)inlength << 32) + outlength / 2) / outlength;
+}
+
+static int64_t get_interp_offset(int inlength, int outlength) {
+  return inlength > outlength
+             ? (((int64_t)(inlength - outlength) << 31) + outlength / 2) /
+                   outlength
+             : -(((int64_t)(outlength - inlength) << 31) + outlength / 2) /
+                   outlength;
+}
+
+// Interpolates outlength pixels, starting at position y and stepping by
+// delta. All the taps must lie inside input; the edges are handled by
+// interpolate().
+void av1_resize_horz_c(const uint8_t *input, uint8_t *output, int outlength,
+                       int64_t y, int64_t delta, const int16_t *filters) {
+  int x, k;
+  for (x = 0; x < outlength; ++x, y += delta) {
+    const int int_pel = (int)(y >> INTERP_PRECISION_BITS);
+    const int sub_pel =
+        (int)(y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
+    const int16_t *const filter = filters + sub_pel * INTERP_TAPS;
+    const uint8_t *const in = input + int_pel - INTERP_TAPS / 2 + 1;
+    int sum = 0;
+    for (k = 0; k < INTERP_TAPS; ++k) sum += filter[k] * in[k];
+    output[x] = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
+  }
+}
+
+// Applies one of the expanded down2 filters to outlength pixels. input
+// points at the first tap of the first output and advances by 2 pixels per
+// output.
+void av1_resize_down2_horz_c(const uint8_t *input, uint8_t *output,
+                             int outlength, const int16_t *filter) {
+  int x, k;
+  for (x = 0; x < outlength; ++x, input += 2) {
+    int sum = 1 << (FILTER_BITS - 1);
+    for (k = 0; k < INTERP_TAPS; ++k) sum += filter[k] * input[k];
+    output[x] = clip_pixel(sum >> FILTER_BITS);
+  }
+}
+
+// Filters width pixels of the INTERP_TAPS rows into one output row.
+void av1_resize_vert_c(const uint8_t *const *rows, const int16_t *filter,
+                       uint8_t *output, int width) {
+  int x, k;
+  for (x = 0; x < width; ++x) {
+    int sum = 1 << (FILTER_BITS - 1);
+    for (k = 0; k < INTERP_TAPS; ++k) sum += filter[k] * rows[k][x];
+    output[x] = clip_pixel(sum >> FILTER_BITS);
+  }
+}
+
+#if CONFIG_AOM_HIGHBITDEPTH
+void av1_highbd_resize_horz_c(const uint16_t *input, uint16_t *output,
+                              int outlength, int64_t y, int64_t delta,
+                              const int16_t *filters, int bd) {
+  int x, k;
+  for (x = 0; x < outlength; ++x, y += delta) {
+    const int int_pel = (int)(y >> INTERP_PRECISION_BITS);
+    const int sub_pel =
+        (int)(y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
+    const int16_t *const filter = filters + sub_pel * INTERP_TAPS;
+    const uint16_t *const in = input + int_pel - INTERP_TAPS / 2 + 1;
+    int sum = 0;
+    for (k = 0; k < INTERP_TAPS; ++k) sum += filter[k] * in[k];
+    output[x] = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
+  }
+}
+
+void av1_highbd_resize_down2_horz_c(const uint16_t *input, uint16_t *output,
+                                    int outlength, const int16_t *filter,
+                                    int bd) {
+  int x, k;
+  for (x = 0; x < outlength; ++x, input += 2) {
+    int sum = 1 << (FILTER_BITS - 1);
+    for (k = 0; k < INTERP_TAPS; ++k) sum += filter[k] * input[k];
+    output[x] = clip_pixel_highbd(sum >> FILTER_BITS, bd);
+  }
+}
+
+void av1_highbd_resize_vert_c(const uint16_t *const *rows,
+                              const int16_t *filter, uint16_t *output,
+                              int width, int bd) {
+  int x, k;
+  for (x = 0; x < width; ++x) {
+    int sum = 1 << (FILTER_BITS - 1);
+    for (k = 0; k < INTERP_TAPS; ++k) sum += filter[k] * rows[k][x];
+    output[x] = clip_pixel_highbd(sum >> FILTER_BITS, bd);
+  }
+}
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+
 static void interpolate(const uint8_t *const input, int inlength,
                         uint8_t *output, int outlength) {
-  const int64_t delta =
-      (((uint64_t)inlength << 32) + outlength / 2) / outlength;
-  const int64_t offset =
-      inlength > outlength
-          ? (((int64_t)(inlength - outlength) << 31) + outlength / 2) /
-                outlength
-          : -(((int64_t)(outlength - inlength) << 31) + outlength / 2) /
-                outlength;
+  const int64_t delta = get_interp_delta(inlength, outlength);
+  const int64_t offset = get_interp_offset(inlength, outlength);
   uint8_t *optr = output;
   int x, x1, x2, sum, k, int_pel, sub_pel;
   int64_t y;
@@ -211,16 +309,10 @@ static void interpolate(const uint8_t *const input, int inlength,
       *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
     }
     // Middle part.
-    for (; x <= x2; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[int_pel - INTERP_TAPS / 2 + 1 + k];
-      *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
-    }
+    av1_resize_horz(input, optr, x2 - x1 + 1, y, delta, interp_filters[0]);
+    optr += x2 - x1 + 1;
+    y += delta * (x2 - x1 + 1);
+    x = x2 + 1;
     // End part.
     for (; x < outlength; ++x, y += delta) {
       const int16_t *filter;
@@ -271,14 +363,10 @@ static void down2_symeven(const uint8_t *const input, int length,
       *optr++ = clip_pixel(sum);
     }
     // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + 1 + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
+    av1_resize_down2_horz(input + i - INTERP_TAPS / 2 + 1, optr, (l2 - i) / 2,
+                          av1_down2_symeven_filter);
+    optr += (l2 - i) / 2;
+    i = l2;
     // End part.
     for (; i < length; i += 2) {
       int sum = (1 << (FILTER_BITS - 1));
@@ -327,14 +415,10 @@ static void down2_symodd(const uint8_t *const input, int length,
       *optr++ = clip_pixel(sum);
     }
     // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
+    av1_resize_down2_horz(input + i - INTERP_TAPS / 2 + 1, optr, (l2 - i) / 2,
+                          av1_down2_symodd_filter);
+    optr += (l2 - i) / 2;
+    i = l2;
     // End part.
     for (; i < length; i += 2) {
       int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
@@ -376,16 +460,9 @@ static void resize_multistep(const uint8_t *const input, int length,
   if (steps > 0) {
     int s;
     uint8_t *out = NULL;
-    uint8_t *tmpbuf = NULL;
-    uint8_t *otmp, *otmp2;
+    uint8_t *const otmp = buf;
+    uint8_t *const otmp2 = otmp + get_down2_length(length, 1);
     int filteredlength = length;
-    if (!tmpbuf) {
-      tmpbuf = (uint8_t *)malloc(sizeof(uint8_t) * length);
-      otmp = tmpbuf;
-    } else {
-      otmp = buf;
-    }
-    otmp2 = otmp + get_down2_length(length, 1);
     for (s = 0; s < steps; ++s) {
       const int proj_filteredlength = get_down2_length(filteredlength, 1);
       const uint8_t *const in = (s == 0 ? input : out);
@@ -402,27 +479,96 @@ static void resize_multistep(const uint8_t *const input, int length,
     if (filteredlength != olength) {
       interpolate(out, filteredlength, output, olength);
     }
-    if (tmpbuf) free(tmpbuf);
   } else {
     interpolate(input, length, output, olength);
   }
 }
 
-static void fill_col_to_arr(uint8_t *img, int stride, int len, uint8_t *arr) {
-  int i;
-  uint8_t *iptr = img;
-  uint8_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *aptr++ = *iptr;
+// The vertical pass works on whole rows: every output row is filtered from
+// INTERP_TAPS input rows, with the edge rows repeated, which gives the same
+// result as running interpolate() or down2_sym*() down each column.
+static void interpolate_vert(const uint8_t *const input, int in_stride,
+                             int inlength, uint8_t *output, int out_stride,
+                             int outlength, int width) {
+  const int64_t delta = get_interp_delta(inlength, outlength);
+  const interp_kernel *interp_filters =
+      choose_interp_filter(inlength, outlength);
+  const uint8_t *rows[INTERP_TAPS];
+  int64_t y = get_interp_offset(inlength, outlength);
+  int x, k;
+
+  for (x = 0; x < outlength; ++x, y += delta) {
+    const int int_pel = (int)(y >> INTERP_PRECISION_BITS);
+    const int sub_pel =
+        (int)(y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
+    for (k = 0; k < INTERP_TAPS; ++k) {
+      const int pk = int_pel - INTERP_TAPS / 2 + 1 + k;
+      rows[k] = input + clamp(pk, 0, inlength - 1) * in_stride;
+    }
+    av1_resize_vert(rows, interp_filters[sub_pel], output, width);
+    output += out_stride;
   }
 }
 
-static void fill_arr_to_col(uint8_t *img, int stride, int len, uint8_t *arr) {
-  int i;
-  uint8_t *iptr = img;
-  uint8_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *iptr = *aptr++;
+static void down2_vert(const uint8_t *const input, int in_stride, int length,
+                       uint8_t *output, int out_stride, int width) {
+  const int16_t *filter =
+      length & 1 ? av1_down2_symodd_filter : av1_down2_symeven_filter;
+  const uint8_t *rows[INTERP_TAPS];
+  int i, k;
+
+  for (i = 0; i < length; i += 2) {
+    for (k = 0; k < INTERP_TAPS; ++k) {
+      const int pk = i - INTERP_TAPS / 2 + 1 + k;
+      rows[k] = input + clamp(pk, 0, length - 1) * in_stride;
+    }
+    av1_resize_vert(rows, filter, output, width);
+    output += out_stride;
+  }
+}
+
+// Same as resize_multistep() for width columns at once. buf must hold
+// width * length pixels.
+static void resize_multistep_vert(const uint8_t *const input, int in_stride,
+                                  int length, uint8_t *output, int out_stride,
+                                  int olength, int width, uint8_t *buf) {
+  int steps;
+  if (length == olength) {
+    int i;
+    for (i = 0; i < length; ++i)
+      memcpy(output + i * out_stride, input + i * in_stride,
+             sizeof(output[0]) * width);
+    return;
+  }
+  steps = get_down2_steps(length, olength);
+
+  if (steps > 0) {
+    int s;
+    const uint8_t *in = input;
+    int stride = in_stride;
+    uint8_t *const otmp = buf;
+    uint8_t *const otmp2 = otmp + get_down2_length(length, 1) * width;
+    int filteredlength = length;
+    for (s = 0; s < steps; ++s) {
+      const int proj_filteredlength = get_down2_length(filteredlength, 1);
+      uint8_t *out = s & 1 ? otmp2 : otmp;
+      int ostride = width;
+      if (s == steps - 1 && proj_filteredlength == olength) {
+        out = output;
+        ostride = out_stride;
+      }
+      down2_vert(in, stride, filteredlength, out, ostride, width);
+      in = out;
+      stride = ostride;
+      filteredlength = proj_filteredlength;
+    }
+    if (filteredlength != olength) {
+      interpolate_vert(in, stride, filteredlength, output, out_stride, olength,
+                       width);
+    }
+  } else {
+    interpolate_vert(input, in_stride, length, output, out_stride, olength,
+                     width);
   }
 }
 
@@ -431,9 +577,8 @@ void av1_resize_plane(const uint8_t *const input, int height, int width,
                        int out_stride) {
   int i;
   uint8_t *intbuf = (uint8_t *)malloc(sizeof(uint8_t) * width2 * height);
-  uint8_t *tmpbuf =
-      (uint8_t *)malloc(sizeof(uint8_t) * (width < height ? height : width));
-  uint8_t *arrbuf = (uint8_t *)malloc(sizeof(uint8_t) * (height + height2));
+  uint8_t *tmpbuf = (uint8_t *)malloc(sizeof(uint8_t) * width);
+  uint8_t *colbuf = (uint8_t *)malloc(sizeof(uint8_t) * width2 * height);
   assert(width > 0);
   assert(height > 0);
   assert(width2 > 0);
@@ -441,27 +586,18 @@ void av1_resize_plane(const uint8_t *const input, int height, int width,
   for (i = 0; i < height; ++i)
     resize_multistep(input + in_stride * i, width, intbuf + width2 * i, width2,
                      tmpbuf);
-  for (i = 0; i < width2; ++i) {
-    fill_col_to_arr(intbuf + i, width2, height, arrbuf);
-    resize_multistep(arrbuf, height, arrbuf + height, height2, tmpbuf);
-    fill_arr_to_col(output + i, out_stride, height2, arrbuf + height);
-  }
+  resize_multistep_vert(intbuf, width2, height, output, out_stride, height2,
+                        width2, colbuf);
   free(intbuf);
   free(tmpbuf);
-  free(arrbuf);
+  free(colbuf);
 }
 
 #if CONFIG_AOM_HIGHBITDEPTH
 static void highbd_interpolate(const uint16_t *const input, int inlength,
                                uint16_t *output, int outlength, int bd) {
-  const int64_t delta =
-      (((uint64_t)inlength << 32) + outlength / 2) / outlength;
-  const int64_t offset =
-      inlength > outlength
-          ? (((int64_t)(inlength - outlength) << 31) + outlength / 2) /
-                outlength
-          : -(((int64_t)(outlength - inlength) << 31) + outlength / 2) /
-                outlength;
+  const int64_t delta = get_interp_delta(inlength, outlength);
+  const int64_t offset = get_interp_offset(inlength, outlength);
   uint16_t *optr = output;
   int x, x1, x2, sum, k, int_pel, sub_pel;
   int64_t y;
@@ -513,16 +649,11 @@ static void highbd_interpolate(const uint16_t *const input, int inlength,
       *optr++ = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
     }
     // Middle part.
-    for (; x <= x2; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[int_pel - INTERP_TAPS / 2 + 1 + k];
-      *optr++ = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
-    }
+    av1_highbd_resize_horz(input, optr, x2 - x1 + 1, y, delta,
+                           interp_filters[0], bd);
+    optr += x2 - x1 + 1;
+    y += delta * (x2 - x1 + 1);
+    x = x2 + 1;
     // End part.
     for (; x < outlength; ++x, y += delta) {
       const int16_t *filter;
@@ -573,14 +704,10 @@ static void highbd_down2_symeven(const uint16_t *const input, int length,
       *optr++ = clip_pixel_highbd(sum, bd);
     }
     // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + 1 + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
+    av1_highbd_resize_down2_horz(input + i - INTERP_TAPS / 2 + 1, optr,
+                                 (l2 - i) / 2, av1_down2_symeven_filter, bd);
+    optr += (l2 - i) / 2;
+    i = l2;
     // End part.
     for (; i < length; i += 2) {
       int sum = (1 << (FILTER_BITS - 1));
@@ -629,14 +756,10 @@ static void highbd_down2_symodd(const uint16_t *const input, int length,
       *optr++ = clip_pixel_highbd(sum, bd);
     }
     // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
+    av1_highbd_resize_down2_horz(input + i - INTERP_TAPS / 2 + 1, optr,
+                                 (l2 - i) / 2, av1_down2_symodd_filter, bd);
+    optr += (l2 - i) / 2;
+    i = l2;
     // End part.
     for (; i < length; i += 2) {
       int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
@@ -663,16 +786,9 @@ static void highbd_resize_multistep(const uint16_t *const input, int length,
   if (steps > 0) {
     int s;
     uint16_t *out = NULL;
-    uint16_t *tmpbuf = NULL;
-    uint16_t *otmp, *otmp2;
+    uint16_t *const otmp = buf;
+    uint16_t *const otmp2 = otmp + get_down2_length(length, 1);
     int filteredlength = length;
-    if (!tmpbuf) {
-      tmpbuf = (uint16_t *)malloc(sizeof(uint16_t) * length);
-      otmp = tmpbuf;
-    } else {
-      otmp = buf;
-    }
-    otmp2 = otmp + get_down2_length(length, 1);
     for (s = 0; s < steps; ++s) {
       const int proj_filteredlength = get_down2_length(filteredlength, 1);
       const uint16_t *const in = (s == 0 ? input : out);
@@ -689,29 +805,95 @@ static void highbd_resize_multistep(const uint16_t *const input, int length,
     if (filteredlength != olength) {
       highbd_interpolate(out, filteredlength, output, olength, bd);
     }
-    if (tmpbuf) free(tmpbuf);
   } else {
     highbd_interpolate(input, length, output, olength, bd);
   }
 }
 
-static void highbd_fill_col_to_arr(uint16_t *img, int stride, int len,
-                                   uint16_t *arr) {
-  int i;
-  uint16_t *iptr = img;
-  uint16_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *aptr++ = *iptr;
+static void highbd_interpolate_vert(const uint16_t *const input,
+                                    int in_stride, int inlength,
+                                    uint16_t *output, int out_stride,
+                                    int outlength, int width, int bd) {
+  const int64_t delta = get_interp_delta(inlength, outlength);
+  const interp_kernel *interp_filters =
+      choose_interp_filter(inlength, outlength);
+  const uint16_t *rows[INTERP_TAPS];
+  int64_t y = get_interp_offset(inlength, outlength);
+  int x, k;
+
+  for (x = 0; x < outlength; ++x, y += delta) {
+    const int int_pel = (int)(y >> INTERP_PRECISION_BITS);
+    const int sub_pel =
+        (int)(y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
+    for (k = 0; k < INTERP_TAPS; ++k) {
+      const int pk = int_pel - INTERP_TAPS / 2 + 1 + k;
+      rows[k] = input + clamp(pk, 0, inlength - 1) * in_stride;
+    }
+    av1_highbd_resize_vert(rows, interp_filters[sub_pel], output, width, bd);
+    output += out_stride;
   }
 }
 
-static void highbd_fill_arr_to_col(uint16_t *img, int stride, int len,
-                                   uint16_t *arr) {
-  int i;
-  uint16_t *iptr = img;
-  uint16_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *iptr = *aptr++;
+static void highbd_down2_vert(const uint16_t *const input, int in_stride,
+                              int length, uint16_t *output, int out_stride,
+                              int width, int bd) {
+  const int16_t *filter =
+      length & 1 ? av1_down2_symodd_filter : av1_down2_symeven_filter;
+  const uint16_t *rows[INTERP_TAPS];
+  int i, k;
+
+  for (i = 0; i < length; i += 2) {
+    for (k = 0; k < INTERP_TAPS; ++k) {
+      const int pk = i - INTERP_TAPS / 2 + 1 + k;
+      rows[k] = input + clamp(pk, 0, length - 1) * in_stride;
+    }
+    av1_highbd_resize_vert(rows, filter, output, width, bd);
+    output += out_stride;
+  }
+}
+
+static void highbd_resize_multistep_vert(const uint16_t *const input,
+                                         int in_stride, int length,
+                                         uint16_t *output, int out_stride,
+                                         int olength, int width, uint16_t *buf,
+                                         int bd) {
+  int steps;
+  if (length == olength) {
+    int i;
+    for (i = 0; i < length; ++i)
+      memcpy(output + i * out_stride, input + i * in_stride,
+             sizeof(output[0]) * width);
+    return;
+  }
+  steps = get_down2_steps(length, olength);
+
+  if (steps > 0) {
+    int s;
+    const uint16_t *in = input;
+    int stride = in_stride;
+    uint16_t *const otmp = buf;
+    uint16_t *const otmp2 = otmp + get_down2_length(length, 1) * width;
+    int filteredlength = length;
+    for (s = 0; s < steps; ++s) {
+      const int proj_filteredlength = get_down2_length(filteredlength, 1);
+      uint16_t *out = s & 1 ? otmp2 : otmp;
+      int ostride = width;
+      if (s == steps - 1 && proj_filteredlength == olength) {
+        out = output;
+        ostride = out_stride;
+      }
+      highbd_down2_vert(in, stride, filteredlength, out, ostride, width, bd);
+      in = out;
+      stride = ostride;
+      filteredlength = proj_filteredlength;
+    }
+    if (filteredlength != olength) {
+      highbd_interpolate_vert(in, stride, filteredlength, output, out_stride,
+                              olength, width, bd);
+    }
+  } else {
+    highbd_interpolate_vert(input, in_stride, length, output, out_stride,
+                            olength, width, bd);
   }
 }
 
@@ -720,23 +902,18 @@ void av1_highbd_resize_plane(const uint8_t *const input, int height, int width,
                               int width2, int out_stride, int bd) {
   int i;
   uint16_t *intbuf = (uint16_t *)malloc(sizeof(uint16_t) * width2 * height);
-  uint16_t *tmpbuf =
-      (uint16_t *)malloc(sizeof(uint16_t) * (width < height ? height : width));
-  uint16_t *arrbuf = (uint16_t *)malloc(sizeof(uint16_t) * (height + height2));
+  uint16_t *tmpbuf = (uint16_t *)malloc(sizeof(uint16_t) * width);
+  uint16_t *colbuf = (uint16_t *)malloc(sizeof(uint16_t) * width2 * height);
   for (i = 0; i < height; ++i) {
     highbd_resize_multistep(CONVERT_TO_SHORTPTR(input + in_stride * i), width,
                             intbuf + width2 * i, width2, tmpbuf, bd);
   }
-  for (i = 0; i < width2; ++i) {
-    highbd_fill_col_to_arr(intbuf + i, width2, height, arrbuf);
-    highbd_resize_multistep(arrbuf, height, arrbuf + height, height2, tmpbuf,
-                            bd);
-    highbd_fill_arr_to_col(CONVERT_TO_SHORTPTR(output + i), out_stride, height2,
-                           arrbuf + height);
-  }
+  highbd_resize_multistep_vert(intbuf, width2, height,
+                               CONVERT_TO_SHORTPTR(output), out_stride,
+                               height2, width2, colbuf, bd);
   free(intbuf);
   free(tmpbuf);
-  free(arrbuf);
+  free(colbuf);
 }
 #endif  // CONFIG_AOM_HIGHBITDEPTH
 
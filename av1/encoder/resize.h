@@ -19,6 +19,12 @@
 extern "C" {
 #endif
 
+// Fixed point layout of the resampler, shared with the SIMD kernels.
+#define RS_INTERP_TAPS 8
+#define RS_SUBPEL_BITS 5
+#define RS_SUBPEL_MASK ((1 << RS_SUBPEL_BITS) - 1)
+#define RS_INTERP_PRECISION_BITS 32
+
 void av1_resize_plane(const uint8_t *const input, int height, int width,
                        int in_stride, uint8_t *output, int height2, int width2,
                        int out_stride);
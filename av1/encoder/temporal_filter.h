@@ -16,8 +16,24 @@
 extern "C" {
 #endif
 
+// The frames filtered into an alt-ref frame, shared by the threads filtering
+// its macroblock rows.
+typedef struct TemporalFilterData {
+  YV12_BUFFER_CONFIG **frames;
+  int frame_count;
+  // Index of the frame the alt-ref frame is built from.
+  int alt_ref_index;
+  int strength;
+  struct scale_factors *scale;
+} TemporalFilterData;
+
 void av1_temporal_filter(AV1_COMP *cpi, int distance);
 
+// Filter macroblock row 'mb_row' of the alt-ref frame with the thread data
+// 'td'. The rows are independent of each other.
+void av1_temporal_filter_iterate_row(AV1_COMP *cpi, ThreadData *td,
+                                     const TemporalFilterData *tf, int mb_row);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
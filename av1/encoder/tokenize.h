@@ -34,7 +34,7 @@ typedef struct {
   EXTRABIT extra;
 } TOKENVALUE;
 
-typedef struct {
+typedef struct TOKENEXTRA {
   const aom_prob *context_tree;
   EXTRABIT extra;
   uint8_t token;
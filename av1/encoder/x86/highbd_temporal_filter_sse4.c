@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <smmintrin.h>
+
+#include "./av1_rtcd.h"
+#include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/mem.h"
+
+// Filters 8 pixels. The modifier is formed in 32 bits, as in the C code, and
+// modifier * pixel is computed with pmaddwd, which needs pixel < (1 << 15).
+static INLINE void filter_8(const uint16_t *frame1, const uint16_t *frame2,
+                            __m128i strength, __m128i rounding,
+                            __m128i weight, unsigned int *accumulator,
+                            uint16_t *count) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i sixteen = _mm_set1_epi32(16);
+  const __m128i src = _mm_loadu_si128((const __m128i *)frame1);
+  const __m128i pred = _mm_loadu_si128((const __m128i *)frame2);
+  const __m128i diff = _mm_sub_epi16(src, pred);
+  const __m128i diff3 = _mm_mullo_epi16(diff, _mm_set1_epi16(3));
+  __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(diff, zero),
+                              _mm_unpacklo_epi16(diff3, zero));
+  __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(diff, zero),
+                              _mm_unpackhi_epi16(diff3, zero));
+  __m128i modifier, cnt, acc_lo, acc_hi;
+
+  lo = _mm_srl_epi32(_mm_add_epi32(lo, rounding), strength);
+  hi = _mm_srl_epi32(_mm_add_epi32(hi, rounding), strength);
+  lo = _mm_sub_epi32(sixteen, _mm_min_epu32(lo, sixteen));
+  hi = _mm_sub_epi32(sixteen, _mm_min_epu32(hi, sixteen));
+  modifier = _mm_mullo_epi16(_mm_packus_epi32(lo, hi), weight);
+
+  cnt = _mm_loadu_si128((const __m128i *)count);
+  _mm_storeu_si128((__m128i *)count, _mm_add_epi16(cnt, modifier));
+
+  acc_lo = _mm_loadu_si128((const __m128i *)accumulator);
+  acc_hi = _mm_loadu_si128((const __m128i *)(accumulator + 4));
+  lo = _mm_madd_epi16(_mm_unpacklo_epi16(modifier, zero),
+                      _mm_unpacklo_epi16(pred, zero));
+  hi = _mm_madd_epi16(_mm_unpackhi_epi16(modifier, zero),
+                      _mm_unpackhi_epi16(pred, zero));
+  acc_lo = _mm_add_epi32(acc_lo, lo);
+  acc_hi = _mm_add_epi32(acc_hi, hi);
+  _mm_storeu_si128((__m128i *)accumulator, acc_lo);
+  _mm_storeu_si128((__m128i *)(accumulator + 4), acc_hi);
+}
+
+void av1_highbd_temporal_filter_apply_sse4_1(
+    uint8_t *frame1_8, unsigned int stride, uint8_t *frame2_8,
+    unsigned int block_width, unsigned int block_height, int strength,
+    int filter_weight, unsigned int *accumulator, uint16_t *count) {
+  const uint16_t *frame1 = CONVERT_TO_SHORTPTR(frame1_8);
+  const uint16_t *frame2 = CONVERT_TO_SHORTPTR(frame2_8);
+  const __m128i shift = _mm_cvtsi32_si128(strength);
+  const __m128i rounding =
+      _mm_set1_epi32(strength > 0 ? 1 << (strength - 1) : 0);
+  const __m128i weight = _mm_set1_epi16(filter_weight);
+  unsigned int i, j;
+
+  if (block_width % 8) {
+    av1_highbd_temporal_filter_apply_c(frame1_8, stride, frame2_8,
+                                       block_width, block_height, strength,
+                                       filter_weight, accumulator, count);
+    return;
+  }
+
+  for (i = 0; i < block_height; i++) {
+    for (j = 0; j < block_width; j += 8) {
+      filter_8(frame1 + j, frame2, shift, rounding, weight, accumulator,
+               count);
+      frame2 += 8;
+      accumulator += 8;
+      count += 8;
+    }
+    frame1 += stride;
+  }
+}
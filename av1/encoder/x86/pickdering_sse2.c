@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <emmintrin.h>  // SSE2
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+
+// Assumes that every |a - b| fits in int16_t: the differences are taken with
+// _mm_sub_epi16(), which wraps where the C version does not. This holds for
+// the encoder, which compares pixels of the same bit depth (up to 12 bits).
+int64_t av1_dering_sse_sse2(const int16_t *a, int astride, const int16_t *b,
+                            int bstride, int w, int h) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sum = zero;
+  int64_t sse;
+  int i, j;
+
+  if (w & 7) return av1_dering_sse_c(a, astride, b, bstride, w, h);
+
+  for (i = 0; i < h; i++) {
+    // Each 32-bit lane sums the squares of 16 differences of a row of up to
+    // 64 pixels, which fits for 12-bit pixels. The lanes are widened before
+    // being added to the total.
+    const int16_t *const ar = a + i * astride;
+    const int16_t *const br = b + i * bstride;
+    __m128i row = zero;
+    for (j = 0; j < w; j += 8) {
+      const __m128i va = _mm_loadu_si128((const __m128i *)(ar + j));
+      const __m128i vb = _mm_loadu_si128((const __m128i *)(br + j));
+      const __m128i d = _mm_sub_epi16(va, vb);
+      row = _mm_add_epi32(row, _mm_madd_epi16(d, d));
+    }
+    sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(row, zero));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(row, zero));
+  }
+  sum = _mm_add_epi64(sum, _mm_srli_si128(sum, 8));
+  _mm_storel_epi64((__m128i *)&sse, sum);
+  return sse;
+}
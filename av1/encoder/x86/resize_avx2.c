@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./av1_rtcd.h"
+#include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_dsp/aom_filter.h"
+#include "av1/encoder/resize.h"
+
+// Splits the 8 taps into the pairs multiplied by _mm256_madd_epi16(), the
+// same in both lanes.
+static INLINE void load_tap_pairs(const int16_t *filter, __m256i *f) {
+  const __m128i taps128 = _mm_loadu_si128((const __m128i *)filter);
+  const __m256i taps =
+      _mm256_inserti128_si256(_mm256_castsi128_si256(taps128), taps128, 1);
+  f[0] = _mm256_shuffle_epi32(taps, 0x00);
+  f[1] = _mm256_shuffle_epi32(taps, 0x55);
+  f[2] = _mm256_shuffle_epi32(taps, 0xaa);
+  f[3] = _mm256_shuffle_epi32(taps, 0xff);
+}
+
+// Vertical pass: 16 columns per register, see resize_sse2.c. The unpacks and
+// the final pack all stay within 128-bit lanes, so the 16 results come out in
+// column order.
+static INLINE __m256i filter_16_cols(const __m256i *px, const __m256i *f) {
+  __m256i lo = _mm256_set1_epi32(1 << (FILTER_BITS - 1));
+  __m256i hi = lo;
+  int k;
+  for (k = 0; k < RS_INTERP_TAPS / 2; ++k) {
+    lo = _mm256_add_epi32(
+        lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(px[2 * k], px[2 * k + 1]),
+                              f[k]));
+    hi = _mm256_add_epi32(
+        hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(px[2 * k], px[2 * k + 1]),
+                              f[k]));
+  }
+  return _mm256_packs_epi32(_mm256_srai_epi32(lo, FILTER_BITS),
+                            _mm256_srai_epi32(hi, FILTER_BITS));
+}
+
+void av1_resize_vert_avx2(const uint8_t *const *rows, const int16_t *filter,
+                          uint8_t *output, int width) {
+  __m256i f[RS_INTERP_TAPS / 2], px[RS_INTERP_TAPS];
+  int x, k;
+
+  if (width < 32) {
+    av1_resize_vert_c(rows, filter, output, width);
+    return;
+  }
+  load_tap_pairs(filter, f);
+
+  // The last 32 columns may overlap the previous ones.
+  for (x = 0; x < width; x += 32) {
+    __m256i lo, hi;
+    if (x > width - 32) x = width - 32;
+    for (k = 0; k < RS_INTERP_TAPS; ++k)
+      px[k] = _mm256_cvtepu8_epi16(
+          _mm_loadu_si128((const __m128i *)(rows[k] + x)));
+    lo = filter_16_cols(px, f);
+    for (k = 0; k < RS_INTERP_TAPS; ++k)
+      px[k] = _mm256_cvtepu8_epi16(
+          _mm_loadu_si128((const __m128i *)(rows[k] + x + 16)));
+    hi = filter_16_cols(px, f);
+    _mm256_storeu_si256(
+        (__m256i *)(output + x),
+        _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xd8));
+  }
+}
+
+// 2:1 downscaler, see resize_sse2.c. Each 128-bit lane holds the pixel pairs
+// of 4 consecutive outputs.
+void av1_resize_down2_horz_avx2(const uint8_t *input, uint8_t *output,
+                                int outlength, const int16_t *filter) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i f[RS_INTERP_TAPS / 2];
+  int x, k;
+
+  load_tap_pairs(filter, f);
+  for (x = 0; x + 16 <= outlength; x += 16, input += 32) {
+    // Outputs 0-3 and 8-11 in lo, 4-7 and 12-15 in hi.
+    __m256i lo = _mm256_set1_epi32(1 << (FILTER_BITS - 1));
+    __m256i hi = lo;
+    for (k = 0; k < RS_INTERP_TAPS / 2; ++k) {
+      const __m256i px =
+          _mm256_loadu_si256((const __m256i *)(input + 2 * k));
+      lo = _mm256_add_epi32(
+          lo, _mm256_madd_epi16(_mm256_unpacklo_epi8(px, zero), f[k]));
+      hi = _mm256_add_epi32(
+          hi, _mm256_madd_epi16(_mm256_unpackhi_epi8(px, zero), f[k]));
+    }
+    lo = _mm256_packs_epi32(_mm256_srai_epi32(lo, FILTER_BITS),
+                            _mm256_srai_epi32(hi, FILTER_BITS));
+    lo = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, lo), 0x08);
+    _mm_storeu_si128((__m128i *)(output + x), _mm256_castsi256_si128(lo));
+  }
+  av1_resize_down2_horz_c(input, output + x, outlength - x, filter);
+}
+
+#if CONFIG_AOM_HIGHBITDEPTH
+void av1_highbd_resize_vert_avx2(const uint16_t *const *rows,
+                                 const int16_t *filter, uint16_t *output,
+                                 int width, int bd) {
+  const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+  __m256i f[RS_INTERP_TAPS / 2], px[RS_INTERP_TAPS];
+  int x, k;
+
+  if (width < 16) {
+    av1_highbd_resize_vert_c(rows, filter, output, width, bd);
+    return;
+  }
+  load_tap_pairs(filter, f);
+
+  for (x = 0; x < width; x += 16) {
+    __m256i res;
+    if (x > width - 16) x = width - 16;
+    for (k = 0; k < RS_INTERP_TAPS; ++k)
+      px[k] = _mm256_loadu_si256((const __m256i *)(rows[k] + x));
+    res = filter_16_cols(px, f);
+    res = _mm256_min_epi16(_mm256_max_epi16(res, _mm256_setzero_si256()), max);
+    _mm256_storeu_si256((__m256i *)(output + x), res);
+  }
+}
+
+void av1_highbd_resize_down2_horz_avx2(const uint16_t *input,
+                                       uint16_t *output, int outlength,
+                                       const int16_t *filter, int bd) {
+  const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+  __m256i f[RS_INTERP_TAPS / 2];
+  int x, k;
+
+  load_tap_pairs(filter, f);
+  for (x = 0; x + 16 <= outlength; x += 16, input += 32) {
+    // Outputs 0-3 and 4-7 in lo, 8-11 and 12-15 in hi.
+    __m256i lo = _mm256_set1_epi32(1 << (FILTER_BITS - 1));
+    __m256i hi = lo, res;
+    for (k = 0; k < RS_INTERP_TAPS / 2; ++k) {
+      lo = _mm256_add_epi32(
+          lo, _mm256_madd_epi16(
+                  _mm256_loadu_si256((const __m256i *)(input + 2 * k)), f[k]));
+      hi = _mm256_add_epi32(
+          hi,
+          _mm256_madd_epi16(
+              _mm256_loadu_si256((const __m256i *)(input + 16 + 2 * k)), f[k]));
+    }
+    res = _mm256_packs_epi32(_mm256_srai_epi32(lo, FILTER_BITS),
+                             _mm256_srai_epi32(hi, FILTER_BITS));
+    res = _mm256_permute4x64_epi64(res, 0xd8);
+    res = _mm256_min_epi16(_mm256_max_epi16(res, _mm256_setzero_si256()), max);
+    _mm256_storeu_si256((__m256i *)(output + x), res);
+  }
+  av1_highbd_resize_down2_horz_c(input, output + x, outlength - x, filter, bd);
+}
+#endif  // CONFIG_AOM_HIGHBITDEPTH
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <emmintrin.h>
+
+#include "./av1_rtcd.h"
+#include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_dsp/aom_filter.h"
+#include "av1/encoder/resize.h"
+
+// Splits the 8 taps into the pairs multiplied by _mm_madd_epi16().
+static INLINE void load_tap_pairs(const int16_t *filter, __m128i *f) {
+  const __m128i taps = _mm_loadu_si128((const __m128i *)filter);
+  f[0] = _mm_shuffle_epi32(taps, 0x00);
+  f[1] = _mm_shuffle_epi32(taps, 0x55);
+  f[2] = _mm_shuffle_epi32(taps, 0xaa);
+  f[3] = _mm_shuffle_epi32(taps, 0xff);
+}
+
+// Filters 8 columns of 16-bit pixels, two rows at a time. The sums are
+// exact in 32 bits.
+static INLINE __m128i filter_8_cols(const __m128i *px, const __m128i *f) {
+  __m128i lo = _mm_set1_epi32(1 << (FILTER_BITS - 1));
+  __m128i hi = lo;
+  int k;
+  for (k = 0; k < RS_INTERP_TAPS / 2; ++k) {
+    lo = _mm_add_epi32(
+        lo, _mm_madd_epi16(_mm_unpacklo_epi16(px[2 * k], px[2 * k + 1]), f[k]));
+    hi = _mm_add_epi32(
+        hi, _mm_madd_epi16(_mm_unpackhi_epi16(px[2 * k], px[2 * k + 1]), f[k]));
+  }
+  return _mm_packs_epi32(_mm_srai_epi32(lo, FILTER_BITS),
+                         _mm_srai_epi32(hi, FILTER_BITS));
+}
+
+void av1_resize_vert_sse2(const uint8_t *const *rows, const int16_t *filter,
+                          uint8_t *output, int width) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i f[RS_INTERP_TAPS / 2], px[RS_INTERP_TAPS];
+  int x, k;
+
+  if (width < 16) {
+    av1_resize_vert_c(rows, filter, output, width);
+    return;
+  }
+  load_tap_pairs(filter, f);
+
+  // The last 16 columns may overlap the previous ones, which only writes the
+  // same pixels twice.
+  for (x = 0; x < width; x += 16) {
+    __m128i lo, hi;
+    if (x > width - 16) x = width - 16;
+    for (k = 0; k < RS_INTERP_TAPS; ++k)
+      px[k] = _mm_unpacklo_epi8(
+          _mm_loadl_epi64((const __m128i *)(rows[k] + x)), zero);
+    lo = filter_8_cols(px, f);
+    for (k = 0; k < RS_INTERP_TAPS; ++k)
+      px[k] = _mm_unpacklo_epi8(
+          _mm_loadl_epi64((const __m128i *)(rows[k] + x + 8)), zero);
+    hi = filter_8_cols(px, f);
+    _mm_storeu_si128((__m128i *)(output + x), _mm_packus_epi16(lo, hi));
+  }
+}
+
+// Tap pair k of output i reads pixels 2 * i + 2 * k and 2 * i + 2 * k + 1, so
+// a load from input + 2 * k holds that pair for consecutive outputs in order
+// and no horizontal adds are needed.
+void av1_resize_down2_horz_sse2(const uint8_t *input, uint8_t *output,
+                                int outlength, const int16_t *filter) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i f[RS_INTERP_TAPS / 2];
+  int x, k;
+
+  load_tap_pairs(filter, f);
+  for (x = 0; x + 8 <= outlength; x += 8, input += 16) {
+    __m128i lo = _mm_set1_epi32(1 << (FILTER_BITS - 1));
+    __m128i hi = lo;
+    for (k = 0; k < RS_INTERP_TAPS / 2; ++k) {
+      const __m128i px = _mm_loadu_si128((const __m128i *)(input + 2 * k));
+      lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi8(px, zero), f[k]));
+      hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi8(px, zero), f[k]));
+    }
+    lo = _mm_packs_epi32(_mm_srai_epi32(lo, FILTER_BITS),
+                         _mm_srai_epi32(hi, FILTER_BITS));
+    _mm_storel_epi64((__m128i *)(output + x), _mm_packus_epi16(lo, lo));
+  }
+  av1_resize_down2_horz_c(input, output + x, outlength - x, filter);
+}
+
+#if CONFIG_AOM_HIGHBITDEPTH
+void av1_highbd_resize_vert_sse2(const uint16_t *const *rows,
+                                 const int16_t *filter, uint16_t *output,
+                                 int width, int bd) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i max = _mm_set1_epi16((1 << bd) - 1);
+  __m128i f[RS_INTERP_TAPS / 2], px[RS_INTERP_TAPS];
+  int x, k;
+
+  if (width < 8) {
+    av1_highbd_resize_vert_c(rows, filter, output, width, bd);
+    return;
+  }
+  load_tap_pairs(filter, f);
+
+  for (x = 0; x < width; x += 8) {
+    __m128i res;
+    if (x > width - 8) x = width - 8;
+    for (k = 0; k < RS_INTERP_TAPS; ++k)
+      px[k] = _mm_loadu_si128((const __m128i *)(rows[k] + x));
+    res = filter_8_cols(px, f);
+    res = _mm_min_epi16(_mm_max_epi16(res, zero), max);
+    _mm_storeu_si128((__m128i *)(output + x), res);
+  }
+}
+
+void av1_highbd_resize_down2_horz_sse2(const uint16_t *input, uint16_t *output,
+                                       int outlength, const int16_t *filter,
+                                       int bd) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i max = _mm_set1_epi16((1 << bd) - 1);
+  __m128i f[RS_INTERP_TAPS / 2];
+  int x, k;
+
+  load_tap_pairs(filter, f);
+  for (x = 0; x + 8 <= outlength; x += 8, input += 16) {
+    __m128i lo = _mm_set1_epi32(1 << (FILTER_BITS - 1));
+    __m128i hi = lo, res;
+    for (k = 0; k < RS_INTERP_TAPS / 2; ++k) {
+      lo = _mm_add_epi32(
+          lo, _mm_madd_epi16(
+                  _mm_loadu_si128((const __m128i *)(input + 2 * k)), f[k]));
+      hi = _mm_add_epi32(
+          hi, _mm_madd_epi16(
+                  _mm_loadu_si128((const __m128i *)(input + 8 + 2 * k)), f[k]));
+    }
+    res = _mm_packs_epi32(_mm_srai_epi32(lo, FILTER_BITS),
+                          _mm_srai_epi32(hi, FILTER_BITS));
+    res = _mm_min_epi16(_mm_max_epi16(res, zero), max);
+    _mm_storeu_si128((__m128i *)(output + x), res);
+  }
+  av1_highbd_resize_down2_horz_c(input, output + x, outlength - x, filter, bd);
+}
+#endif  // CONFIG_AOM_HIGHBITDEPTH
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <tmmintrin.h>
+
+#include "./av1_rtcd.h"
+#include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_dsp/aom_filter.h"
+#include "av1/encoder/resize.h"
+
+// Every output has its own 8 input pixels and taps. Each one is reduced to
+// four partial sums with _mm_madd_epi16(), and the sums of four outputs are
+// finished with two rounds of _mm_hadd_epi32().
+
+static INLINE __m128i madd_taps(const uint8_t *in, const int16_t *filter) {
+  const __m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)in),
+                                       _mm_setzero_si128());
+  return _mm_madd_epi16(px, _mm_loadu_si128((const __m128i *)filter));
+}
+
+static INLINE __m128i sum_4(const __m128i *s) {
+  const __m128i round = _mm_set1_epi32(1 << (FILTER_BITS - 1));
+  const __m128i sum = _mm_hadd_epi32(_mm_hadd_epi32(s[0], s[1]),
+                                     _mm_hadd_epi32(s[2], s[3]));
+  return _mm_srai_epi32(_mm_add_epi32(sum, round), FILTER_BITS);
+}
+
+static INLINE void store_8(uint8_t *output, const __m128i *s) {
+  const __m128i res = _mm_packs_epi32(sum_4(s), sum_4(s + 4));
+  _mm_storel_epi64((__m128i *)output, _mm_packus_epi16(res, res));
+}
+
+void av1_resize_horz_ssse3(const uint8_t *input, uint8_t *output,
+                           int outlength, int64_t y, int64_t delta,
+                           const int16_t *filters) {
+  __m128i s[8];
+  int x, i;
+
+  for (x = 0; x + 8 <= outlength; x += 8) {
+    for (i = 0; i < 8; ++i, y += delta) {
+      const int int_pel = (int)(y >> RS_INTERP_PRECISION_BITS);
+      const int sub_pel =
+          (int)(y >> (RS_INTERP_PRECISION_BITS - RS_SUBPEL_BITS)) &
+          RS_SUBPEL_MASK;
+      s[i] = madd_taps(input + int_pel - RS_INTERP_TAPS / 2 + 1,
+                       filters + sub_pel * RS_INTERP_TAPS);
+    }
+    store_8(output + x, s);
+  }
+  av1_resize_horz_c(input, output + x, outlength - x, y, delta, filters);
+}
+
+#if CONFIG_AOM_HIGHBITDEPTH
+static INLINE __m128i highbd_madd_taps(const uint16_t *in,
+                                       const int16_t *filter) {
+  return _mm_madd_epi16(_mm_loadu_si128((const __m128i *)in),
+                        _mm_loadu_si128((const __m128i *)filter));
+}
+
+static INLINE void highbd_store_8(uint16_t *output, const __m128i *s,
+                                  int bd) {
+  const __m128i max = _mm_set1_epi16((1 << bd) - 1);
+  __m128i res = _mm_packs_epi32(sum_4(s), sum_4(s + 4));
+  res = _mm_min_epi16(_mm_max_epi16(res, _mm_setzero_si128()), max);
+  _mm_storeu_si128((__m128i *)output, res);
+}
+
+void av1_highbd_resize_horz_ssse3(const uint16_t *input, uint16_t *output,
+                                  int outlength, int64_t y, int64_t delta,
+                                  const int16_t *filters, int bd) {
+  __m128i s[8];
+  int x, i;
+
+  for (x = 0; x + 8 <= outlength; x += 8) {
+    for (i = 0; i < 8; ++i, y += delta) {
+      const int int_pel = (int)(y >> RS_INTERP_PRECISION_BITS);
+      const int sub_pel =
+          (int)(y >> (RS_INTERP_PRECISION_BITS - RS_SUBPEL_BITS)) &
+          RS_SUBPEL_MASK;
+      s[i] = highbd_madd_taps(input + int_pel - RS_INTERP_TAPS / 2 + 1,
+                              filters + sub_pel * RS_INTERP_TAPS);
+    }
+    highbd_store_8(output + x, s, bd);
+  }
+  av1_highbd_resize_horz_c(input, output + x, outlength - x, y, delta, filters,
+                           bd);
+}
+#endif  // CONFIG_AOM_HIGHBITDEPTH
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./av1_rtcd.h"
+#include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/mem.h"
+
+// Computes filter_weight * (16 - min(16, (3 * diff * diff + rounding) >>
+// strength)) for 16 pixels. The square is formed in 32 bits so that the
+// result matches the C code for any pixel difference.
+static INLINE __m256i filter_modifier(__m256i diff, __m128i strength,
+                                      __m256i rounding, __m256i weight) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i sixteen = _mm256_set1_epi32(16);
+  const __m256i diff3 = _mm256_mullo_epi16(diff, _mm256_set1_epi16(3));
+  __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(diff, zero),
+                                 _mm256_unpacklo_epi16(diff3, zero));
+  __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(diff, zero),
+                                 _mm256_unpackhi_epi16(diff3, zero));
+  __m256i modifier;
+
+  lo = _mm256_srl_epi32(_mm256_add_epi32(lo, rounding), strength);
+  hi = _mm256_srl_epi32(_mm256_add_epi32(hi, rounding), strength);
+  lo = _mm256_sub_epi32(sixteen, _mm256_min_epu32(lo, sixteen));
+  hi = _mm256_sub_epi32(sixteen, _mm256_min_epu32(hi, sixteen));
+  modifier = _mm256_packus_epi32(lo, hi);
+  return _mm256_mullo_epi16(modifier, weight);
+}
+
+// Adds the modifiers to count and modifier * pixel to the accumulator for 16
+// consecutive entries. pixel must fit in 15 bits.
+static INLINE void accumulate(__m256i modifier, __m256i pixel,
+                              unsigned int *accumulator, uint16_t *count) {
+  const __m256i mod_lo =
+      _mm256_cvtepu16_epi32(_mm256_castsi256_si128(modifier));
+  const __m256i mod_hi =
+      _mm256_cvtepu16_epi32(_mm256_extracti128_si256(modifier, 1));
+  const __m256i pix_lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(pixel));
+  const __m256i pix_hi =
+      _mm256_cvtepu16_epi32(_mm256_extracti128_si256(pixel, 1));
+  __m256i acc_lo = _mm256_loadu_si256((const __m256i *)accumulator);
+  __m256i acc_hi = _mm256_loadu_si256((const __m256i *)(accumulator + 8));
+  __m256i cnt = _mm256_loadu_si256((const __m256i *)count);
+
+  cnt = _mm256_add_epi16(cnt, modifier);
+  acc_lo = _mm256_add_epi32(acc_lo, _mm256_madd_epi16(mod_lo, pix_lo));
+  acc_hi = _mm256_add_epi32(acc_hi, _mm256_madd_epi16(mod_hi, pix_hi));
+  _mm256_storeu_si256((__m256i *)count, cnt);
+  _mm256_storeu_si256((__m256i *)accumulator, acc_lo);
+  _mm256_storeu_si256((__m256i *)(accumulator + 8), acc_hi);
+}
+
+void av1_temporal_filter_apply_avx2(uint8_t *frame1, unsigned int stride,
+                                    uint8_t *frame2, unsigned int block_width,
+                                    unsigned int block_height, int strength,
+                                    int filter_weight,
+                                    unsigned int *accumulator,
+                                    uint16_t *count) {
+  const __m128i shift = _mm_cvtsi32_si128(strength);
+  const __m256i rounding =
+      _mm256_set1_epi32(strength > 0 ? 1 << (strength - 1) : 0);
+  const __m256i weight = _mm256_set1_epi16(filter_weight);
+  const unsigned int rows = block_width == 16 ? 1 : 2;
+  unsigned int i;
+
+  if ((block_width != 16 && block_width != 8) || (block_height % rows)) {
+    av1_temporal_filter_apply_c(frame1, stride, frame2, block_width,
+                                block_height, strength, filter_weight,
+                                accumulator, count);
+    return;
+  }
+
+  // Sixteen pixels per iteration: one row of a 16 wide block or two rows of
+  // an 8 wide one. frame2, accumulator and count are packed.
+  for (i = 0; i < block_height; i += rows) {
+    __m128i src;
+    __m256i src16, pred16;
+    if (rows == 1) {
+      src = _mm_loadu_si128((const __m128i *)frame1);
+    } else {
+      src = _mm_unpacklo_epi64(
+          _mm_loadl_epi64((const __m128i *)frame1),
+          _mm_loadl_epi64((const __m128i *)(frame1 + stride)));
+    }
+    src16 = _mm256_cvtepu8_epi16(src);
+    pred16 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)frame2));
+
+    accumulate(filter_modifier(_mm256_sub_epi16(src16, pred16), shift,
+                               rounding, weight),
+               pred16, accumulator, count);
+
+    frame1 += rows * stride;
+    frame2 += 16;
+    accumulator += 16;
+    count += 16;
+  }
+}
+
+#if CONFIG_AOM_HIGHBITDEPTH
+void av1_highbd_temporal_filter_apply_avx2(
+    uint8_t *frame1_8, unsigned int stride, uint8_t *frame2_8,
+    unsigned int block_width, unsigned int block_height, int strength,
+    int filter_weight, unsigned int *accumulator, uint16_t *count) {
+  const uint16_t *frame1 = CONVERT_TO_SHORTPTR(frame1_8);
+  const uint16_t *frame2 = CONVERT_TO_SHORTPTR(frame2_8);
+  const __m128i shift = _mm_cvtsi32_si128(strength);
+  const __m256i rounding =
+      _mm256_set1_epi32(strength > 0 ? 1 << (strength - 1) : 0);
+  const __m256i weight = _mm256_set1_epi16(filter_weight);
+  const unsigned int rows = block_width == 16 ? 1 : 2;
+  unsigned int i;
+
+  if ((block_width != 16 && block_width != 8) || (block_height % rows)) {
+    av1_highbd_temporal_filter_apply_c(frame1_8, stride, frame2_8,
+                                       block_width, block_height, strength,
+                                       filter_weight, accumulator, count);
+    return;
+  }
+
+  for (i = 0; i < block_height; i += rows) {
+    __m256i src, pred;
+    if (rows == 1) {
+      src = _mm256_loadu_si256((const __m256i *)frame1);
+    } else {
+      src = _mm256_inserti128_si256(
+          _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)frame1)),
+          _mm_loadu_si128((const __m128i *)(frame1 + stride)), 1);
+    }
+    pred = _mm256_loadu_si256((const __m256i *)frame2);
+
+    accumulate(filter_modifier(_mm256_sub_epi16(src, pred), shift, rounding,
+                               weight),
+               pred, accumulator, count);
+
+    frame1 += rows * stride;
+    frame2 += 16;
+    accumulator += 16;
+    count += 16;
+  }
+}
+#endif  // CONFIG_AOM_HIGHBITDEPTH
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/threaded_decode_test.h"
+#include "test/util.h"
+
+namespace {
+
+const int kNumFrames = 20;
+
+// Thread counts to decode with. Counts above 8 used to be clamped.
+const int kThreads[] = { 2, 3, 4, 8, 9, 16, 32 };
+
+class AV1FrameParallelTest : public ::libaom_test::ThreadedDecodeTest,
+                             public ::libaom_test::CodecTestWithParam<int> {
+ protected:
+  AV1FrameParallelTest()
+      : ThreadedDecodeTest(GET_PARAM(0)), lag_in_frames_(GET_PARAM(1)) {}
+
+  virtual ~AV1FrameParallelTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = lag_in_frames_;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 4);
+      encoder->Control(AV1E_SET_FRAME_PARALLEL_DECODING, 1);
+    }
+  }
+
+ private:
+  int lag_in_frames_;
+};
+
+TEST_P(AV1FrameParallelTest, MD5Match) {
+  ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                       30, 1, 0, kNumFrames);
+  const int num_threads =
+      static_cast<int>(sizeof(kThreads) / sizeof(kThreads[0]));
+  ASSERT_NO_FATAL_FAILURE(RunTest(&video, kNumFrames, kThreads, num_threads,
+                                  AOM_CODEC_USE_FRAME_THREADING));
+}
+
+// Without and with hidden alternate reference frames.
+AV1_INSTANTIATE_TEST_CASE(AV1FrameParallelTest, ::testing::Values(0, 25));
+
+}  // namespace
@@ -274,4 +274,218 @@ INSTANTIATE_TEST_CASE_P(
                                  &av1_idct8x8_1_add_c, TX_8X8, 1),
                       make_tuple(&aom_fdct4x4_c, &av1_idct4x4_16_add_c,
                                  &av1_idct4x4_1_add_c, TX_4X4, 1)));
+
+typedef void (*FhtFunc)(const int16_t *in, tran_low_t *out, int stride,
+                        int tx_type);
+typedef void (*IhtFunc)(const tran_low_t *in, uint8_t *out, int stride,
+                        int tx_type, int bd);
+typedef std::tr1::tuple<FhtFunc, IhtFunc, IhtFunc, int, int, aom_bit_depth_t>
+    IhtParam;
+
+// Compares an optimized inverse hybrid transform against the C version.
+// Coefficients come from the forward transform of random residuals and, for
+// the high bitdepth transforms, from random values over the full range the
+// dequantizer can produce.
+class AV1InvHtTest : public ::testing::TestWithParam<IhtParam> {
+ public:
+  virtual ~AV1InvHtTest() {}
+  virtual void SetUp() {
+    fwd_txfm_ = GET_PARAM(0);
+    ref_txfm_ = GET_PARAM(1);
+    inv_txfm_ = GET_PARAM(2);
+    size_ = GET_PARAM(3);
+    tx_type_ = GET_PARAM(4);
+    bit_depth_ = GET_PARAM(5);
+    mask_ = (1 << bit_depth_) - 1;
+  }
+
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void RunMatchCheck() {
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    const int count_test_block = 1000;
+    const int block_size = size_ * size_;
+    const int max_coeff = (1 << (7 + bit_depth_)) - 1;
+    DECLARE_ALIGNED(16, int16_t, residual[kMaxNumCoeffs]);
+    DECLARE_ALIGNED(16, tran_low_t, coeff[kMaxNumCoeffs]);
+    DECLARE_ALIGNED(16, uint8_t, dst[kMaxNumCoeffs]);
+    DECLARE_ALIGNED(16, uint8_t, ref_dst[kMaxNumCoeffs]);
+#if CONFIG_AOM_HIGHBITDEPTH
+    DECLARE_ALIGNED(16, uint16_t, dst16[kMaxNumCoeffs]);
+    DECLARE_ALIGNED(16, uint16_t, ref_dst16[kMaxNumCoeffs]);
+#endif
+
+    for (int i = 0; i < count_test_block; ++i) {
+      if (bit_depth_ == AOM_BITS_8 || (i & 1)) {
+        for (int j = 0; j < block_size; ++j)
+          residual[j] = (rnd.Rand16() & mask_) - (rnd.Rand16() & mask_);
+        fwd_txfm_(residual, coeff, size_, tx_type_);
+      } else if (i & 2) {
+        for (int j = 0; j < block_size; ++j)
+          coeff[j] = rnd.Rand8() & 1 ? max_coeff : -max_coeff;
+      } else {
+        for (int j = 0; j < block_size; ++j)
+          coeff[j] = rnd(2 * max_coeff + 1) - max_coeff;
+      }
+
+      for (int j = 0; j < block_size; ++j) {
+        if (bit_depth_ == AOM_BITS_8) {
+          dst[j] = ref_dst[j] = rnd.Rand8();
+#if CONFIG_AOM_HIGHBITDEPTH
+        } else {
+          dst16[j] = ref_dst16[j] = rnd.Rand16() & mask_;
+#endif
+        }
+      }
+
+      if (bit_depth_ == AOM_BITS_8) {
+        ref_txfm_(coeff, ref_dst, size_, tx_type_, bit_depth_);
+        ASM_REGISTER_STATE_CHECK(
+            inv_txfm_(coeff, dst, size_, tx_type_, bit_depth_));
+#if CONFIG_AOM_HIGHBITDEPTH
+      } else {
+        ref_txfm_(coeff, CONVERT_TO_BYTEPTR(ref_dst16), size_, tx_type_,
+                  bit_depth_);
+        ASM_REGISTER_STATE_CHECK(inv_txfm_(coeff, CONVERT_TO_BYTEPTR(dst16),
+                                           size_, tx_type_, bit_depth_));
+#endif
+      }
+
+      for (int j = 0; j < block_size; ++j) {
+#if CONFIG_AOM_HIGHBITDEPTH
+        if (bit_depth_ != AOM_BITS_8) {
+          ASSERT_EQ(ref_dst16[j], dst16[j]) << "Error: " << size_ << "x"
+                                            << size_ << " iht of type "
+                                            << tx_type_ << " at " << j;
+          continue;
+        }
+#endif
+        ASSERT_EQ(ref_dst[j], dst[j]) << "Error: " << size_ << "x" << size_
+                                      << " iht of type " << tx_type_ << " at "
+                                      << j;
+      }
+    }
+  }
+
+  FhtFunc fwd_txfm_;
+  IhtFunc ref_txfm_;
+  IhtFunc inv_txfm_;
+  int size_;
+  int tx_type_;
+  aom_bit_depth_t bit_depth_;
+  int mask_;
+};
+
+TEST_P(AV1InvHtTest, MatchesReferenceC) { RunMatchCheck(); }
+
+#if HAVE_SSE2 && CONFIG_AV1_ENCODER && !CONFIG_EMULATE_HARDWARE
+void iht4x4_16_add_c(const tran_low_t *in, uint8_t *out, int stride,
+                     int tx_type, int bd) {
+  (void)bd;
+  av1_iht4x4_16_add_c(in, out, stride, tx_type);
+}
+
+void iht8x8_64_add_c(const tran_low_t *in, uint8_t *out, int stride,
+                     int tx_type, int bd) {
+  (void)bd;
+  av1_iht8x8_64_add_c(in, out, stride, tx_type);
+}
+
+void iht16x16_256_add_c(const tran_low_t *in, uint8_t *out, int stride,
+                        int tx_type, int bd) {
+  (void)bd;
+  av1_iht16x16_256_add_c(in, out, stride, tx_type);
+}
+
+void iht4x4_16_add_sse2(const tran_low_t *in, uint8_t *out, int stride,
+                        int tx_type, int bd) {
+  (void)bd;
+  av1_iht4x4_16_add_sse2(in, out, stride, tx_type);
+}
+
+void iht8x8_64_add_sse2(const tran_low_t *in, uint8_t *out, int stride,
+                        int tx_type, int bd) {
+  (void)bd;
+  av1_iht8x8_64_add_sse2(in, out, stride, tx_type);
+}
+
+void iht16x16_256_add_sse2(const tran_low_t *in, uint8_t *out, int stride,
+                           int tx_type, int bd) {
+  (void)bd;
+  av1_iht16x16_256_add_sse2(in, out, stride, tx_type);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    SSE2, AV1InvHtTest,
+    ::testing::Values(
+        make_tuple(&av1_fht4x4_c, &iht4x4_16_add_c, &iht4x4_16_add_sse2, 4, 0,
+                   AOM_BITS_8),
+        make_tuple(&av1_fht4x4_c, &iht4x4_16_add_c, &iht4x4_16_add_sse2, 4, 1,
+                   AOM_BITS_8),
+        make_tuple(&av1_fht4x4_c, &iht4x4_16_add_c, &iht4x4_16_add_sse2, 4, 2,
+                   AOM_BITS_8),
+        make_tuple(&av1_fht4x4_c, &iht4x4_16_add_c, &iht4x4_16_add_sse2, 4, 3,
+                   AOM_BITS_8),
+        make_tuple(&av1_fht8x8_c, &iht8x8_64_add_c, &iht8x8_64_add_sse2, 8, 0,
+                   AOM_BITS_8),
+        make_tuple(&av1_fht8x8_c, &iht8x8_64_add_c, &iht8x8_64_add_sse2, 8, 1,
+                   AOM_BITS_8),
+        make_tuple(&av1_fht8x8_c, &iht8x8_64_add_c, &iht8x8_64_add_sse2, 8, 2,
+                   AOM_BITS_8),
+        make_tuple(&av1_fht8x8_c, &iht8x8_64_add_c, &iht8x8_64_add_sse2, 8, 3,
+                   AOM_BITS_8),
+        make_tuple(&av1_fht16x16_c, &iht16x16_256_add_c,
+                   &iht16x16_256_add_sse2, 16, 0, AOM_BITS_8),
+        make_tuple(&av1_fht16x16_c, &iht16x16_256_add_c,
+                   &iht16x16_256_add_sse2, 16, 1, AOM_BITS_8),
+        make_tuple(&av1_fht16x16_c, &iht16x16_256_add_c,
+                   &iht16x16_256_add_sse2, 16, 2, AOM_BITS_8),
+        make_tuple(&av1_fht16x16_c, &iht16x16_256_add_c,
+                   &iht16x16_256_add_sse2, 16, 3, AOM_BITS_8)));
+#endif  // HAVE_SSE2 && CONFIG_AV1_ENCODER && !CONFIG_EMULATE_HARDWARE
+
+#if HAVE_SSE4_1 && CONFIG_AOM_HIGHBITDEPTH && CONFIG_AV1_ENCODER && \
+    !CONFIG_EMULATE_HARDWARE
+INSTANTIATE_TEST_CASE_P(
+    SSE4_1, AV1InvHtTest,
+    ::testing::Values(
+        make_tuple(&av1_highbd_fht4x4_c, &av1_highbd_iht4x4_16_add_c,
+                   &av1_highbd_iht4x4_16_add_sse4_1, 4, 0, AOM_BITS_10),
+        make_tuple(&av1_highbd_fht4x4_c, &av1_highbd_iht4x4_16_add_c,
+                   &av1_highbd_iht4x4_16_add_sse4_1, 4, 1, AOM_BITS_10),
+        make_tuple(&av1_highbd_fht4x4_c, &av1_highbd_iht4x4_16_add_c,
+                   &av1_highbd_iht4x4_16_add_sse4_1, 4, 2, AOM_BITS_10),
+        make_tuple(&av1_highbd_fht4x4_c, &av1_highbd_iht4x4_16_add_c,
+                   &av1_highbd_iht4x4_16_add_sse4_1, 4, 3, AOM_BITS_10),
+        make_tuple(&av1_highbd_fht4x4_c, &av1_highbd_iht4x4_16_add_c,
+                   &av1_highbd_iht4x4_16_add_sse4_1, 4, 0, AOM_BITS_12),
+        make_tuple(&av1_highbd_fht4x4_c, &av1_highbd_iht4x4_16_add_c,
+                   &av1_highbd_iht4x4_16_add_sse4_1, 4, 3, AOM_BITS_12),
+        make_tuple(&av1_highbd_fht8x8_c, &av1_highbd_iht8x8_64_add_c,
+                   &av1_highbd_iht8x8_64_add_sse4_1, 8, 0, AOM_BITS_10),
+        make_tuple(&av1_highbd_fht8x8_c, &av1_highbd_iht8x8_64_add_c,
+                   &av1_highbd_iht8x8_64_add_sse4_1, 8, 1, AOM_BITS_10),
+        make_tuple(&av1_highbd_fht8x8_c, &av1_highbd_iht8x8_64_add_c,
+                   &av1_highbd_iht8x8_64_add_sse4_1, 8, 2, AOM_BITS_10),
+        make_tuple(&av1_highbd_fht8x8_c, &av1_highbd_iht8x8_64_add_c,
+                   &av1_highbd_iht8x8_64_add_sse4_1, 8, 3, AOM_BITS_10),
+        make_tuple(&av1_highbd_fht8x8_c, &av1_highbd_iht8x8_64_add_c,
+                   &av1_highbd_iht8x8_64_add_sse4_1, 8, 0, AOM_BITS_12),
+        make_tuple(&av1_highbd_fht8x8_c, &av1_highbd_iht8x8_64_add_c,
+                   &av1_highbd_iht8x8_64_add_sse4_1, 8, 3, AOM_BITS_12),
+        make_tuple(&av1_highbd_fht16x16_c, &av1_highbd_iht16x16_256_add_c,
+                   &av1_highbd_iht16x16_256_add_sse4_1, 16, 0, AOM_BITS_10),
+        make_tuple(&av1_highbd_fht16x16_c, &av1_highbd_iht16x16_256_add_c,
+                   &av1_highbd_iht16x16_256_add_sse4_1, 16, 1, AOM_BITS_10),
+        make_tuple(&av1_highbd_fht16x16_c, &av1_highbd_iht16x16_256_add_c,
+                   &av1_highbd_iht16x16_256_add_sse4_1, 16, 2, AOM_BITS_10),
+        make_tuple(&av1_highbd_fht16x16_c, &av1_highbd_iht16x16_256_add_c,
+                   &av1_highbd_iht16x16_256_add_sse4_1, 16, 3, AOM_BITS_10),
+        make_tuple(&av1_highbd_fht16x16_c, &av1_highbd_iht16x16_256_add_c,
+                   &av1_highbd_iht16x16_256_add_sse4_1, 16, 0, AOM_BITS_12),
+        make_tuple(&av1_highbd_fht16x16_c, &av1_highbd_iht16x16_256_add_c,
+                   &av1_highbd_iht16x16_256_add_sse4_1, 16, 3, AOM_BITS_12)));
+#endif  // HAVE_SSE4_1 && CONFIG_AOM_HIGHBITDEPTH && CONFIG_AV1_ENCODER &&
+        // !CONFIG_EMULATE_HARDWARE
 }  // namespace
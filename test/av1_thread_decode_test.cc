@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/threaded_decode_test.h"
+#include "test/util.h"
+
+namespace {
+
+const int kNumFrames = 10;
+
+// Thread counts to decode with, checked against a single threaded decode.
+const int kThreads[] = { 2, 4 };
+
+// The parameters are the log2 of the number of tile columns and tile rows. A
+// single tile column is decoded with its superblock rows on the workers,
+// several with one tile column per worker. The loop filter, CLPF and
+// deringing of both run on the workers when the build enables them.
+class AV1ThreadDecodeTest
+    : public ::libaom_test::ThreadedDecodeTest,
+      public ::libaom_test::CodecTestWith2Params<int, int> {
+ protected:
+  AV1ThreadDecodeTest()
+      : ThreadedDecodeTest(GET_PARAM(0)), log2_tile_cols_(GET_PARAM(1)),
+        log2_tile_rows_(GET_PARAM(2)) {}
+
+  virtual ~AV1ThreadDecodeTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 4);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, log2_tile_cols_);
+      encoder->Control(AV1E_SET_TILE_ROWS, log2_tile_rows_);
+    }
+  }
+
+ private:
+  int log2_tile_cols_;
+  int log2_tile_rows_;
+};
+
+TEST_P(AV1ThreadDecodeTest, MD5Match) {
+  // Wide enough for two tile columns, with three superblock rows.
+  ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 704, 144,
+                                       30, 1, 0, kNumFrames);
+  const int num_threads =
+      static_cast<int>(sizeof(kThreads) / sizeof(kThreads[0]));
+  ASSERT_NO_FATAL_FAILURE(
+      RunTest(&video, kNumFrames, kThreads, num_threads, 0));
+}
+
+AV1_INSTANTIATE_TEST_CASE(AV1ThreadDecodeTest, ::testing::Range(0, 2),
+                          ::testing::Range(0, 2));
+
+}  // namespace
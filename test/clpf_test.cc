@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/function_equivalence_test.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "aom/aom_integer.h"
+#include "aom_ports/aom_timer.h"
+#include "aom_ports/mem.h"
+
+using libaom_test::ACMRandom;
+using libaom_test::kSpeedTestNumIterations;
+using libaom_test::PrintSpeedTestResult;
+
+namespace {
+
+typedef void (*ClpfFunc)(const uint8_t *src, uint8_t *dst, int sstride,
+                         int dstride, int has_top, int has_left,
+                         int has_bottom, int has_right, int width,
+                         int height);
+#if CONFIG_AOM_HIGHBITDEPTH
+typedef void (*ClpfHbdFunc)(const uint16_t *src, uint16_t *dst, int sstride,
+                            int dstride, int has_top, int has_left,
+                            int has_bottom, int has_right, int width,
+                            int height);
+#endif
+
+// <function to test, reference function>
+typedef std::tr1::tuple<ClpfFunc, ClpfFunc> ClpfParam;
+#if CONFIG_AOM_HIGHBITDEPTH
+typedef std::tr1::tuple<ClpfHbdFunc, ClpfHbdFunc> ClpfHbdParam;
+#endif
+
+const int kNumIterations = 10000;
+// The block and a one pixel border around it.
+const int kStride = 16;
+const int kSrcSize = kStride * (8 + 2);
+const int kDstStride = 8;
+
+// Fill the source with noise of the given bit depth. Half of the blocks are
+// kept nearly flat so that the filter often changes the pixels.
+template <typename Pixel>
+void FillSource(ACMRandom *rnd, Pixel *src, int bd) {
+  const int mask = (1 << bd) - 1;
+  const int flat = rnd->Rand8() & 1;
+  const int base = rnd->Rand16() & mask;
+  for (int i = 0; i < kSrcSize; ++i) {
+    src[i] = flat ? (base + rnd->Rand8() % 3 - 1) & mask : rnd->Rand16() & mask;
+  }
+}
+
+class ClpfBlockTest : public ::testing::TestWithParam<ClpfParam> {
+ public:
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  ClpfFunc func_;
+  ClpfFunc ref_func_;
+};
+
+TEST_P(ClpfBlockTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint8_t, src[kSrcSize]);
+  DECLARE_ALIGNED(16, uint8_t, dst[8 * kDstStride]);
+  DECLARE_ALIGNED(16, uint8_t, ref_dst[8 * kDstStride]);
+  const uint8_t *const block = src + kStride + 1;
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int flags = rnd.Rand8();
+    const int width = 4 << (flags >> 4 & 1);
+    const int height = 4 << (flags >> 5 & 1);
+    const int has_top = flags & 1;
+    const int has_left = flags >> 1 & 1;
+    const int has_bottom = flags >> 2 & 1;
+    const int has_right = flags >> 3 & 1;
+    FillSource(&rnd, src, 8);
+    memset(dst, 0, sizeof(dst));
+    memset(ref_dst, 0, sizeof(ref_dst));
+    ref_func_(block, ref_dst, kStride, kDstStride, has_top, has_left,
+              has_bottom, has_right, width, height);
+    ASM_REGISTER_STATE_CHECK(func_(block, dst, kStride, kDstStride, has_top,
+                                   has_left, has_bottom, has_right, width,
+                                   height));
+    for (int r = 0; r < 8; ++r) {
+      for (int c = 0; c < 8; ++c) {
+        ASSERT_EQ(ref_dst[r * kDstStride + c], dst[r * kDstStride + c])
+            << "Error at " << r << "," << c << " iteration " << i << " size "
+            << width << "x" << height << " flags " << (flags & 15);
+      }
+    }
+  }
+}
+
+TEST_P(ClpfBlockTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint8_t, src[kSrcSize]);
+  DECLARE_ALIGNED(16, uint8_t, dst[8 * kDstStride]);
+  const uint8_t *const block = src + kStride + 1;
+  FillSource(&rnd, src, 8);
+
+  aom_usec_timer ref_timer, timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < kSpeedTestNumIterations; ++i)
+    ref_func_(block, dst, kStride, kDstStride, 1, 1, 1, 1, 8, 8);
+  aom_usec_timer_mark(&ref_timer);
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kSpeedTestNumIterations; ++i)
+    func_(block, dst, kStride, kDstStride, 1, 1, 1, 1, 8, 8);
+  aom_usec_timer_mark(&timer);
+
+  PrintSpeedTestResult(&ref_timer, &timer);
+}
+
+#if CONFIG_AOM_HIGHBITDEPTH
+class ClpfBlockHbdTest : public ::testing::TestWithParam<ClpfHbdParam> {
+ public:
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  ClpfHbdFunc func_;
+  ClpfHbdFunc ref_func_;
+};
+
+TEST_P(ClpfBlockHbdTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint16_t, src[kSrcSize]);
+  DECLARE_ALIGNED(16, uint16_t, dst[8 * kDstStride]);
+  DECLARE_ALIGNED(16, uint16_t, ref_dst[8 * kDstStride]);
+  const uint16_t *const block = src + kStride + 1;
+  const int kBitDepths[] = { 8, 10, 12 };
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int bd = kBitDepths[i % 3];
+    const int flags = rnd.Rand8();
+    const int width = 4 << (flags >> 4 & 1);
+    const int height = 4 << (flags >> 5 & 1);
+    const int has_top = flags & 1;
+    const int has_left = flags >> 1 & 1;
+    const int has_bottom = flags >> 2 & 1;
+    const int has_right = flags >> 3 & 1;
+    FillSource(&rnd, src, bd);
+    memset(dst, 0, sizeof(dst));
+    memset(ref_dst, 0, sizeof(ref_dst));
+    ref_func_(block, ref_dst, kStride, kDstStride, has_top, has_left,
+              has_bottom, has_right, width, height);
+    ASM_REGISTER_STATE_CHECK(func_(block, dst, kStride, kDstStride, has_top,
+                                   has_left, has_bottom, has_right, width,
+                                   height));
+    for (int r = 0; r < 8; ++r) {
+      for (int c = 0; c < 8; ++c) {
+        ASSERT_EQ(ref_dst[r * kDstStride + c], dst[r * kDstStride + c])
+            << "Error at " << r << "," << c << " iteration " << i << " bd "
+            << bd << " size " << width << "x" << height << " flags "
+            << (flags & 15);
+      }
+    }
+  }
+}
+
+TEST_P(ClpfBlockHbdTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint16_t, src[kSrcSize]);
+  DECLARE_ALIGNED(16, uint16_t, dst[8 * kDstStride]);
+  const uint16_t *const block = src + kStride + 1;
+  FillSource(&rnd, src, 10);
+
+  aom_usec_timer ref_timer, timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < kSpeedTestNumIterations; ++i)
+    ref_func_(block, dst, kStride, kDstStride, 1, 1, 1, 1, 8, 8);
+  aom_usec_timer_mark(&ref_timer);
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kSpeedTestNumIterations; ++i)
+    func_(block, dst, kStride, kDstStride, 1, 1, 1, 1, 8, 8);
+  aom_usec_timer_mark(&timer);
+
+  PrintSpeedTestResult(&ref_timer, &timer);
+}
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+
+using std::tr1::make_tuple;
+
+INSTANTIATE_TEST_CASE_P(C, ClpfBlockTest,
+                        ::testing::Values(make_tuple(&aom_clpf_block_c,
+                                                     &aom_clpf_block_c)));
+#if CONFIG_AOM_HIGHBITDEPTH
+INSTANTIATE_TEST_CASE_P(C, ClpfBlockHbdTest,
+                        ::testing::Values(make_tuple(&aom_clpf_block_hbd_c,
+                                                     &aom_clpf_block_hbd_c)));
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(SSE2, ClpfBlockTest,
+                        ::testing::Values(make_tuple(&aom_clpf_block_sse2,
+                                                     &aom_clpf_block_c)));
+#if CONFIG_AOM_HIGHBITDEPTH
+INSTANTIATE_TEST_CASE_P(SSE2, ClpfBlockHbdTest,
+                        ::testing::Values(make_tuple(&aom_clpf_block_hbd_sse2,
+                                                     &aom_clpf_block_hbd_c)));
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, ClpfBlockTest,
+                        ::testing::Values(make_tuple(&aom_clpf_block_avx2,
+                                                     &aom_clpf_block_c)));
+#if CONFIG_AOM_HIGHBITDEPTH
+INSTANTIATE_TEST_CASE_P(AVX2, ClpfBlockHbdTest,
+                        ::testing::Values(make_tuple(&aom_clpf_block_hbd_avx2,
+                                                     &aom_clpf_block_hbd_c)));
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+#endif  // HAVE_AVX2
+}  // namespace
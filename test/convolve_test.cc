@@ -894,6 +894,34 @@ TEST_P(ConvolveTest, CheckScalingFiltering) {
   }
 }
 
+TEST_P(ConvolveTest, MatchesReferenceScaledFilter) {
+  uint8_t *const in = input();
+  uint8_t *const out = output();
+  uint8_t ref[kOutputStride * kMaxDimension];
+  const InterpKernel *const eighttap = av1_filter_kernels[EIGHTTAP];
+
+  // The scaled filters only have an 8-bit reference.
+  if (UUT_->use_highbd_ != 0) return;
+
+  for (int frac = 0; frac < 16; ++frac) {
+    for (int step = 1; step <= 32; ++step) {
+      aom_scaled_2d_c(in, kInputStride, ref, kOutputStride, eighttap[frac],
+                      step, eighttap[15 - frac], 33 - step, Width(), Height());
+      ASM_REGISTER_STATE_CHECK(UUT_->shv8_(
+          in, kInputStride, out, kOutputStride, eighttap[frac], step,
+          eighttap[15 - frac], 33 - step, Width(), Height()));
+
+      CheckGuardBlocks();
+
+      for (int y = 0; y < Height(); ++y)
+        for (int x = 0; x < Width(); ++x)
+          ASSERT_EQ(ref[y * kOutputStride + x], out[y * kOutputStride + x])
+              << "mismatch at (" << x << "," << y << "), "
+              << "frac == " << frac << ", step == " << step;
+    }
+  }
+}
+
 using std::tr1::make_tuple;
 
 #if CONFIG_AOM_HIGHBITDEPTH
@@ -934,6 +962,33 @@ WRAP(convolve8_sse2, 12)
 WRAP(convolve8_avg_sse2, 12)
 #endif  // HAVE_SSE2 && ARCH_X86_64
 
+#if HAVE_AVX2
+WRAP(convolve_copy_avx2, 8)
+WRAP(convolve_avg_avx2, 8)
+WRAP(convolve8_horiz_avx2, 8)
+WRAP(convolve8_avg_horiz_avx2, 8)
+WRAP(convolve8_vert_avx2, 8)
+WRAP(convolve8_avg_vert_avx2, 8)
+WRAP(convolve8_avx2, 8)
+WRAP(convolve8_avg_avx2, 8)
+WRAP(convolve_copy_avx2, 10)
+WRAP(convolve_avg_avx2, 10)
+WRAP(convolve8_horiz_avx2, 10)
+WRAP(convolve8_avg_horiz_avx2, 10)
+WRAP(convolve8_vert_avx2, 10)
+WRAP(convolve8_avg_vert_avx2, 10)
+WRAP(convolve8_avx2, 10)
+WRAP(convolve8_avg_avx2, 10)
+WRAP(convolve_copy_avx2, 12)
+WRAP(convolve_avg_avx2, 12)
+WRAP(convolve8_horiz_avx2, 12)
+WRAP(convolve8_avg_horiz_avx2, 12)
+WRAP(convolve8_vert_avx2, 12)
+WRAP(convolve8_avg_vert_avx2, 12)
+WRAP(convolve8_avx2, 12)
+WRAP(convolve8_avg_avx2, 12)
+#endif  // HAVE_AVX2
+
 WRAP(convolve_copy_c, 8)
 WRAP(convolve_avg_c, 8)
 WRAP(convolve8_horiz_c, 8)
@@ -1141,7 +1196,7 @@ const ConvolveFunctions convolve8_ssse3(
     aom_convolve8_avg_horiz_ssse3, aom_convolve8_vert_ssse3,
     aom_convolve8_avg_vert_ssse3, aom_convolve8_ssse3, aom_convolve8_avg_ssse3,
     aom_scaled_horiz_c, aom_scaled_avg_horiz_c, aom_scaled_vert_c,
-    aom_scaled_avg_vert_c, aom_scaled_2d_c, aom_scaled_avg_2d_c, 0);
+    aom_scaled_avg_vert_c, aom_scaled_2d_ssse3, aom_scaled_avg_2d_c, 0);
 
 INSTANTIATE_TEST_CASE_P(SSSE3, ConvolveTest,
                         ::testing::Values(make_tuple(4, 4, &convolve8_ssse3),
@@ -1184,6 +1239,81 @@ INSTANTIATE_TEST_CASE_P(AVX2, ConvolveTest,
                                           make_tuple(64, 64, &convolve8_avx2)));
 #endif  // HAVE_AVX2 && HAVE_SSSE3
 
+#if HAVE_AVX2 && CONFIG_AOM_HIGHBITDEPTH
+const ConvolveFunctions convolve8_highbd_avx2(
+    wrap_convolve_copy_avx2_8, wrap_convolve_avg_avx2_8,
+    wrap_convolve8_horiz_avx2_8, wrap_convolve8_avg_horiz_avx2_8,
+    wrap_convolve8_vert_avx2_8, wrap_convolve8_avg_vert_avx2_8,
+    wrap_convolve8_avx2_8, wrap_convolve8_avg_avx2_8,
+    wrap_convolve8_horiz_avx2_8, wrap_convolve8_avg_horiz_avx2_8,
+    wrap_convolve8_vert_avx2_8, wrap_convolve8_avg_vert_avx2_8,
+    wrap_convolve8_avx2_8, wrap_convolve8_avg_avx2_8, 8);
+const ConvolveFunctions convolve10_highbd_avx2(
+    wrap_convolve_copy_avx2_10, wrap_convolve_avg_avx2_10,
+    wrap_convolve8_horiz_avx2_10, wrap_convolve8_avg_horiz_avx2_10,
+    wrap_convolve8_vert_avx2_10, wrap_convolve8_avg_vert_avx2_10,
+    wrap_convolve8_avx2_10, wrap_convolve8_avg_avx2_10,
+    wrap_convolve8_horiz_avx2_10, wrap_convolve8_avg_horiz_avx2_10,
+    wrap_convolve8_vert_avx2_10, wrap_convolve8_avg_vert_avx2_10,
+    wrap_convolve8_avx2_10, wrap_convolve8_avg_avx2_10, 10);
+const ConvolveFunctions convolve12_highbd_avx2(
+    wrap_convolve_copy_avx2_12, wrap_convolve_avg_avx2_12,
+    wrap_convolve8_horiz_avx2_12, wrap_convolve8_avg_horiz_avx2_12,
+    wrap_convolve8_vert_avx2_12, wrap_convolve8_avg_vert_avx2_12,
+    wrap_convolve8_avx2_12, wrap_convolve8_avg_avx2_12,
+    wrap_convolve8_horiz_avx2_12, wrap_convolve8_avg_horiz_avx2_12,
+    wrap_convolve8_vert_avx2_12, wrap_convolve8_avg_vert_avx2_12,
+    wrap_convolve8_avx2_12, wrap_convolve8_avg_avx2_12, 12);
+INSTANTIATE_TEST_CASE_P(
+    AVX2_8, ConvolveTest,
+    ::testing::Values(
+        make_tuple(4, 4, &convolve8_highbd_avx2),
+        make_tuple(8, 4, &convolve8_highbd_avx2),
+        make_tuple(4, 8, &convolve8_highbd_avx2),
+        make_tuple(8, 8, &convolve8_highbd_avx2),
+        make_tuple(16, 8, &convolve8_highbd_avx2),
+        make_tuple(8, 16, &convolve8_highbd_avx2),
+        make_tuple(16, 16, &convolve8_highbd_avx2),
+        make_tuple(32, 16, &convolve8_highbd_avx2),
+        make_tuple(16, 32, &convolve8_highbd_avx2),
+        make_tuple(32, 32, &convolve8_highbd_avx2),
+        make_tuple(64, 32, &convolve8_highbd_avx2),
+        make_tuple(32, 64, &convolve8_highbd_avx2),
+        make_tuple(64, 64, &convolve8_highbd_avx2)));
+INSTANTIATE_TEST_CASE_P(
+    AVX2_10, ConvolveTest,
+    ::testing::Values(
+        make_tuple(4, 4, &convolve10_highbd_avx2),
+        make_tuple(8, 4, &convolve10_highbd_avx2),
+        make_tuple(4, 8, &convolve10_highbd_avx2),
+        make_tuple(8, 8, &convolve10_highbd_avx2),
+        make_tuple(16, 8, &convolve10_highbd_avx2),
+        make_tuple(8, 16, &convolve10_highbd_avx2),
+        make_tuple(16, 16, &convolve10_highbd_avx2),
+        make_tuple(32, 16, &convolve10_highbd_avx2),
+        make_tuple(16, 32, &convolve10_highbd_avx2),
+        make_tuple(32, 32, &convolve10_highbd_avx2),
+        make_tuple(64, 32, &convolve10_highbd_avx2),
+        make_tuple(32, 64, &convolve10_highbd_avx2),
+        make_tuple(64, 64, &convolve10_highbd_avx2)));
+INSTANTIATE_TEST_CASE_P(
+    AVX2_12, ConvolveTest,
+    ::testing::Values(
+        make_tuple(4, 4, &convolve12_highbd_avx2),
+        make_tuple(8, 4, &convolve12_highbd_avx2),
+        make_tuple(4, 8, &convolve12_highbd_avx2),
+        make_tuple(8, 8, &convolve12_highbd_avx2),
+        make_tuple(16, 8, &convolve12_highbd_avx2),
+        make_tuple(8, 16, &convolve12_highbd_avx2),
+        make_tuple(16, 16, &convolve12_highbd_avx2),
+        make_tuple(32, 16, &convolve12_highbd_avx2),
+        make_tuple(16, 32, &convolve12_highbd_avx2),
+        make_tuple(32, 32, &convolve12_highbd_avx2),
+        make_tuple(64, 32, &convolve12_highbd_avx2),
+        make_tuple(32, 64, &convolve12_highbd_avx2),
+        make_tuple(64, 64, &convolve12_highbd_avx2)));
+#endif  // HAVE_AVX2 && CONFIG_AOM_HIGHBITDEPTH
+
 #if HAVE_NEON
 #if HAVE_NEON_ASM
 const ConvolveFunctions convolve8_neon(
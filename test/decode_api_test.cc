@@ -9,13 +9,20 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
 */
 
+#include <string.h>
+
+#include <string>
+#include <vector>
 
 #include "third_party/googletest/src/include/gtest/gtest.h"
 
 #include "./aom_config.h"
 #include "test/ivf_video_source.h"
+#include "test/md5_helper.h"
+#include "aom/aomcx.h"
 #include "aom/aomdx.h"
 #include "aom/aom_decoder.h"
+#include "aom/aom_encoder.h"
 
 namespace {
 
@@ -56,4 +63,134 @@ TEST(DecodeAPI, InvalidParams) {
   }
 }
 
+#if CONFIG_AV1_ENCODER && CONFIG_AV1_DECODER
+// Compressed frames and the order in which the decoder released them.
+struct InputBuffers {
+  std::vector<std::vector<uint8_t> > frames;
+  std::vector<int> released;
+};
+
+void ReleaseInputBuffer(void *release_state, const uint8_t *data,
+                        void *user_priv) {
+  InputBuffers *const buffers = static_cast<InputBuffers *>(release_state);
+  const int index = static_cast<int>(reinterpret_cast<intptr_t>(user_priv));
+  std::vector<uint8_t> &frame = buffers->frames[index];
+  EXPECT_EQ(&frame[0], data);
+  buffers->released.push_back(index);
+  // Clobber the buffer so that decoding from it after the release shows up
+  // as a mismatch.
+  memset(&frame[0], 0, frame.size());
+}
+
+void EncodeFrames(int num_frames, InputBuffers *buffers) {
+  const int kWidth = 128;
+  const int kHeight = 96;
+  aom_codec_ctx_t enc;
+  aom_codec_enc_cfg_t cfg;
+  aom_image_t img;
+
+  ASSERT_EQ(AOM_CODEC_OK,
+            aom_codec_enc_config_default(&aom_codec_av1_cx_algo, &cfg, 0));
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_init(&enc, &aom_codec_av1_cx_algo,
+                                             &cfg, 0));
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_control(&enc, AOME_SET_CPUUSED, 4));
+  ASSERT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&enc, AV1E_SET_FRAME_PARALLEL_DECODING, 1));
+  ASSERT_TRUE(aom_img_alloc(&img, AOM_IMG_FMT_I420, kWidth, kHeight, 32) !=
+              NULL);
+
+  for (int i = 0; i <= num_frames; ++i) {
+    // A gradient that moves a little every frame. The last pass flushes.
+    if (i < num_frames) {
+      for (int plane = 0; plane < 3; ++plane) {
+        const int w = plane ? kWidth / 2 : kWidth;
+        const int h = plane ? kHeight / 2 : kHeight;
+        for (int y = 0; y < h; ++y) {
+          for (int x = 0; x < w; ++x) {
+            img.planes[plane][y * img.stride[plane] + x] =
+                static_cast<uint8_t>((x + 2 * y + 3 * i + 40 * plane) ^ i);
+          }
+        }
+      }
+    }
+    ASSERT_EQ(AOM_CODEC_OK,
+              aom_codec_encode(&enc, i < num_frames ? &img : NULL, i, 1, 0,
+                               AOM_DL_GOOD_QUALITY));
+    aom_codec_iter_t iter = NULL;
+    const aom_codec_cx_pkt_t *pkt;
+    while ((pkt = aom_codec_get_cx_data(&enc, &iter)) != NULL) {
+      if (pkt->kind != AOM_CODEC_CX_FRAME_PKT) continue;
+      const uint8_t *const data = static_cast<uint8_t *>(pkt->data.frame.buf);
+      buffers->frames.push_back(
+          std::vector<uint8_t>(data, data + pkt->data.frame.sz));
+    }
+  }
+  aom_img_free(&img);
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&enc));
+}
+
+void DecodeFrames(aom_codec_ctx_t *dec, InputBuffers *buffers,
+                  std::vector<std::string> *md5s) {
+  for (int i = 0; i <= static_cast<int>(buffers->frames.size()); ++i) {
+    if (i < static_cast<int>(buffers->frames.size())) {
+      std::vector<uint8_t> &frame = buffers->frames[i];
+      ASSERT_EQ(AOM_CODEC_OK,
+                aom_codec_decode(dec, &frame[0],
+                                 static_cast<unsigned int>(frame.size()),
+                                 reinterpret_cast<void *>(i), 0));
+    } else {
+      ASSERT_EQ(AOM_CODEC_OK, aom_codec_decode(dec, NULL, 0, NULL, 0));
+    }
+    aom_codec_iter_t iter = NULL;
+    aom_image_t *img;
+    while ((img = aom_codec_get_frame(dec, &iter)) != NULL) {
+      libaom_test::MD5 md5;
+      md5.Add(img);
+      md5s->push_back(md5.Get());
+    }
+  }
+}
+
+TEST(DecodeAPI, InputBufferRelease) {
+  const int kNumFrames = 10;
+  InputBuffers buffers;
+  aom_input_buffer_init init = { ReleaseInputBuffer, &buffers };
+  aom_codec_dec_cfg_t cfg = { 4, 0, 0 };
+  aom_codec_ctx_t dec;
+  std::vector<std::string> ref_md5s;
+  std::vector<std::string> md5s;
+
+  EncodeFrames(kNumFrames, &buffers);
+  ASSERT_FALSE(buffers.frames.empty());
+
+  // Reference decode, copying the input.
+  ASSERT_EQ(AOM_CODEC_OK,
+            aom_codec_dec_init(&dec, &aom_codec_av1_dx_algo, NULL, 0));
+  DecodeFrames(&dec, &buffers, &ref_md5s);
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&dec));
+  ASSERT_EQ(kNumFrames, static_cast<int>(ref_md5s.size()));
+
+  // Frame parallel decode reading the buffers in place.
+  ASSERT_EQ(AOM_CODEC_OK,
+            aom_codec_dec_init(&dec, &aom_codec_av1_dx_algo, &cfg,
+                               AOM_CODEC_USE_FRAME_THREADING));
+  ASSERT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&dec, AV1D_SET_INPUT_BUFFER_RELEASE, &init));
+  DecodeFrames(&dec, &buffers, &md5s);
+  // The release function cannot change once decoding has started.
+  EXPECT_EQ(AOM_CODEC_ERROR,
+            aom_codec_control(&dec, AV1D_SET_INPUT_BUFFER_RELEASE, &init));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&dec));
+
+  EXPECT_EQ(ref_md5s, md5s);
+  // Every buffer is released once, in decode order.
+  ASSERT_EQ(buffers.frames.size(), buffers.released.size());
+  for (int i = 0; i < static_cast<int>(buffers.released.size()); ++i) {
+    EXPECT_EQ(i, buffers.released[i]);
+  }
+}
+#endif  // CONFIG_AV1_ENCODER && CONFIG_AV1_DECODER
+
 }  // namespace
@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/function_equivalence_test.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "av1/common/od_dering.h"
+#include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/aom_timer.h"
+#include "aom_ports/mem.h"
+
+using libaom_test::ACMRandom;
+using libaom_test::kSpeedTestNumIterations;
+using libaom_test::PrintSpeedTestResult;
+
+namespace {
+
+typedef void (*DirectionFunc)(int16_t *y, int ystride, const int16_t *in,
+                              int threshold, int dir);
+typedef void (*OrthogonalFunc)(int16_t *y, int ystride, const int16_t *in,
+                               const int16_t *x, int xstride, int threshold,
+                               int dir);
+typedef int (*FindDirFunc)(const int16_t *img, int stride, int32_t *var,
+                           int coeff_shift);
+#if CONFIG_AV1_ENCODER
+typedef int64_t (*SseFunc)(const int16_t *a, int astride, const int16_t *b,
+                           int bstride, int w, int h);
+#endif
+
+// <function to test, reference function, log2 of the block size>
+typedef std::tr1::tuple<DirectionFunc, DirectionFunc, int> DirectionParam;
+typedef std::tr1::tuple<OrthogonalFunc, OrthogonalFunc, int> OrthogonalParam;
+// <function to test, reference function>
+typedef std::tr1::tuple<FindDirFunc, FindDirFunc> FindDirParam;
+#if CONFIG_AV1_ENCODER
+typedef std::tr1::tuple<SseFunc, SseFunc> SseParam;
+#endif
+
+const int kNumIterations = 10000;
+const int kBitDepths[] = { 8, 10, 12 };
+// Value od_dering() puts in the filter input outside the frame.
+const int16_t kVeryLarge = 30000;
+const int kInSize = OD_FILT_BSTRIDE * (8 + 2 * OD_FILT_BORDER);
+const int kXStride = 16;
+const int kOutStride = 8;
+
+// Fill the filter input of a block of the given bit depth, marking some
+// pixels as outside the frame. Half of the blocks are kept nearly flat so
+// that most differences fall below the threshold.
+void FillInput(ACMRandom *rnd, int16_t *in, int size, int bd) {
+  const int mask = (1 << bd) - 1;
+  const int flat = rnd->Rand8() & 1;
+  const int base = rnd->Rand16() & mask;
+  for (int i = 0; i < size; ++i) {
+    if (rnd->Rand8() < 16) {
+      in[i] = kVeryLarge;
+    } else if (flat) {
+      in[i] = (base + rnd->Rand8() % 9 - 4) & mask;
+    } else {
+      in[i] = rnd->Rand16() & mask;
+    }
+  }
+}
+
+// Thresholds of od_dering(): the level scaled by the bit depth and by up to
+// three by the variance adjustment.
+int RandomThreshold(ACMRandom *rnd, int bd) {
+  return ((rnd->Rand8() % 64) << (bd - 8)) * (1 + rnd->Rand8() % 3);
+}
+
+class DeringDirectionTest : public ::testing::TestWithParam<DirectionParam> {
+ public:
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+    bsize_ = 1 << GET_PARAM(2);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  DirectionFunc func_;
+  DirectionFunc ref_func_;
+  int bsize_;
+};
+
+TEST_P(DeringDirectionTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, int16_t, in[kInSize]);
+  DECLARE_ALIGNED(16, int16_t, out[8 * kOutStride]);
+  DECLARE_ALIGNED(16, int16_t, ref_out[8 * kOutStride]);
+  const int16_t *const block = in + OD_FILT_BORDER * OD_FILT_BSTRIDE +
+                               OD_FILT_BORDER;
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int bd = kBitDepths[i % 3];
+    const int threshold = RandomThreshold(&rnd, bd);
+    const int dir = rnd.Rand8() & 7;
+    FillInput(&rnd, in, kInSize, bd);
+    memset(out, 0, sizeof(out));
+    memset(ref_out, 0, sizeof(ref_out));
+    ref_func_(ref_out, kOutStride, block, threshold, dir);
+    ASM_REGISTER_STATE_CHECK(func_(out, kOutStride, block, threshold, dir));
+    for (int r = 0; r < bsize_; ++r) {
+      for (int c = 0; c < bsize_; ++c) {
+        ASSERT_EQ(ref_out[r * kOutStride + c], out[r * kOutStride + c])
+            << "Error at " << r << "," << c << " iteration " << i
+            << " bd " << bd << " dir " << dir << " threshold " << threshold;
+      }
+    }
+  }
+}
+
+TEST_P(DeringDirectionTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, int16_t, in[kInSize]);
+  DECLARE_ALIGNED(16, int16_t, out[8 * kOutStride]);
+  const int16_t *const block = in + OD_FILT_BORDER * OD_FILT_BSTRIDE +
+                               OD_FILT_BORDER;
+  FillInput(&rnd, in, kInSize, 8);
+
+  aom_usec_timer ref_timer, timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < kSpeedTestNumIterations; ++i)
+    ref_func_(out, kOutStride, block, 16, i & 7);
+  aom_usec_timer_mark(&ref_timer);
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kSpeedTestNumIterations; ++i)
+    func_(out, kOutStride, block, 16, i & 7);
+  aom_usec_timer_mark(&timer);
+
+  printf("%dx%d: ", bsize_, bsize_);
+  PrintSpeedTestResult(&ref_timer, &timer);
+}
+
+class DeringOrthogonalTest : public ::testing::TestWithParam<OrthogonalParam> {
+ public:
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+    bsize_ = 1 << GET_PARAM(2);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  OrthogonalFunc func_;
+  OrthogonalFunc ref_func_;
+  int bsize_;
+};
+
+TEST_P(DeringOrthogonalTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, int16_t, in[kInSize]);
+  DECLARE_ALIGNED(16, int16_t, x[8 * kXStride]);
+  DECLARE_ALIGNED(16, int16_t, out[8 * kOutStride]);
+  DECLARE_ALIGNED(16, int16_t, ref_out[8 * kOutStride]);
+  const int16_t *const block = in + OD_FILT_BORDER * OD_FILT_BSTRIDE +
+                               OD_FILT_BORDER;
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int bd = kBitDepths[i % 3];
+    const int threshold = RandomThreshold(&rnd, bd);
+    const int dir = rnd.Rand8() & 7;
+    FillInput(&rnd, in, kInSize, bd);
+    // The source pixels are always inside the frame.
+    for (int j = 0; j < 8 * kXStride; ++j)
+      x[j] = rnd.Rand16() & ((1 << bd) - 1);
+    memset(out, 0, sizeof(out));
+    memset(ref_out, 0, sizeof(ref_out));
+    ref_func_(ref_out, kOutStride, block, x, kXStride, threshold, dir);
+    ASM_REGISTER_STATE_CHECK(
+        func_(out, kOutStride, block, x, kXStride, threshold, dir));
+    for (int r = 0; r < bsize_; ++r) {
+      for (int c = 0; c < bsize_; ++c) {
+        ASSERT_EQ(ref_out[r * kOutStride + c], out[r * kOutStride + c])
+            << "Error at " << r << "," << c << " iteration " << i
+            << " bd " << bd << " dir " << dir << " threshold " << threshold;
+      }
+    }
+  }
+}
+
+TEST_P(DeringOrthogonalTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, int16_t, in[kInSize]);
+  DECLARE_ALIGNED(16, int16_t, x[8 * kXStride]);
+  DECLARE_ALIGNED(16, int16_t, out[8 * kOutStride]);
+  const int16_t *const block = in + OD_FILT_BORDER * OD_FILT_BSTRIDE +
+                               OD_FILT_BORDER;
+  FillInput(&rnd, in, kInSize, 8);
+  for (int j = 0; j < 8 * kXStride; ++j) x[j] = rnd.Rand8();
+
+  aom_usec_timer ref_timer, timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < kSpeedTestNumIterations; ++i)
+    ref_func_(out, kOutStride, block, x, kXStride, 16, i & 7);
+  aom_usec_timer_mark(&ref_timer);
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kSpeedTestNumIterations; ++i)
+    func_(out, kOutStride, block, x, kXStride, 16, i & 7);
+  aom_usec_timer_mark(&timer);
+
+  printf("%dx%d: ", bsize_, bsize_);
+  PrintSpeedTestResult(&ref_timer, &timer);
+}
+
+class DeringFindDirTest : public ::testing::TestWithParam<FindDirParam> {
+ public:
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  FindDirFunc func_;
+  FindDirFunc ref_func_;
+};
+
+// Fill an 8x8 block with a random directional pattern or with noise.
+void FillDirectionalBlock(ACMRandom *rnd, int16_t *img, int stride, int bd) {
+  const int mask = (1 << bd) - 1;
+  const int pattern = rnd->Rand8() % 3;
+  const int dx = rnd->Rand8() % 5 - 2;
+  const int dy = rnd->Rand8() % 5 - 2;
+  for (int r = 0; r < 8; ++r) {
+    for (int c = 0; c < 8; ++c) {
+      if (pattern == 0) {
+        img[r * stride + c] = rnd->Rand16() & mask;
+      } else if (pattern == 1) {
+        img[r * stride + c] = (((r * dy + c * dx) & 1) ? mask : 0);
+      } else {
+        img[r * stride + c] =
+            ((r * dy + c * dx) * 37 + (rnd->Rand8() & 15)) & mask;
+      }
+    }
+  }
+}
+
+TEST_P(DeringFindDirTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, int16_t, img[8 * kXStride]);
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int bd = kBitDepths[i % 3];
+    int32_t var = 0;
+    int32_t ref_var = 0;
+    int dir = 0;
+    FillDirectionalBlock(&rnd, img, kXStride, bd);
+    const int ref_dir = ref_func_(img, kXStride, &ref_var, bd - 8);
+    ASM_REGISTER_STATE_CHECK(dir = func_(img, kXStride, &var, bd - 8));
+    ASSERT_EQ(ref_dir, dir) << "iteration " << i << " bd " << bd;
+    ASSERT_EQ(ref_var, var) << "iteration " << i << " bd " << bd;
+  }
+}
+
+TEST_P(DeringFindDirTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, int16_t, img[8 * kXStride]);
+  int32_t var;
+  int dir = 0;
+  FillDirectionalBlock(&rnd, img, kXStride, 8);
+
+  aom_usec_timer ref_timer, timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < kSpeedTestNumIterations; ++i)
+    dir += ref_func_(img, kXStride, &var, 0);
+  aom_usec_timer_mark(&ref_timer);
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kSpeedTestNumIterations; ++i)
+    dir -= func_(img, kXStride, &var, 0);
+  aom_usec_timer_mark(&timer);
+
+  EXPECT_EQ(0, dir);
+  PrintSpeedTestResult(&ref_timer, &timer);
+}
+
+#if CONFIG_AV1_ENCODER
+class DeringSseTest : public ::testing::TestWithParam<SseParam> {
+ public:
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  SseFunc func_;
+  SseFunc ref_func_;
+};
+
+// Size of a superblock.
+const int kSbSize = 64;
+// Stride of the superblock copies searched by the encoder.
+const int kSbStride = kSbSize + 2 * OD_FILT_BORDER;
+
+// Fill a superblock copy with pixels of the given bit depth, including the
+// border columns, and b with a deringed version of the superblock starting at
+// column 1 of a that differs by up to the largest change of the filter.
+void FillSsePair(ACMRandom *rnd, int16_t *a, int16_t *b, int bd) {
+  const int mask = (1 << bd) - 1;
+  const int range = 55 << (bd - 8);
+  for (int r = 0; r < kSbSize; ++r) {
+    for (int c = 0; c < kSbStride; ++c)
+      a[r * kSbStride + c] = rnd->Rand16() & mask;
+    for (int c = 0; c < kSbSize; ++c) {
+      const int d = rnd->Rand16() % (2 * range + 1) - range;
+      b[r * kSbSize + c] = clamp(a[r * kSbStride + c + 1] + d, 0, mask);
+    }
+  }
+}
+
+TEST_P(DeringSseTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, int16_t, a[kSbSize * kSbStride]);
+  DECLARE_ALIGNED(16, int16_t, b[kSbSize * kSbSize]);
+
+  for (int i = 0; i < kNumIterations / 10; ++i) {
+    const int bd = kBitDepths[i % 3];
+    // Superblocks at the right and bottom frame edges are 8x8 blocks wide
+    // and tall.
+    const int w = 8 * (1 + rnd.Rand8() % 8);
+    const int h = 8 * (1 + rnd.Rand8() % 8);
+    int64_t sse = 0;
+    FillSsePair(&rnd, a, b, bd);
+    const int64_t ref_sse = ref_func_(a + 1, kSbStride, b, kSbSize, w, h);
+    ASM_REGISTER_STATE_CHECK(sse = func_(a + 1, kSbStride, b, kSbSize, w, h));
+    ASSERT_EQ(ref_sse, sse) << "iteration " << i << " bd " << bd << " size "
+                            << w << "x" << h;
+  }
+}
+
+TEST_P(DeringSseTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, int16_t, a[kSbSize * kSbStride]);
+  DECLARE_ALIGNED(16, int16_t, b[kSbSize * kSbSize]);
+  int64_t sse = 0;
+  FillSsePair(&rnd, a, b, 8);
+
+  aom_usec_timer ref_timer, timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    sse += ref_func_(a + 1, kSbStride, b, kSbSize, kSbSize, kSbSize);
+  aom_usec_timer_mark(&ref_timer);
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    sse -= func_(a + 1, kSbStride, b, kSbSize, kSbSize, kSbSize);
+  aom_usec_timer_mark(&timer);
+
+  EXPECT_EQ(0, sse);
+  PrintSpeedTestResult(&ref_timer, &timer);
+}
+#endif  // CONFIG_AV1_ENCODER
+
+using std::tr1::make_tuple;
+
+INSTANTIATE_TEST_CASE_P(
+    C, DeringDirectionTest,
+    ::testing::Values(make_tuple(&od_filter_dering_direction_4x4_c,
+                                 &od_filter_dering_direction_4x4_c, 2),
+                      make_tuple(&od_filter_dering_direction_8x8_c,
+                                 &od_filter_dering_direction_8x8_c, 3)));
+
+INSTANTIATE_TEST_CASE_P(
+    C, DeringOrthogonalTest,
+    ::testing::Values(make_tuple(&od_filter_dering_orthogonal_4x4_c,
+                                 &od_filter_dering_orthogonal_4x4_c, 2),
+                      make_tuple(&od_filter_dering_orthogonal_8x8_c,
+                                 &od_filter_dering_orthogonal_8x8_c, 3)));
+
+INSTANTIATE_TEST_CASE_P(C, DeringFindDirTest,
+                        ::testing::Values(make_tuple(&od_dir_find8_c,
+                                                     &od_dir_find8_c)));
+
+#if CONFIG_AV1_ENCODER
+INSTANTIATE_TEST_CASE_P(C, DeringSseTest,
+                        ::testing::Values(make_tuple(&av1_dering_sse_c,
+                                                     &av1_dering_sse_c)));
+#endif  // CONFIG_AV1_ENCODER
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(
+    SSE2, DeringDirectionTest,
+    ::testing::Values(make_tuple(&od_filter_dering_direction_4x4_sse2,
+                                 &od_filter_dering_direction_4x4_c, 2),
+                      make_tuple(&od_filter_dering_direction_8x8_sse2,
+                                 &od_filter_dering_direction_8x8_c, 3)));
+
+INSTANTIATE_TEST_CASE_P(
+    SSE2, DeringOrthogonalTest,
+    ::testing::Values(make_tuple(&od_filter_dering_orthogonal_4x4_sse2,
+                                 &od_filter_dering_orthogonal_4x4_c, 2),
+                      make_tuple(&od_filter_dering_orthogonal_8x8_sse2,
+                                 &od_filter_dering_orthogonal_8x8_c, 3)));
+
+INSTANTIATE_TEST_CASE_P(SSE2, DeringFindDirTest,
+                        ::testing::Values(make_tuple(&od_dir_find8_sse2,
+                                                     &od_dir_find8_c)));
+
+#if CONFIG_AV1_ENCODER
+INSTANTIATE_TEST_CASE_P(SSE2, DeringSseTest,
+                        ::testing::Values(make_tuple(&av1_dering_sse_sse2,
+                                                     &av1_dering_sse_c)));
+#endif  // CONFIG_AV1_ENCODER
+#endif  // HAVE_SSE2
+
+#if HAVE_SSSE3
+INSTANTIATE_TEST_CASE_P(
+    SSSE3, DeringDirectionTest,
+    ::testing::Values(make_tuple(&od_filter_dering_direction_4x4_ssse3,
+                                 &od_filter_dering_direction_4x4_c, 2),
+                      make_tuple(&od_filter_dering_direction_8x8_ssse3,
+                                 &od_filter_dering_direction_8x8_c, 3)));
+
+INSTANTIATE_TEST_CASE_P(
+    SSSE3, DeringOrthogonalTest,
+    ::testing::Values(make_tuple(&od_filter_dering_orthogonal_4x4_ssse3,
+                                 &od_filter_dering_orthogonal_4x4_c, 2),
+                      make_tuple(&od_filter_dering_orthogonal_8x8_ssse3,
+                                 &od_filter_dering_orthogonal_8x8_c, 3)));
+#endif  // HAVE_SSSE3
+
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_CASE_P(SSE4_1, DeringFindDirTest,
+                        ::testing::Values(make_tuple(&od_dir_find8_sse4_1,
+                                                     &od_dir_find8_c)));
+#endif  // HAVE_SSE4_1
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, DeringDirectionTest,
+    ::testing::Values(make_tuple(&od_filter_dering_direction_8x8_avx2,
+                                 &od_filter_dering_direction_8x8_c, 3)));
+
+INSTANTIATE_TEST_CASE_P(
+    AVX2, DeringOrthogonalTest,
+    ::testing::Values(make_tuple(&od_filter_dering_orthogonal_8x8_avx2,
+                                 &od_filter_dering_orthogonal_8x8_c, 3)));
+#endif  // HAVE_AVX2
+}  // namespace
@@ -10,9 +10,11 @@
 */
 
 
+#include <set>
 #include <string>
 #include <vector>
 #include "third_party/googletest/src/include/gtest/gtest.h"
+#include "aom_util/aom_thread.h"
 #include "test/codec_factory.h"
 #include "test/encode_test_driver.h"
 #include "test/md5_helper.h"
@@ -20,13 +22,24 @@
 #include "test/y4m_video_source.h"
 
 namespace {
+// The frames encoded by EncoderResultTest, and the fewer frames encoded by the
+// cases that each check a single multi-threaded stage.
+//
+// In --enable-experimental builds, the single threaded one pass encodes of
+// niklas_1280_720_30.y4m fail, as they already did for EncoderResultTest and
+// TileIndependenceTest. The one pass cases then fail before they compare
+// anything.
+const int kNumFrames = 5;
+const int kNumShortFrames = 2;
+
 class AVxEncoderThreadTest
     : public ::libaom_test::EncoderTest,
       public ::libaom_test::CodecTestWith2Params<libaom_test::TestMode, int> {
  protected:
   AVxEncoderThreadTest()
       : EncoderTest(GET_PARAM(0)), encoder_initialized_(false), tiles_(2),
-        encoding_mode_(GET_PARAM(1)), set_cpu_used_(GET_PARAM(2)) {
+        tile_rows_(0), row_mt_(0), encoding_mode_(GET_PARAM(1)),
+        set_cpu_used_(GET_PARAM(2)) {
     init_flags_ = AOM_CODEC_USE_PSNR;
     aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
     cfg.w = 1280;
@@ -62,8 +75,10 @@ class AVxEncoderThreadTest
   virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
                                   ::libaom_test::Encoder *encoder) {
     if (!encoder_initialized_) {
-      // Encode 4 column tiles.
+      // Encode with 1 << tiles_ tile columns and 1 << tile_rows_ tile rows.
       encoder->Control(AV1E_SET_TILE_COLUMNS, tiles_);
+      encoder->Control(AV1E_SET_TILE_ROWS, tile_rows_);
+      encoder->Control(AV1E_SET_ROW_MT, row_mt_);
       encoder->Control(AOME_SET_CPUUSED, set_cpu_used_);
       if (encoding_mode_ != ::libaom_test::kRealTime) {
         encoder->Control(AOME_SET_ENABLEAUTOALTREF, 1);
@@ -94,8 +109,39 @@ class AVxEncoderThreadTest
     }
   }
 
+  // Encode 'num_frames' frames with a single thread and then with each of the
+  // given thread counts, and check that the decoded frames match.
+  void DoTest(const unsigned int *threads, int num_threads, int num_frames) {
+    std::vector<std::string> single_thr_md5, multi_thr_md5;
+
+    ::libaom_test::Y4mVideoSource video("niklas_1280_720_30.y4m", 15,
+                                        15 + num_frames);
+
+    cfg_.rc_target_bitrate = 1000;
+
+    // Encode using single thread.
+    cfg_.g_threads = 1;
+    init_flags_ = AOM_CODEC_USE_PSNR;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    single_thr_md5 = md5_;
+    md5_.clear();
+
+    // Encode using multiple threads.
+    for (int i = 0; i < num_threads; ++i) {
+      cfg_.g_threads = threads[i];
+      ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+      multi_thr_md5 = md5_;
+      md5_.clear();
+
+      // Compare to check if two vectors are equal.
+      ASSERT_EQ(single_thr_md5, multi_thr_md5) << "threads " << threads[i];
+    }
+  }
+
   bool encoder_initialized_;
   int tiles_;
+  int tile_rows_;
+  int row_mt_;
   ::libaom_test::TestMode encoding_mode_;
   int set_cpu_used_;
   ::libaom_test::Decoder *decoder_;
@@ -103,31 +149,176 @@ class AVxEncoderThreadTest
 };
 
 TEST_P(AVxEncoderThreadTest, EncoderResultTest) {
-  std::vector<std::string> single_thr_md5, multi_thr_md5;
+  // Include fewer threads than tile columns so that the workers share the
+  // columns.
+  const unsigned int kThreads[] = { 3, 4 };
+  DoTest(kThreads, 2, kNumFrames);
+}
 
-  ::libaom_test::Y4mVideoSource video("niklas_1280_720_30.y4m", 15, 20);
+TEST_P(AVxEncoderThreadTest, FirstPassStatsTest) {
+  // Only the two pass encodes have a first pass.
+  if (encoding_mode_ != ::libaom_test::kTwoPassGood) return;
+
+  ::libaom_test::Y4mVideoSource video("niklas_1280_720_30.y4m", 15,
+                                      15 + kNumShortFrames);
+  const unsigned int kThreads[] = { 1, 4 };
+  std::string single_thr_stats;
 
   cfg_.rc_target_bitrate = 1000;
+  for (int i = 0; i < 2; ++i) {
+    cfg_.g_threads = kThreads[i];
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
 
-  // Encode using single thread.
-  cfg_.g_threads = 1;
-  init_flags_ = AOM_CODEC_USE_PSNR;
-  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
-  single_thr_md5 = md5_;
-  md5_.clear();
+    // The statistics of the first pass are kept for the second one.
+    const aom_fixed_buf_t stats = stats_.buf();
+    const std::string thr_stats(static_cast<const char *>(stats.buf), stats.sz);
+    ASSERT_FALSE(thr_stats.empty());
+    if (i == 0)
+      single_thr_stats = thr_stats;
+    else
+      ASSERT_TRUE(single_thr_stats == thr_stats) << "threads " << kThreads[i];
+  }
+}
 
-  // Encode using multiple threads.
-  cfg_.g_threads = 4;
-  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
-  multi_thr_md5 = md5_;
-  md5_.clear();
+TEST_P(AVxEncoderThreadTest, LoopFilterLevelTest) {
+  // A single tile, so that every thread joins the loop filter level search,
+  // which tries up to four levels at once, and the loop filter itself runs
+  // on more workers than there are tile columns.
+  tiles_ = 0;
 
-  // Compare to check if two vectors are equal.
-  ASSERT_EQ(single_thr_md5, multi_thr_md5);
+  const unsigned int kThreads[] = { 2, 4 };
+  DoTest(kThreads, 2, kNumShortFrames);
+}
+
+TEST_P(AVxEncoderThreadTest, TileRowsResultTest) {
+  // A single tile column, whose tile rows only run in parallel with
+  // AV1E_SET_ROW_MT.
+  tiles_ = 0;
+  tile_rows_ = 2;
+  row_mt_ = 1;
+
+  const unsigned int kThreads[] = { 4 };
+  DoTest(kThreads, 1, kNumShortFrames);
+}
+
+TEST_P(AVxEncoderThreadTest, RowMTResultTest) {
+  // A single tile, so that only the superblock rows are encoded in parallel.
+  tiles_ = 0;
+  row_mt_ = 1;
+
+  // Include more threads than rows.
+  const unsigned int kThreads[] = { 2, 16 };
+  DoTest(kThreads, 2, kNumShortFrames);
+}
+
+TEST_P(AVxEncoderThreadTest, RowMTTileRowsResultTest) {
+  // The superblock rows of each tile column continue across the tile rows.
+  tiles_ = 1;
+  tile_rows_ = 1;
+  row_mt_ = 1;
+
+  const unsigned int kThreads[] = { 4 };
+  DoTest(kThreads, 1, kNumShortFrames);
 }
 
 AV1_INSTANTIATE_TEST_CASE(AVxEncoderThreadTest,
                            ::testing::Values(::libaom_test::kTwoPassGood,
                                              ::libaom_test::kOnePassGood),
                            ::testing::Range(1, 3));
+
+// The workers given a thread of their own.
+std::set<const AVxWorker *> thread_workers;
+AVxWorkerInterface default_winterface;
+
+int RecordingReset(AVxWorker *const worker) {
+  thread_workers.insert(worker);
+  return default_winterface.reset(worker);
+}
+
+// Records the threads started by each pass of an encode. Nothing is decoded
+// and there is no lag, so that all of the workers are the encoder's.
+class AVxEncoderThreadCountTest
+    : public ::libaom_test::EncoderTest,
+      public ::libaom_test::CodecTestWithParam<libaom_test::TestMode> {
+ protected:
+  AVxEncoderThreadCountTest()
+      : EncoderTest(GET_PARAM(0)), encoder_initialized_(false), tiles_(1),
+        encoding_mode_(GET_PARAM(1)) {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(encoding_mode_);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_target_bitrate = 1000;
+
+    default_winterface = *aom_get_worker_interface();
+    AVxWorkerInterface winterface = default_winterface;
+    winterface.reset = RecordingReset;
+    ASSERT_TRUE(aom_set_worker_interface(&winterface));
+  }
+
+  virtual void TearDown() {
+    ASSERT_TRUE(aom_set_worker_interface(&default_winterface));
+  }
+
+  virtual void BeginPassHook(unsigned int /*pass*/) {
+    encoder_initialized_ = false;
+    thread_workers.clear();
+  }
+
+  virtual void EndPassHook() {
+    pass_threads_.push_back(static_cast<int>(thread_workers.size()));
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource * /*video*/,
+                                  ::libaom_test::Encoder *encoder) {
+    if (!encoder_initialized_) {
+      encoder->Control(AV1E_SET_TILE_COLUMNS, tiles_);
+      encoder->Control(AOME_SET_CPUUSED, 2);
+      encoder->Control(AOME_SET_ENABLEAUTOALTREF, 1);
+      encoder_initialized_ = true;
+    }
+  }
+
+  virtual bool DoDecode() const { return false; }
+
+  bool encoder_initialized_;
+  int tiles_;
+  ::libaom_test::TestMode encoding_mode_;
+  std::vector<int> pass_threads_;
+};
+
+TEST_P(AVxEncoderThreadCountTest, UsesAllThreadsTest) {
+  // Two tile columns for four threads. The tile workers are not the only
+  // multi-threaded stage, so the encoder still starts a thread for each of
+  // the threads besides the calling one.
+  ::libaom_test::Y4mVideoSource video("niklas_1280_720_30.y4m", 0,
+                                      kNumShortFrames);
+  cfg_.g_threads = 4;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+  ASSERT_FALSE(pass_threads_.empty());
+  for (size_t i = 0; i < pass_threads_.size(); ++i) {
+    EXPECT_EQ(static_cast<int>(cfg_.g_threads) - 1, pass_threads_[i])
+        << "pass " << i;
+  }
+}
+
+TEST_P(AVxEncoderThreadCountTest, LoopFilterSearchThreadsTest) {
+  // A single tile and no lag, so that no stage before the loop filter level
+  // search runs on the workers in the last pass. The search still starts a
+  // thread for each of the threads besides the calling one.
+  tiles_ = 0;
+  ::libaom_test::Y4mVideoSource video("niklas_1280_720_30.y4m", 0,
+                                      kNumShortFrames);
+  cfg_.g_threads = 4;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+  ASSERT_FALSE(pass_threads_.empty());
+  EXPECT_EQ(static_cast<int>(cfg_.g_threads) - 1, pass_threads_.back());
+}
+
+AV1_INSTANTIATE_TEST_CASE(AVxEncoderThreadCountTest,
+                          ::testing::Values(::libaom_test::kTwoPassGood,
+                                            ::libaom_test::kOnePassGood));
 }  // namespace
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef TEST_FUNCTION_EQUIVALENCE_TEST_H_
+#define TEST_FUNCTION_EQUIVALENCE_TEST_H_
+
+#include <stdio.h>
+
+#include "aom_ports/aom_timer.h"
+
+namespace libaom_test {
+
+// Number of calls timed by the DISABLED_Speed tests, which compare an
+// optimized function with its reference version. Tests of functions that do
+// much more work per call run a fraction of it.
+const int kSpeedTestNumIterations = 1000000;
+
+// Print the time taken by the reference and the optimized version of a
+// function, as measured by 'ref_timer' and 'timer'.
+static void PrintSpeedTestResult(aom_usec_timer *ref_timer,
+                                 aom_usec_timer *timer) {
+  const int ref_time = static_cast<int>(aom_usec_timer_elapsed(ref_timer));
+  const int time = static_cast<int>(aom_usec_timer_elapsed(timer));
+  printf("reference %d us, optimized %d us, %.2fx\n", ref_time, time,
+         time ? static_cast<double>(ref_time) / time : 0.0);
+}
+
+}  // namespace libaom_test
+
+#endif  // TEST_FUNCTION_EQUIVALENCE_TEST_H_
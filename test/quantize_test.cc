@@ -18,6 +18,7 @@
 
 #include "./aom_config.h"
 #include "./aom_dsp_rtcd.h"
+#include "./av1_rtcd.h"
 #include "test/acm_random.h"
 #include "test/clear_system_state.h"
 #include "test/register_state_check.h"
@@ -344,5 +345,187 @@ INSTANTIATE_TEST_CASE_P(
                                  &aom_highbd_quantize_b_32x32_c, AOM_BITS_12)));
 #endif  // HAVE_SSE2
 #endif  // CONFIG_AOM_HIGHBITDEPTH
-#endif  // CONFIG_AOM_QM
+#else   // !CONFIG_AOM_QM
+const int number_of_iterations = 100;
+
+typedef void (*QuantizeQmFunc)(const tran_low_t *coeff, intptr_t count,
+                               int skip_block, const int16_t *zbin,
+                               const int16_t *round, const int16_t *quant,
+                               const int16_t *quant_shift, tran_low_t *qcoeff,
+                               tran_low_t *dqcoeff, const int16_t *dequant,
+                               uint16_t *eob, const int16_t *scan,
+                               const int16_t *iscan, const qm_val_t *qm,
+                               const qm_val_t *iqm);
+// The third parameter is non-zero for the 32x32 quantizers.
+typedef std::tr1::tuple<QuantizeQmFunc, QuantizeQmFunc, int, aom_bit_depth_t>
+    QuantizeQmParam;
+
+class AV1QuantizeQmTest : public ::testing::TestWithParam<QuantizeQmParam> {
+ public:
+  virtual ~AV1QuantizeQmTest() {}
+  virtual void SetUp() {
+    quantize_op_ = GET_PARAM(0);
+    ref_quantize_op_ = GET_PARAM(1);
+    is_32x32_ = GET_PARAM(2);
+    bit_depth_ = GET_PARAM(3);
+    mask_ = (1 << (bit_depth_ + 7)) - 1;
+  }
+
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void RunCheck(bool sparse) {
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    DECLARE_ALIGNED(16, tran_low_t, coeff_ptr[1024]);
+    DECLARE_ALIGNED(16, int16_t, zbin_ptr[2]);
+    DECLARE_ALIGNED(16, int16_t, round_ptr[2]);
+    DECLARE_ALIGNED(16, int16_t, quant_ptr[2]);
+    DECLARE_ALIGNED(16, int16_t, quant_shift_ptr[2]);
+    DECLARE_ALIGNED(16, tran_low_t, qcoeff_ptr[1024]);
+    DECLARE_ALIGNED(16, tran_low_t, dqcoeff_ptr[1024]);
+    DECLARE_ALIGNED(16, tran_low_t, ref_qcoeff_ptr[1024]);
+    DECLARE_ALIGNED(16, tran_low_t, ref_dqcoeff_ptr[1024]);
+    DECLARE_ALIGNED(16, int16_t, dequant_ptr[2]);
+    DECLARE_ALIGNED(16, qm_val_t, qm_ptr[1024]);
+    DECLARE_ALIGNED(16, qm_val_t, iqm_ptr[1024]);
+    DECLARE_ALIGNED(16, uint16_t, eob_ptr[1]);
+    DECLARE_ALIGNED(16, uint16_t, ref_eob_ptr[1]);
+    int err_count_total = 0;
+    int first_failure = -1;
+    for (int i = 0; i < number_of_iterations; ++i) {
+      const int skip_block = i == 0;
+      const TX_SIZE sz = is_32x32_ ? TX_32X32 : (TX_SIZE)(i % 3);
+      const TX_TYPE tx_type = (TX_TYPE)((i >> 2) % 3);
+      const scan_order *scan_order = &av1_scan_orders[sz][tx_type];
+      const int count = (4 << sz) * (4 << sz);
+      int err_count = 0;
+      *eob_ptr = rnd.Rand16();
+      *ref_eob_ptr = *eob_ptr;
+      for (int j = 0; j < count; j++) {
+        if (sparse || rnd(2)) {
+          coeff_ptr[j] = 0;
+        } else {
+          coeff_ptr[j] = (rnd.Rand31() & mask_) >> rnd(bit_depth_ + 7);
+          if (rnd(2)) coeff_ptr[j] = -coeff_ptr[j];
+        }
+        // Quantization matrix weights lie well within 9 bits.
+        qm_ptr[j] = rnd(1 << 9);
+        iqm_ptr[j] = rnd(1 << 9);
+      }
+      if (sparse) {
+        // Two random entries
+        coeff_ptr[rnd(count)] = rnd.Rand31() & mask_;
+        coeff_ptr[rnd(count)] = -(int)(rnd.Rand31() & mask_);
+      }
+      for (int j = 0; j < 2; j++) {
+        zbin_ptr[j] = rnd.Rand16() >> (1 + rnd(15));
+        round_ptr[j] = rnd.Rand16() >> (1 + rnd(15));
+        quant_ptr[j] = rnd.Rand16();
+        quant_shift_ptr[j] = rnd.Rand16();
+        dequant_ptr[j] = rnd.Rand16() >> (1 + rnd(15));
+      }
+      ref_quantize_op_(coeff_ptr, count, skip_block, zbin_ptr, round_ptr,
+                       quant_ptr, quant_shift_ptr, ref_qcoeff_ptr,
+                       ref_dqcoeff_ptr, dequant_ptr, ref_eob_ptr,
+                       scan_order->scan, scan_order->iscan, qm_ptr, iqm_ptr);
+      ASM_REGISTER_STATE_CHECK(quantize_op_(
+          coeff_ptr, count, skip_block, zbin_ptr, round_ptr, quant_ptr,
+          quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr, dequant_ptr, eob_ptr,
+          scan_order->scan, scan_order->iscan, qm_ptr, iqm_ptr));
+      for (int j = 0; j < count; ++j) {
+        err_count += (ref_qcoeff_ptr[j] != qcoeff_ptr[j]) |
+                     (ref_dqcoeff_ptr[j] != dqcoeff_ptr[j]);
+      }
+      err_count += (*ref_eob_ptr != *eob_ptr);
+      if (err_count && !err_count_total) {
+        first_failure = i;
+      }
+      err_count_total += err_count;
+    }
+    EXPECT_EQ(0, err_count_total)
+        << "Error: Quantization Test, C output doesn't match SIMD output. "
+        << "First failed at test case " << first_failure;
+  }
+
+  aom_bit_depth_t bit_depth_;
+  int is_32x32_;
+  int mask_;
+  QuantizeQmFunc quantize_op_;
+  QuantizeQmFunc ref_quantize_op_;
+};
+
+TEST_P(AV1QuantizeQmTest, OperationCheck) { RunCheck(false); }
+
+TEST_P(AV1QuantizeQmTest, EOBCheck) { RunCheck(true); }
+
+using std::tr1::make_tuple;
+
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_CASE_P(
+    SSE4_1, AV1QuantizeQmTest,
+    ::testing::Values(
+        make_tuple(&aom_quantize_b_sse4_1, &aom_quantize_b_c, 0, AOM_BITS_8),
+        make_tuple(&aom_quantize_b_32x32_sse4_1, &aom_quantize_b_32x32_c, 1,
+                   AOM_BITS_8),
+        make_tuple(&av1_quantize_fp_sse4_1, &av1_quantize_fp_c, 0, AOM_BITS_8),
+        make_tuple(&av1_quantize_fp_32x32_sse4_1, &av1_quantize_fp_32x32_c, 1,
+                   AOM_BITS_8)));
+
+#if CONFIG_AOM_HIGHBITDEPTH
+INSTANTIATE_TEST_CASE_P(
+    SSE4_1_HBD, AV1QuantizeQmTest,
+    ::testing::Values(
+        make_tuple(&aom_highbd_quantize_b_sse4_1, &aom_highbd_quantize_b_c, 0,
+                   AOM_BITS_10),
+        make_tuple(&aom_highbd_quantize_b_sse4_1, &aom_highbd_quantize_b_c, 0,
+                   AOM_BITS_12),
+        make_tuple(&aom_highbd_quantize_b_32x32_sse4_1,
+                   &aom_highbd_quantize_b_32x32_c, 1, AOM_BITS_10),
+        make_tuple(&aom_highbd_quantize_b_32x32_sse4_1,
+                   &aom_highbd_quantize_b_32x32_c, 1, AOM_BITS_12),
+        make_tuple(&av1_highbd_quantize_fp_sse4_1, &av1_highbd_quantize_fp_c,
+                   0, AOM_BITS_10),
+        make_tuple(&av1_highbd_quantize_fp_sse4_1, &av1_highbd_quantize_fp_c,
+                   0, AOM_BITS_12),
+        make_tuple(&av1_highbd_quantize_fp_32x32_sse4_1,
+                   &av1_highbd_quantize_fp_32x32_c, 1, AOM_BITS_10),
+        make_tuple(&av1_highbd_quantize_fp_32x32_sse4_1,
+                   &av1_highbd_quantize_fp_32x32_c, 1, AOM_BITS_12)));
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+#endif  // HAVE_SSE4_1
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, AV1QuantizeQmTest,
+    ::testing::Values(
+        make_tuple(&aom_quantize_b_avx2, &aom_quantize_b_c, 0, AOM_BITS_8),
+        make_tuple(&aom_quantize_b_32x32_avx2, &aom_quantize_b_32x32_c, 1,
+                   AOM_BITS_8),
+        make_tuple(&av1_quantize_fp_avx2, &av1_quantize_fp_c, 0, AOM_BITS_8),
+        make_tuple(&av1_quantize_fp_32x32_avx2, &av1_quantize_fp_32x32_c, 1,
+                   AOM_BITS_8)));
+
+#if CONFIG_AOM_HIGHBITDEPTH
+INSTANTIATE_TEST_CASE_P(
+    AVX2_HBD, AV1QuantizeQmTest,
+    ::testing::Values(
+        make_tuple(&aom_highbd_quantize_b_avx2, &aom_highbd_quantize_b_c, 0,
+                   AOM_BITS_10),
+        make_tuple(&aom_highbd_quantize_b_avx2, &aom_highbd_quantize_b_c, 0,
+                   AOM_BITS_12),
+        make_tuple(&aom_highbd_quantize_b_32x32_avx2,
+                   &aom_highbd_quantize_b_32x32_c, 1, AOM_BITS_10),
+        make_tuple(&aom_highbd_quantize_b_32x32_avx2,
+                   &aom_highbd_quantize_b_32x32_c, 1, AOM_BITS_12),
+        make_tuple(&av1_highbd_quantize_fp_avx2, &av1_highbd_quantize_fp_c, 0,
+                   AOM_BITS_10),
+        make_tuple(&av1_highbd_quantize_fp_avx2, &av1_highbd_quantize_fp_c, 0,
+                   AOM_BITS_12),
+        make_tuple(&av1_highbd_quantize_fp_32x32_avx2,
+                   &av1_highbd_quantize_fp_32x32_c, 1, AOM_BITS_10),
+        make_tuple(&av1_highbd_quantize_fp_32x32_avx2,
+                   &av1_highbd_quantize_fp_32x32_c, 1, AOM_BITS_12)));
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+#endif  // HAVE_AVX2
+#endif  // !CONFIG_AOM_QM
 }  // namespace
@@ -0,0 +1,573 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/function_equivalence_test.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "aom/aom_integer.h"
+#include "aom_ports/aom_timer.h"
+#include "aom_ports/mem.h"
+#include "av1/encoder/resize.h"
+
+using libaom_test::ACMRandom;
+using libaom_test::kSpeedTestNumIterations;
+using libaom_test::PrintSpeedTestResult;
+
+namespace {
+
+typedef void (*ResizeHorzFunc)(const uint8_t *input, uint8_t *output,
+                               int outlength, int64_t y, int64_t delta,
+                               const int16_t *filters);
+typedef void (*ResizeDown2HorzFunc)(const uint8_t *input, uint8_t *output,
+                                    int outlength, const int16_t *filter);
+typedef void (*ResizeVertFunc)(const uint8_t *const *rows,
+                               const int16_t *filter, uint8_t *output,
+                               int width);
+
+// <function to test, reference function>
+typedef std::tr1::tuple<ResizeHorzFunc, ResizeHorzFunc> ResizeHorzParam;
+typedef std::tr1::tuple<ResizeDown2HorzFunc, ResizeDown2HorzFunc>
+    ResizeDown2HorzParam;
+typedef std::tr1::tuple<ResizeVertFunc, ResizeVertFunc> ResizeVertParam;
+
+#if CONFIG_AOM_HIGHBITDEPTH
+typedef void (*HighbdResizeHorzFunc)(const uint16_t *input, uint16_t *output,
+                                     int outlength, int64_t y, int64_t delta,
+                                     const int16_t *filters, int bd);
+typedef void (*HighbdResizeDown2HorzFunc)(const uint16_t *input,
+                                          uint16_t *output, int outlength,
+                                          const int16_t *filter, int bd);
+typedef void (*HighbdResizeVertFunc)(const uint16_t *const *rows,
+                                     const int16_t *filter, uint16_t *output,
+                                     int width, int bd);
+
+// <function to test, reference function, bit depth>
+typedef std::tr1::tuple<HighbdResizeHorzFunc, HighbdResizeHorzFunc, int>
+    HighbdResizeHorzParam;
+typedef std::tr1::tuple<HighbdResizeDown2HorzFunc, HighbdResizeDown2HorzFunc,
+                        int> HighbdResizeDown2HorzParam;
+typedef std::tr1::tuple<HighbdResizeVertFunc, HighbdResizeVertFunc, int>
+    HighbdResizeVertParam;
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+
+const int kNumIterations = 1000;
+const int kMaxLength = 512;
+// Enough input for kMaxLength outputs with a step of up to 4.25 pixels.
+const int kInputSize = 5 * kMaxLength;
+const int kNumRows = 12;
+const int kNumFilters = 1 << RS_SUBPEL_BITS;
+// The width of a 1080p row, used for the speed tests.
+const int kSpeedLength = 1920;
+
+// Random taps, large enough to clip the results at both ends.
+void FillFilters(ACMRandom *rnd, int16_t *filters, int count) {
+  for (int i = 0; i < count * RS_INTERP_TAPS; ++i)
+    filters[i] = rnd->Rand8() % 193 - 64;
+}
+
+// Mostly short lengths, which take the tails and the C fallbacks, and every
+// few iterations one of any size.
+int RandomLength(ACMRandom *rnd, int i) {
+  return i % 4 ? (*rnd)(40) + 1 : (*rnd)(kMaxLength) + 1;
+}
+
+// A step between 0.25 and 4.25 input pixels per output, in the 32.32 fixed
+// point of resize.c.
+int64_t RandomDelta(ACMRandom *rnd) {
+  return (static_cast<int64_t>(rnd->Rand16()) << 18) + (1LL << 30);
+}
+
+// The first position has its first tap on input pixel 0 or later.
+int64_t RandomStart(ACMRandom *rnd) {
+  return (static_cast<int64_t>(RS_INTERP_TAPS / 2 - 1)
+          << RS_INTERP_PRECISION_BITS) +
+         (static_cast<int64_t>(rnd->Rand16()) << 16);
+}
+
+template <typename Pixel>
+void FillPixels(ACMRandom *rnd, Pixel *buf, int count, int bd) {
+  const int mask = (1 << bd) - 1;
+  const int extreme = rnd->Rand8() & 1;
+  for (int i = 0; i < count; ++i)
+    buf[i] = extreme ? (rnd->Rand8() & 1) * mask : rnd->Rand16() & mask;
+}
+
+template <typename Pixel>
+void SetRows(ACMRandom *rnd, const Pixel *buf, const Pixel **rows) {
+  // Repeated rows, as at the frame edges, are allowed.
+  for (int k = 0; k < RS_INTERP_TAPS; ++k)
+    rows[k] = buf + (*rnd)(kNumRows) * kMaxLength;
+}
+
+class ResizeHorzTest : public ::testing::TestWithParam<ResizeHorzParam> {
+ public:
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  ResizeHorzFunc func_;
+  ResizeHorzFunc ref_func_;
+};
+
+TEST_P(ResizeHorzTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint8_t, input[kInputSize]);
+  DECLARE_ALIGNED(16, uint8_t, output[kMaxLength]);
+  DECLARE_ALIGNED(16, uint8_t, ref_output[kMaxLength]);
+  DECLARE_ALIGNED(16, int16_t, filters[kNumFilters * RS_INTERP_TAPS]);
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int length = RandomLength(&rnd, i);
+    const int64_t delta = RandomDelta(&rnd);
+    const int64_t y = RandomStart(&rnd);
+    ASSERT_LE(((y + delta * (length - 1)) >> RS_INTERP_PRECISION_BITS) +
+                  RS_INTERP_TAPS / 2,
+              kInputSize - 1);
+    FillPixels(&rnd, input, kInputSize, 8);
+    FillFilters(&rnd, filters, kNumFilters);
+    memset(output, 0, sizeof(output));
+    memset(ref_output, 0, sizeof(ref_output));
+
+    ref_func_(input, ref_output, length, y, delta, filters);
+    ASM_REGISTER_STATE_CHECK(func_(input, output, length, y, delta, filters));
+    for (int j = 0; j < kMaxLength; ++j) {
+      ASSERT_EQ(ref_output[j], output[j]) << "Error at " << j << " iteration "
+                                          << i << " length " << length;
+    }
+  }
+}
+
+TEST_P(ResizeHorzTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  // Upscaling by 4/3 reads 1440 pixels for a 1920 pixel row.
+  const int64_t delta = (3LL << RS_INTERP_PRECISION_BITS) / 4;
+  const int64_t y = RandomStart(&rnd);
+  uint8_t *const input = new uint8_t[kSpeedLength];
+  uint8_t *const output = new uint8_t[kSpeedLength];
+  DECLARE_ALIGNED(16, int16_t, filters[kNumFilters * RS_INTERP_TAPS]);
+  FillPixels(&rnd, input, kSpeedLength, 8);
+  FillFilters(&rnd, filters, kNumFilters);
+
+  aom_usec_timer ref_timer, timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    ref_func_(input, output, kSpeedLength, y, delta, filters);
+  aom_usec_timer_mark(&ref_timer);
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    func_(input, output, kSpeedLength, y, delta, filters);
+  aom_usec_timer_mark(&timer);
+  PrintSpeedTestResult(&ref_timer, &timer);
+  delete[] input;
+  delete[] output;
+}
+
+class ResizeDown2HorzTest
+    : public ::testing::TestWithParam<ResizeDown2HorzParam> {
+ public:
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  ResizeDown2HorzFunc func_;
+  ResizeDown2HorzFunc ref_func_;
+};
+
+TEST_P(ResizeDown2HorzTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint8_t, input[2 * kMaxLength + RS_INTERP_TAPS]);
+  DECLARE_ALIGNED(16, uint8_t, output[kMaxLength]);
+  DECLARE_ALIGNED(16, uint8_t, ref_output[kMaxLength]);
+  DECLARE_ALIGNED(16, int16_t, filter[RS_INTERP_TAPS]);
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int length = RandomLength(&rnd, i);
+    FillPixels(&rnd, input, 2 * kMaxLength + RS_INTERP_TAPS, 8);
+    FillFilters(&rnd, filter, 1);
+    memset(output, 0, sizeof(output));
+    memset(ref_output, 0, sizeof(ref_output));
+
+    ref_func_(input, ref_output, length, filter);
+    ASM_REGISTER_STATE_CHECK(func_(input, output, length, filter));
+    for (int j = 0; j < kMaxLength; ++j) {
+      ASSERT_EQ(ref_output[j], output[j]) << "Error at " << j << " iteration "
+                                          << i << " length " << length;
+    }
+  }
+}
+
+TEST_P(ResizeDown2HorzTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint8_t *const input = new uint8_t[2 * kSpeedLength + RS_INTERP_TAPS];
+  uint8_t *const output = new uint8_t[kSpeedLength];
+  DECLARE_ALIGNED(16, int16_t, filter[RS_INTERP_TAPS]);
+  FillPixels(&rnd, input, 2 * kSpeedLength + RS_INTERP_TAPS, 8);
+  FillFilters(&rnd, filter, 1);
+
+  aom_usec_timer ref_timer, timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    ref_func_(input, output, kSpeedLength, filter);
+  aom_usec_timer_mark(&ref_timer);
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    func_(input, output, kSpeedLength, filter);
+  aom_usec_timer_mark(&timer);
+  PrintSpeedTestResult(&ref_timer, &timer);
+  delete[] input;
+  delete[] output;
+}
+
+class ResizeVertTest : public ::testing::TestWithParam<ResizeVertParam> {
+ public:
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  ResizeVertFunc func_;
+  ResizeVertFunc ref_func_;
+};
+
+TEST_P(ResizeVertTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint8_t, input[kNumRows * kMaxLength]);
+  DECLARE_ALIGNED(16, uint8_t, output[kMaxLength]);
+  DECLARE_ALIGNED(16, uint8_t, ref_output[kMaxLength]);
+  DECLARE_ALIGNED(16, int16_t, filter[RS_INTERP_TAPS]);
+  const uint8_t *rows[RS_INTERP_TAPS];
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int width = RandomLength(&rnd, i);
+    FillPixels(&rnd, input, kNumRows * kMaxLength, 8);
+    FillFilters(&rnd, filter, 1);
+    SetRows(&rnd, input, rows);
+    memset(output, 0, sizeof(output));
+    memset(ref_output, 0, sizeof(ref_output));
+
+    ref_func_(rows, filter, ref_output, width);
+    ASM_REGISTER_STATE_CHECK(func_(rows, filter, output, width));
+    for (int j = 0; j < kMaxLength; ++j) {
+      ASSERT_EQ(ref_output[j], output[j]) << "Error at " << j << " iteration "
+                                          << i << " width " << width;
+    }
+  }
+}
+
+TEST_P(ResizeVertTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint8_t *const input = new uint8_t[RS_INTERP_TAPS * kSpeedLength];
+  uint8_t *const output = new uint8_t[kSpeedLength];
+  DECLARE_ALIGNED(16, int16_t, filter[RS_INTERP_TAPS]);
+  const uint8_t *rows[RS_INTERP_TAPS];
+  FillPixels(&rnd, input, RS_INTERP_TAPS * kSpeedLength, 8);
+  FillFilters(&rnd, filter, 1);
+  for (int k = 0; k < RS_INTERP_TAPS; ++k) rows[k] = input + k * kSpeedLength;
+
+  aom_usec_timer ref_timer, timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    ref_func_(rows, filter, output, kSpeedLength);
+  aom_usec_timer_mark(&ref_timer);
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    func_(rows, filter, output, kSpeedLength);
+  aom_usec_timer_mark(&timer);
+  PrintSpeedTestResult(&ref_timer, &timer);
+  delete[] input;
+  delete[] output;
+}
+
+#if CONFIG_AOM_HIGHBITDEPTH
+class HighbdResizeHorzTest
+    : public ::testing::TestWithParam<HighbdResizeHorzParam> {
+ public:
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+    bd_ = GET_PARAM(2);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  HighbdResizeHorzFunc func_;
+  HighbdResizeHorzFunc ref_func_;
+  int bd_;
+};
+
+TEST_P(HighbdResizeHorzTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint16_t, input[kInputSize]);
+  DECLARE_ALIGNED(16, uint16_t, output[kMaxLength]);
+  DECLARE_ALIGNED(16, uint16_t, ref_output[kMaxLength]);
+  DECLARE_ALIGNED(16, int16_t, filters[kNumFilters * RS_INTERP_TAPS]);
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int length = RandomLength(&rnd, i);
+    const int64_t delta = RandomDelta(&rnd);
+    const int64_t y = RandomStart(&rnd);
+    FillPixels(&rnd, input, kInputSize, bd_);
+    FillFilters(&rnd, filters, kNumFilters);
+    memset(output, 0, sizeof(output));
+    memset(ref_output, 0, sizeof(ref_output));
+
+    ref_func_(input, ref_output, length, y, delta, filters, bd_);
+    ASM_REGISTER_STATE_CHECK(
+        func_(input, output, length, y, delta, filters, bd_));
+    for (int j = 0; j < kMaxLength; ++j) {
+      ASSERT_EQ(ref_output[j], output[j]) << "Error at " << j << " iteration "
+                                          << i << " length " << length;
+    }
+  }
+}
+
+TEST_P(HighbdResizeHorzTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  const int64_t delta = (3LL << RS_INTERP_PRECISION_BITS) / 4;
+  const int64_t y = RandomStart(&rnd);
+  uint16_t *const input = new uint16_t[kSpeedLength];
+  uint16_t *const output = new uint16_t[kSpeedLength];
+  DECLARE_ALIGNED(16, int16_t, filters[kNumFilters * RS_INTERP_TAPS]);
+  FillPixels(&rnd, input, kSpeedLength, bd_);
+  FillFilters(&rnd, filters, kNumFilters);
+
+  aom_usec_timer ref_timer, timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    ref_func_(input, output, kSpeedLength, y, delta, filters, bd_);
+  aom_usec_timer_mark(&ref_timer);
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    func_(input, output, kSpeedLength, y, delta, filters, bd_);
+  aom_usec_timer_mark(&timer);
+  PrintSpeedTestResult(&ref_timer, &timer);
+  delete[] input;
+  delete[] output;
+}
+
+class HighbdResizeDown2HorzTest
+    : public ::testing::TestWithParam<HighbdResizeDown2HorzParam> {
+ public:
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+    bd_ = GET_PARAM(2);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  HighbdResizeDown2HorzFunc func_;
+  HighbdResizeDown2HorzFunc ref_func_;
+  int bd_;
+};
+
+TEST_P(HighbdResizeDown2HorzTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint16_t, input[2 * kMaxLength + RS_INTERP_TAPS]);
+  DECLARE_ALIGNED(16, uint16_t, output[kMaxLength]);
+  DECLARE_ALIGNED(16, uint16_t, ref_output[kMaxLength]);
+  DECLARE_ALIGNED(16, int16_t, filter[RS_INTERP_TAPS]);
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int length = RandomLength(&rnd, i);
+    FillPixels(&rnd, input, 2 * kMaxLength + RS_INTERP_TAPS, bd_);
+    FillFilters(&rnd, filter, 1);
+    memset(output, 0, sizeof(output));
+    memset(ref_output, 0, sizeof(ref_output));
+
+    ref_func_(input, ref_output, length, filter, bd_);
+    ASM_REGISTER_STATE_CHECK(func_(input, output, length, filter, bd_));
+    for (int j = 0; j < kMaxLength; ++j) {
+      ASSERT_EQ(ref_output[j], output[j]) << "Error at " << j << " iteration "
+                                          << i << " length " << length;
+    }
+  }
+}
+
+TEST_P(HighbdResizeDown2HorzTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint16_t *const input = new uint16_t[2 * kSpeedLength + RS_INTERP_TAPS];
+  uint16_t *const output = new uint16_t[kSpeedLength];
+  DECLARE_ALIGNED(16, int16_t, filter[RS_INTERP_TAPS]);
+  FillPixels(&rnd, input, 2 * kSpeedLength + RS_INTERP_TAPS, bd_);
+  FillFilters(&rnd, filter, 1);
+
+  aom_usec_timer ref_timer, timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    ref_func_(input, output, kSpeedLength, filter, bd_);
+  aom_usec_timer_mark(&ref_timer);
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    func_(input, output, kSpeedLength, filter, bd_);
+  aom_usec_timer_mark(&timer);
+  PrintSpeedTestResult(&ref_timer, &timer);
+  delete[] input;
+  delete[] output;
+}
+
+class HighbdResizeVertTest
+    : public ::testing::TestWithParam<HighbdResizeVertParam> {
+ public:
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+    bd_ = GET_PARAM(2);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  HighbdResizeVertFunc func_;
+  HighbdResizeVertFunc ref_func_;
+  int bd_;
+};
+
+TEST_P(HighbdResizeVertTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint16_t, input[kNumRows * kMaxLength]);
+  DECLARE_ALIGNED(16, uint16_t, output[kMaxLength]);
+  DECLARE_ALIGNED(16, uint16_t, ref_output[kMaxLength]);
+  DECLARE_ALIGNED(16, int16_t, filter[RS_INTERP_TAPS]);
+  const uint16_t *rows[RS_INTERP_TAPS];
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int width = RandomLength(&rnd, i);
+    FillPixels(&rnd, input, kNumRows * kMaxLength, bd_);
+    FillFilters(&rnd, filter, 1);
+    SetRows(&rnd, input, rows);
+    memset(output, 0, sizeof(output));
+    memset(ref_output, 0, sizeof(ref_output));
+
+    ref_func_(rows, filter, ref_output, width, bd_);
+    ASM_REGISTER_STATE_CHECK(func_(rows, filter, output, width, bd_));
+    for (int j = 0; j < kMaxLength; ++j) {
+      ASSERT_EQ(ref_output[j], output[j]) << "Error at " << j << " iteration "
+                                          << i << " width " << width;
+    }
+  }
+}
+
+TEST_P(HighbdResizeVertTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint16_t *const input = new uint16_t[RS_INTERP_TAPS * kSpeedLength];
+  uint16_t *const output = new uint16_t[kSpeedLength];
+  DECLARE_ALIGNED(16, int16_t, filter[RS_INTERP_TAPS]);
+  const uint16_t *rows[RS_INTERP_TAPS];
+  FillPixels(&rnd, input, RS_INTERP_TAPS * kSpeedLength, bd_);
+  FillFilters(&rnd, filter, 1);
+  for (int k = 0; k < RS_INTERP_TAPS; ++k) rows[k] = input + k * kSpeedLength;
+
+  aom_usec_timer ref_timer, timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    ref_func_(rows, filter, output, kSpeedLength, bd_);
+  aom_usec_timer_mark(&ref_timer);
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kSpeedTestNumIterations / 100; ++i)
+    func_(rows, filter, output, kSpeedLength, bd_);
+  aom_usec_timer_mark(&timer);
+  PrintSpeedTestResult(&ref_timer, &timer);
+  delete[] input;
+  delete[] output;
+}
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+
+using std::tr1::make_tuple;
+
+INSTANTIATE_TEST_CASE_P(C, ResizeHorzTest,
+                        ::testing::Values(make_tuple(&av1_resize_horz_c,
+                                                     &av1_resize_horz_c)));
+INSTANTIATE_TEST_CASE_P(
+    C, ResizeDown2HorzTest,
+    ::testing::Values(make_tuple(&av1_resize_down2_horz_c,
+                                 &av1_resize_down2_horz_c)));
+INSTANTIATE_TEST_CASE_P(C, ResizeVertTest,
+                        ::testing::Values(make_tuple(&av1_resize_vert_c,
+                                                     &av1_resize_vert_c)));
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(
+    SSE2, ResizeDown2HorzTest,
+    ::testing::Values(make_tuple(&av1_resize_down2_horz_sse2,
+                                 &av1_resize_down2_horz_c)));
+INSTANTIATE_TEST_CASE_P(SSE2, ResizeVertTest,
+                        ::testing::Values(make_tuple(&av1_resize_vert_sse2,
+                                                     &av1_resize_vert_c)));
+#if CONFIG_AOM_HIGHBITDEPTH
+INSTANTIATE_TEST_CASE_P(
+    SSE2, HighbdResizeDown2HorzTest,
+    ::testing::Values(make_tuple(&av1_highbd_resize_down2_horz_sse2,
+                                 &av1_highbd_resize_down2_horz_c, 10),
+                      make_tuple(&av1_highbd_resize_down2_horz_sse2,
+                                 &av1_highbd_resize_down2_horz_c, 12)));
+INSTANTIATE_TEST_CASE_P(
+    SSE2, HighbdResizeVertTest,
+    ::testing::Values(make_tuple(&av1_highbd_resize_vert_sse2,
+                                 &av1_highbd_resize_vert_c, 10),
+                      make_tuple(&av1_highbd_resize_vert_sse2,
+                                 &av1_highbd_resize_vert_c, 12)));
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+#endif  // HAVE_SSE2
+
+#if HAVE_SSSE3
+INSTANTIATE_TEST_CASE_P(SSSE3, ResizeHorzTest,
+                        ::testing::Values(make_tuple(&av1_resize_horz_ssse3,
+                                                     &av1_resize_horz_c)));
+#if CONFIG_AOM_HIGHBITDEPTH
+INSTANTIATE_TEST_CASE_P(
+    SSSE3, HighbdResizeHorzTest,
+    ::testing::Values(make_tuple(&av1_highbd_resize_horz_ssse3,
+                                 &av1_highbd_resize_horz_c, 10),
+                      make_tuple(&av1_highbd_resize_horz_ssse3,
+                                 &av1_highbd_resize_horz_c, 12)));
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+#endif  // HAVE_SSSE3
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, ResizeDown2HorzTest,
+    ::testing::Values(make_tuple(&av1_resize_down2_horz_avx2,
+                                 &av1_resize_down2_horz_c)));
+INSTANTIATE_TEST_CASE_P(AVX2, ResizeVertTest,
+                        ::testing::Values(make_tuple(&av1_resize_vert_avx2,
+                                                     &av1_resize_vert_c)));
+#if CONFIG_AOM_HIGHBITDEPTH
+INSTANTIATE_TEST_CASE_P(
+    AVX2, HighbdResizeDown2HorzTest,
+    ::testing::Values(make_tuple(&av1_highbd_resize_down2_horz_avx2,
+                                 &av1_highbd_resize_down2_horz_c, 10),
+                      make_tuple(&av1_highbd_resize_down2_horz_avx2,
+                                 &av1_highbd_resize_down2_horz_c, 12)));
+INSTANTIATE_TEST_CASE_P(
+    AVX2, HighbdResizeVertTest,
+    ::testing::Values(make_tuple(&av1_highbd_resize_vert_avx2,
+                                 &av1_highbd_resize_vert_c, 10),
+                      make_tuple(&av1_highbd_resize_vert_avx2,
+                                 &av1_highbd_resize_vert_c, 12)));
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+#endif  // HAVE_AVX2
+}  // namespace
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/function_equivalence_test.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/aom_timer.h"
+#include "aom_ports/mem.h"
+
+using libaom_test::ACMRandom;
+using libaom_test::kSpeedTestNumIterations;
+using libaom_test::PrintSpeedTestResult;
+
+namespace {
+
+typedef void (*TemporalFilterFunc)(uint8_t *frame1, unsigned int stride,
+                                   uint8_t *frame2, unsigned int block_width,
+                                   unsigned int block_height, int strength,
+                                   int filter_weight,
+                                   unsigned int *accumulator, uint16_t *count);
+
+// <function to test, reference function, bit depth>
+typedef std::tr1::tuple<TemporalFilterFunc, TemporalFilterFunc, int>
+    TemporalFilterParam;
+
+const int kNumIterations = 2000;
+const int kStride = 24;
+const int kMaxSize = 16;
+// The luma block and the chroma block sizes of temporal_filter_iterate_c().
+const int kBlockSizes[][2] = { { 16, 16 }, { 8, 8 }, { 16, 8 }, { 8, 16 } };
+
+class TemporalFilterTest
+    : public ::testing::TestWithParam<TemporalFilterParam> {
+ public:
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+    bd_ = GET_PARAM(2);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void RunCheck(bool extreme);
+
+  // Fills the frame and the packed predictor. Normally the predictor is a
+  // noisy copy of the frame, so that all filter weights show up; otherwise
+  // every pixel is either 0 or the largest value.
+  void FillBlocks(ACMRandom *rnd, int width, int height, bool extreme) {
+    const int mask = (1 << bd_) - 1;
+    const int range = 1 << rnd->Rand8() % bd_;
+    for (int r = 0; r < height; ++r) {
+      for (int c = 0; c < width; ++c) {
+        int src, pred;
+        if (extreme) {
+          src = rnd->Rand8() & 1 ? mask : 0;
+          pred = rnd->Rand8() & 1 ? mask : 0;
+        } else {
+          src = rnd->Rand16() & mask;
+          pred = clamp(src + (*rnd)(2 * range + 1) - range, 0, mask);
+        }
+#if CONFIG_AOM_HIGHBITDEPTH
+        src16_[r * kStride + c] = src;
+        pred16_[r * width + c] = pred;
+#endif
+        src8_[r * kStride + c] = src;
+        pred8_[r * width + c] = pred;
+      }
+    }
+  }
+
+#if CONFIG_AOM_HIGHBITDEPTH
+  uint8_t *Frame1() {
+    return bd_ == 8 ? src8_ : CONVERT_TO_BYTEPTR(src16_);
+  }
+  uint8_t *Frame2() {
+    return bd_ == 8 ? pred8_ : CONVERT_TO_BYTEPTR(pred16_);
+  }
+#else
+  uint8_t *Frame1() { return src8_; }
+  uint8_t *Frame2() { return pred8_; }
+#endif
+
+  TemporalFilterFunc func_;
+  TemporalFilterFunc ref_func_;
+  int bd_;
+  DECLARE_ALIGNED(16, uint8_t, src8_[kStride * kMaxSize]);
+  DECLARE_ALIGNED(16, uint8_t, pred8_[kMaxSize * kMaxSize]);
+#if CONFIG_AOM_HIGHBITDEPTH
+  DECLARE_ALIGNED(16, uint16_t, src16_[kStride * kMaxSize]);
+  DECLARE_ALIGNED(16, uint16_t, pred16_[kMaxSize * kMaxSize]);
+#endif
+};
+
+void TemporalFilterTest::RunCheck(bool extreme) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, unsigned int, acc[kMaxSize * kMaxSize]);
+  DECLARE_ALIGNED(16, unsigned int, ref_acc[kMaxSize * kMaxSize]);
+  DECLARE_ALIGNED(16, uint16_t, count[kMaxSize * kMaxSize]);
+  DECLARE_ALIGNED(16, uint16_t, ref_count[kMaxSize * kMaxSize]);
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int *const size = kBlockSizes[i % 4];
+    const int width = size[0];
+    const int height = size[1];
+    // The encoder raises the strength by 2 per extra bit of depth.
+    const int strength = rnd(7) + 2 * (bd_ - 8);
+    const int weight = rnd(3);
+    FillBlocks(&rnd, width, height, extreme);
+    for (int j = 0; j < kMaxSize * kMaxSize; ++j) {
+      ref_acc[j] = acc[j] = rnd.Rand16();
+      ref_count[j] = count[j] = rnd.Rand8();
+    }
+
+    ref_func_(Frame1(), kStride, Frame2(), width, height, strength, weight,
+              ref_acc, ref_count);
+    ASM_REGISTER_STATE_CHECK(func_(Frame1(), kStride, Frame2(), width,
+                                   height, strength, weight, acc, count));
+    for (int j = 0; j < kMaxSize * kMaxSize; ++j) {
+      ASSERT_EQ(ref_count[j], count[j])
+          << "Count error at " << j << " iteration " << i << " size "
+          << width << "x" << height << " strength " << strength
+          << " weight " << weight;
+      ASSERT_EQ(ref_acc[j], acc[j])
+          << "Accumulator error at " << j << " iteration " << i << " size "
+          << width << "x" << height << " strength " << strength
+          << " weight " << weight;
+    }
+  }
+}
+
+TEST_P(TemporalFilterTest, MatchesReference) { RunCheck(false); }
+
+TEST_P(TemporalFilterTest, ExtremeValues) { RunCheck(true); }
+
+TEST_P(TemporalFilterTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, unsigned int, acc[kMaxSize * kMaxSize]);
+  DECLARE_ALIGNED(16, uint16_t, count[kMaxSize * kMaxSize]);
+  const int strength = 6 + 2 * (bd_ - 8);
+  FillBlocks(&rnd, kMaxSize, kMaxSize, false);
+  memset(acc, 0, sizeof(acc));
+  memset(count, 0, sizeof(count));
+
+  aom_usec_timer ref_timer, timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < kSpeedTestNumIterations; ++i)
+    ref_func_(Frame1(), kStride, Frame2(), 16, 16, strength, 2, acc, count);
+  aom_usec_timer_mark(&ref_timer);
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kSpeedTestNumIterations; ++i)
+    func_(Frame1(), kStride, Frame2(), 16, 16, strength, 2, acc, count);
+  aom_usec_timer_mark(&timer);
+
+  PrintSpeedTestResult(&ref_timer, &timer);
+}
+
+using std::tr1::make_tuple;
+
+INSTANTIATE_TEST_CASE_P(C, TemporalFilterTest,
+                        ::testing::Values(make_tuple(
+                            &av1_temporal_filter_apply_c,
+                            &av1_temporal_filter_apply_c, 8)));
+
+// The SSE2 assembly computes 3 * diff * diff in 16 bits and therefore does
+// not match the C code for differences above 147, so it is not tested here.
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, TemporalFilterTest,
+                        ::testing::Values(make_tuple(
+                            &av1_temporal_filter_apply_avx2,
+                            &av1_temporal_filter_apply_c, 8)));
+#endif  // HAVE_AVX2
+
+#if CONFIG_AOM_HIGHBITDEPTH
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_CASE_P(
+    SSE4_1_HBD, TemporalFilterTest,
+    ::testing::Values(make_tuple(&av1_highbd_temporal_filter_apply_sse4_1,
+                                 &av1_highbd_temporal_filter_apply_c, 10),
+                      make_tuple(&av1_highbd_temporal_filter_apply_sse4_1,
+                                 &av1_highbd_temporal_filter_apply_c, 12)));
+#endif  // HAVE_SSE4_1
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2_HBD, TemporalFilterTest,
+    ::testing::Values(make_tuple(&av1_highbd_temporal_filter_apply_avx2,
+                                 &av1_highbd_temporal_filter_apply_c, 10),
+                      make_tuple(&av1_highbd_temporal_filter_apply_avx2,
+                                 &av1_highbd_temporal_filter_apply_c, 12)));
+#endif  // HAVE_AVX2
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+}  // namespace
@@ -1,6 +1,7 @@
 LIBAOM_TEST_SRCS-yes += acm_random.h
 LIBAOM_TEST_SRCS-yes += clear_system_state.h
 LIBAOM_TEST_SRCS-yes += codec_factory.h
+LIBAOM_TEST_SRCS-yes += function_equivalence_test.h
 LIBAOM_TEST_SRCS-yes += md5_helper.h
 LIBAOM_TEST_SRCS-yes += register_state_check.h
 LIBAOM_TEST_SRCS-yes += test.mk
@@ -90,6 +91,9 @@ ifeq ($(CONFIG_AV1_ENCODER)$(CONFIG_AV1_DECODER),yesyes)
 LIBAOM_TEST_SRCS-yes                   += idct8x8_test.cc
 LIBAOM_TEST_SRCS-yes                   += partial_idct_test.cc
 LIBAOM_TEST_SRCS-yes                   += superframe_test.cc
+LIBAOM_TEST_SRCS-yes                   += threaded_decode_test.h
+LIBAOM_TEST_SRCS-yes                   += av1_frame_parallel_test.cc
+LIBAOM_TEST_SRCS-yes                   += av1_thread_decode_test.cc
 LIBAOM_TEST_SRCS-yes                   += tile_independence_test.cc
 LIBAOM_TEST_SRCS-yes                   += boolcoder_test.cc
 LIBAOM_TEST_SRCS-yes                   += divu_small_test.cc
@@ -99,6 +103,8 @@ endif
 LIBAOM_TEST_SRCS-yes                   += convolve_test.cc
 LIBAOM_TEST_SRCS-yes                   += lpf_8_test.cc
 LIBAOM_TEST_SRCS-yes                   += intrapred_test.cc
+LIBAOM_TEST_SRCS-yes                   += clpf_test.cc
+LIBAOM_TEST_SRCS-$(CONFIG_DERING)      += dering_test.cc
 LIBAOM_TEST_SRCS-$(CONFIG_AV1_ENCODER) += dct16x16_test.cc
 LIBAOM_TEST_SRCS-$(CONFIG_AV1_ENCODER) += dct32x32_test.cc
 LIBAOM_TEST_SRCS-$(CONFIG_AV1_ENCODER) += fdct4x4_test.cc
@@ -106,6 +112,8 @@ LIBAOM_TEST_SRCS-$(CONFIG_AV1_ENCODER) += fdct8x8_test.cc
 LIBAOM_TEST_SRCS-$(CONFIG_AV1_ENCODER) += variance_test.cc
 LIBAOM_TEST_SRCS-$(CONFIG_AV1_ENCODER) += quantize_test.cc
 LIBAOM_TEST_SRCS-$(CONFIG_AV1_ENCODER) += subtract_test.cc
+LIBAOM_TEST_SRCS-$(CONFIG_AV1_ENCODER) += temporal_filter_test.cc
+LIBAOM_TEST_SRCS-$(CONFIG_AV1_ENCODER) += resize_filter_test.cc
 
 ifeq ($(CONFIG_AV1_ENCODER),yes)
 LIBAOM_TEST_SRCS-$(CONFIG_SPATIAL_SVC) += svc_test.cc
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef TEST_THREADED_DECODE_TEST_H_
+#define TEST_THREADED_DECODE_TEST_H_
+
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+
+namespace libaom_test {
+
+// Encodes a clip, then decodes it with a single thread and with each of a
+// list of thread counts, and checks that the decoded frames match. The
+// derived tests set up the encoder for the stream layout they cover.
+class ThreadedDecodeTest : public EncoderTest {
+ protected:
+  explicit ThreadedDecodeTest(const CodecFactory *codec)
+      : EncoderTest(codec) {}
+
+  virtual ~ThreadedDecodeTest() {}
+
+  // The frames are decoded after the encode, once per thread count.
+  virtual bool DoDecode() const { return false; }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const uint8_t *const buf = static_cast<uint8_t *>(pkt->data.frame.buf);
+    frames_.push_back(std::vector<uint8_t>(buf, buf + pkt->data.frame.sz));
+  }
+
+  // Decode all the frames with the given number of threads and flags and
+  // return the MD5 of every output frame.
+  void DecodeFrames(int threads, aom_codec_flags_t flags,
+                    std::vector<std::string> *md5s) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = threads;
+    Decoder *const decoder = codec_->CreateDecoder(cfg, flags, 0);
+    for (int i = 0; i <= static_cast<int>(frames_.size()); ++i) {
+      // The last call flushes the decoder.
+      const aom_codec_err_t res =
+          i < static_cast<int>(frames_.size())
+              ? decoder->DecodeFrame(&frames_[i][0], frames_[i].size())
+              : decoder->DecodeFrame(NULL, 0);
+      ASSERT_EQ(AOM_CODEC_OK, res) << decoder->DecodeError();
+      DxDataIterator dec_iter = decoder->GetDxData();
+      const aom_image_t *img;
+      while ((img = dec_iter.Next()) != NULL) {
+        MD5 md5;
+        md5.Add(img);
+        md5s->push_back(md5.Get());
+      }
+    }
+    delete decoder;
+  }
+
+  // Encode the 'num_frames' frames of 'video', then check that decoding them
+  // with each of the 'num_threads' thread counts in 'threads' and the given
+  // flags gives the frames of a single threaded decode.
+  void RunTest(VideoSource *video, int num_frames, const int *threads,
+               int num_threads, aom_codec_flags_t flags) {
+    std::vector<std::string> ref_md5s;
+
+    ASSERT_NO_FATAL_FAILURE(RunLoop(video));
+    ASSERT_NO_FATAL_FAILURE(DecodeFrames(1, 0, &ref_md5s));
+    ASSERT_EQ(num_frames, static_cast<int>(ref_md5s.size()));
+
+    for (int i = 0; i < num_threads; ++i) {
+      std::vector<std::string> md5s;
+      ASSERT_NO_FATAL_FAILURE(DecodeFrames(threads[i], flags, &md5s));
+      EXPECT_EQ(ref_md5s, md5s) << "threads " << threads[i];
+    }
+  }
+
+  std::vector<std::vector<uint8_t> > frames_;
+};
+
+}  // namespace libaom_test
+
+#endif  // TEST_THREADED_DECODE_TEST_H_